@@ -0,0 +1,211 @@
+//-----------------------------------------------------------------------------
+//   BridgeLog.cpp
+//   Asynchronous logging to bridge_debug.log
+//-----------------------------------------------------------------------------
+
+#include "include/BridgeLog.h"
+#include "include/Platform.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+int g_log_level = LOG_LEVEL_INFO;
+
+using BridgeLogDetail::Record;
+
+static const size_t kRingSize = 4096;           // Power of two
+static const size_t kRingMask = kRingSize - 1;
+static const char* kLogHeader = "GSswmm Bridge v5.212 (with LID API)\n";
+
+static Record* s_ring = NULL;                   // Allocated once, reused across runs
+static std::atomic<bool> s_running(false);
+static std::atomic<size_t> s_enqueue_pos(0);
+static std::atomic<size_t> s_dequeue_pos(0);    // Written only by the writer thread
+static std::atomic<size_t> s_flushed_pos(0);    // Records durable on disk
+static std::atomic<bool> s_stop(false);
+static std::atomic<bool> s_writer_idle(false);
+static std::mutex s_wake_mutex;
+static std::condition_variable s_wake;
+static std::thread* s_writer = NULL;            // Heap-held so an un-stopped writer never runs a destructor at unload
+static FILE* s_file = NULL;
+static bool s_file_started = false;              // Header written, append from now on
+static std::string s_path = LOG_FILE;
+
+void LogSetLevel(int level) { g_log_level = level; }
+int LogGetLevel() { return g_log_level; }
+
+void LogSetFile(const std::string& path) {
+    if (path == s_path) return;
+    s_path = path;
+    s_file_started = false;
+}
+
+static FILE* OpenLogFile() {
+    FILE* f = NULL;
+    if (fopen_s(&f, s_path.c_str(), s_file_started ? "a" : "w") != 0 || !f) return NULL;
+    if (!s_file_started) {
+        fputs(kLogHeader, f);
+        s_file_started = true;
+    }
+    return f;
+}
+
+static size_t FormatLine(const Record* r, char* line, size_t size) {
+    struct tm lt;
+    time_t t = r->timestamp;
+#ifdef _WIN32
+    localtime_s(&lt, &t);
+#else
+    localtime_r(&t, &lt);
+#endif
+    const char* tag = (r->level == 1) ? "ERROR" : (r->level == 2) ? "INFO " : "DEBUG";
+    int n = snprintf(line, size, "[%02d:%02d:%02d] [%s] ", lt.tm_hour, lt.tm_min, lt.tm_sec, tag);
+    int m = r->format(line + n, size - n - 1, r->fmt, r->payload);
+    size_t len = (size_t)n + (m < 0 ? 0 : (size_t)m);
+    if (len > size - 2) len = size - 2;          // Message was truncated by snprintf
+    line[len++] = '\n';
+    line[len] = '\0';
+    return len;
+}
+
+static void WakeWriter() {
+    if (s_writer_idle.load(std::memory_order_acquire)) {
+        s_wake.notify_one();
+    }
+}
+
+static void WriterMain() {
+    char line[2048];
+    size_t pos = s_dequeue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        Record* cell = &s_ring[pos & kRingMask];
+        size_t seq = cell->seq.load(std::memory_order_acquire);
+        if (seq == pos + 1) {
+            size_t len = FormatLine(cell, line, sizeof(line));
+            fwrite(line, 1, len, s_file);
+            cell->seq.store(pos + kRingSize, std::memory_order_release);
+            pos++;
+            s_dequeue_pos.store(pos, std::memory_order_release);
+            if (pos - s_flushed_pos.load(std::memory_order_relaxed) >= kRingSize / 4) {
+                fflush(s_file);
+                s_flushed_pos.store(pos, std::memory_order_release);
+            }
+            continue;
+        }
+
+        // Queue drained: make everything written so far durable
+        if (s_flushed_pos.load(std::memory_order_relaxed) != pos) {
+            fflush(s_file);
+            s_flushed_pos.store(pos, std::memory_order_release);
+        }
+        if (s_stop.load(std::memory_order_acquire) &&
+            s_enqueue_pos.load(std::memory_order_acquire) == pos) {
+            break;
+        }
+
+        std::unique_lock<std::mutex> lock(s_wake_mutex);
+        s_writer_idle.store(true, std::memory_order_release);
+        // Re-check after publishing idle so a producer that missed the flag
+        // is picked up; the timeout bounds any remaining race.
+        if (s_ring[pos & kRingMask].seq.load(std::memory_order_acquire) != pos + 1 && !s_stop.load()) {
+            s_wake.wait_for(lock, std::chrono::milliseconds(20));
+        }
+        s_writer_idle.store(false, std::memory_order_release);
+    }
+}
+
+void LogStart() {
+    if (s_running.load()) return;
+    if (g_log_level <= LOG_LEVEL_OFF) return;
+
+    s_file = OpenLogFile();
+    if (!s_file) return;                          // Fall back to synchronous writes
+
+    if (!s_ring) {
+        s_ring = new Record[kRingSize];
+    }
+    for (size_t i = 0; i < kRingSize; i++) {
+        s_ring[i].seq.store(i, std::memory_order_relaxed);
+    }
+    s_enqueue_pos.store(0);
+    s_dequeue_pos.store(0);
+    s_flushed_pos.store(0);
+    s_stop.store(false);
+    s_writer = new std::thread(WriterMain);
+    s_running.store(true, std::memory_order_release);
+}
+
+void LogStop() {
+    if (!s_running.load()) return;
+    s_running.store(false, std::memory_order_release);
+    s_stop.store(true, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(s_wake_mutex);
+        s_wake.notify_one();
+    }
+    s_writer->join();
+    delete s_writer;
+    s_writer = NULL;
+    fclose(s_file);
+    s_file = NULL;
+}
+
+void LogFlush() {
+    if (!s_running.load(std::memory_order_acquire)) return;
+    size_t target = s_enqueue_pos.load(std::memory_order_acquire);
+    {
+        std::lock_guard<std::mutex> lock(s_wake_mutex);
+        s_wake.notify_one();
+    }
+    while (s_flushed_pos.load(std::memory_order_acquire) < target) {
+        std::this_thread::yield();
+    }
+}
+
+namespace BridgeLogDetail {
+
+Record* BeginRecord() {
+    if (!s_running.load(std::memory_order_acquire)) return NULL;
+    size_t pos = s_enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        Record* cell = &s_ring[pos & kRingMask];
+        size_t seq = cell->seq.load(std::memory_order_acquire);
+        ptrdiff_t dif = (ptrdiff_t)seq - (ptrdiff_t)pos;
+        if (dif == 0) {
+            if (s_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                cell->pos = pos;
+                return cell;
+            }
+        } else if (dif < 0) {
+            // Ring full: let the writer catch up rather than drop the record
+            WakeWriter();
+            std::this_thread::yield();
+            pos = s_enqueue_pos.load(std::memory_order_relaxed);
+        } else {
+            pos = s_enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void CommitRecord(Record* r) {
+    r->seq.store(r->pos + 1, std::memory_order_release);
+    WakeWriter();
+}
+
+void WriteNow(Record* r) {
+    char line[2048];
+    size_t len = FormatLine(r, line, sizeof(line));
+    FILE* f = OpenLogFile();
+    if (!f) return;
+    fwrite(line, 1, len, f);
+    fclose(f);
+}
+
+int FormatTruncated(char* out, size_t size, const char* fmt, const unsigned char* payload) {
+    (void)payload;
+    return snprintf(out, size, "[log record truncated] %s", fmt);
+}
+
+} // namespace BridgeLogDetail
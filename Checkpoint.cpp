@@ -0,0 +1,298 @@
+//-----------------------------------------------------------------------------
+//   Checkpoint.cpp
+//   Mid-run checkpoint files, written by a background thread
+//-----------------------------------------------------------------------------
+
+#include "include/Platform.h"
+#include "include/Checkpoint.h"
+#include "include/Hash.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+static const char kMagic[8] = { 'G', 'S', 'C', 'K', 'P', 'T', '0', '2' };
+
+// Fixed part of a .state file; followed by the pending inputs, the runtime
+// state and an FNV-1a checksum of everything before it
+struct StateHeader {
+    char magic[8];
+    unsigned long long model_hash;
+    double start_days;
+    double elapsed_sec;
+    long long interval_count;
+    long long route_steps;
+    long long hotstart_bytes;       // Size of the .hsf when it was committed
+    int first_calculate;
+    int realization;
+    unsigned int input_count;
+    unsigned int runtime_count;
+};
+
+static long long FileSize(const std::string& path) {
+    FILE* f = NULL;
+    if (fopen_s(&f, path.c_str(), "rb") != 0 || !f) return -1;
+    fseek(f, 0, SEEK_END);
+    long long n = (long long)ftell(f);
+    fclose(f);
+    return n;
+}
+
+bool ReplaceFileAtomic(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+CheckpointStore::CheckpointStore()
+    : hash_(0), keep_(1), thread_(NULL), busy_(false), stop_(false), failed_(false) {}
+
+CheckpointStore::~CheckpointStore() {
+    Close();
+}
+
+bool CheckpointStore::Open(const std::string& dir, unsigned long long model_hash, int keep, std::string& error) {
+    Close();
+    dir_ = dir;
+    if (!dir_.empty()) {
+        MakeDirectory(dir_);
+        if (dir_[dir_.size() - 1] != '\\' && dir_[dir_.size() - 1] != '/') dir_ += PATH_SEP;
+    }
+    hash_ = model_hash;
+    keep_ = keep < 1 ? 1 : keep;
+    failed_ = false;
+    stop_ = false;
+    last_error_.clear();
+
+    FILE* probe = NULL;
+    if (fopen_s(&probe, (ListPath() + ".tmp").c_str(), "wb") != 0 || !probe) {
+        error = "Cannot write to checkpoint directory " + (dir.empty() ? std::string(".") : dir);
+        return false;
+    }
+    fclose(probe);
+    std::remove((ListPath() + ".tmp").c_str());
+
+    // Carry on the list left by an earlier run so pruning still covers it
+    committed_.clear();
+    std::ifstream list(ListPath().c_str());
+    std::string line;
+    while (std::getline(list, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        if (!line.empty()) committed_.push_back(line);
+    }
+
+    thread_ = new std::thread(&CheckpointStore::Run, this);
+    return true;
+}
+
+bool CheckpointStore::Close() {
+    if (!thread_) return !failed_;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_->join();
+    delete thread_;
+    thread_ = NULL;
+    return !failed_;
+}
+
+std::string CheckpointStore::BaseName(double elapsed_sec) const {
+    char name[64];
+    sprintf_s(name, "ckpt_%016llx_%012lld", hash_, (long long)std::floor(elapsed_sec + 0.5));
+    return name;
+}
+
+std::string CheckpointStore::ListPath() const {
+    char name[48];
+    sprintf_s(name, "ckpt_%016llx.list", hash_);
+    return dir_ + name;
+}
+
+std::string CheckpointStore::HotstartTempPath(double elapsed_sec) const {
+    return dir_ + BaseName(elapsed_sec) + ".hsf.tmp";
+}
+
+void CheckpointStore::Commit(const CheckpointState& state) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queue_.push_back(state);
+    }
+    cv_.notify_all();
+}
+
+void CheckpointStore::Flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return queue_.empty() && !busy_; });
+}
+
+void CheckpointStore::Run() {
+    for (;;) {
+        CheckpointState state;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return !queue_.empty() || stop_; });
+            if (queue_.empty()) return;
+            state = queue_.front();
+            queue_.pop_front();
+            busy_ = true;
+        }
+        std::string error;
+        bool ok = WriteCheckpoint(state, error);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_ = false;
+            if (!ok) {
+                failed_ = true;
+                last_error_ = error;
+            }
+        }
+        cv_.notify_all();
+    }
+}
+
+bool CheckpointStore::WriteCheckpoint(const CheckpointState& state, std::string& error) {
+    const std::string base = BaseName(state.elapsed_sec);
+    const std::string hsf = dir_ + base + ".hsf";
+    if (!ReplaceFileAtomic(hsf + ".tmp", hsf)) {
+        error = "Checkpoint hotstart missing: " + hsf + ".tmp";
+        return false;
+    }
+
+    StateHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.model_hash = hash_;
+    h.start_days = state.start_days;
+    h.elapsed_sec = state.elapsed_sec;
+    h.interval_count = state.interval_count;
+    h.route_steps = state.route_steps;
+    h.hotstart_bytes = FileSize(hsf);
+    h.first_calculate = state.first_calculate;
+    h.realization = state.realization;
+    h.input_count = (unsigned int)state.pending_inputs.size();
+    h.runtime_count = (unsigned int)state.runtime.size();
+    unsigned long long sum = Fnv1a64(&h, sizeof(h));
+    sum = Fnv1a64(state.pending_inputs.data(), state.pending_inputs.size() * sizeof(double), sum);
+    sum = Fnv1a64(state.runtime.data(), state.runtime.size() * sizeof(double), sum);
+
+    const std::string path = dir_ + base + ".state";
+    FILE* f = NULL;
+    if (fopen_s(&f, (path + ".tmp").c_str(), "wb") != 0 || !f) {
+        error = "Cannot write checkpoint " + path;
+        return false;
+    }
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    if (!state.pending_inputs.empty()) {
+        ok = ok && fwrite(state.pending_inputs.data(), sizeof(double), state.pending_inputs.size(), f) == state.pending_inputs.size();
+    }
+    if (!state.runtime.empty()) {
+        ok = ok && fwrite(state.runtime.data(), sizeof(double), state.runtime.size(), f) == state.runtime.size();
+    }
+    ok = ok && fwrite(&sum, sizeof(sum), 1, f) == 1;
+    ok = (fclose(f) == 0) && ok;
+    if (!ok || !ReplaceFileAtomic(path + ".tmp", path)) {
+        std::remove((path + ".tmp").c_str());
+        error = "Cannot write checkpoint " + path;
+        return false;
+    }
+
+    // Publish, then drop what falls off the end of the list
+    for (size_t i = 0; i < committed_.size(); i++) {
+        if (committed_[i] == base) { committed_.erase(committed_.begin() + i); break; }
+    }
+    committed_.push_front(base);
+    std::vector<std::string> dropped;
+    while ((int)committed_.size() > keep_) {
+        dropped.push_back(committed_.back());
+        committed_.pop_back();
+    }
+    if (!WriteList(error)) return false;
+    for (const std::string& old : dropped) {
+        std::remove((dir_ + old + ".state").c_str());
+        std::remove((dir_ + old + ".hsf").c_str());
+    }
+    return true;
+}
+
+bool CheckpointStore::WriteList(std::string& error) {
+    const std::string path = ListPath();
+    {
+        std::ofstream f((path + ".tmp").c_str(), std::ios::trunc);
+        for (const std::string& name : committed_) f << name << "\n";
+        f.close();
+        if (f.fail()) { error = "Cannot write " + path; return false; }
+    }
+    if (!ReplaceFileAtomic(path + ".tmp", path)) {
+        error = "Cannot replace " + path;
+        return false;
+    }
+    return true;
+}
+
+void CheckpointStore::Discard() {
+    Flush();
+    std::lock_guard<std::mutex> lock(mutex_);     // Writer is idle after Flush()
+    for (const std::string& name : committed_) {
+        std::remove((dir_ + name + ".state").c_str());
+        std::remove((dir_ + name + ".hsf").c_str());
+    }
+    committed_.clear();
+    std::remove(ListPath().c_str());
+}
+
+int CheckpointStore::GetCommittedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return (int)committed_.size();
+}
+
+bool CheckpointStore::FindLatest(CheckpointState& state, std::string& hotstart_path, std::string& error) const {
+    std::ifstream list(ListPath().c_str());
+    if (!list.is_open()) {
+        error = "No checkpoints for this model in " + (dir_.empty() ? std::string(".") : dir_);
+        return false;
+    }
+    std::string name;
+    error = "No intact checkpoint in " + ListPath();
+    while (std::getline(list, name)) {
+        if (!name.empty() && name[name.size() - 1] == '\r') name.erase(name.size() - 1);
+        if (name.empty()) continue;
+
+        std::ifstream f((dir_ + name + ".state").c_str(), std::ios::binary);
+        StateHeader h;
+        if (!f.read((char*)&h, sizeof(h)) || memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 ||
+            h.model_hash != hash_ || h.input_count > 1000000 || h.runtime_count > 100000000) {
+            continue;
+        }
+        std::vector<double> inputs(h.input_count);
+        std::vector<double> runtime(h.runtime_count);
+        unsigned long long stored = 0;
+        if ((h.input_count > 0 && !f.read((char*)inputs.data(), inputs.size() * sizeof(double))) ||
+            (h.runtime_count > 0 && !f.read((char*)runtime.data(), runtime.size() * sizeof(double))) ||
+            !f.read((char*)&stored, sizeof(stored))) {
+            continue;
+        }
+        unsigned long long sum = Fnv1a64(&h, sizeof(h));
+        sum = Fnv1a64(inputs.data(), inputs.size() * sizeof(double), sum);
+        sum = Fnv1a64(runtime.data(), runtime.size() * sizeof(double), sum);
+        const std::string hsf = dir_ + name + ".hsf";
+        if (sum != stored || FileSize(hsf) != h.hotstart_bytes) continue;
+
+        state.model_hash = h.model_hash;
+        state.start_days = h.start_days;
+        state.elapsed_sec = h.elapsed_sec;
+        state.interval_count = (long)h.interval_count;
+        state.route_steps = (long)h.route_steps;
+        state.first_calculate = h.first_calculate;
+        state.realization = h.realization;
+        state.pending_inputs.swap(inputs);
+        state.runtime.swap(runtime);
+        hotstart_path = hsf;
+        error.clear();
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,172 @@
+//-----------------------------------------------------------------------------
+//   Controllers.cpp
+//   Native controllers (deadband, PID, lookup table) evaluated before every
+//   routing step
+//-----------------------------------------------------------------------------
+
+#include "include/Controllers.h"
+#include "include/swmm5.h"
+#include <algorithm>
+#include <limits>
+
+ControllerBank::ControllerBank() : last_time_(-1.0) {}
+ControllerBank::~ControllerBank() {}
+
+void ControllerBank::Clear() {
+    defs_.clear();
+    states_.clear();
+    last_time_ = -1.0;
+}
+
+int ControllerBank::GetCount() const { return (int)defs_.size(); }
+bool ControllerBank::IsEmpty() const { return defs_.empty(); }
+
+int ControllerBank::Add(const Definition& def) {
+    defs_.push_back(def);
+    states_.push_back(State());
+    Reset();
+    return (int)defs_.size() - 1;
+}
+
+void ControllerBank::Reset() {
+    for (size_t i = 0; i < defs_.size(); i++) {
+        const Definition& d = defs_[i];
+        State& st = states_[i];
+        st.params[SETPOINT] = d.setpoint;
+        st.params[ON_LEVEL] = d.on_level;
+        st.params[OFF_LEVEL] = d.off_level;
+        st.params[ENABLED] = 1.0;
+        st.integral = 0.0;
+        st.prev_measured = 0.0;
+        st.last_setting = std::numeric_limits<double>::quiet_NaN();
+        st.on = false;
+        st.primed = false;
+    }
+    last_time_ = -1.0;
+}
+
+void ControllerBank::SetParam(int slot, int param, double value) {
+    if (slot < 0 || slot >= (int)states_.size() || param < 0 || param >= PARAM_COUNT) return;
+    states_[slot].params[param] = value;
+}
+
+double ControllerBank::Evaluate(const Definition& def, State& st, double measured, double dt) const {
+    switch (def.type) {
+    case DEADBAND: {
+        double on = st.params[ON_LEVEL], off = st.params[OFF_LEVEL];
+        if (on >= off) {
+            // Drain: switch on when the sensor rises to on_level
+            if (measured >= on) st.on = true;
+            else if (measured <= off) st.on = false;
+        } else {
+            // Fill: switch on when the sensor falls to on_level
+            if (measured <= on) st.on = true;
+            else if (measured >= off) st.on = false;
+        }
+        return st.on ? def.on_setting : def.off_setting;
+    }
+    case PID: {
+        double error = measured - st.params[SETPOINT];
+        // Derivative on the measurement so setpoint changes do not kick the output
+        double derivative = (st.primed && dt > 0.0) ? (measured - st.prev_measured) / dt : 0.0;
+        double integral = st.integral + error * dt;
+        double u = def.kp * error + def.ki * integral + def.kd * derivative;
+        // Conditional integration: stop winding up while saturated
+        if (u > def.max_setting) {
+            u = def.max_setting;
+            if (def.ki * error > 0.0) integral = st.integral;
+        } else if (u < def.min_setting) {
+            u = def.min_setting;
+            if (def.ki * error < 0.0) integral = st.integral;
+        }
+        st.integral = integral;
+        return u;
+    }
+    case TABLE: {
+        const std::vector<double>& x = def.table_x;
+        const std::vector<double>& y = def.table_y;
+        if (measured <= x.front()) return y.front();
+        if (measured >= x.back()) return y.back();
+        size_t i = 1;
+        while (x[i] < measured) i++;      // x[i-1] < measured <= x[i]
+        if (def.table_step) return measured == x[i] ? y[i] : y[i - 1];
+        double frac = (measured - x[i - 1]) / (x[i] - x[i - 1]);
+        return y[i - 1] + (y[i] - y[i - 1]) * frac;
+    }
+    }
+    return st.last_setting;
+}
+
+int ControllerBank::Update(double elapsed_sec) {
+    double dt = last_time_ < 0.0 ? 0.0 : elapsed_sec - last_time_;
+    last_time_ = elapsed_sec;
+
+    int written = 0;
+    for (size_t i = 0; i < defs_.size(); i++) {
+        const Definition& d = defs_[i];
+        State& st = states_[i];
+        if (st.params[ENABLED] == 0.0) continue;
+
+        double measured = swmm_getValue(d.sensor_prop, d.sensor_index);
+        double setting = Evaluate(d, st, measured, dt);
+        st.prev_measured = measured;
+        st.primed = true;
+        if (setting == st.last_setting) continue;
+        swmm_setValue(swmm_LINK_SETTING, d.actuator_index, setting);
+        st.last_setting = setting;
+        written++;
+    }
+    return written;
+}
+
+// Layout: controller count, last update time, then per controller its
+// parameters, integral, previous measurement and on/primed flags
+static const size_t kStateValues = ControllerBank::PARAM_COUNT + 4;
+
+void ControllerBank::SaveState(std::vector<double>& out) const {
+    out.push_back((double)states_.size());
+    out.push_back(last_time_);
+    for (const State& st : states_) {
+        out.insert(out.end(), st.params, st.params + PARAM_COUNT);
+        out.push_back(st.integral);
+        out.push_back(st.prev_measured);
+        out.push_back(st.on ? 1.0 : 0.0);
+        out.push_back(st.primed ? 1.0 : 0.0);
+    }
+}
+
+bool ControllerBank::RestoreState(const std::vector<double>& data, size_t& pos) {
+    if (data.size() < pos + 2 || data[pos] != (double)states_.size() ||
+        data.size() - pos - 2 < states_.size() * kStateValues) {
+        return false;
+    }
+    const double* v = data.data() + pos;
+    last_time_ = v[1];
+    v += 2;
+    for (State& st : states_) {
+        std::copy(v, v + PARAM_COUNT, st.params);
+        st.integral = v[PARAM_COUNT];
+        st.prev_measured = v[PARAM_COUNT + 1];
+        st.on = v[PARAM_COUNT + 2] != 0.0;
+        st.primed = v[PARAM_COUNT + 3] != 0.0;
+        st.last_setting = std::numeric_limits<double>::quiet_NaN();
+        v += kStateValues;
+    }
+    pos = v - data.data();
+    return true;
+}
+
+int ControllerTypeFromName(const std::string& name) {
+    if (name == "DEADBAND") return ControllerBank::DEADBAND;
+    if (name == "PID") return ControllerBank::PID;
+    if (name == "TABLE") return ControllerBank::TABLE;
+    return -1;
+}
+
+int ControllerParamFromName(int type, const std::string& name) {
+    if (name == "ENABLED") return ControllerBank::ENABLED;
+    if (type == ControllerBank::PID && name == "SETPOINT") return ControllerBank::SETPOINT;
+    if (type == ControllerBank::DEADBAND && name == "ON_LEVEL") return ControllerBank::ON_LEVEL;
+    if (type == ControllerBank::DEADBAND && name == "OFF_LEVEL") return ControllerBank::OFF_LEVEL;
+    return -1;
+}
@@ -0,0 +1,316 @@
+//-----------------------------------------------------------------------------
+//   Expression.cpp
+//   Arithmetic expression outputs compiled once to stack bytecode and
+//   evaluated after every gather
+//-----------------------------------------------------------------------------
+
+#include "include/Expression.h"
+#include "include/Platform.h"
+#include <cctype>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+
+//-----------------------------------------------------------------------------
+//   Recursive-descent parser emitting postfix code
+//-----------------------------------------------------------------------------
+
+class ExpressionParser {
+public:
+    ExpressionParser(ExpressionProgram& prog, const std::string& text)
+        : prog_(prog), s_(text), pos_(0) {}
+
+    bool Parse(std::string& error) {
+        if (!ParseExpr()) { error = error_; return false; }
+        SkipSpace();
+        if (pos_ < s_.size()) { error = Fail("unexpected '" + std::string(1, s_[pos_]) + "'"); return false; }
+        return true;
+    }
+
+private:
+    std::string Fail(const std::string& msg) {
+        char where[32];
+        sprintf_s(where, " at position %d", (int)pos_ + 1);
+        error_ = msg + where;
+        return error_;
+    }
+
+    void SkipSpace() {
+        while (pos_ < s_.size() && std::isspace((unsigned char)s_[pos_])) pos_++;
+    }
+
+    bool Accept(char c) {
+        SkipSpace();
+        if (pos_ < s_.size() && s_[pos_] == c) { pos_++; return true; }
+        return false;
+    }
+
+    static bool IsNameChar(char c) { return std::isalnum((unsigned char)c) || c == '_'; }
+
+    std::string ReadName() {
+        size_t start = pos_;
+        while (pos_ < s_.size() && IsNameChar(s_[pos_])) pos_++;
+        return s_.substr(start, pos_ - start);
+    }
+
+    bool ParseExpr() {
+        if (!ParseTerm()) return false;
+        for (;;) {
+            if (Accept('+')) { if (!ParseTerm()) return false; prog_.Emit(ExpressionProgram::OP_ADD, 0, 0.0); }
+            else if (Accept('-')) { if (!ParseTerm()) return false; prog_.Emit(ExpressionProgram::OP_SUB, 0, 0.0); }
+            else return true;
+        }
+    }
+
+    bool ParseTerm() {
+        if (!ParseUnary()) return false;
+        for (;;) {
+            if (Accept('*')) { if (!ParseUnary()) return false; prog_.Emit(ExpressionProgram::OP_MUL, 0, 0.0); }
+            else if (Accept('/')) { if (!ParseUnary()) return false; prog_.Emit(ExpressionProgram::OP_DIV, 0, 0.0); }
+            else return true;
+        }
+    }
+
+    bool ParseUnary() {
+        if (Accept('-')) {
+            if (!ParseUnary()) return false;
+            prog_.Emit(ExpressionProgram::OP_NEG, 0, 0.0);
+            return true;
+        }
+        if (Accept('+')) return ParseUnary();
+        return ParsePower();
+    }
+
+    bool ParsePower() {
+        if (!ParsePrimary()) return false;
+        if (Accept('^')) {
+            if (!ParseUnary()) return false;      // Right-associative
+            prog_.Emit(ExpressionProgram::OP_POW, 0, 0.0);
+        }
+        return true;
+    }
+
+    bool ParsePrimary() {
+        SkipSpace();
+        if (pos_ >= s_.size()) { Fail("unexpected end of expression"); return false; }
+        char c = s_[pos_];
+
+        if (c == '(') {
+            pos_++;
+            if (!ParseExpr()) return false;
+            if (!Accept(')')) { Fail("expected ')'"); return false; }
+            return true;
+        }
+        if (c == '\'') return ParseReference(std::string());
+
+        // A number unless it is followed by ".PROPERTY" (names may start with a digit)
+        if (std::isdigit((unsigned char)c) || c == '.') {
+            size_t save = pos_;
+            std::string run = ReadName();
+            bool is_ref = !run.empty() && pos_ + 1 < s_.size() && s_[pos_] == '.' &&
+                          std::isalpha((unsigned char)s_[pos_ + 1]);
+            pos_ = save;
+            if (!is_ref) {
+                const char* begin = s_.c_str() + pos_;
+                char* end = NULL;
+                double v = std::strtod(begin, &end);
+                if (end == begin) { Fail("bad number"); return false; }
+                pos_ += (size_t)(end - begin);
+                prog_.Emit(ExpressionProgram::OP_CONST, 0, v);
+                return true;
+            }
+        }
+        if (!IsNameChar(c)) { Fail("unexpected '" + std::string(1, c) + "'"); return false; }
+
+        size_t save = pos_;
+        std::string word = ReadName();
+        SkipSpace();
+        if (pos_ < s_.size() && s_[pos_] == '(') return ParseCall(word);
+        if (pos_ < s_.size() && s_[pos_] == ':') {
+            pos_++;
+            SkipSpace();
+            std::string type = word;
+            for (auto& ch : type) ch = (char)std::toupper((unsigned char)ch);
+            return ParseReference(type);
+        }
+        pos_ = save;
+        return ParseReference(std::string());
+    }
+
+    bool ParseCall(const std::string& name) {
+        pos_++;   // '('
+        std::string fn = name;
+        for (auto& ch : fn) ch = (char)std::tolower((unsigned char)ch);
+        int args = 0;
+        if (!Accept(')')) {
+            do {
+                if (!ParseExpr()) return false;
+                args++;
+                if (args > 1 && (fn == "min" || fn == "max")) {
+                    prog_.Emit(fn == "min" ? ExpressionProgram::OP_MIN : ExpressionProgram::OP_MAX, 0, 0.0);
+                }
+            } while (Accept(','));
+            if (!Accept(')')) { Fail("expected ')' after arguments of " + name); return false; }
+        }
+        if (fn == "min" || fn == "max") {
+            if (args < 1) { Fail(fn + " needs at least one argument"); return false; }
+            return true;
+        }
+        if (fn == "abs" || fn == "sqrt") {
+            if (args != 1) { Fail(fn + " takes one argument"); return false; }
+            prog_.Emit(fn == "abs" ? ExpressionProgram::OP_ABS : ExpressionProgram::OP_SQRT, 0, 0.0);
+            return true;
+        }
+        Fail("unknown function " + name);
+        return false;
+    }
+
+    bool ParseReference(const std::string& type) {
+        std::string name;
+        if (pos_ < s_.size() && s_[pos_] == '\'') {
+            size_t end = s_.find('\'', pos_ + 1);
+            if (end == std::string::npos) { Fail("unterminated quoted name"); return false; }
+            name = s_.substr(pos_ + 1, end - pos_ - 1);
+            pos_ = end + 1;
+        } else {
+            name = ReadName();
+        }
+        if (name.empty()) { Fail("expected element name"); return false; }
+        if (pos_ >= s_.size() || s_[pos_] != '.') { Fail("expected '.PROPERTY' after " + name); return false; }
+        pos_++;
+        std::string prop = ReadName();
+        if (prop.empty()) { Fail("expected property after " + name + "."); return false; }
+        for (auto& ch : prop) ch = (char)std::toupper((unsigned char)ch);
+
+        int slot = -1;
+        for (size_t i = 0; i < prog_.refs_.size(); i++) {
+            const ExpressionProgram::Reference& r = prog_.refs_[i];
+            if (r.object_type == type && r.name == name && r.property == prop) { slot = (int)i; break; }
+        }
+        if (slot < 0) {
+            ExpressionProgram::Reference r;
+            r.object_type = type;
+            r.name = name;
+            r.property = prop;
+            r.prop = -1;
+            r.index = -1;
+            prog_.refs_.push_back(r);
+            slot = (int)prog_.refs_.size() - 1;
+        }
+        prog_.Emit(ExpressionProgram::OP_REF, slot, 0.0);
+        return true;
+    }
+
+    ExpressionProgram& prog_;
+    const std::string& s_;
+    size_t pos_;
+    std::string error_;
+};
+
+//-----------------------------------------------------------------------------
+//   ExpressionProgram
+//-----------------------------------------------------------------------------
+
+ExpressionProgram::ExpressionProgram() : depth_(0), max_stack_(0) {}
+
+void ExpressionProgram::Emit(int op, int arg, double value) {
+    Instr in;
+    in.op = op;
+    in.arg = arg;
+    in.value = value;
+    const size_t n = code_.size();
+
+    if (op == OP_CONST || op == OP_REF) {
+        code_.push_back(in);
+        if (++depth_ > max_stack_) max_stack_ = depth_;
+        return;
+    }
+    if (op >= OP_NEG) {
+        // Unary: fold a constant operand
+        if (n >= 1 && code_[n - 1].op == OP_CONST) {
+            code_[n - 1].value = Fold(op, code_[n - 1].value, 0.0);
+            return;
+        }
+        code_.push_back(in);
+        return;
+    }
+    // Binary: fold two constant operands
+    depth_--;
+    if (n >= 2 && code_[n - 1].op == OP_CONST && code_[n - 2].op == OP_CONST) {
+        code_[n - 2].value = Fold(op, code_[n - 2].value, code_[n - 1].value);
+        code_.pop_back();
+        return;
+    }
+    code_.push_back(in);
+}
+
+bool ExpressionProgram::Compile(const std::string& text, std::string& error) {
+    text_ = text;
+    code_.clear();
+    refs_.clear();
+    depth_ = 0;
+    max_stack_ = 0;
+
+    ExpressionParser parser(*this, text_);
+    if (!parser.Parse(error)) {
+        error = "Expression \"" + text + "\": " + error;
+        return false;
+    }
+    if (max_stack_ > MAX_STACK) {
+        error = "Expression \"" + text + "\" is nested too deeply";
+        return false;
+    }
+    return true;
+}
+
+int ExpressionProgram::GetReferenceCount() const { return (int)refs_.size(); }
+const ExpressionProgram::Reference& ExpressionProgram::GetReference(int i) const { return refs_[i]; }
+const std::string& ExpressionProgram::GetText() const { return text_; }
+int ExpressionProgram::GetInstructionCount() const { return (int)code_.size(); }
+int ExpressionProgram::GetMaxStack() const { return max_stack_; }
+
+void ExpressionProgram::ResolveReference(int i, int prop, int index) {
+    refs_[i].prop = prop;
+    refs_[i].index = index;
+}
+
+double ExpressionProgram::Fold(int op, double a, double b) {
+    switch (op) {
+    case OP_ADD:  return a + b;
+    case OP_SUB:  return a - b;
+    case OP_MUL:  return a * b;
+    case OP_DIV:  return a / b;
+    case OP_POW:  return std::pow(a, b);
+    case OP_MIN:  return b < a ? b : a;
+    case OP_MAX:  return b > a ? b : a;
+    case OP_NEG:  return -a;
+    case OP_ABS:  return std::fabs(a);
+    case OP_SQRT: return std::sqrt(a);
+    }
+    return a;
+}
+
+double ExpressionProgram::Evaluate(const double* ref_values) const {
+    double stack[MAX_STACK];
+    int sp = 0;
+    const Instr* code = code_.data();
+    const int n = (int)code_.size();
+    for (int i = 0; i < n; i++) {
+        const Instr& in = code[i];
+        switch (in.op) {
+        case OP_CONST: stack[sp++] = in.value; break;
+        case OP_REF:   stack[sp++] = ref_values[in.arg]; break;
+        case OP_ADD:   sp--; stack[sp - 1] += stack[sp]; break;
+        case OP_SUB:   sp--; stack[sp - 1] -= stack[sp]; break;
+        case OP_MUL:   sp--; stack[sp - 1] *= stack[sp]; break;
+        case OP_DIV:   sp--; stack[sp - 1] /= stack[sp]; break;
+        case OP_POW:   sp--; stack[sp - 1] = std::pow(stack[sp - 1], stack[sp]); break;
+        case OP_MIN:   sp--; if (stack[sp] < stack[sp - 1]) stack[sp - 1] = stack[sp]; break;
+        case OP_MAX:   sp--; if (stack[sp] > stack[sp - 1]) stack[sp - 1] = stack[sp]; break;
+        case OP_NEG:   stack[sp - 1] = -stack[sp - 1]; break;
+        case OP_ABS:   stack[sp - 1] = std::fabs(stack[sp - 1]); break;
+        case OP_SQRT:  stack[sp - 1] = std::sqrt(stack[sp - 1]); break;
+        }
+    }
+    return sp > 0 ? stack[sp - 1] : 0.0;
+}
@@ -0,0 +1,75 @@
+//-----------------------------------------------------------------------------
+//   FlightRecorder.cpp
+//   Ring of recent steps, dumped as CSV on failure
+//-----------------------------------------------------------------------------
+
+#include "include/FlightRecorder.h"
+#include "include/Platform.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+FlightRecorder::FlightRecorder() : steps_(0), inputs_(0), outputs_(0), row_(0), written_(0) {}
+
+FlightRecorder::~FlightRecorder() {}
+
+void FlightRecorder::Configure(int steps, const std::vector<std::string>& input_names,
+                               const std::vector<std::string>& output_names) {
+    steps_ = steps < 1 ? 1 : steps;
+    inputs_ = (int)input_names.size();
+    outputs_ = (int)output_names.size();
+    input_names_ = input_names;
+    output_names_ = output_names;
+    row_ = FIELD_COUNT + (size_t)inputs_ + (size_t)outputs_;
+    ring_.assign((size_t)steps_ * row_, 0.0);
+    written_ = 0;
+}
+
+void FlightRecorder::Clear() { written_ = 0; }
+bool FlightRecorder::IsConfigured() const { return steps_ > 0; }
+
+int FlightRecorder::GetCount() const {
+    return written_ < steps_ ? (int)written_ : steps_;
+}
+
+void FlightRecorder::Record(long step, double elapsed_days, int code, const double* inputs, const double* outputs) {
+    if (steps_ == 0) return;
+    double* r = &ring_[(size_t)(written_ % steps_) * row_];
+    r[FIELD_STEP] = (double)step;
+    r[FIELD_ELAPSED] = elapsed_days;
+    r[FIELD_CODE] = (double)code;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    double* in = r + FIELD_COUNT;
+    if (inputs) memcpy(in, inputs, (size_t)inputs_ * sizeof(double));
+    else for (int i = 0; i < inputs_; i++) in[i] = nan;
+    double* out = in + inputs_;
+    if (outputs) memcpy(out, outputs, (size_t)outputs_ * sizeof(double));
+    else for (int i = 0; i < outputs_; i++) out[i] = nan;
+    written_++;
+}
+
+bool FlightRecorder::Dump(const std::string& path, const std::string& reason) const {
+    FILE* f = NULL;
+    if (fopen_s(&f, path.c_str(), "w") != 0 || !f) return false;
+
+    fprintf(f, "# %s\n", reason.c_str());
+    fprintf(f, "step,elapsed_days,return_code");
+    for (const std::string& n : input_names_) fprintf(f, ",in:%s", n.c_str());
+    for (const std::string& n : output_names_) fprintf(f, ",out:%s", n.c_str());
+    fprintf(f, "\n");
+
+    const int count = GetCount();
+    for (int k = 0; k < count; k++) {
+        const double* r = &ring_[(size_t)((written_ - count + k) % steps_) * row_];
+        fprintf(f, "%.0f,%.9g,%.0f", r[FIELD_STEP], r[FIELD_ELAPSED], r[FIELD_CODE]);
+        for (size_t i = FIELD_COUNT; i < row_; i++) {
+            if (std::isnan(r[i])) fprintf(f, ",");
+            else fprintf(f, ",%.9g", r[i]);
+        }
+        fprintf(f, "\n");
+    }
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
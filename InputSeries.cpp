@@ -0,0 +1,222 @@
+//-----------------------------------------------------------------------------
+//   InputSeries.cpp
+//   Preloaded input time series: memory-mapped binary or parsed CSV, read
+//   through a forward-moving cursor
+//-----------------------------------------------------------------------------
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "include/InputSeries.h"
+#include "include/Platform.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+static const char kMagic[8] = { 'G', 'S', 'T', 'S', 'E', 'R', '0', '1' };
+
+InputSeries::InputSeries()
+    : data_(NULL), rows_(0), stride_(2), column_(1), scale_(1.0), interp_(HOLD), cursor_(0),
+      file_(NULL), mapping_(NULL), view_(NULL), view_bytes_(0) {}
+
+InputSeries::~InputSeries() {
+    Close();
+}
+
+bool InputSeries::Load(const std::string& path, int column, double seconds_per_unit, Interp interp, std::string& error) {
+    Close();
+    if (column < 1) { error = "Series column must be at least 1: " + path; return false; }
+    if (!(seconds_per_unit > 0.0)) { error = "Series time unit must be > 0: " + path; return false; }
+    scale_ = seconds_per_unit;
+    interp_ = interp;
+
+    // The magic decides the format; anything else is read as CSV
+    char magic[sizeof(kMagic)] = { 0 };
+    FILE* f = NULL;
+    if (fopen_s(&f, path.c_str(), "rb") != 0 || !f) { error = "Cannot open series file: " + path; return false; }
+    size_t n = fread(magic, 1, sizeof(magic), f);
+    fclose(f);
+    bool ok = (n == sizeof(magic) && memcmp(magic, kMagic, sizeof(kMagic)) == 0)
+        ? LoadBinary(path, column, error) : LoadCsv(path, column, error);
+    if (!ok) { Close(); return false; }
+
+    if (rows_ == 0) { error = "Series file has no rows: " + path; Close(); return false; }
+    for (size_t i = 1; i < rows_; i++) {
+        if (!(Time(i) > Time(i - 1))) {
+            char buf[64];
+            sprintf_s(buf, " (row %zu)", i + 1);
+            error = "Series times must increase: " + path + buf;
+            Close();
+            return false;
+        }
+    }
+    cursor_ = 0;
+    return true;
+}
+
+void InputSeries::Close() {
+    Unmap();
+    parsed_.clear();
+    parsed_.shrink_to_fit();
+    data_ = NULL;
+    rows_ = 0;
+    cursor_ = 0;
+}
+
+bool InputSeries::LoadCsv(const std::string& path, int column, std::string& error) {
+    std::ifstream in(path.c_str(), std::ios::binary);
+    if (!in.is_open()) { error = "Cannot open series file: " + path; return false; }
+    std::string line;
+    size_t line_no = 0;
+    bool first = true;
+    while (std::getline(in, line)) {
+        line_no++;
+        size_t p = line.find_first_not_of(" \t\r");
+        if (p == std::string::npos || line[p] == ';' || line[p] == '#') continue;
+
+        const char* s = line.c_str() + p;
+        char* end = NULL;
+        double t = std::strtod(s, &end);
+        if (end == s) {
+            if (first) { first = false; continue; }     // Header line
+            char buf[32];
+            sprintf_s(buf, ":%zu", line_no);
+            error = "Series file has a non-numeric time: " + path + buf;
+            return false;
+        }
+        first = false;
+
+        double v = 0.0;
+        for (int c = 0; c < column; c++) {
+            s = end;
+            while (*s == ',' || *s == ';' || *s == ' ' || *s == '\t') s++;
+            v = std::strtod(s, &end);
+            if (end == s) {
+                char buf[48];
+                sprintf_s(buf, ":%zu has no column %d", line_no, column);
+                error = "Series file " + path + buf;
+                return false;
+            }
+        }
+        parsed_.push_back(t);
+        parsed_.push_back(v);
+    }
+    data_ = parsed_.data();
+    rows_ = parsed_.size() / 2;
+    stride_ = 2;
+    column_ = 1;
+    return true;
+}
+
+bool InputSeries::LoadBinary(const std::string& path, int column, std::string& error) {
+    size_t bytes = 0;
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (f == INVALID_HANDLE_VALUE) { error = "Cannot open series file: " + path; return false; }
+    file_ = f;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(f, &size)) { error = "Cannot read series file size: " + path; return false; }
+    bytes = (size_t)size.QuadPart;
+    if (bytes < sizeof(FileHeader)) { error = "Series file is truncated: " + path; return false; }
+    mapping_ = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping_) { error = "Cannot map series file: " + path; return false; }
+    view_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) { error = "Cannot open series file: " + path; return false; }
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); error = "Cannot read series file size: " + path; return false; }
+    bytes = (size_t)st.st_size;
+    if (bytes < sizeof(FileHeader)) { close(fd); error = "Series file is truncated: " + path; return false; }
+    void* p = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);                                      // The mapping keeps the file
+    if (p != MAP_FAILED) {
+        madvise(p, bytes, MADV_SEQUENTIAL);
+        view_ = p;
+    }
+#endif
+    if (!view_) { error = "Cannot map series file: " + path; return false; }
+    view_bytes_ = bytes;
+
+    FileHeader h;
+    memcpy(&h, view_, sizeof(h));
+    if (h.columns == 0 || (unsigned)column > h.columns) {
+        char buf[64];
+        sprintf_s(buf, " has %u value column(s), not %d", h.columns, column);
+        error = "Series file " + path + buf;
+        return false;
+    }
+    const unsigned long long stride = 1ull + h.columns;
+    if (h.data_offset < sizeof(FileHeader) || h.data_offset % sizeof(double) != 0 || h.data_offset > bytes ||
+        h.rows > (bytes - h.data_offset) / sizeof(double) / stride) {
+        error = "Series file is truncated or has a bad header: " + path;
+        return false;
+    }
+    data_ = (const double*)((const char*)view_ + h.data_offset);
+    rows_ = (size_t)h.rows;
+    stride_ = (size_t)stride;
+    column_ = (size_t)column;
+    return true;
+}
+
+void InputSeries::Unmap() {
+#ifdef _WIN32
+    if (view_) UnmapViewOfFile(view_);
+    if (mapping_) CloseHandle((HANDLE)mapping_);
+    if (file_) CloseHandle((HANDLE)file_);
+#else
+    if (view_) munmap(view_, view_bytes_);
+#endif
+    view_ = NULL;
+    mapping_ = NULL;
+    file_ = NULL;
+    view_bytes_ = 0;
+}
+
+size_t InputSeries::Find(double t) const {
+    // Last row with time <= t (0 when t is before the first row)
+    size_t lo = 0, hi = rows_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (Time(mid) <= t) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo > 0 ? lo - 1 : 0;
+}
+
+void InputSeries::Seek(double seconds) {
+    cursor_ = rows_ ? Find(seconds / scale_) : 0;
+}
+
+double InputSeries::ValueAt(double seconds) {
+    if (rows_ == 0) return 0.0;
+    const double t = seconds / scale_;
+    if (cursor_ > 0 && t < Time(cursor_)) cursor_ = Find(t);
+    while (cursor_ + 1 < rows_ && Time(cursor_ + 1) <= t) cursor_++;
+    if (interp_ == HOLD || cursor_ + 1 >= rows_ || t <= Time(cursor_)) return Value(cursor_);
+    const double t0 = Time(cursor_), t1 = Time(cursor_ + 1);
+    const double v0 = Value(cursor_);
+    return v0 + (Value(cursor_ + 1) - v0) * (t - t0) / (t1 - t0);
+}
+
+double InputSeries::PeakAbs(double t0, double t1) const {
+    if (rows_ == 0) return 0.0;
+    const double a = t0 / scale_, b = t1 / scale_;
+    size_t i = cursor_;
+    if (i > 0 && a < Time(i)) i = Find(a);
+    while (i + 1 < rows_ && Time(i + 1) <= a) i++;
+    double peak = std::fabs(Value(i));
+    for (i++; i < rows_ && Time(i) < b; i++) peak = (std::max)(peak, std::fabs(Value(i)));
+    // LINEAR values ramp towards the first row past the window
+    if (interp_ == LINEAR && i < rows_) peak = (std::max)(peak, std::fabs(Value(i)));
+    return peak;
+}
@@ -7,6 +7,7 @@
 #include <fstream>
 #include <sstream>
 #include <cctype>
+#include <cstdlib>
 
 static std::string trim(const std::string& str) {
     size_t start = 0, end = str.length();
@@ -26,6 +27,15 @@ static int extractInt(const std::string& val) {
     return std::atoi(trim(val).c_str());
 }
 
+static double extractDouble(const std::string& val) {
+    return std::atof(trim(val).c_str());
+}
+
+static bool extractBool(const std::string& val) {
+    std::string t = trim(val);
+    return t == "true" || t == "1";
+}
+
 static std::string findValue(const std::string& json, const std::string& key, std::string& error) {
     std::string searchKey = "\"" + key + "\"";
     size_t keyPos = json.find(searchKey);
@@ -46,12 +56,14 @@ static std::string findValue(const std::string& json, const std::string& key, st
             valueEnd++;
         }
         if (valueEnd < json.length()) valueEnd++;
-    } else if (json[valueStart] == '[') {
+    } else if (json[valueStart] == '[' || json[valueStart] == '{') {
+        char open = json[valueStart];
+        char close = (open == '[') ? ']' : '}';
         int depth = 1;
         valueEnd = valueStart + 1;
         while (valueEnd < json.length() && depth > 0) {
-            if (json[valueEnd] == '[') depth++;
-            else if (json[valueEnd] == ']') depth--;
+            if (json[valueEnd] == open) depth++;
+            else if (json[valueEnd] == close) depth--;
             valueEnd++;
         }
     } else {
@@ -61,9 +73,49 @@ static std::string findValue(const std::string& json, const std::string& key, st
     return json.substr(valueStart, valueEnd - valueStart);
 }
 
-template<typename T>
-static bool parseArray(const std::string& arrayJson, std::vector<T>& items, std::string& error) {
-    items.clear();
+// Look up an optional key; returns false (and leaves error untouched) if absent
+static bool findOptional(const std::string& json, const std::string& key, std::string& value) {
+    std::string err;
+    value = findValue(json, key, err);
+    return err.empty();
+}
+
+// Optional per-item keys
+static void parseExtras(const std::string& objJson, MappingLoader::InputMapping& item) {
+    std::string v;
+    if (findOptional(objJson, "interpolate", v)) item.interpolate = extractString(v);
+    if (findOptional(objJson, "tolerance", v)) item.tolerance = extractDouble(v);
+}
+
+// Parse every string in a JSON array of strings
+static std::vector<std::string> extractStrings(const std::string& arrayJson) {
+    std::vector<std::string> values;
+    size_t pos = 0;
+    while ((pos = arrayJson.find('"', pos)) != std::string::npos) {
+        size_t end = arrayJson.find('"', pos + 1);
+        if (end == std::string::npos) break;
+        values.push_back(arrayJson.substr(pos + 1, end - pos - 1));
+        pos = end + 1;
+    }
+    return values;
+}
+
+static void parseExtras(const std::string& objJson, MappingLoader::OutputMapping& item) {
+    std::string v;
+    if (findOptional(objJson, "aggregate", v)) item.aggregate = extractString(v);
+    if (findOptional(objJson, "reduce", v)) item.reduce = extractString(v);
+    if (findOptional(objJson, "threshold", v)) item.threshold = extractDouble(v);
+    if (findOptional(objJson, "elements", v)) item.elements = extractStrings(v);
+    if (findOptional(objJson, "expression", v)) item.expression = extractString(v);
+    if (findOptional(objJson, "source", v)) item.source = extractString(v);
+    if (findOptional(objJson, "exceed_threshold", v)) item.exceed_threshold = extractDouble(v);
+    if (findOptional(objJson, "update_every", v)) item.update_every = extractInt(v);
+    if (findOptional(objJson, "update_every_seconds", v)) item.update_every_seconds = extractDouble(v);
+}
+
+// Split a JSON array into its top-level objects
+static bool splitObjects(const std::string& arrayJson, std::vector<std::string>& objects, std::string& error) {
+    objects.clear();
     size_t pos = 0;
     while (pos < arrayJson.length()) {
         size_t objStart = arrayJson.find('{', pos);
@@ -78,7 +130,18 @@ static bool parseArray(const std::string& arrayJson, std::vector<T>& items, std:
         }
         if (depth != 0) { error = "Malformed JSON"; return false; }
         
-        std::string objJson = arrayJson.substr(objStart, objEnd - objStart);
+        objects.push_back(arrayJson.substr(objStart, objEnd - objStart));
+        pos = objEnd;
+    }
+    return true;
+}
+
+template<typename T>
+static bool parseArray(const std::string& arrayJson, std::vector<T>& items, std::string& error) {
+    items.clear();
+    std::vector<std::string> objects;
+    if (!splitObjects(arrayJson, objects, error)) return false;
+    for (const std::string& objJson : objects) {
         T item;
         std::string err;
         
@@ -94,9 +157,302 @@ static bool parseArray(const std::string& arrayJson, std::vector<T>& items, std:
         item.property = extractString(findValue(objJson, "property", err));
         if (!err.empty()) { error = err; return false; }
         
+        parseExtras(objJson, item);
         item.swmm_index = -1;
         items.push_back(item);
-        pos = objEnd;
+    }
+    return true;
+}
+
+// Parse every number in a (possibly nested) JSON array
+static std::vector<double> extractNumbers(const std::string& arrayJson) {
+    std::vector<double> values;
+    const char* p = arrayJson.c_str();
+    while (*p) {
+        if (*p == '-' || *p == '+' || *p == '.' || std::isdigit((unsigned char)*p)) {
+            char* end = NULL;
+            values.push_back(std::strtod(p, &end));
+            if (end == p) end++;
+            p = end;
+        } else {
+            p++;
+        }
+    }
+    return values;
+}
+
+static bool parseController(const std::string& objJson, MappingLoader::ControllerMapping& c, std::string& error) {
+    const char* required[] = { "name", "type", "sensor_type", "sensor", "sensor_property", "actuator_type", "actuator" };
+    std::string* fields[] = { &c.name, &c.type, &c.sensor_type, &c.sensor, &c.sensor_property, &c.actuator_type, &c.actuator };
+    for (int i = 0; i < 7; i++) {
+        std::string err;
+        *fields[i] = extractString(findValue(objJson, required[i], err));
+        if (!err.empty()) { error = "Controller: " + err; return false; }
+    }
+    
+    std::string v;
+    if (findOptional(objJson, "setpoint", v)) c.setpoint = extractDouble(v);
+    if (findOptional(objJson, "kp", v)) c.kp = extractDouble(v);
+    if (findOptional(objJson, "ki", v)) c.ki = extractDouble(v);
+    if (findOptional(objJson, "kd", v)) c.kd = extractDouble(v);
+    if (findOptional(objJson, "min_setting", v)) c.min_setting = extractDouble(v);
+    if (findOptional(objJson, "max_setting", v)) c.max_setting = extractDouble(v);
+    if (findOptional(objJson, "on_level", v)) c.on_level = extractDouble(v);
+    if (findOptional(objJson, "off_level", v)) c.off_level = extractDouble(v);
+    if (findOptional(objJson, "on_setting", v)) c.on_setting = extractDouble(v);
+    if (findOptional(objJson, "off_setting", v)) c.off_setting = extractDouble(v);
+    if (findOptional(objJson, "table", v)) c.table = extractNumbers(v);
+    if (findOptional(objJson, "interpolate", v)) c.interpolate = extractString(v);
+    
+    if (c.type == "DEADBAND") {
+        if (c.on_level == c.off_level) {
+            error = "Controller " + c.name + ": on_level and off_level must differ";
+            return false;
+        }
+    } else if (c.type == "PID") {
+        if (c.min_setting > c.max_setting) {
+            error = "Controller " + c.name + ": min_setting must be <= max_setting";
+            return false;
+        }
+    } else if (c.type == "TABLE") {
+        if (c.table.empty() || c.table.size() % 2 != 0) {
+            error = "Controller " + c.name + ": table must be a list of [value, setting] pairs";
+            return false;
+        }
+        for (size_t i = 2; i < c.table.size(); i += 2) {
+            if (c.table[i] <= c.table[i - 2]) {
+                error = "Controller " + c.name + ": table values must be increasing";
+                return false;
+            }
+        }
+        if (!c.interpolate.empty() && c.interpolate != "LINEAR" && c.interpolate != "STEP") {
+            error = "Controller " + c.name + ": unknown interpolate " + c.interpolate;
+            return false;
+        }
+    } else {
+        error = "Controller " + c.name + ": unknown type " + c.type;
+        return false;
+    }
+    return true;
+}
+
+static bool parseControllers(const std::string& arrayJson, std::vector<MappingLoader::ControllerMapping>& items, std::string& error) {
+    items.clear();
+    std::vector<std::string> objects;
+    if (!splitObjects(arrayJson, objects, error)) return false;
+    for (const std::string& objJson : objects) {
+        MappingLoader::ControllerMapping c;
+        if (!parseController(objJson, c, error)) return false;
+        for (const auto& other : items) {
+            if (other.name == c.name) { error = "Duplicate controller name: " + c.name; return false; }
+        }
+        items.push_back(c);
+    }
+    return true;
+}
+
+static bool parseStepping(const std::string& sectionJson, MappingLoader::SteppingOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "async", v)) opts.async = extractBool(v);
+    if (findOptional(sectionJson, "mode", v)) opts.mode = extractString(v);
+    if (findOptional(sectionJson, "timestep_seconds", v)) opts.timestep_seconds = extractDouble(v);
+
+    if (opts.mode != "ROUTING_STEP" && opts.mode != "GOLDSIM_TIME") {
+        error = "Unknown stepping mode: " + opts.mode;
+        return false;
+    }
+    if (opts.mode == "GOLDSIM_TIME" && opts.timestep_seconds <= 0.0) {
+        error = "stepping.timestep_seconds must be > 0 for GOLDSIM_TIME mode";
+        return false;
+    }
+    return true;
+}
+
+static bool parseRealization(const std::string& sectionJson, MappingLoader::RealizationOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "recycle", v)) opts.recycle = extractBool(v);
+    if (findOptional(sectionJson, "minimal_io", v)) opts.minimal_io = extractBool(v);
+    (void)error;
+    return true;
+}
+
+static bool parseSpinup(const std::string& sectionJson, MappingLoader::SpinupOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "duration_days", v)) opts.duration_days = extractDouble(v);
+    if (findOptional(sectionJson, "cache_dir", v)) opts.cache_dir = extractString(v);
+    if (opts.duration_days < 0.0) {
+        error = "spinup.duration_days must be >= 0";
+        return false;
+    }
+    return true;
+}
+
+static bool parseMemo(const std::string& sectionJson, MappingLoader::MemoOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "enabled", v)) opts.enabled = extractBool(v);
+    if (findOptional(sectionJson, "dir", v)) opts.dir = extractString(v);
+    (void)error;
+    return true;
+}
+
+static bool parseStatistics(const std::string& sectionJson, MappingLoader::StatisticsOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "enabled", v)) opts.enabled = extractBool(v);
+    if (findOptional(sectionJson, "file", v)) opts.file = extractString(v);
+    if (findOptional(sectionJson, "quantiles", v)) opts.quantiles = extractNumbers(v);
+    for (double p : opts.quantiles) {
+        if (!(p > 0.0 && p < 1.0)) { error = "statistics.quantiles must be between 0 and 1"; return false; }
+    }
+    if (opts.file.empty()) { error = "statistics.file must not be empty"; return false; }
+    return true;
+}
+
+static bool parseRecorder(const std::string& sectionJson, MappingLoader::RecorderOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "enabled", v)) opts.enabled = extractBool(v);
+    if (findOptional(sectionJson, "dir", v)) opts.dir = extractString(v);
+    if (findOptional(sectionJson, "record_inputs", v)) opts.inputs = extractBool(v);
+    if (findOptional(sectionJson, "chunk_rows", v)) opts.chunk_rows = extractInt(v);
+    if (opts.chunk_rows < 1) { error = "recorder.chunk_rows must be at least 1"; return false; }
+    return true;
+}
+
+static bool parseWorker(const std::string& sectionJson, MappingLoader::WorkerOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "enabled", v)) opts.enabled = extractBool(v);
+    if (findOptional(sectionJson, "command", v)) opts.command = extractString(v);
+    if (findOptional(sectionJson, "timeout_seconds", v)) opts.timeout_seconds = extractDouble(v);
+    if (findOptional(sectionJson, "startup_seconds", v)) opts.startup_seconds = extractDouble(v);
+    if (findOptional(sectionJson, "spin_microseconds", v)) opts.spin_microseconds = extractInt(v);
+    if (findOptional(sectionJson, "keep_alive", v)) opts.keep_alive = extractBool(v);
+    if (opts.timeout_seconds < 0.0 || opts.startup_seconds <= 0.0 || opts.spin_microseconds < 0) {
+        error = "worker: timeout_seconds and spin_microseconds must be >= 0, startup_seconds > 0";
+        return false;
+    }
+    return true;
+}
+
+static bool parseEnsemble(const std::string& sectionJson, MappingLoader::EnsembleOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "members", v)) opts.members = extractInt(v);
+    if (opts.members < 1) { error = "ensemble.members must be at least 1"; return false; }
+    return true;
+}
+
+static bool parseProfile(const std::string& sectionJson, MappingLoader::ProfileOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "enabled", v)) opts.enabled = extractBool(v);
+    if (findOptional(sectionJson, "file", v)) opts.file = extractString(v);
+    if (opts.file.empty()) { error = "profile.file must not be empty"; return false; }
+    return true;
+}
+
+static bool parseTrace(const std::string& sectionJson, MappingLoader::TraceOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "enabled", v)) opts.enabled = extractBool(v);
+    if (findOptional(sectionJson, "file", v)) opts.file = extractString(v);
+    if (findOptional(sectionJson, "max_events", v)) opts.max_events = extractInt(v);
+    if (opts.file.empty()) { error = "trace.file must not be empty"; return false; }
+    if (opts.max_events < 1) { error = "trace.max_events must be at least 1"; return false; }
+    return true;
+}
+
+static bool parseFlightRecorder(const std::string& sectionJson, MappingLoader::FlightRecorderOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "enabled", v)) opts.enabled = extractBool(v);
+    if (findOptional(sectionJson, "steps", v)) opts.steps = extractInt(v);
+    if (findOptional(sectionJson, "file", v)) opts.file = extractString(v);
+    if (opts.steps < 1) { error = "flight_recorder.steps must be at least 1"; return false; }
+    if (opts.file.empty()) { error = "flight_recorder.file must not be empty"; return false; }
+    return true;
+}
+
+static bool parseTelemetry(const std::string& sectionJson, MappingLoader::TelemetryOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "enabled", v)) opts.enabled = extractBool(v);
+    if (findOptional(sectionJson, "name", v)) opts.name = extractString(v);
+    if (opts.name.empty() || opts.name.find_first_of("/\\") != std::string::npos) {
+        error = "telemetry.name must be a non-empty name without path separators";
+        return false;
+    }
+    return true;
+}
+
+static bool parseFastForward(const std::string& sectionJson, MappingLoader::FastForwardOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "enabled", v)) opts.enabled = extractBool(v);
+    if (findOptional(sectionJson, "input_threshold", v)) opts.input_threshold = extractDouble(v);
+    if (findOptional(sectionJson, "watch_inputs", v)) opts.inputs = extractStrings(v);
+    if (findOptional(sectionJson, "states", v)) {
+        std::vector<std::string> objects;
+        if (!splitObjects(v, objects, error)) return false;
+        for (const std::string& objJson : objects) {
+            MappingLoader::FastForwardState s;
+            s.output = extractString(findValue(objJson, "output", error));
+            if (!error.empty()) return false;
+            s.max = extractDouble(findValue(objJson, "max", error));
+            if (!error.empty()) return false;
+            if (s.max < 0.0) { error = "fast_forward.states max must be >= 0: " + s.output; return false; }
+            opts.states.push_back(s);
+        }
+    }
+    if (opts.input_threshold < 0.0) { error = "fast_forward.input_threshold must be >= 0"; return false; }
+    return true;
+}
+
+static bool parseCheckpoint(const std::string& sectionJson, MappingLoader::CheckpointOptions& opts, std::string& error) {
+    std::string v;
+    if (findOptional(sectionJson, "enabled", v)) opts.enabled = extractBool(v);
+    if (findOptional(sectionJson, "every_days", v)) opts.every_days = extractDouble(v);
+    if (findOptional(sectionJson, "dir", v)) opts.dir = extractString(v);
+    if (findOptional(sectionJson, "keep", v)) opts.keep = extractInt(v);
+    if (findOptional(sectionJson, "resume", v)) opts.resume = extractBool(v);
+    if (!(opts.every_days > 0.0)) { error = "checkpoint.every_days must be > 0"; return false; }
+    if (opts.keep < 1) { error = "checkpoint.keep must be at least 1"; return false; }
+    return true;
+}
+
+static bool parseSeriesInputs(const std::string& arrayJson, std::vector<MappingLoader::SeriesInputMapping>& items, std::string& error) {
+    items.clear();
+    std::vector<std::string> objects;
+    if (!splitObjects(arrayJson, objects, error)) return false;
+    for (const std::string& objJson : objects) {
+        MappingLoader::SeriesInputMapping s;
+        std::string v;
+        s.name = extractString(findValue(objJson, "name", error));
+        if (!error.empty()) return false;
+        s.object_type = extractString(findValue(objJson, "object_type", error));
+        if (!error.empty()) return false;
+        s.property = extractString(findValue(objJson, "property", error));
+        if (!error.empty()) return false;
+        s.file = extractString(findValue(objJson, "file", error));
+        if (!error.empty()) return false;
+        if (findOptional(objJson, "column", v)) s.column = extractInt(v);
+        if (findOptional(objJson, "interpolate", v)) s.interpolate = extractString(v);
+        if (findOptional(objJson, "time_unit", v)) s.time_unit = extractString(v);
+
+        if (s.file.empty()) { error = "timeseries_inputs file is empty: " + s.name; return false; }
+        if (s.column < 1) { error = "timeseries_inputs column must be at least 1: " + s.name; return false; }
+        if (s.interpolate != "HOLD" && s.interpolate != "LINEAR") {
+            error = "Unknown interpolate: " + s.interpolate + " (timeseries input " + s.name + ")";
+            return false;
+        }
+        if (s.time_unit == "SECONDS") s.seconds_per_unit = 1.0;
+        else if (s.time_unit == "MINUTES") s.seconds_per_unit = 60.0;
+        else if (s.time_unit == "HOURS") s.seconds_per_unit = 3600.0;
+        else if (s.time_unit == "DAYS") s.seconds_per_unit = 86400.0;
+        else { error = "Unknown time_unit: " + s.time_unit + " (timeseries input " + s.name + ")"; return false; }
+        if (s.object_type == "SYSTEM" || s.object_type == "CONTROLLER") {
+            error = "timeseries_inputs cannot set " + s.object_type + " inputs: " + s.name;
+            return false;
+        }
+        for (const auto& other : items) {
+            if (other.name == s.name && other.object_type == s.object_type && other.property == s.property) {
+                error = "Duplicate timeseries input: " + s.name + "/" + s.property;
+                return false;
+            }
+        }
+        items.push_back(s);
     }
     return true;
 }
@@ -107,7 +463,23 @@ MappingLoader::~MappingLoader() {}
 bool MappingLoader::LoadFromFile(const std::string& path, std::string& error) {
     inputs_.clear();
     outputs_.clear();
+    controllers_.clear();
     logging_level_ = "INFO";  // Default
+    stepping_ = SteppingOptions();
+    realization_ = RealizationOptions();
+    spinup_ = SpinupOptions();
+    memo_ = MemoOptions();
+    statistics_ = StatisticsOptions();
+    recorder_ = RecorderOptions();
+    worker_ = WorkerOptions();
+    ensemble_ = EnsembleOptions();
+    profile_ = ProfileOptions();
+    trace_ = TraceOptions();
+    flight_ = FlightRecorderOptions();
+    telemetry_ = TelemetryOptions();
+    fast_forward_ = FastForwardOptions();
+    checkpoint_ = CheckpointOptions();
+    series_inputs_.clear();
     
     std::ifstream file(path);
     if (!file.is_open()) {
@@ -143,6 +515,30 @@ bool MappingLoader::LoadFromFile(const std::string& path, std::string& error) {
     if (!error.empty()) return false;
     if (!parseArray(outputsStr, outputs_, error)) return false;
     
+    // Compile expression outputs once; references are resolved at XF_INITIALIZE
+    for (auto& out : outputs_) {
+        if (out.object_type != "EXPRESSION") continue;
+        if (out.expression.empty()) { error = "Expression output has no expression: " + out.name; return false; }
+        if (!out.program.Compile(out.expression, error)) return false;
+    }
+
+    // Decimated outputs are plain element reads; computed outputs follow their inputs
+    for (const auto& out : outputs_) {
+        if (out.update_every == 0 && out.update_every_seconds == 0.0) continue;
+        if (out.update_every < 0 || out.update_every_seconds < 0.0) {
+            error = "update_every must be >= 0: " + out.name;
+            return false;
+        }
+        if (out.update_every > 0 && out.update_every_seconds > 0.0) {
+            error = "Output has both update_every and update_every_seconds: " + out.name;
+            return false;
+        }
+        if (!out.reduce.empty() || out.object_type == "EXPRESSION" || out.object_type == "STATISTIC") {
+            error = "update_every applies only to single-element outputs: " + out.name;
+            return false;
+        }
+    }
+    
     // Parse logging_level (optional)
     std::string loggingStr = findValue(json, "logging_level", error);
     if (error.empty()) {
@@ -152,6 +548,154 @@ bool MappingLoader::LoadFromFile(const std::string& path, std::string& error) {
         error.clear();  // Clear error since it's optional
     }
     
+    // Parse controllers (optional)
+    std::string controllersStr;
+    if (findOptional(json, "controllers", controllersStr)) {
+        if (!parseControllers(controllersStr, controllers_, error)) return false;
+    }
+    
+    // Parse preloaded series inputs (optional); GoldSim and a series never
+    // set the same property
+    std::string seriesStr;
+    if (findOptional(json, "timeseries_inputs", seriesStr)) {
+        if (!parseSeriesInputs(seriesStr, series_inputs_, error)) return false;
+        for (const auto& s : series_inputs_) {
+            for (const auto& inp : inputs_) {
+                if (inp.name == s.name && inp.object_type == s.object_type && inp.property == s.property) {
+                    error = "Input " + s.name + "/" + s.property + " is also a timeseries input";
+                    return false;
+                }
+            }
+        }
+    }
+
+    // Parse stepping options (optional)
+    std::string steppingStr;
+    if (findOptional(json, "stepping", steppingStr)) {
+        if (!parseStepping(steppingStr, stepping_, error)) return false;
+    }
+    
+    // Parse realization options (optional)
+    std::string realizationStr;
+    if (findOptional(json, "realization", realizationStr)) {
+        if (!parseRealization(realizationStr, realization_, error)) return false;
+    }
+    
+    // Parse spin-up options (optional)
+    std::string spinupStr;
+    if (findOptional(json, "spinup", spinupStr)) {
+        if (!parseSpinup(spinupStr, spinup_, error)) return false;
+    }
+    
+    // Parse result memo options (optional)
+    std::string memoStr;
+    if (findOptional(json, "memo", memoStr)) {
+        if (!parseMemo(memoStr, memo_, error)) return false;
+    }
+    
+    // Parse whole-run statistics options (optional)
+    std::string statisticsStr;
+    if (findOptional(json, "statistics", statisticsStr)) {
+        if (!parseStatistics(statisticsStr, statistics_, error)) return false;
+        if (statistics_.enabled && memo_.enabled) {
+            // A realization served from the memo never runs SWMM, so it
+            // would have no row in the summary file
+            error = "statistics cannot be combined with memo";
+            return false;
+        }
+    }
+    
+    // Parse per-step recorder options (optional)
+    std::string recorderStr;
+    if (findOptional(json, "recorder", recorderStr)) {
+        if (!parseRecorder(recorderStr, recorder_, error)) return false;
+        if (recorder_.enabled && memo_.enabled) {
+            // Served calls skip the live path that appends recorder rows
+            error = "recorder cannot be combined with memo";
+            return false;
+        }
+    }
+
+    // Parse worker process options (optional)
+    std::string workerStr;
+    if (findOptional(json, "worker", workerStr)) {
+        if (!parseWorker(workerStr, worker_, error)) return false;
+    }
+
+    // Parse profiling options (optional)
+    std::string profileStr;
+    if (findOptional(json, "profile", profileStr)) {
+        if (!parseProfile(profileStr, profile_, error)) return false;
+    }
+
+    // Parse trace options (optional)
+    std::string traceStr;
+    if (findOptional(json, "trace", traceStr)) {
+        if (!parseTrace(traceStr, trace_, error)) return false;
+    }
+
+    // Parse flight recorder options (optional)
+    std::string flightStr;
+    if (findOptional(json, "flight_recorder", flightStr)) {
+        if (!parseFlightRecorder(flightStr, flight_, error)) return false;
+    }
+
+    // Parse telemetry options (optional)
+    std::string telemetryStr;
+    if (findOptional(json, "telemetry", telemetryStr)) {
+        if (!parseTelemetry(telemetryStr, telemetry_, error)) return false;
+        if (telemetry_.enabled && memo_.enabled) {
+            // Nothing would be published while calls are served
+            error = "telemetry cannot be combined with memo";
+            return false;
+        }
+    }
+
+    // Parse fast-forward options (optional)
+    std::string fastForwardStr;
+    if (findOptional(json, "fast_forward", fastForwardStr)) {
+        if (!parseFastForward(fastForwardStr, fast_forward_, error)) return false;
+        if (fast_forward_.enabled) {
+            // One routing step per call leaves nothing to skip, and
+            // controllers must see every routing step
+            if (stepping_.mode != "GOLDSIM_TIME") { error = "fast_forward requires stepping.mode GOLDSIM_TIME"; return false; }
+            if (!controllers_.empty()) { error = "fast_forward cannot be combined with controllers"; return false; }
+            for (const std::string& name : fast_forward_.inputs) {
+                bool found = false;
+                for (const auto& inp : inputs_) found = found || inp.name == name;
+                for (const auto& s : series_inputs_) found = found || s.name == name;
+                if (!found) { error = "fast_forward.watch_inputs: unknown input " + name; return false; }
+            }
+            for (const auto& s : fast_forward_.states) {
+                bool found = false;
+                for (const auto& out : outputs_) found = found || out.name == s.output;
+                if (!found) { error = "fast_forward.states: unknown output " + s.output; return false; }
+            }
+        }
+    }
+
+    // Parse checkpoint options (optional)
+    std::string checkpointStr;
+    if (findOptional(json, "checkpoint", checkpointStr)) {
+        if (!parseCheckpoint(checkpointStr, checkpoint_, error)) return false;
+        if ((checkpoint_.enabled || checkpoint_.resume) && memo_.enabled) {
+            // A resumed realization has no input stream to key the memo on
+            error = "checkpoint cannot be combined with memo";
+            return false;
+        }
+    }
+
+    // Parse ensemble options (optional)
+    std::string ensembleStr;
+    if (findOptional(json, "ensemble", ensembleStr)) {
+        if (!parseEnsemble(ensembleStr, ensemble_, error)) return false;
+        if (ensemble_.members > 1 && memo_.enabled) {
+            // Members would write the same memo files concurrently
+            error = "ensemble cannot be combined with memo";
+            return false;
+        }
+    }
+    
     return true;
 }
 
@@ -159,4 +703,20 @@ int MappingLoader::GetInputCount() const { return (int)inputs_.size(); }
 int MappingLoader::GetOutputCount() const { return (int)outputs_.size(); }
 const std::vector<MappingLoader::InputMapping>& MappingLoader::GetInputs() const { return inputs_; }
 const std::vector<MappingLoader::OutputMapping>& MappingLoader::GetOutputs() const { return outputs_; }
+const std::vector<MappingLoader::ControllerMapping>& MappingLoader::GetControllers() const { return controllers_; }
 const std::string& MappingLoader::GetLoggingLevel() const { return logging_level_; }
+const MappingLoader::SteppingOptions& MappingLoader::GetStepping() const { return stepping_; }
+const MappingLoader::RealizationOptions& MappingLoader::GetRealization() const { return realization_; }
+const MappingLoader::SpinupOptions& MappingLoader::GetSpinup() const { return spinup_; }
+const MappingLoader::MemoOptions& MappingLoader::GetMemo() const { return memo_; }
+const MappingLoader::StatisticsOptions& MappingLoader::GetStatistics() const { return statistics_; }
+const MappingLoader::RecorderOptions& MappingLoader::GetRecorder() const { return recorder_; }
+const MappingLoader::WorkerOptions& MappingLoader::GetWorker() const { return worker_; }
+const MappingLoader::EnsembleOptions& MappingLoader::GetEnsemble() const { return ensemble_; }
+const MappingLoader::ProfileOptions& MappingLoader::GetProfile() const { return profile_; }
+const MappingLoader::TraceOptions& MappingLoader::GetTrace() const { return trace_; }
+const MappingLoader::FlightRecorderOptions& MappingLoader::GetFlightRecorder() const { return flight_; }
+const MappingLoader::TelemetryOptions& MappingLoader::GetTelemetry() const { return telemetry_; }
+const MappingLoader::FastForwardOptions& MappingLoader::GetFastForward() const { return fast_forward_; }
+const MappingLoader::CheckpointOptions& MappingLoader::GetCheckpoint() const { return checkpoint_; }
+const std::vector<MappingLoader::SeriesInputMapping>& MappingLoader::GetSeriesInputs() const { return series_inputs_; }
@@ -0,0 +1,91 @@
+//-----------------------------------------------------------------------------
+//   NameIndex.cpp
+//   Open-addressing name -> index hash table
+//-----------------------------------------------------------------------------
+
+#include "include/NameIndex.h"
+#include "include/Hash.h"
+
+static inline unsigned char FoldCase(unsigned char c) {
+    return (c >= 'a' && c <= 'z') ? (unsigned char)(c - 'a' + 'A') : c;
+}
+
+NameIndex::NameIndex(bool ignore_case) : ignore_case_(ignore_case), count_(0) {}
+
+void NameIndex::Clear() {
+    slots_.clear();
+    pool_.clear();
+    count_ = 0;
+}
+
+void NameIndex::Reserve(size_t count) {
+    size_t capacity = 16;
+    while (capacity < count * 2) capacity *= 2;
+    if (capacity > slots_.size()) Rehash(capacity);
+}
+
+unsigned long long NameIndex::Hash(const char* name, size_t length) const {
+    if (!ignore_case_) return Fnv1a64(name, length);
+    unsigned long long h = FNV64_OFFSET_BASIS;
+    for (size_t i = 0; i < length; i++) {
+        h ^= FoldCase((unsigned char)name[i]);
+        h *= FNV64_PRIME;
+    }
+    return h;
+}
+
+bool NameIndex::Equal(const Slot& slot, const char* name, size_t length) const {
+    if (slot.length != length) return false;
+    const char* s = pool_.data() + slot.offset;
+    if (!ignore_case_) return pool_.compare(slot.offset, length, name, length) == 0;
+    for (size_t i = 0; i < length; i++) {
+        if (FoldCase((unsigned char)s[i]) != FoldCase((unsigned char)name[i])) return false;
+    }
+    return true;
+}
+
+size_t NameIndex::Probe(unsigned long long hash, const char* name, size_t length) const {
+    // Slot holding the name, or the empty slot where it would go
+    const size_t mask = slots_.size() - 1;
+    size_t i = (size_t)(hash ^ (hash >> 32)) & mask;
+    while (slots_[i].value >= 0) {
+        if (slots_[i].hash == hash && Equal(slots_[i], name, length)) return i;
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+void NameIndex::Rehash(size_t capacity) {
+    std::vector<Slot> old;
+    old.swap(slots_);
+    Slot empty = { 0, 0, 0, -1 };
+    slots_.assign(capacity, empty);
+    const size_t mask = capacity - 1;
+    for (const Slot& s : old) {
+        if (s.value < 0) continue;
+        size_t i = (size_t)(s.hash ^ (s.hash >> 32)) & mask;
+        while (slots_[i].value >= 0) i = (i + 1) & mask;
+        slots_[i] = s;
+    }
+}
+
+bool NameIndex::Add(const char* name, size_t length, int value) {
+    if (value < 0) return false;
+    if (slots_.empty() || (count_ + 1) * 2 > slots_.size()) Reserve(count_ + 1);
+    const unsigned long long hash = Hash(name, length);
+    size_t i = Probe(hash, name, length);
+    if (slots_[i].value >= 0) return false;
+    Slot& s = slots_[i];
+    s.hash = hash;
+    s.offset = pool_.size();
+    s.length = length;
+    s.value = value;
+    pool_.append(name, length);
+    count_++;
+    return true;
+}
+
+int NameIndex::Find(const char* name, size_t length) const {
+    if (count_ == 0) return -1;
+    return slots_[Probe(Hash(name, length), name, length)].value;
+}
@@ -0,0 +1,82 @@
+//-----------------------------------------------------------------------------
+//   OutputAggregator.cpp
+//   Reduces the routing steps inside one GoldSim time step to one value
+//   per output (instantaneous, mean, max, min or time integral)
+//-----------------------------------------------------------------------------
+
+#include "include/OutputAggregator.h"
+
+OutputAggregator::OutputAggregator() : total_dt_(0.0), steps_(0) {}
+OutputAggregator::~OutputAggregator() {}
+
+void OutputAggregator::Clear() {
+    for (int m = 0; m < MODE_COUNT; m++) slots_[m].clear();
+    acc_.clear();
+    total_dt_ = 0.0;
+    steps_ = 0;
+}
+
+void OutputAggregator::SetMode(int slot, Mode mode) {
+    for (int m = 0; m < MODE_COUNT; m++) {
+        std::vector<int>& v = slots_[m];
+        for (size_t i = 0; i < v.size(); i++) {
+            if (v[i] == slot) { v.erase(v.begin() + i); break; }
+        }
+    }
+    if (mode != INSTANT) slots_[mode].push_back(slot);
+    if ((int)acc_.size() < slot + 1) acc_.resize(slot + 1, 0.0);
+}
+
+bool OutputAggregator::NeedsSubsteps() const {
+    return !slots_[MEAN].empty() || !slots_[MAX].empty() ||
+           !slots_[MIN].empty() || !slots_[INTEGRAL].empty();
+}
+
+void OutputAggregator::Begin() {
+    total_dt_ = 0.0;
+    steps_ = 0;
+    for (int s : slots_[MEAN]) acc_[s] = 0.0;
+    for (int s : slots_[INTEGRAL]) acc_[s] = 0.0;
+    // MAX/MIN are seeded from the first sub-step
+}
+
+void OutputAggregator::Accumulate(const double* values, double dt) {
+    const bool first = (steps_ == 0);
+    for (int s : slots_[MEAN]) acc_[s] += values[s] * dt;
+    for (int s : slots_[INTEGRAL]) acc_[s] += values[s] * dt;
+    for (int s : slots_[MAX]) {
+        if (first || values[s] > acc_[s]) acc_[s] = values[s];
+    }
+    for (int s : slots_[MIN]) {
+        if (first || values[s] < acc_[s]) acc_[s] = values[s];
+    }
+    total_dt_ += dt;
+    steps_++;
+}
+
+void OutputAggregator::Finish(const double* last, double* dst) const {
+    // INSTANT slots are not listed; copy them from the last sub-step
+    const int n = (int)acc_.size();
+    for (int s = 0; s < n; s++) dst[s] = last[s];
+
+    if (steps_ == 0) {
+        // Empty interval (the first GoldSim call): nothing has flowed yet
+        for (int s : slots_[INTEGRAL]) dst[s] = 0.0;
+        return;
+    }
+    if (total_dt_ > 0.0) {
+        for (int s : slots_[MEAN]) dst[s] = acc_[s] / total_dt_;
+    }
+    for (int s : slots_[INTEGRAL]) dst[s] = acc_[s];
+    for (int s : slots_[MAX]) dst[s] = acc_[s];
+    for (int s : slots_[MIN]) dst[s] = acc_[s];
+}
+
+int AggregateNameToMode(const std::string& name) {
+    if (name.empty() || name == "INSTANT") return OutputAggregator::INSTANT;
+    if (name == "MEAN") return OutputAggregator::MEAN;
+    if (name == "MAX") return OutputAggregator::MAX;
+    if (name == "MIN") return OutputAggregator::MIN;
+    if (name == "INTEGRAL" || name == "VOLUME") return OutputAggregator::INTEGRAL;
+    return -1;
+}
@@ -0,0 +1,354 @@
+//-----------------------------------------------------------------------------
+//   OutputPlan.cpp
+//   Compiled gather plan for reading mapped SWMM outputs each time step
+//-----------------------------------------------------------------------------
+
+#include "include/OutputPlan.h"
+#include "include/swmm5.h"
+#include <algorithm>
+
+static const double kScheduleTolerance = 1e-3;     // Seconds; absorbs round-off in SWMM's elapsed time
+
+OutputPlan::OutputPlan() : output_count_(0), slot_count_(0) {}
+OutputPlan::~OutputPlan() {}
+
+void OutputPlan::Clear() {
+    pending_.clear();
+    pending_members_.clear();
+    tables_.clear();
+    member_tables_.clear();
+    reductions_.clear();
+    expressions_.clear();
+    cadences_.clear();
+    scratch_.clear();
+    output_count_ = 0;
+    slot_count_ = 0;
+}
+
+void OutputPlan::Add(Getter getter, int prop, int index, int lid, int slot, int every_steps, double every_seconds) {
+    Entry e;
+    e.getter = getter;
+    e.prop = (getter == GET_VALUE) ? prop : -1;
+    e.index = index;
+    e.lid = (getter == GET_VALUE) ? -1 : lid;
+    e.slot = slot;
+    e.cadence = -1;
+    if (every_steps <= 1 && every_seconds <= 0.0) {
+        pending_.push_back(e);
+        return;
+    }
+
+    // Outputs with the same schedule share one cadence group
+    if (every_seconds > 0.0) every_steps = 0;
+    for (size_t c = 0; c < cadences_.size(); c++) {
+        if (cadences_[c].every_steps == every_steps && cadences_[c].every_seconds == every_seconds) {
+            e.cadence = (int)c;
+            break;
+        }
+    }
+    if (e.cadence < 0) {
+        Cadence c;
+        c.every_steps = every_steps;
+        c.every_seconds = every_seconds;
+        c.next_step = 0;
+        c.next_time = 0.0;
+        cadences_.push_back(c);
+        e.cadence = (int)cadences_.size() - 1;
+    }
+    cadences_[e.cadence].pending.push_back(e);
+}
+
+int OutputPlan::AddReduction(Reduce op, double threshold, int slot) {
+    Reduction r;
+    r.op = op;
+    r.threshold = threshold;
+    r.slot = slot;
+    r.begin = 0;
+    r.count = 0;
+    reductions_.push_back(r);
+    return (int)reductions_.size() - 1;
+}
+
+void OutputPlan::AddMember(int group, Getter getter, int prop, int index, int lid) {
+    Entry e;
+    e.getter = getter;
+    e.prop = (getter == GET_VALUE) ? prop : -1;
+    e.index = index;
+    e.lid = (getter == GET_VALUE) ? -1 : lid;
+    e.slot = group;
+    e.cadence = -1;
+    pending_members_.push_back(e);
+}
+
+void OutputPlan::AddExpression(const ExpressionProgram& program, int slot) {
+    Expression e;
+    e.program = program;
+    e.slot = slot;
+    e.begin = 0;
+    expressions_.push_back(e);
+}
+
+void OutputPlan::BuildTables(std::vector<Entry>& entries, std::vector<Table>& tables) {
+    // Sort so each (getter, prop) group is contiguous and walks SWMM's
+    // element arrays in index order.
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        if (a.getter != b.getter) return a.getter < b.getter;
+        if (a.prop != b.prop) return a.prop < b.prop;
+        if (a.index != b.index) return a.index < b.index;
+        if (a.lid != b.lid) return a.lid < b.lid;
+        return a.slot < b.slot;
+    });
+
+    tables.clear();
+    for (const Entry& e : entries) {
+        if (tables.empty() || tables.back().getter != e.getter || tables.back().prop != e.prop) {
+            Table t;
+            t.getter = e.getter;
+            t.prop = e.prop;
+            tables.push_back(t);
+        }
+        Table& t = tables.back();
+        t.index.push_back(e.index);
+        t.lid.push_back(e.lid);
+        t.slot.push_back(e.slot);
+    }
+}
+
+void OutputPlan::Compile() {
+    slot_count_ = 0;
+    for (const Entry& e : pending_) {
+        if (e.slot + 1 > slot_count_) slot_count_ = e.slot + 1;
+    }
+    BuildTables(pending_, tables_);
+    output_count_ = (int)(pending_.size() + reductions_.size() + expressions_.size());
+    pending_.clear();
+
+    // Each cadence group reads into its own cache, in the same table order
+    for (Cadence& c : cadences_) {
+        c.slot.clear();
+        for (Entry& e : c.pending) {
+            if (e.slot + 1 > slot_count_) slot_count_ = e.slot + 1;
+            c.slot.push_back(e.slot);
+            e.slot = (int)c.slot.size() - 1;
+        }
+        BuildTables(c.pending, c.tables);
+        c.cache.assign(c.slot.size(), 0.0);
+        output_count_ += (int)c.slot.size();
+        c.pending.clear();
+    }
+    ResetSchedule();
+
+    // Give each group a contiguous run of scratch_ so it reduces in one
+    // pass; members still read SWMM in (getter, prop, index) order
+    for (Reduction& r : reductions_) r.count = 0;
+    for (const Entry& e : pending_members_) reductions_[e.slot].count++;
+    int next = 0;
+    std::vector<int> fill(reductions_.size());
+    for (size_t g = 0; g < reductions_.size(); g++) {
+        reductions_[g].begin = next;
+        fill[g] = next;
+        next += reductions_[g].count;
+        if (reductions_[g].slot + 1 > slot_count_) slot_count_ = reductions_[g].slot + 1;
+    }
+    for (Entry& e : pending_members_) e.slot = fill[e.slot]++;
+
+    // Expression references share the member tables; each program reads
+    // its own run of scratch_
+    for (Expression& x : expressions_) {
+        x.begin = next;
+        for (int i = 0; i < x.program.GetReferenceCount(); i++) {
+            const ExpressionProgram::Reference& ref = x.program.GetReference(i);
+            Entry e;
+            e.getter = GET_VALUE;
+            e.prop = ref.prop;
+            e.index = ref.index;
+            e.lid = -1;
+            e.slot = next++;
+            e.cadence = -1;
+            pending_members_.push_back(e);
+        }
+        if (x.slot + 1 > slot_count_) slot_count_ = x.slot + 1;
+    }
+    BuildTables(pending_members_, member_tables_);
+    scratch_.assign(next, 0.0);
+    pending_members_.clear();
+}
+
+void OutputPlan::GatherTables(const std::vector<Table>& tables, double* dst) {
+    for (const Table& t : tables) {
+        const int n = (int)t.slot.size();
+        const int* idx = t.index.data();
+        const int* lid = t.lid.data();
+        const int* slot = t.slot.data();
+
+        // One dispatch per table, then a branch-free loop over its entries
+        switch (t.getter) {
+        case GET_VALUE:
+            for (int i = 0; i < n; i++) dst[slot[i]] = swmm_getValue(t.prop, idx[i]);
+            break;
+        case GET_LID_STORAGE_VOLUME:
+            for (int i = 0; i < n; i++) dst[slot[i]] = swmm_getLidUStorageVolume(idx[i], lid[i]);
+            break;
+        case GET_LID_SURFACE_OUTFLOW:
+            for (int i = 0; i < n; i++) dst[slot[i]] = swmm_getLidUSurfaceOutflow(idx[i], lid[i]);
+            break;
+        case GET_LID_SURFACE_INFLOW:
+            for (int i = 0; i < n; i++) dst[slot[i]] = swmm_getLidUSurfaceInflow(idx[i], lid[i]);
+            break;
+        case GET_LID_DRAIN_FLOW:
+            for (int i = 0; i < n; i++) dst[slot[i]] = swmm_getLidUDrainFlow(idx[i], lid[i]);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+// Reduction kernels over a contiguous run. Four independent accumulators
+// break the loop-carried dependency so the compiler can keep them in SIMD
+// lanes without needing floating-point reassociation.
+static double SumRun(const double* v, int n) {
+    double a0 = 0.0, a1 = 0.0, a2 = 0.0, a3 = 0.0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        a0 += v[i];
+        a1 += v[i + 1];
+        a2 += v[i + 2];
+        a3 += v[i + 3];
+    }
+    for (; i < n; i++) a0 += v[i];
+    return (a0 + a1) + (a2 + a3);
+}
+
+static double MaxRun(const double* v, int n) {
+    double m0 = v[0], m1 = v[0], m2 = v[0], m3 = v[0];
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        m0 = v[i] > m0 ? v[i] : m0;
+        m1 = v[i + 1] > m1 ? v[i + 1] : m1;
+        m2 = v[i + 2] > m2 ? v[i + 2] : m2;
+        m3 = v[i + 3] > m3 ? v[i + 3] : m3;
+    }
+    for (; i < n; i++) m0 = v[i] > m0 ? v[i] : m0;
+    m0 = m1 > m0 ? m1 : m0;
+    m2 = m3 > m2 ? m3 : m2;
+    return m2 > m0 ? m2 : m0;
+}
+
+static double MinRun(const double* v, int n) {
+    double m0 = v[0], m1 = v[0], m2 = v[0], m3 = v[0];
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        m0 = v[i] < m0 ? v[i] : m0;
+        m1 = v[i + 1] < m1 ? v[i + 1] : m1;
+        m2 = v[i + 2] < m2 ? v[i + 2] : m2;
+        m3 = v[i + 3] < m3 ? v[i + 3] : m3;
+    }
+    for (; i < n; i++) m0 = v[i] < m0 ? v[i] : m0;
+    m0 = m1 < m0 ? m1 : m0;
+    m2 = m3 < m2 ? m3 : m2;
+    return m2 < m0 ? m2 : m0;
+}
+
+static double CountAboveRun(const double* v, int n, double threshold) {
+    int c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        c0 += v[i] > threshold;
+        c1 += v[i + 1] > threshold;
+        c2 += v[i + 2] > threshold;
+        c3 += v[i + 3] > threshold;
+    }
+    for (; i < n; i++) c0 += v[i] > threshold;
+    return (double)(c0 + c1 + c2 + c3);
+}
+
+void OutputPlan::CopyCache(const Cadence& c, double* dst) {
+    const int n = (int)c.slot.size();
+    const int* slot = c.slot.data();
+    const double* v = c.cache.data();
+    for (int i = 0; i < n; i++) dst[slot[i]] = v[i];
+}
+
+void OutputPlan::Gather(double* dst) const {
+    GatherTables(tables_, dst);
+    for (const Cadence& c : cadences_) {
+        GatherTables(c.tables, c.cache.data());
+        CopyCache(c, dst);
+    }
+    GatherComputed(dst);
+}
+
+void OutputPlan::Gather(double* dst, long step, double elapsed_sec) {
+    GatherTables(tables_, dst);
+    for (Cadence& c : cadences_) {
+        bool due = c.every_seconds > 0.0 ? elapsed_sec >= c.next_time - kScheduleTolerance
+                                         : step >= c.next_step;
+        if (due) {
+            GatherTables(c.tables, c.cache.data());
+            if (c.every_seconds > 0.0) {
+                // Stay on the schedule's grid even if a routing step overshoots it
+                while (c.next_time <= elapsed_sec + kScheduleTolerance) c.next_time += c.every_seconds;
+            } else {
+                c.next_step = step + c.every_steps;
+            }
+        }
+        CopyCache(c, dst);
+    }
+    GatherComputed(dst);
+}
+
+void OutputPlan::ResetSchedule() {
+    for (Cadence& c : cadences_) {
+        c.next_step = c.every_steps;
+        c.next_time = c.every_seconds;
+    }
+}
+
+void OutputPlan::GatherComputed(double* dst) const {
+    GatherTables(member_tables_, scratch_.data());
+    for (const Reduction& r : reductions_) {
+        const double* v = scratch_.data() + r.begin;
+        const int n = r.count;
+        double result = 0.0;    // Empty groups reduce to 0
+        if (n > 0) {
+            switch (r.op) {
+            case REDUCE_SUM:        result = SumRun(v, n); break;
+            case REDUCE_MEAN:       result = SumRun(v, n) / n; break;
+            case REDUCE_MAX:        result = MaxRun(v, n); break;
+            case REDUCE_MIN:        result = MinRun(v, n); break;
+            case REDUCE_COUNT_ABOVE: result = CountAboveRun(v, n, r.threshold); break;
+            default: break;
+            }
+        }
+        dst[r.slot] = result;
+    }
+    for (const Expression& x : expressions_) dst[x.slot] = x.program.Evaluate(scratch_.data() + x.begin);
+}
+
+int OutputPlan::GetOutputCount() const { return output_count_; }
+int OutputPlan::GetMemberCount() const { return (int)scratch_.size(); }
+int OutputPlan::GetTableCount() const {
+    size_t n = tables_.size() + member_tables_.size();
+    for (const Cadence& c : cadences_) n += c.tables.size();
+    return (int)n;
+}
+int OutputPlan::GetSlotCount() const { return slot_count_; }
+int OutputPlan::GetCadenceCount() const { return (int)cadences_.size(); }
+
+int LidPropertyToGetter(const std::string& property) {
+    if (property == "STORAGE_VOLUME") return OutputPlan::GET_LID_STORAGE_VOLUME;
+    if (property == "SURFACE_OUTFLOW") return OutputPlan::GET_LID_SURFACE_OUTFLOW;
+    if (property == "SURFACE_INFLOW") return OutputPlan::GET_LID_SURFACE_INFLOW;
+    if (property == "DRAIN_FLOW") return OutputPlan::GET_LID_DRAIN_FLOW;
+    return -1;
+}
+
+int ReduceNameToOp(const std::string& name) {
+    if (name == "SUM") return OutputPlan::REDUCE_SUM;
+    if (name == "MEAN") return OutputPlan::REDUCE_MEAN;
+    if (name == "MAX") return OutputPlan::REDUCE_MAX;
+    if (name == "MIN") return OutputPlan::REDUCE_MIN;
+    if (name == "COUNT_ABOVE") return OutputPlan::REDUCE_COUNT_ABOVE;
+    return -1;
+}
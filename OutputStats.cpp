@@ -0,0 +1,297 @@
+//-----------------------------------------------------------------------------
+//   OutputStats.cpp
+//   Whole-run statistics per output in constant memory
+//-----------------------------------------------------------------------------
+
+#include "include/OutputStats.h"
+#include "include/Platform.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
+OutputStats::OutputStats() : samples_(0) {}
+OutputStats::~OutputStats() {}
+
+void OutputStats::Clear() {
+    series_.clear();
+    probs_.clear();
+    psq_.clear();
+    outputs_.clear();
+    samples_ = 0;
+}
+
+int OutputStats::Track(int slot, double threshold) {
+    Series s;
+    s.slot = slot;
+    s.threshold = threshold;
+    series_.push_back(s);
+    Reset();
+    return (int)series_.size() - 1;
+}
+
+int OutputStats::AddQuantile(double p) {
+    for (size_t i = 0; i < probs_.size(); i++) {
+        if (probs_[i] == p) return (int)i;
+    }
+    probs_.push_back(p);
+    Reset();
+    return (int)probs_.size() - 1;
+}
+
+void OutputStats::AddOutput(int slot, int tracked, Stat stat, int quantile) {
+    Output o;
+    o.slot = slot;
+    o.tracked = tracked;
+    o.stat = stat;
+    o.quantile = quantile;
+    outputs_.push_back(o);
+}
+
+void OutputStats::Reset() {
+    for (Series& s : series_) {
+        s.weight = 0.0;
+        s.mean = 0.0;
+        s.m2 = 0.0;
+        s.min = 0.0;
+        s.max = 0.0;
+        s.t_min = 0.0;
+        s.t_max = 0.0;
+        s.exceed_sec = 0.0;
+        s.events = 0.0;
+        s.above = false;
+    }
+    psq_.resize(series_.size() * probs_.size());
+    for (Psq& e : psq_) PsqInit(e);
+    samples_ = 0;
+}
+
+void OutputStats::Update(const double* values, double elapsed_days, double dt) {
+    const bool first = (samples_ == 0);
+    const int nq = (int)probs_.size();
+    for (size_t i = 0; i < series_.size(); i++) {
+        Series& s = series_[i];
+        const double x = values[s.slot];
+
+        if (first || x < s.min) { s.min = x; s.t_min = elapsed_days; }
+        if (first || x > s.max) { s.max = x; s.t_max = elapsed_days; }
+
+        // Weighted Welford update: each step is weighted by its length
+        double w = s.weight + dt;
+        if (w > 0.0) {
+            double delta = x - s.mean;
+            s.mean += delta * dt / w;
+            s.m2 += dt * delta * (x - s.mean);
+            s.weight = w;
+        }
+
+        // NaN thresholds never compare true
+        bool above = x > s.threshold;
+        if (above) {
+            s.exceed_sec += dt;
+            if (!s.above) s.events += 1.0;
+        }
+        s.above = above;
+
+        Psq* e = psq_.data() + i * nq;
+        for (int q = 0; q < nq; q++) PsqAdd(e[q], probs_[q], x);
+    }
+    samples_++;
+}
+
+void OutputStats::Fill(double* dst) const {
+    for (const Output& o : outputs_) dst[o.slot] = Get(o.tracked, o.stat, o.quantile);
+}
+
+double OutputStats::Get(int tracked, Stat stat, int quantile) const {
+    const Series& s = series_[tracked];
+    if (samples_ == 0) return 0.0;
+    switch (stat) {
+    case STAT_MEAN:         return s.mean;
+    case STAT_STDDEV:       return s.weight > 0.0 ? std::sqrt((std::max)(0.0, s.m2 / s.weight)) : 0.0;
+    case STAT_MIN:          return s.min;
+    case STAT_MAX:          return s.max;
+    case STAT_TIME_OF_MIN:  return s.t_min;
+    case STAT_TIME_OF_MAX:  return s.t_max;
+    case STAT_EXCEED_HOURS: return s.exceed_sec / 3600.0;
+    case STAT_EXCEED_EVENTS: return s.events;
+    case STAT_QUANTILE:
+        return PsqValue(psq_[tracked * probs_.size() + quantile], probs_[quantile]);
+    default:
+        return 0.0;
+    }
+}
+
+bool OutputStats::WriteSummary(const std::string& path, const std::vector<std::string>& names,
+                               int realization, bool append) const {
+    FILE* f = NULL;
+    if (fopen_s(&f, path.c_str(), append ? "a" : "w") != 0 || !f) return false;
+
+    if (!append) {
+        fprintf(f, "realization,output,steps,mean,stddev,min,time_of_min,max,time_of_max,exceed_hours,exceed_events");
+        for (double p : probs_) fprintf(f, ",p%g", p * 100.0);
+        fprintf(f, "\n");
+    }
+    for (size_t i = 0; i < series_.size(); i++) {
+        int t = (int)i;
+        fprintf(f, "%d,%s,%ld,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g,%.9g", realization,
+            i < names.size() ? names[i].c_str() : "", samples_,
+            Get(t, STAT_MEAN, 0), Get(t, STAT_STDDEV, 0),
+            Get(t, STAT_MIN, 0), Get(t, STAT_TIME_OF_MIN, 0),
+            Get(t, STAT_MAX, 0), Get(t, STAT_TIME_OF_MAX, 0),
+            Get(t, STAT_EXCEED_HOURS, 0), Get(t, STAT_EXCEED_EVENTS, 0));
+        for (size_t q = 0; q < probs_.size(); q++) fprintf(f, ",%.9g", Get(t, STAT_QUANTILE, (int)q));
+        fprintf(f, "\n");
+    }
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+// Layout: samples, tracked count, quantile count, then per tracked slot its
+// ten accumulators and per estimator its markers and count
+static const size_t kSeriesValues = 10;
+static const size_t kPsqValues = 16;
+
+void OutputStats::SaveState(std::vector<double>& out) const {
+    out.push_back((double)samples_);
+    out.push_back((double)series_.size());
+    out.push_back((double)probs_.size());
+    for (const Series& s : series_) {
+        const double v[kSeriesValues] = { s.weight, s.mean, s.m2, s.min, s.max, s.t_min, s.t_max,
+                                          s.exceed_sec, s.events, s.above ? 1.0 : 0.0 };
+        out.insert(out.end(), v, v + kSeriesValues);
+    }
+    for (const Psq& e : psq_) {
+        out.insert(out.end(), e.q, e.q + 5);
+        out.insert(out.end(), e.n, e.n + 5);
+        out.insert(out.end(), e.np, e.np + 5);
+        out.push_back((double)e.count);
+    }
+}
+
+bool OutputStats::RestoreState(const std::vector<double>& data, size_t& pos) {
+    if (data.size() < pos + 3 || data[pos + 1] != (double)series_.size() || data[pos + 2] != (double)probs_.size()) {
+        return false;
+    }
+    if (data.size() - pos - 3 < series_.size() * kSeriesValues + psq_.size() * kPsqValues) return false;
+    const double* v = data.data() + pos;
+    samples_ = (long)v[0];
+    v += 3;
+    for (Series& s : series_) {
+        s.weight = v[0];
+        s.mean = v[1];
+        s.m2 = v[2];
+        s.min = v[3];
+        s.max = v[4];
+        s.t_min = v[5];
+        s.t_max = v[6];
+        s.exceed_sec = v[7];
+        s.events = v[8];
+        s.above = v[9] != 0.0;
+        v += kSeriesValues;
+    }
+    for (Psq& e : psq_) {
+        std::copy(v, v + 5, e.q);
+        std::copy(v + 5, v + 10, e.n);
+        std::copy(v + 10, v + 15, e.np);
+        e.count = (int)v[15];
+        v += kPsqValues;
+    }
+    pos = v - data.data();
+    return true;
+}
+
+bool OutputStats::IsEmpty() const { return series_.empty(); }
+int OutputStats::GetTrackedCount() const { return (int)series_.size(); }
+int OutputStats::GetQuantileCount() const { return (int)probs_.size(); }
+long OutputStats::GetSampleCount() const { return samples_; }
+
+//-----------------------------------------------------------------------------
+//   P-square quantile estimator
+//-----------------------------------------------------------------------------
+
+void OutputStats::PsqInit(Psq& e) {
+    for (int i = 0; i < 5; i++) { e.q[i] = 0.0; e.n[i] = i + 1.0; e.np[i] = 0.0; }
+    e.count = 0;
+}
+
+void OutputStats::PsqAdd(Psq& e, double p, double x) {
+    // The first five observations are kept exactly
+    if (e.count < 5) {
+        e.q[e.count++] = x;
+        if (e.count == 5) {
+            std::sort(e.q, e.q + 5);
+            e.np[0] = 1.0;
+            e.np[1] = 1.0 + 2.0 * p;
+            e.np[2] = 1.0 + 4.0 * p;
+            e.np[3] = 3.0 + 2.0 * p;
+            e.np[4] = 5.0;
+        }
+        return;
+    }
+
+    int k;
+    if (x < e.q[0]) { e.q[0] = x; k = 0; }
+    else if (x >= e.q[4]) { e.q[4] = x; k = 3; }
+    else { k = 0; while (x >= e.q[k + 1]) k++; }
+
+    for (int i = k + 1; i < 5; i++) e.n[i] += 1.0;
+    e.np[1] += p / 2.0;
+    e.np[2] += p;
+    e.np[3] += (1.0 + p) / 2.0;
+    e.np[4] += 1.0;
+
+    // Move the middle markers toward their desired positions
+    for (int i = 1; i <= 3; i++) {
+        double d = e.np[i] - e.n[i];
+        if ((d >= 1.0 && e.n[i + 1] - e.n[i] > 1.0) || (d <= -1.0 && e.n[i - 1] - e.n[i] < -1.0)) {
+            double s = d >= 0.0 ? 1.0 : -1.0;
+            double qp = e.q[i] + s / (e.n[i + 1] - e.n[i - 1]) *
+                ((e.n[i] - e.n[i - 1] + s) * (e.q[i + 1] - e.q[i]) / (e.n[i + 1] - e.n[i]) +
+                 (e.n[i + 1] - e.n[i] - s) * (e.q[i] - e.q[i - 1]) / (e.n[i] - e.n[i - 1]));
+            if (!(e.q[i - 1] < qp && qp < e.q[i + 1])) {
+                // Parabolic step would break marker order: use linear
+                int j = i + (int)s;
+                qp = e.q[i] + s * (e.q[j] - e.q[i]) / (e.n[j] - e.n[i]);
+            }
+            e.q[i] = qp;
+            e.n[i] += s;
+        }
+    }
+    e.count++;
+}
+
+double OutputStats::PsqValue(const Psq& e, double p) {
+    if (e.count >= 5) return e.q[2];
+    if (e.count == 0) return 0.0;
+    // Fewer than five observations: interpolate the exact sample quantile
+    double v[5];
+    std::copy(e.q, e.q + e.count, v);
+    std::sort(v, v + e.count);
+    double r = p * (e.count - 1);
+    int lo = (int)r;
+    int hi = lo + 1 < e.count ? lo + 1 : lo;
+    return v[lo] + (v[hi] - v[lo]) * (r - lo);
+}
+
+int StatNameToStat(const std::string& name, double* p) {
+    if (name == "MEAN") return OutputStats::STAT_MEAN;
+    if (name == "STDDEV") return OutputStats::STAT_STDDEV;
+    if (name == "MIN") return OutputStats::STAT_MIN;
+    if (name == "MAX") return OutputStats::STAT_MAX;
+    if (name == "TIME_OF_MIN") return OutputStats::STAT_TIME_OF_MIN;
+    if (name == "TIME_OF_MAX") return OutputStats::STAT_TIME_OF_MAX;
+    if (name == "EXCEED_HOURS") return OutputStats::STAT_EXCEED_HOURS;
+    if (name == "EXCEED_EVENTS") return OutputStats::STAT_EXCEED_EVENTS;
+    if (name.size() >= 2 && name[0] == 'P') {
+        char* end = NULL;
+        double pct = std::strtod(name.c_str() + 1, &end);
+        if (*end == '\0' && pct > 0.0 && pct < 100.0) {
+            if (p) *p = pct / 100.0;
+            return OutputStats::STAT_QUANTILE;
+        }
+    }
+    return -1;
+}
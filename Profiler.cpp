@@ -0,0 +1,168 @@
+//-----------------------------------------------------------------------------
+//   Profiler.cpp
+//   Per-phase timing histograms and sampled resident memory
+//-----------------------------------------------------------------------------
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+#include "include/Profiler.h"
+#include "include/Platform.h"
+#include "include/Tracer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+static const char* kPhaseNames[Profiler::PHASE_COUNT] = {
+    "initialize", "open", "resolve", "calculate", "apply", "step", "gather", "cleanup", "log"
+};
+
+Profiler::Profiler() : enabled_(false), active_(false), tracer_(NULL) {
+    Reset();
+}
+
+Profiler::~Profiler() {}
+
+void Profiler::Reset() {
+    memset(phases_, 0, sizeof(phases_));
+}
+
+const char* Profiler::PhaseName(Phase phase) {
+    return (phase >= 0 && phase < PHASE_COUNT) ? kPhaseNames[phase] : "";
+}
+
+long long Profiler::Now() {
+    return (long long)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int Profiler::BucketOf(long long ns) {
+    if (ns < kSubBuckets) return ns < 0 ? 0 : (int)ns;
+    // Exact below 16 ns; above, 16 linear sub-buckets per power of two
+    int e = 4;
+    while ((ns >> (e + 1)) != 0) e++;
+    int sub = (int)(ns >> (e - 4)) - kSubBuckets;
+    return (e - 3) * kSubBuckets + sub;
+}
+
+long long Profiler::BucketMid(int bucket) {
+    if (bucket < kSubBuckets) return bucket;
+    int e = bucket / kSubBuckets + 3;
+    long long low = (long long)(kSubBuckets + bucket % kSubBuckets) << (e - 4);
+    return low + ((1LL << (e - 4)) >> 1);
+}
+
+void Profiler::Finish(Phase phase, long long begin) {
+    long long ns = Now() - begin;
+    if (enabled_) Record(phase, ns);
+    if (tracer_) tracer_->Add(kPhaseNames[phase], begin, ns);
+}
+
+void Profiler::Record(Phase phase, long long ns) {
+    PhaseData& p = phases_[phase];
+    if (p.count == 0 || ns < p.min_ns) p.min_ns = ns;
+    if (ns > p.max_ns) p.max_ns = ns;
+    p.total_ns += ns;
+    p.buckets[BucketOf(ns)]++;
+    if (p.count % kRssEvery == 0) {
+        long long rss = CurrentRss();
+        if (rss > p.rss_sampled) p.rss_sampled = rss;
+    }
+    p.count++;
+}
+
+long long Profiler::GetCount(Phase phase) const { return phases_[phase].count; }
+long long Profiler::GetTotalNs(Phase phase) const { return phases_[phase].total_ns; }
+long long Profiler::GetMaxNs(Phase phase) const { return phases_[phase].max_ns; }
+long long Profiler::GetRssSampled(Phase phase) const { return phases_[phase].rss_sampled; }
+
+long long Profiler::GetPercentileNs(Phase phase, double q) const {
+    const PhaseData& p = phases_[phase];
+    if (p.count == 0) return 0;
+    long long rank = (long long)(q * (double)p.count + 0.999999);
+    if (rank < 1) rank = 1;
+    if (rank >= p.count) return p.max_ns;
+    long long seen = 0;
+    for (int b = 0; b < kBuckets; b++) {
+        seen += p.buckets[b];
+        if (seen >= rank) {
+            // Never report beyond what was actually measured
+            long long mid = BucketMid(b);
+            if (mid > p.max_ns) mid = p.max_ns;
+            if (mid < p.min_ns) mid = p.min_ns;
+            return mid;
+        }
+    }
+    return p.max_ns;
+}
+
+bool Profiler::WriteReport(const std::string& path, int realizations) const {
+    FILE* f = NULL;
+    if (fopen_s(&f, path.c_str(), "w") != 0 || !f) return false;
+
+    fprintf(f, "{\n  \"realizations\": %d,\n  \"rss_bytes\": %lld,\n  \"rss_peak_bytes\": %lld,\n  \"phases\": [",
+            realizations, CurrentRss(), PeakRss());
+    bool first = true;
+    for (int i = 0; i < PHASE_COUNT; i++) {
+        const PhaseData& p = phases_[i];
+        if (p.count == 0) continue;
+        Phase ph = (Phase)i;
+        fprintf(f, "%s\n    {\"phase\": \"%s\", \"count\": %lld, \"total_ms\": %.3f, \"mean_us\": %.3f, "
+                   "\"min_us\": %.3f, \"p50_us\": %.3f, \"p90_us\": %.3f, \"p99_us\": %.3f, \"p999_us\": %.3f, "
+                   "\"max_us\": %.3f, \"rss_sampled_bytes\": %lld}",
+            first ? "" : ",", kPhaseNames[i], p.count, p.total_ns / 1e6, p.total_ns / 1e3 / (double)p.count,
+            p.min_ns / 1e3, GetPercentileNs(ph, 0.5) / 1e3, GetPercentileNs(ph, 0.9) / 1e3,
+            GetPercentileNs(ph, 0.99) / 1e3, GetPercentileNs(ph, 0.999) / 1e3, p.max_ns / 1e3, p.rss_sampled);
+        first = false;
+    }
+    fprintf(f, "\n  ]\n}\n");
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+#ifdef _WIN32
+
+long long Profiler::CurrentRss() {
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+    return (long long)pmc.WorkingSetSize;
+}
+
+long long Profiler::PeakRss() {
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return 0;
+    return (long long)pmc.PeakWorkingSetSize;
+}
+
+#else
+
+long long Profiler::CurrentRss() {
+    FILE* f = fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    long long pages_total = 0, pages_rss = 0;
+    int n = fscanf(f, "%lld %lld", &pages_total, &pages_rss);
+    fclose(f);
+    return n == 2 ? pages_rss * (long long)sysconf(_SC_PAGESIZE) : 0;
+}
+
+long long Profiler::PeakRss() {
+    FILE* f = fopen("/proc/self/status", "r");
+    if (!f) return 0;
+    char line[256];
+    long long kb = 0;
+    while (fgets(line, sizeof(line), f)) {
+        if (strncmp(line, "VmHWM:", 6) == 0) {
+            kb = atoll(line + 6);
+            break;
+        }
+    }
+    fclose(f);
+    return kb * 1024;
+}
+
+#endif
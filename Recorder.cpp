@@ -0,0 +1,277 @@
+//-----------------------------------------------------------------------------
+//   Recorder.cpp
+//   Columnar binary recording of the values GoldSim exchanges each step
+//-----------------------------------------------------------------------------
+
+#include "include/Recorder.h"
+#include "include/Platform.h"
+#include <cstring>
+#include <limits>
+
+using namespace RecordingFormat;
+
+static const char kMagic[8] = { 'G', 'S', 'R', 'E', 'C', '0', '0', '1' };
+static const size_t kChunkHeaderDoubles = sizeof(ChunkHeader) / sizeof(double);
+static const size_t kMaxQueuedChunks = 4;      // Append() waits beyond this
+
+//-----------------------------------------------------------------------------
+//   Recorder
+//-----------------------------------------------------------------------------
+
+Recorder::Recorder()
+    : file_(NULL), chunk_rows_(0), chunk_doubles_(0), current_(NULL), rows_(0), total_rows_(0),
+      thread_(NULL), buffers_(0), stop_(false), failed_(false) {}
+
+Recorder::~Recorder() {
+    Close();
+}
+
+bool Recorder::Open(const std::string& path, const std::vector<Column>& columns, int chunk_rows, std::string& error) {
+    Close();
+    if (chunk_rows < 1) chunk_rows = 1;
+    if (fopen_s(&file_, path.c_str(), "wb") != 0 || !file_) {
+        file_ = NULL;
+        error = "Cannot create recording: " + path;
+        return false;
+    }
+
+    FileHeader h;
+    memcpy(h.magic, kMagic, sizeof(h.magic));
+    h.columns = (unsigned int)columns.size();
+    h.chunk_rows = (unsigned int)chunk_rows;
+    h.header_bytes = sizeof(FileHeader) + columns.size() * sizeof(ColumnDesc);
+    bool ok = fwrite(&h, sizeof(h), 1, file_) == 1;
+    for (const Column& c : columns) {
+        ColumnDesc d;
+        memset(&d, 0, sizeof(d));
+        d.kind = c.kind;
+        d.index = c.index;
+        strncpy_s(d.name, c.name.c_str(), _TRUNCATE);
+        ok = ok && fwrite(&d, sizeof(d), 1, file_) == 1;
+    }
+    if (!ok) {
+        fclose(file_);
+        file_ = NULL;
+        error = "Cannot write recording header: " + path;
+        return false;
+    }
+
+    columns_ = columns;
+    chunk_rows_ = chunk_rows;
+    chunk_doubles_ = kChunkHeaderDoubles + (size_t)chunk_rows * (columns.size() + 1);
+    rows_ = 0;
+    total_rows_ = 0;
+    stop_ = false;
+    failed_ = false;
+    current_ = TakeBuffer();
+    thread_ = new std::thread(&Recorder::Run, this);
+    return true;
+}
+
+std::vector<double>* Recorder::TakeBuffer() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_.empty()) {
+        std::vector<double>* b = free_.back();
+        free_.pop_back();
+        return b;
+    }
+    buffers_++;
+    return new std::vector<double>(chunk_doubles_, 0.0);
+}
+
+void Recorder::Append(double elapsed_days, const double* outputs, const double* inputs) {
+    if (!file_) return;
+    double* col = current_->data() + kChunkHeaderDoubles + rows_;
+    col[0] = elapsed_days;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (size_t c = 0; c < columns_.size(); c++) {
+        const Column& d = columns_[c];
+        double v;
+        if (d.kind == COLUMN_OUTPUT) v = outputs[d.index];
+        else v = inputs ? inputs[d.index] : nan;
+        col[(c + 1) * chunk_rows_] = v;
+    }
+    rows_++;
+    total_rows_++;
+    if (rows_ == chunk_rows_) Submit();
+}
+
+void Recorder::Submit() {
+    ChunkHeader ch;
+    ch.magic = CHUNK_MAGIC;
+    ch.rows = (unsigned int)rows_;
+    ch.first_row = (unsigned long long)(total_rows_ - rows_);
+    memcpy(current_->data(), &ch, sizeof(ch));
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return full_.size() < kMaxQueuedChunks; });
+        full_.push_back(current_);
+    }
+    cv_.notify_all();
+    current_ = TakeBuffer();
+    rows_ = 0;
+}
+
+void Recorder::Run() {
+    for (;;) {
+        std::vector<double>* b;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return !full_.empty() || stop_; });
+            if (full_.empty()) return;
+            b = full_.front();
+        }
+        bool ok = fwrite(b->data(), sizeof(double), b->size(), file_) == b->size();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            full_.pop_front();
+            free_.push_back(b);
+            if (!ok) failed_ = true;
+        }
+        cv_.notify_all();
+    }
+}
+
+bool Recorder::Close() {
+    if (!file_) return true;
+    if (rows_ > 0) {
+        // Pad the unused rows so stale values from a reused buffer are not written
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        double* data = current_->data() + kChunkHeaderDoubles;
+        for (size_t c = 0; c <= columns_.size(); c++) {
+            for (int r = rows_; r < chunk_rows_; r++) data[c * chunk_rows_ + r] = nan;
+        }
+        Submit();
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_->join();
+    delete thread_;
+    thread_ = NULL;
+
+    bool ok = !failed_;
+    if (fclose(file_) != 0) ok = false;
+    file_ = NULL;
+    delete current_;
+    current_ = NULL;
+    for (std::vector<double>* b : free_) delete b;
+    free_.clear();
+    buffers_ = 0;
+    return ok;
+}
+
+bool Recorder::IsOpen() const { return file_ != NULL; }
+long long Recorder::GetRowCount() const { return total_rows_; }
+
+//-----------------------------------------------------------------------------
+//   RecordingReader
+//-----------------------------------------------------------------------------
+
+RecordingReader::RecordingReader()
+    : file_(NULL), chunk_rows_(0), header_bytes_(0), chunk_bytes_(0), rows_(0) {}
+
+RecordingReader::~RecordingReader() {
+    Close();
+}
+
+void RecordingReader::Close() {
+    if (file_) fclose(file_);
+    file_ = NULL;
+    names_.clear();
+    kinds_.clear();
+    indices_.clear();
+    rows_ = 0;
+}
+
+bool RecordingReader::Open(const std::string& path, std::string& error) {
+    Close();
+    if (fopen_s(&file_, path.c_str(), "rb") != 0 || !file_) {
+        file_ = NULL;
+        error = "Cannot open recording: " + path;
+        return false;
+    }
+    FileHeader h;
+    if (fread(&h, sizeof(h), 1, file_) != 1 || memcmp(h.magic, kMagic, sizeof(h.magic)) != 0 || h.chunk_rows == 0) {
+        Close();
+        error = "Not a bridge recording: " + path;
+        return false;
+    }
+    for (unsigned int c = 0; c < h.columns; c++) {
+        ColumnDesc d;
+        if (fread(&d, sizeof(d), 1, file_) != 1) {
+            Close();
+            error = "Truncated recording header: " + path;
+            return false;
+        }
+        d.name[sizeof(d.name) - 1] = '\0';
+        names_.push_back(d.name);
+        kinds_.push_back(d.kind);
+        indices_.push_back(d.index);
+    }
+    chunk_rows_ = h.chunk_rows;
+    header_bytes_ = h.header_bytes;
+    chunk_bytes_ = sizeof(ChunkHeader) + (unsigned long long)chunk_rows_ * (h.columns + 1) * sizeof(double);
+
+    // Only whole chunks count; the last one says how many of its rows are used
+    if (_fseeki64(file_, 0, SEEK_END) != 0) { Close(); error = "Cannot size recording: " + path; return false; }
+    long long size = _ftelli64(file_);
+    long long chunks = size > (long long)header_bytes_ ? (size - (long long)header_bytes_) / (long long)chunk_bytes_ : 0;
+    rows_ = 0;
+    while (chunks > 0) {
+        ChunkHeader ch;
+        if (_fseeki64(file_, (long long)(header_bytes_ + (chunks - 1) * chunk_bytes_), SEEK_SET) == 0 &&
+            fread(&ch, sizeof(ch), 1, file_) == 1 && ch.magic == CHUNK_MAGIC && ch.rows <= chunk_rows_) {
+            rows_ = (chunks - 1) * (long long)chunk_rows_ + ch.rows;
+            break;
+        }
+        chunks--;
+    }
+    return true;
+}
+
+int RecordingReader::GetColumnCount() const { return (int)names_.size(); }
+const std::string& RecordingReader::GetColumnName(int col) const { return names_[col]; }
+int RecordingReader::GetColumnKind(int col) const { return kinds_[col]; }
+int RecordingReader::GetColumnIndex(int col) const { return indices_[col]; }
+long long RecordingReader::GetRowCount() const { return rows_; }
+
+int RecordingReader::FindColumn(const std::string& name, int kind) const {
+    for (size_t c = 0; c < names_.size(); c++) {
+        if (names_[c] == name && (kind < 0 || kinds_[c] == kind)) return (int)c;
+    }
+    return -1;
+}
+
+bool RecordingReader::ReadColumn(int col, long long first_row, long long rows, double* out) const {
+    if (!file_ || col < -1 || col >= (int)names_.size() || first_row < 0 || rows < 0 || first_row + rows > rows_) {
+        return false;
+    }
+    long long row = first_row;
+    long long end = first_row + rows;
+    while (row < end) {
+        long long chunk = row / chunk_rows_;
+        long long offset = row % chunk_rows_;
+        long long run = chunk_rows_ - offset;
+        if (run > end - row) run = end - row;
+
+        unsigned long long pos = header_bytes_ + chunk * chunk_bytes_ + sizeof(ChunkHeader) +
+                                 ((unsigned long long)(col + 1) * chunk_rows_ + offset) * sizeof(double);
+        if (_fseeki64(file_, (long long)pos, SEEK_SET) != 0) return false;
+        if (fread(out, sizeof(double), (size_t)run, file_) != (size_t)run) return false;
+        out += run;
+        row += run;
+    }
+    return true;
+}
+
+bool RecordingReader::ReadColumn(int col, std::vector<double>& out) const {
+    out.resize((size_t)rows_);
+    return ReadColumn(col, 0, rows_, out.data());
+}
+
+bool RecordingReader::ReadTimes(std::vector<double>& out) const {
+    return ReadColumn(-1, out);
+}
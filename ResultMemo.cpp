@@ -0,0 +1,156 @@
+//-----------------------------------------------------------------------------
+//   ResultMemo.cpp
+//   On-disk store of per-call outputs keyed by a hash chain over the
+//   model, the mapping and every input vector GoldSim has passed so far
+//-----------------------------------------------------------------------------
+
+#include "include/Platform.h"
+#include "include/ResultMemo.h"
+#include <cstring>
+
+static const char kMagic[8] = { 'G', 'S', 'M', 'E', 'M', 'O', '0', '1' };
+static const int kFlagEnded = 1;
+
+struct MemoHeader {
+    char magic[8];
+    int output_count;
+    int record_bytes;
+};
+
+ResultMemo::ResultMemo() : file_(NULL), base_(0), output_count_(0), end_offset_(0) {}
+ResultMemo::~ResultMemo() { Close(); }
+
+size_t ResultMemo::RecordBytes() const {
+    return sizeof(Record) + (size_t)output_count_ * sizeof(double);
+}
+
+bool ResultMemo::IsOpen() const { return file_ != NULL; }
+unsigned long long ResultMemo::GetBase() const { return base_; }
+size_t ResultMemo::GetRecordCount() const { return index_.size(); }
+
+void ResultMemo::Close() {
+    if (file_) fclose(file_);
+    file_ = NULL;
+    index_.clear();
+    queue_.clear();
+    end_offset_ = 0;
+}
+
+bool ResultMemo::Open(const std::string& dir, unsigned long long base, int output_count, std::string& error) {
+    if (file_ && base == base_ && output_count == output_count_) return true;
+    Close();
+    base_ = base;
+    output_count_ = output_count;
+
+    std::string path;
+    if (!dir.empty()) {
+        MakeDirectory(dir);
+        path = dir;
+        if (path[path.size() - 1] != '\\' && path[path.size() - 1] != '/') path += PATH_SEP;
+    }
+    char name[32];
+    sprintf_s(name, "%016llx.memo", base);
+    path += name;
+
+    MemoHeader h;
+    memset(&h, 0, sizeof(h));
+    if (fopen_s(&file_, path.c_str(), "r+b") != 0 || !file_) {
+        // New store
+        file_ = NULL;
+        if (fopen_s(&file_, path.c_str(), "w+b") != 0 || !file_) {
+            file_ = NULL;
+            error = "Cannot create result memo " + path;
+            return false;
+        }
+        memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.output_count = output_count_;
+        h.record_bytes = (int)RecordBytes();
+        fwrite(&h, sizeof(h), 1, file_);
+        fflush(file_);
+        end_offset_ = sizeof(h);
+        return true;
+    }
+
+    if (fread(&h, sizeof(h), 1, file_) != 1 || memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 ||
+        h.output_count != output_count_ || h.record_bytes != (int)RecordBytes()) {
+        Close();
+        error = "Result memo " + path + " has a different layout; delete it to start over";
+        return false;
+    }
+
+    // Index every complete record; a torn tail from an interrupted write is ignored
+    const size_t rec_bytes = RecordBytes();
+    std::vector<unsigned char> rec(rec_bytes);
+    long long offset = sizeof(h);
+    while (fread(rec.data(), rec_bytes, 1, file_) == 1) {
+        Record r;
+        memcpy(&r, rec.data(), sizeof(r));
+        index_.insert(std::make_pair(r.key, offset));
+        offset += (long long)rec_bytes;
+    }
+    end_offset_ = offset;
+    return true;
+}
+
+bool ResultMemo::Lookup(unsigned long long key, double* outputs, bool* ended) {
+    std::unordered_map<unsigned long long, long long>::const_iterator it = index_.find(key);
+    if (it == index_.end()) return false;
+
+    const size_t rec_bytes = RecordBytes();
+    Record r;
+    if (it->second < 0) {
+        const unsigned char* p = &queue_[(size_t)(-1 - it->second) * rec_bytes];
+        memcpy(&r, p, sizeof(r));
+        if (!(r.flags & kFlagEnded)) memcpy(outputs, p + sizeof(r), output_count_ * sizeof(double));
+    } else {
+        if (_fseeki64(file_, it->second, SEEK_SET) != 0 || fread(&r, sizeof(r), 1, file_) != 1) return false;
+        if (!(r.flags & kFlagEnded) && output_count_ > 0 &&
+            fread(outputs, sizeof(double), output_count_, file_) != (size_t)output_count_) {
+            return false;
+        }
+    }
+    *ended = (r.flags & kFlagEnded) != 0;
+    return true;
+}
+
+void ResultMemo::Add(unsigned long long key, const double* outputs, bool ended) {
+    if (!file_ || index_.count(key)) return;
+    const size_t rec_bytes = RecordBytes();
+    const size_t pos = queue_.size() / rec_bytes;
+    queue_.resize(queue_.size() + rec_bytes, 0);
+    unsigned char* p = &queue_[pos * rec_bytes];
+
+    Record r;
+    r.key = key;
+    r.flags = ended ? kFlagEnded : 0;
+    r.reserved = 0;
+    memcpy(p, &r, sizeof(r));
+    if (!ended) memcpy(p + sizeof(r), outputs, output_count_ * sizeof(double));
+    index_[key] = -1 - (long long)pos;
+}
+
+bool ResultMemo::Flush(std::string& error) {
+    if (!file_ || queue_.empty()) return true;
+    const size_t rec_bytes = RecordBytes();
+    const size_t count = queue_.size() / rec_bytes;
+
+    if (_fseeki64(file_, end_offset_, SEEK_SET) != 0 ||
+        fwrite(queue_.data(), rec_bytes, count, file_) != count || fflush(file_) != 0) {
+        error = "Failed to write result memo";
+        // Queued keys stay unindexed so a partial write is never served
+        for (auto it = index_.begin(); it != index_.end();) {
+            if (it->second < 0) it = index_.erase(it);
+            else ++it;
+        }
+        queue_.clear();
+        return false;
+    }
+
+    // Re-point queued keys at their file offsets
+    for (auto& kv : index_) {
+        if (kv.second < 0) kv.second = end_offset_ + (-1 - kv.second) * (long long)rec_bytes;
+    }
+    end_offset_ += (long long)(count * rec_bytes);
+    queue_.clear();
+    return true;
+}
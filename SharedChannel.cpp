@@ -0,0 +1,254 @@
+//-----------------------------------------------------------------------------
+//   SharedChannel.cpp
+//   Cross-process message channel over named shared memory
+//-----------------------------------------------------------------------------
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+#include "include/SharedChannel.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+static const char kMagic[8] = { 'G', 'S', 'C', 'H', 'A', 'N', '0', '1' };
+static const int kBlockSliceMs = 100;      // Longest single blocking wait
+
+SharedChannel::SharedChannel()
+    : owner_(false), header_(NULL), creator_(NULL) {
+    events_[0] = events_[1] = NULL;
+}
+
+SharedChannel::~SharedChannel() {
+    Close();
+}
+
+size_t SharedChannel::SlotBytes(int capacity) {
+    return sizeof(SlotHeader) + (size_t)capacity * sizeof(double);
+}
+
+size_t SharedChannel::RegionBytes(int capacity) {
+    return sizeof(Header) + 2 * kSlots * SlotBytes(capacity);
+}
+
+char* SharedChannel::SlotAt(Direction dir, unsigned int index) const {
+    return (char*)header_ + sizeof(Header) + ((size_t)dir * kSlots + index % kSlots) * header_->slot_bytes;
+}
+
+bool SharedChannel::Create(const std::string& name, int capacity, std::string& error) {
+    Close();
+    if (capacity < 1) capacity = 1;
+    name_ = name;
+    owner_ = true;
+    if (!region_.Create(name, RegionBytes(capacity), error)) { Close(); return false; }
+    header_ = (Header*)region_.GetData();
+
+    // The region starts zeroed: both rings are empty
+    memcpy(header_->magic, kMagic, sizeof(kMagic));
+    header_->capacity = (unsigned int)capacity;
+    header_->slot_bytes = (unsigned int)SlotBytes(capacity);
+    header_->creator_pid = SharedMemory::CurrentProcessId();
+    for (int d = 0; d < 2; d++) {
+        header_->rings[d].head.store(0);
+        header_->rings[d].tail.store(0);
+        header_->rings[d].waiting.store(0);
+    }
+    if (!CreateSignals(error)) { Close(); return false; }
+    return true;
+}
+
+bool SharedChannel::Open(const std::string& name, std::string& error) {
+    Close();
+    name_ = name;
+    owner_ = false;
+    if (!region_.Open(name, error)) { Close(); return false; }
+    header_ = (Header*)region_.GetData();
+    size_t bytes = region_.GetSize();
+    if (bytes < sizeof(Header) || memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 ||
+        bytes < RegionBytes((int)header_->capacity)) {
+        Close();
+        error = "Not a bridge channel: " + name;
+        return false;
+    }
+    if (!CreateSignals(error)) { Close(); return false; }
+    return true;
+}
+
+bool SharedChannel::IsOpen() const { return header_ != NULL; }
+int SharedChannel::GetCapacity() const { return header_ ? (int)header_->capacity : 0; }
+const std::string& SharedChannel::GetName() const { return name_; }
+
+bool SharedChannel::Post(Direction dir, int method, int status, int aux, const double* values, int count, const char* text) {
+    if (!header_ || count < 0 || count > (int)header_->capacity) return false;
+    Ring& r = header_->rings[dir];
+    unsigned int head = r.head.load(std::memory_order_relaxed);
+    if (head - r.tail.load(std::memory_order_acquire) >= (unsigned int)kSlots) return false;
+
+    char* slot = SlotAt(dir, head);
+    SlotHeader* s = (SlotHeader*)slot;
+    s->method = method;
+    s->status = status;
+    s->aux = aux;
+    s->count = count;
+    s->text[0] = '\0';
+    if (text) {
+        size_t n = strlen(text);
+        if (n >= sizeof(s->text)) n = sizeof(s->text) - 1;
+        memcpy(s->text, text, n);
+        s->text[n] = '\0';
+    }
+    if (count > 0) memcpy(slot + sizeof(SlotHeader), values, (size_t)count * sizeof(double));
+
+    // seq_cst pairs with the reader's waiting/head check: either it sees
+    // the new head, or we see its waiting flag and wake it
+    r.head.store(head + 1);
+    if (r.waiting.load()) Wake(dir);
+    return true;
+}
+
+int SharedChannel::Receive(Direction dir, Message& msg, double* values, int max_values, int timeout_ms, int spin_us) {
+    if (!header_) return 0;
+    Ring& r = header_->rings[dir];
+    const unsigned int tail = r.tail.load(std::memory_order_relaxed);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (;;) {
+        unsigned int head = r.head.load(std::memory_order_acquire);
+        if (head != tail) break;
+
+        long long elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        if (elapsed_us < spin_us) {
+            std::this_thread::yield();
+            continue;
+        }
+        int wait_ms = kBlockSliceMs;
+        if (timeout_ms >= 0) {
+            long long left = timeout_ms - elapsed_us / 1000;
+            if (left <= 0) return 0;
+            if (left < wait_ms) wait_ms = (int)left;
+        }
+        r.waiting.store(1);
+        head = r.head.load();
+        if (head == tail) Block(dir, head, wait_ms);
+        r.waiting.store(0);
+    }
+
+    const char* slot = SlotAt(dir, tail);
+    const SlotHeader* s = (const SlotHeader*)slot;
+    msg.method = s->method;
+    msg.status = s->status;
+    msg.aux = s->aux;
+    msg.count = s->count;
+    memcpy(msg.text, s->text, sizeof(msg.text));
+    msg.text[sizeof(msg.text) - 1] = '\0';
+    int n = s->count < max_values ? s->count : max_values;
+    if (n > 0) memcpy(values, slot + sizeof(SlotHeader), (size_t)n * sizeof(double));
+    r.tail.store(tail + 1, std::memory_order_release);
+    return 1;
+}
+
+//-----------------------------------------------------------------------------
+//   Platform layer
+//-----------------------------------------------------------------------------
+
+#ifdef _WIN32
+
+bool SharedChannel::CreateSignals(std::string& error) {
+    for (int d = 0; d < 2; d++) {
+        char name[300];
+        sprintf_s(name, "%s_%d", name_.c_str(), d);
+        events_[d] = CreateEventA(NULL, FALSE, FALSE, name);     // Auto-reset; opens it if it exists
+        if (!events_[d]) {
+            error = std::string("Cannot create event: ") + name;
+            return false;
+        }
+    }
+    return true;
+}
+
+void SharedChannel::Wake(Direction dir) {
+    SetEvent((HANDLE)events_[dir]);
+}
+
+void SharedChannel::Block(Direction dir, unsigned int seen_head, int timeout_ms) {
+    (void)seen_head;    // A SetEvent after the check leaves the event signaled
+    WaitForSingleObject((HANDLE)events_[dir], (DWORD)timeout_ms);
+}
+
+bool SharedChannel::IsCreatorAlive() const {
+    if (!header_) return false;
+    if (owner_) return true;
+    if (!creator_) creator_ = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)header_->creator_pid);
+    if (!creator_) return false;
+    return WaitForSingleObject((HANDLE)creator_, 0) == WAIT_TIMEOUT;
+}
+
+void SharedChannel::Close() {
+    for (int d = 0; d < 2; d++) {
+        if (events_[d]) CloseHandle((HANDLE)events_[d]);
+        events_[d] = NULL;
+    }
+    if (creator_) CloseHandle((HANDLE)creator_);
+    creator_ = NULL;
+    region_.Close();
+    header_ = NULL;
+    owner_ = false;
+}
+
+std::string SharedChannel::MakeName(int sequence) {
+    char name[64];
+    sprintf_s(name, "Local\\gsswmm_%lu_%d", (unsigned long)GetCurrentProcessId(), sequence);
+    return name;
+}
+
+#else
+
+static long Futex(std::atomic<unsigned int>* word, int op, unsigned int value, const struct timespec* timeout) {
+    // Shared (not FUTEX_PRIVATE) so it works across processes
+    return syscall(SYS_futex, (unsigned int*)word, op, value, timeout, NULL, 0);
+}
+
+bool SharedChannel::CreateSignals(std::string& error) {
+    (void)error;    // The futex words live in the ring headers
+    return true;
+}
+
+void SharedChannel::Wake(Direction dir) {
+    Futex(&header_->rings[dir].head, FUTEX_WAKE, 1, NULL);
+}
+
+void SharedChannel::Block(Direction dir, unsigned int seen_head, int timeout_ms) {
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+    // Returns at once if head has already moved past seen_head
+    Futex(&header_->rings[dir].head, FUTEX_WAIT, seen_head, &ts);
+}
+
+bool SharedChannel::IsCreatorAlive() const {
+    if (!header_) return false;
+    if (owner_) return true;
+    return SharedMemory::IsProcessAlive(header_->creator_pid);
+}
+
+void SharedChannel::Close() {
+    region_.Close();
+    header_ = NULL;
+    owner_ = false;
+}
+
+std::string SharedChannel::MakeName(int sequence) {
+    char name[64];
+    snprintf(name, sizeof(name), "/gsswmm_%ld_%d", (long)getpid(), sequence);
+    return name;
+}
+
+#endif
@@ -0,0 +1,161 @@
+//-----------------------------------------------------------------------------
+//   SharedMemory.cpp
+//   Named shared-memory region
+//-----------------------------------------------------------------------------
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "include/SharedMemory.h"
+
+SharedMemory::SharedMemory() : owner_(false), data_(NULL), bytes_(0), mapping_(NULL) {}
+
+SharedMemory::~SharedMemory() {
+    Close();
+}
+
+bool SharedMemory::Create(const std::string& name, size_t bytes, std::string& error) {
+    Close();
+    name_ = name;
+    owner_ = true;
+    if (!Map(true, bytes, error)) { Close(); return false; }
+    return true;
+}
+
+bool SharedMemory::Open(const std::string& name, std::string& error) {
+    Close();
+    name_ = name;
+    owner_ = false;
+    if (!Map(false, 0, error)) { Close(); return false; }
+    return true;
+}
+
+bool SharedMemory::IsOpen() const { return data_ != NULL; }
+void* SharedMemory::GetData() const { return data_; }
+size_t SharedMemory::GetSize() const { return bytes_; }
+const std::string& SharedMemory::GetName() const { return name_; }
+
+#ifdef _WIN32
+
+bool SharedMemory::Map(bool create, size_t bytes, std::string& error) {
+    HANDLE m;
+    if (create) {
+        unsigned long long size = (unsigned long long)bytes;
+        m = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                               (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFFull), name_.c_str());
+        if (m && GetLastError() == ERROR_ALREADY_EXISTS) {
+            CloseHandle(m);
+            m = NULL;
+        }
+    } else {
+        m = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name_.c_str());
+    }
+    if (!m) {
+        error = "Cannot " + std::string(create ? "create" : "open") + " shared memory: " + name_;
+        return false;
+    }
+    mapping_ = m;
+    void* p = MapViewOfFile(m, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!p) {
+        error = "Cannot map shared memory: " + name_;
+        return false;
+    }
+    data_ = p;
+    if (create) {
+        bytes_ = bytes;
+    } else {
+        MEMORY_BASIC_INFORMATION info;
+        bytes_ = VirtualQuery(p, &info, sizeof(info)) ? info.RegionSize : 0;
+    }
+    return true;
+}
+
+void SharedMemory::Close() {
+    if (data_) UnmapViewOfFile(data_);
+    data_ = NULL;
+    if (mapping_) CloseHandle((HANDLE)mapping_);   // Section goes away with the last handle
+    mapping_ = NULL;
+    bytes_ = 0;
+    owner_ = false;
+}
+
+void SharedMemory::Remove(const std::string& name) {
+    (void)name;
+}
+
+long long SharedMemory::CurrentProcessId() {
+    return (long long)GetCurrentProcessId();
+}
+
+bool SharedMemory::IsProcessAlive(long long pid) {
+    HANDLE h = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)pid);
+    if (!h) return false;
+    bool alive = WaitForSingleObject(h, 0) == WAIT_TIMEOUT;
+    CloseHandle(h);
+    return alive;
+}
+
+#else
+
+bool SharedMemory::Map(bool create, size_t bytes, std::string& error) {
+    int fd = create ? shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600)
+                    : shm_open(name_.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        owner_ = false;         // Not ours to unlink
+        error = "Cannot " + std::string(create ? "create" : "open") + " shared memory: " + name_;
+        return false;
+    }
+    if (create) {
+        if (ftruncate(fd, (off_t)bytes) != 0) {
+            close(fd);
+            error = "Cannot size shared memory: " + name_;
+            return false;
+        }
+    } else {
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            error = "Cannot size shared memory: " + name_;
+            return false;
+        }
+        bytes = (size_t)st.st_size;
+    }
+    void* p = bytes ? mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (p == MAP_FAILED) {
+        error = "Cannot map shared memory: " + name_;
+        return false;
+    }
+    data_ = p;
+    bytes_ = bytes;
+    return true;
+}
+
+void SharedMemory::Close() {
+    if (data_) munmap(data_, bytes_);
+    data_ = NULL;
+    if (owner_ && !name_.empty()) shm_unlink(name_.c_str());
+    bytes_ = 0;
+    owner_ = false;
+}
+
+void SharedMemory::Remove(const std::string& name) {
+    shm_unlink(name.c_str());
+}
+
+long long SharedMemory::CurrentProcessId() {
+    return (long long)getpid();
+}
+
+bool SharedMemory::IsProcessAlive(long long pid) {
+    return kill((pid_t)pid, 0) == 0 || errno == EPERM;
+}
+
+#endif
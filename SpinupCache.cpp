@@ -0,0 +1,358 @@
+//-----------------------------------------------------------------------------
+//   SpinupCache.cpp
+//   Runs the antecedent spin-up period once and starts every realization
+//   from the SWMM hotstart file it saved
+//-----------------------------------------------------------------------------
+
+#include "include/Platform.h"
+#include "include/SpinupCache.h"
+#include "include/Hash.h"
+#include "include/swmm5.h"
+#include "include/BridgeLog.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+
+static const char* kMonths[] = { "JAN", "FEB", "MAR", "APR", "MAY", "JUN",
+                                 "JUL", "AUG", "SEP", "OCT", "NOV", "DEC" };
+
+static std::string Trim(const std::string& s) {
+    size_t a = 0, b = s.size();
+    while (a < b && std::isspace((unsigned char)s[a])) a++;
+    while (b > a && std::isspace((unsigned char)s[b - 1])) b--;
+    return s.substr(a, b - a);
+}
+
+static std::string Upper(std::string s) {
+    for (size_t i = 0; i < s.size(); i++) s[i] = (char)std::toupper((unsigned char)s[i]);
+    return s;
+}
+
+static std::vector<std::string> Tokens(const std::string& line) {
+    std::vector<std::string> out;
+    std::istringstream ss(line);
+    std::string t;
+    while (ss >> t) out.push_back(t);
+    return out;
+}
+
+static bool ReadFile(const std::string& path, std::string& text) {
+    std::ifstream f(path.c_str(), std::ios::binary);
+    if (!f.is_open()) return false;
+    std::stringstream buf;
+    buf << f.rdbuf();
+    text = buf.str();
+    return true;
+}
+
+static bool WriteFile(const std::string& path, const std::string& text) {
+    std::ofstream f(path.c_str(), std::ios::binary | std::ios::trunc);
+    if (!f.is_open()) return false;
+    f << text;
+    return f.good();
+}
+
+static bool FileExists(const std::string& path) {
+    std::ifstream f(path.c_str(), std::ios::binary);
+    return f.is_open();
+}
+
+// Days from 01/01/1900 for a proleptic Gregorian date (H. Hinnant's algorithm)
+static long DaysFromCivil(int y, int m, int d) {
+    y -= m <= 2;
+    const long era = (y >= 0 ? y : y - 399) / 400;
+    const long yoe = y - era * 400;
+    const long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 693901;     // 693901 = days(1900-01-01) from 0000-03-01
+}
+
+static void CivilFromDays(long z, int* y, int* m, int* d) {
+    z += 693901;
+    const long era = (z >= 0 ? z : z - 146096) / 146097;
+    const long doe = z - era * 146097;
+    const long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const long mp = (5 * doy + 2) / 153;
+    *d = (int)(doy - (153 * mp + 2) / 5 + 1);
+    *m = (int)(mp < 10 ? mp + 3 : mp - 9);
+    *y = (int)(yoe + era * 400 + (*m <= 2));
+}
+
+bool InpDateTimeToDays(const std::string& date, const std::string& time, double* days) {
+    // Date: month/day/year with '/' or '-', month numeric or abbreviated
+    std::string d = date;
+    std::replace(d.begin(), d.end(), '-', '/');
+    size_t p1 = d.find('/');
+    size_t p2 = (p1 == std::string::npos) ? std::string::npos : d.find('/', p1 + 1);
+    if (p2 == std::string::npos) return false;
+    std::string ms = Upper(d.substr(0, p1));
+    int month = 0;
+    for (int i = 0; i < 12; i++) {
+        if (ms == kMonths[i]) month = i + 1;
+    }
+    if (month == 0) month = std::atoi(ms.c_str());
+    int day = std::atoi(d.substr(p1 + 1, p2 - p1 - 1).c_str());
+    int year = std::atoi(d.substr(p2 + 1).c_str());
+    if (month < 1 || month > 12 || day < 1 || day > 31 || year < 1900) return false;
+
+    // Time: HH:MM[:SS] or decimal hours
+    double hours = 0.0;
+    std::string t = Trim(time);
+    if (!t.empty()) {
+        if (t.find(':') != std::string::npos) {
+            int hh = 0, mm = 0, ss = 0;
+            if (sscanf(t.c_str(), "%d:%d:%d", &hh, &mm, &ss) < 2) return false;
+            hours = hh + mm / 60.0 + ss / 3600.0;
+        } else {
+            hours = std::atof(t.c_str());
+        }
+    }
+    *days = (double)DaysFromCivil(year, month, day) + hours / 24.0;
+    return true;
+}
+
+void DaysToInpDateTime(double days, std::string& date, std::string& time) {
+    long whole = (long)std::floor(days);
+    long secs = (long)std::floor((days - whole) * 86400.0 + 0.5);
+    if (secs >= 86400) { whole++; secs -= 86400; }
+    int y, m, d;
+    CivilFromDays(whole, &y, &m, &d);
+    char buf[32];
+    sprintf_s(buf, "%02d/%02d/%04d", m, d, y);
+    date = buf;
+    sprintf_s(buf, "%02ld:%02ld:%02ld", secs / 3600, (secs / 60) % 60, secs % 60);
+    time = buf;
+}
+
+std::map<std::string, std::string> ReadInpOptions(const std::string& inp) {
+    std::map<std::string, std::string> opts;
+    std::istringstream in(inp);
+    std::string line, section;
+    while (std::getline(in, line)) {
+        std::string t = Trim(line);
+        if (t.empty() || t[0] == ';') continue;
+        if (t[0] == '[') { section = Upper(t); continue; }
+        if (section != "[OPTIONS]") continue;
+        std::vector<std::string> tok = Tokens(t);
+        if (tok.size() >= 2) opts[Upper(tok[0])] = tok[1];
+    }
+    return opts;
+}
+
+static std::string FormatOption(const std::string& key, const std::string& value) {
+    std::string line = key;
+    if (line.size() < 20) line.append(20 - line.size(), ' ');
+    return line + "\t" + value;
+}
+
+// Insert lines at the end of the current section, ahead of its trailing blank lines
+static void AppendToSection(std::vector<std::string>& out, const std::vector<std::string>& lines) {
+    size_t pos = out.size();
+    while (pos > 0 && Trim(out[pos - 1]).empty()) pos--;
+    out.insert(out.begin() + pos, lines.begin(), lines.end());
+}
+
+std::string RewriteInp(const std::string& inp, const std::map<std::string, std::string>& options,
+                       const std::vector<std::string>& files_lines) {
+    std::vector<std::string> out;
+    std::set<std::string> written;
+    bool has_options = false, has_files = false;
+    std::string section;
+
+    // Called when a section ends: add whatever it still lacks
+    auto close_section = [&]() {
+        if (section == "[OPTIONS]") {
+            std::vector<std::string> add;
+            for (const auto& kv : options) {
+                if (!written.count(kv.first)) add.push_back(FormatOption(kv.first, kv.second));
+            }
+            AppendToSection(out, add);
+        } else if (section == "[FILES]") {
+            AppendToSection(out, files_lines);
+        }
+    };
+
+    std::istringstream in(inp);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r') line.erase(line.size() - 1);
+        std::string t = Trim(line);
+        if (!t.empty() && t[0] == '[') {
+            close_section();
+            section = Upper(t);
+            if (section == "[OPTIONS]") has_options = true;
+            if (section == "[FILES]") has_files = true;
+            out.push_back(line);
+            continue;
+        }
+        if (!t.empty() && t[0] != ';') {
+            std::vector<std::string> tok = Tokens(t);
+            if (section == "[OPTIONS]") {
+                std::string key = Upper(tok[0]);
+                std::map<std::string, std::string>::const_iterator it = options.find(key);
+                if (it != options.end()) {
+                    out.push_back(FormatOption(key, it->second));
+                    written.insert(key);
+                    continue;
+                }
+            } else if (section == "[FILES]" && tok.size() >= 2) {
+                std::string verb = Upper(tok[0]);
+                if ((verb == "USE" || verb == "SAVE") && Upper(tok[1]) == "HOTSTART") continue;
+            }
+        }
+        out.push_back(line);
+    }
+    close_section();
+
+    if (!has_options) {
+        out.push_back("");
+        out.push_back("[OPTIONS]");
+        section = "[OPTIONS]";
+        close_section();
+    }
+    if (!has_files) {
+        out.push_back("");
+        out.push_back("[FILES]");
+        out.insert(out.end(), files_lines.begin(), files_lines.end());
+    }
+
+    std::string text;
+    for (const auto& l : out) {
+        text += l;
+        text += "\r\n";
+    }
+    return text;
+}
+
+SpinupCache::SpinupCache() : ran_spinup_(false) {}
+SpinupCache::~SpinupCache() {}
+
+bool SpinupCache::RanSpinup() const { return ran_spinup_; }
+const std::string& SpinupCache::GetHotstartPath() const { return hotstart_path_; }
+
+bool SpinupCache::Prepare(const std::string& model_path, double duration_days, const std::string& cache_dir,
+                          std::string& run_inp, std::string& error) {
+    ran_spinup_ = false;
+
+    std::string inp;
+    if (!ReadFile(model_path, inp)) { error = "Cannot read " + model_path; return false; }
+
+    // Spin-up window: [START, START + duration)
+    std::map<std::string, std::string> opts = ReadInpOptions(inp);
+    double start = 0.0, end = 0.0;
+    if (!opts.count("START_DATE") ||
+        !InpDateTimeToDays(opts["START_DATE"], opts.count("START_TIME") ? opts["START_TIME"] : "", &start)) {
+        error = "Spin-up needs a valid START_DATE in [OPTIONS] of " + model_path;
+        return false;
+    }
+    const double spin_end = start + duration_days;
+    if (opts.count("END_DATE") &&
+        InpDateTimeToDays(opts["END_DATE"], opts.count("END_TIME") ? opts["END_TIME"] : "", &end) &&
+        end <= spin_end) {
+        error = "Spin-up window reaches past END_DATE of " + model_path;
+        return false;
+    }
+    double report_start = start;
+    if (opts.count("REPORT_START_DATE")) {
+        InpDateTimeToDays(opts["REPORT_START_DATE"],
+                          opts.count("REPORT_START_TIME") ? opts["REPORT_START_TIME"] : "", &report_start);
+    }
+
+    std::string end_date, end_time, start_date, start_time;
+    DaysToInpDateTime(spin_end, end_date, end_time);
+    DaysToInpDateTime(start, start_date, start_time);
+
+    // Cache key: model contents plus the window
+    char key[32];
+    sprintf_s(key, "%016llx", Fnv1a64(end_date + " " + end_time, Fnv1a64(inp)));
+
+    std::string dir;
+    if (!cache_dir.empty()) {
+        MakeDirectory(cache_dir);
+        dir = cache_dir;
+        if (dir[dir.size() - 1] != '\\' && dir[dir.size() - 1] != '/') dir += PATH_SEP;
+    }
+    hotstart_path_ = dir + "spinup_" + key + ".hsf";
+
+    // Derived .inp files stay next to model.inp so relative paths inside it still resolve
+    std::string base = model_path;
+    size_t dot = base.rfind('.');
+    if (dot != std::string::npos) base = base.substr(0, dot);
+
+    if (FileExists(hotstart_path_)) {
+        Log(2, "Spin-up hotstart cached: %s", hotstart_path_);
+    } else {
+        Log(2, "Running %.3f day spin-up to %s %s", duration_days, end_date, end_time);
+        std::string tmp_path = hotstart_path_ + ".tmp";
+        std::string spin_inp = base + "_spinup.inp";
+        std::map<std::string, std::string> spin_opts;
+        spin_opts["END_DATE"] = end_date;
+        spin_opts["END_TIME"] = end_time;
+        if (report_start >= spin_end) {
+            spin_opts["REPORT_START_DATE"] = start_date;
+            spin_opts["REPORT_START_TIME"] = start_time;
+        }
+        std::vector<std::string> spin_files(1, "SAVE HOTSTART \"" + tmp_path + "\"");
+        if (!WriteFile(spin_inp, RewriteInp(inp, spin_opts, spin_files))) {
+            error = "Cannot write " + spin_inp;
+            return false;
+        }
+
+        std::remove(tmp_path.c_str());
+        int ec = swmm_open(spin_inp.c_str(), (base + "_spinup.rpt").c_str(), (base + "_spinup.out").c_str());
+        if (ec == 0) {
+            ec = swmm_start(0);
+            if (ec == 0) {
+                double elapsed = 0.0;
+                long steps = 0;
+                int rc;
+                do {
+                    rc = swmm_step(&elapsed);
+                    steps++;
+                } while (rc == 0 && elapsed > 0.0);
+                if (rc < 0) ec = rc;
+                int e = swmm_end();               // Writes the hotstart file
+                if (ec == 0) ec = e;
+                Log(2, "Spin-up finished after %ld routing steps", steps);
+            }
+        }
+        if (ec != 0) {
+            char msg[256];
+            swmm_getError(msg, sizeof(msg));
+            error = std::string("Spin-up failed: ") + msg;
+        }
+        swmm_close();
+        if (ec != 0) {
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+        if (!FileExists(tmp_path) || std::rename(tmp_path.c_str(), hotstart_path_.c_str()) != 0) {
+            error = "Spin-up did not produce hotstart file " + hotstart_path_;
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+        ran_spinup_ = true;
+    }
+
+    // Realizations start where the spin-up ended
+    std::map<std::string, std::string> run_opts;
+    run_opts["START_DATE"] = end_date;
+    run_opts["START_TIME"] = end_time;
+    if (report_start < spin_end) {
+        run_opts["REPORT_START_DATE"] = end_date;
+        run_opts["REPORT_START_TIME"] = end_time;
+    }
+    std::vector<std::string> run_files(1, "USE HOTSTART \"" + hotstart_path_ + "\"");
+    run_inp = base + "_hotstart.inp";
+    if (!WriteFile(run_inp, RewriteInp(inp, run_opts, run_files))) {
+        error = "Cannot write " + run_inp;
+        return false;
+    }
+    return true;
+}
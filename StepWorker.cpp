@@ -0,0 +1,73 @@
+//-----------------------------------------------------------------------------
+//   StepWorker.cpp
+//   Dedicated thread that runs one SWMM step job at a time
+//-----------------------------------------------------------------------------
+
+#include "include/StepWorker.h"
+
+StepWorker::StepWorker() : thread_(NULL), has_job_(false), stop_(false) {}
+
+StepWorker::~StepWorker() {
+    Stop();
+}
+
+void StepWorker::Start() {
+    if (thread_) return;
+    stop_ = false;
+    has_job_ = false;
+    thread_ = new std::thread(&StepWorker::Run, this);
+}
+
+void StepWorker::Stop() {
+    if (!thread_) return;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return !has_job_; });
+        stop_ = true;
+    }
+    cv_.notify_all();
+    thread_->join();
+    delete thread_;
+    thread_ = NULL;
+}
+
+void StepWorker::Submit(const std::function<void()>& job) {
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this]() { return !has_job_; });
+        job_ = job;
+        has_job_ = true;
+    }
+    cv_.notify_all();
+}
+
+void StepWorker::Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this]() { return !has_job_; });
+}
+
+bool StepWorker::IsRunning() const { return thread_ != NULL; }
+
+bool StepWorker::IsBusy() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return has_job_;
+}
+
+void StepWorker::Run() {
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this]() { return has_job_ || stop_; });
+            if (stop_ && !has_job_) return;
+            job = job_;
+        }
+        job();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = std::function<void()>();
+            has_job_ = false;
+        }
+        cv_.notify_all();
+    }
+}
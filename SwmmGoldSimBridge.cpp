@@ -3,32 +3,50 @@
 //   GoldSim-SWMM Bridge DLL v5.0 (config-driven)
 //-----------------------------------------------------------------------------
 
-#include <windows.h>
+#include "include/Platform.h"
 #include <string>
 #include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
 #include "include/swmm5.h"
 #include "include/MappingLoader.h"
+#include "include/OutputPlan.h"
+#include "include/OutputAggregator.h"
+#include "include/BridgeLog.h"
+#include "include/StepWorker.h"
+#include "include/SpinupCache.h"
+#include "include/Controllers.h"
+#include "include/ResultMemo.h"
+#include "include/Hash.h"
+#include "include/Expression.h"
+#include "include/OutputStats.h"
+#include "include/Recorder.h"
+#include "include/WorkerPool.h"
+#include "include/Profiler.h"
+#include "include/Tracer.h"
+#include "include/FlightRecorder.h"
+#include "include/Telemetry.h"
+#include "include/Checkpoint.h"
+#include "include/InputSeries.h"
+#include "include/NameIndex.h"
 
 #define DLL_VERSION 1.05
 #define CONFIG_FILE "SwmmGoldSimBridge.json"
+#define MODEL_FILE "model.inp"
+#define REPORT_FILE "model.rpt"
+#define RESULTS_FILE "model.out"
+#define NULL_REPORT_FILE NULL_DEVICE // minimal_io: report discarded
+#define WORKER_LOG_FILE "bridge_worker.log"
+#define SWMM_LIBRARY "swmm5.dll"       // Searched for API extensions at run time
 #define PROPERTY_SKIP -1
-
-// Logging: 0=OFF, 1=ERROR, 2=INFO, 3=DEBUG
-static int s_log_level = 2;  // Default to INFO, can be overridden by JSON
-
-static void Log(int level, const char* fmt, ...) {
-    if (level > s_log_level) return;
-    static bool first = true;
-    FILE* f = NULL;
-    if (fopen_s(&f, "bridge_debug.log", first ? "w" : "a") == 0 && f) {
-        if (first) { fprintf(f, "GSswmm Bridge v5.212 (with LID API)\n"); first = false; }
-        SYSTEMTIME st; GetLocalTime(&st);
-        const char* tag = (level == 1) ? "ERROR" : (level == 2) ? "INFO " : "DEBUG";
-        fprintf(f, "[%02d:%02d:%02d] [%s] ", st.wHour, st.wMinute, st.wSecond, tag);
-        va_list ap; va_start(ap, fmt); vfprintf(f, fmt, ap); va_end(ap);
-        fprintf(f, "\n"); fclose(f);
-    }
-}
+#define PROPERTY_CONTROLLER 1000    // CONTROLLER inputs: + ControllerBank::Param, swmm_idx = controller slot
+#define INTERP_HOLD     0   // Input held at the previous call's value for the whole interval
+#define INTERP_LINEAR   1   // Input ramped from the previous call's value to this call's
+#define TIME_TOLERANCE  1e-3    // Seconds; absorbs round-off in SWMM's elapsed time
 
 // GoldSim API
 #define XF_INITIALIZE   0
@@ -46,18 +64,30 @@ struct Resolved {
     int swmm_idx;    // Subcatchment index (for LID) or element index
     int lid_idx;     // LID unit index (only for LID outputs, -1 otherwise)
     bool is_lid;     // True if this is an LID output
-    std::string lid_property;  // LID property name (e.g., "STORAGE_VOLUME", "SURFACE_OUTFLOW")
+    OutputPlan::Getter getter;  // SWMM getter used to read this output
+    int mode;        // INTERP_* for inputs, OutputAggregator::Mode for outputs
+    double tolerance;   // Inputs: change needed before re-applying (<0 = always apply)
+    int reduce;         // Outputs: OutputPlan::Reduce over members (-1 = single element)
+    double threshold;   // REDUCE_COUNT_ABOVE threshold
+    std::vector<int> members;   // Element indices reduced into this output
+    bool is_expression;         // Outputs: computed by expression
+    bool is_statistic;          // Outputs: whole-run statistic written by OutputStats
+    int update_steps;           // Outputs: re-read every N routing steps (0 = every step)
+    double update_seconds;      // Outputs: re-read every N simulated seconds (0 = every step)
+    ExpressionProgram expression;
     
     // Constructor for regular outputs (backward compatibility)
-    Resolved(int iface, int prop, int swmm) 
-        : iface_idx(iface), prop_enum(prop), swmm_idx(swmm), lid_idx(-1), is_lid(false), lid_property("") {}
+    Resolved(int iface, int prop, int swmm, int mode = 0) 
+        : iface_idx(iface), prop_enum(prop), swmm_idx(swmm), lid_idx(-1), is_lid(false), getter(OutputPlan::GET_VALUE), mode(mode), tolerance(0.0),
+          reduce(-1), threshold(0.0), is_expression(false), is_statistic(false),
+          update_steps(0), update_seconds(0.0) {}
     
     // Static factory method for LID outputs
-    static Resolved CreateLidOutput(int iface, int subcatch, int lid, const std::string& property) {
+    static Resolved CreateLidOutput(int iface, int subcatch, int lid, OutputPlan::Getter getter) {
         Resolved r(iface, -1, subcatch);
         r.lid_idx = lid;
         r.is_lid = true;
-        r.lid_property = property;
+        r.getter = getter;
         return r;
     }
 };
@@ -66,20 +96,203 @@ struct Resolved {
 static MappingLoader s_mapping;
 static bool s_mapping_loaded = false;
 static std::vector<Resolved> s_inputs, s_outputs;
+static OutputPlan s_output_plan;
 static bool s_swmm_running = false;
 static char s_error_buf[256];
 static bool s_first_calculate = true;
 static std::vector<double> s_pending_inputs;
 
+// Dirty tracking: the value last pushed to SWMM for each input, so inputs
+// that have not changed are not re-applied through swmm_setValue
+static std::vector<double> s_applied_inputs;
+static bool s_inputs_dirty = true;           // Some staged input differs from SWMM's
+
+// Interval stepping: each XF_CALCULATE advances SWMM by one GoldSim time
+// step (stepping.mode = GOLDSIM_TIME) or by one routing step
+static OutputAggregator s_aggregator;
+static bool s_goldsim_time = false;
+static double s_interval_seconds = 0.0;      // GoldSim time step (GOLDSIM_TIME mode)
+static long s_interval_count = 0;            // Intervals completed this realization
+static double s_swmm_elapsed_sec = 0.0;      // SWMM clock at the end of the last routing step
+static long s_route_steps = 0;               // Routing steps completed this realization
+static double s_route_step = 0.0;            // Routing step (s), for LINEAR interpolation
+static bool s_has_linear = false;
+static ControllerBank s_controllers;         // Native controllers, run before every routing step
+static std::vector<double> s_substep_values; // Outputs gathered after each routing step
+static int s_slot_count = 0;                 // Highest output interface index + 1
+
+// Mid-run checkpoints (checkpoint section): SWMM hotstart plus bridge state
+// every every_days of simulated time, and resuming from the newest one
+#ifdef _WIN32
+typedef int (__stdcall *SaveHotstartFn)(const char* hsfile);
+#else
+typedef int (*SaveHotstartFn)(const char* hsfile);
+#endif
+static CheckpointStore s_checkpoints;
+static SaveHotstartFn s_save_hotstart = NULL;   // swmm_saveHotstart, if the SWMM library has it
+static bool s_ckpt_on = false;               // Writing checkpoints this realization
+static double s_ckpt_next_sec = 0.0;         // Bridge clock of the next checkpoint
+static double s_ckpt_start_days = 0.0;       // START of the run being checkpointed (days since 1900)
+static double s_time_offset_days = 0.0;      // Resumed run: bridge clock when SWMM's clock read 0
+
+// Dry-weather fast-forward (fast_forward section): a GOLDSIM_TIME interval
+// whose inputs and watched states are quiet is advanced by one swmm_stride
+static bool s_ff_on = false;
+static std::vector<int> s_ff_inputs;         // Interface indices of the watched inputs
+static std::vector<int> s_ff_slots;          // Output slots of the watched states
+static std::vector<double> s_ff_max;         // Their quiet limits
+static std::vector<double> s_ff_states;      // Their values at the end of the last interval
+static std::vector<int> s_ff_series;         // Watched preloaded series
+static long s_ff_intervals = 0;              // Intervals strided this realization
+
+// Whole-run statistics (statistics section and STATISTIC outputs), updated
+// after every routing step and summarized when the realization ends
+static OutputStats s_stats;
+static OutputStats s_stats_consumed;         // Look-ahead mode: state as of the last delivered interval
+static bool s_stats_active = false;
+static std::vector<std::string> s_stats_names;
+static int s_realization = 0;                // Realizations started since the DLL was loaded
+static bool s_stats_file_started = false;    // Summary file truncated in this process
+
+// Per-call columnar recording (recorder section), one file per realization
+static Recorder s_recorder;
+
+// Per-phase timing (profile section); totals since the DLL was loaded
+static Profiler s_profiler;
+
+// Timeline of the same phases (trace section), one file per realization
+static Tracer s_tracer;
+
+// Last steps of the realization (flight_recorder section), dumped on failure
+static FlightRecorder s_flight;
+static bool s_flight_on = false;
+
+// Live state for external monitors (telemetry section), one segment per
+// process kept across realizations
+static Telemetry s_telemetry;
+
+// Realization recycling (realization.recycle): swmm_end/swmm_start between
+// realizations while model.inp is unchanged, keeping s_inputs/s_outputs
+struct ModelStamp {
+    unsigned long long size;
+    unsigned long long write_time;
+    ModelStamp() : size(0), write_time(0) {}
+    bool operator==(const ModelStamp& o) const { return size == o.size && write_time == o.write_time; }
+};
+static bool s_recycle = false;
+static bool s_project_open = false;          // swmm_open done, swmm_close still due
+static bool s_resolved = false;              // s_inputs/s_outputs match the open project
+static ModelStamp s_model_stamp;             // model.inp when the project was opened
+
+// Name resolution: one hash table per object type (gage, subcatchment,
+// node, link), filled from swmm_getCount/swmm_getName the first time the
+// type is looked up, and one for LID units; all valid while the project is open
+static NameIndex s_names[4];
+static bool s_names_built[4] = { false, false, false, false };
+static NameIndex s_lid_names(false);         // Subcatchment index + LID control name, exact match
+static bool s_lid_names_built = false;
+
+// Spin-up hotstart (spinup section): realizations open a copy of model.inp
+// that starts from the cached end-of-spin-up state
+static SpinupCache s_spinup;
+static bool s_spinup_ready = false;
+static ModelStamp s_spinup_stamp;            // model.inp when s_spinup_inp was prepared
+static std::string s_spinup_inp;
+
+// Preloaded input series (timeseries_inputs section): files loaded once and
+// kept across realizations, applied before every routing step
+static std::vector<InputSeries*> s_series;       // Mapping order
+static std::vector<ModelStamp> s_series_stamps;  // Each file as loaded
+static std::vector<int> s_series_prop;           // swmm_setValue property and index
+static std::vector<int> s_series_idx;
+static std::vector<double> s_series_applied;     // Value last pushed to SWMM (NaN = never)
+
+// Look-ahead stepping (stepping.async): the next interval is stepped on a
+// worker thread as soon as XF_CALCULATE returns
+static StepWorker s_step_worker;
+static bool s_async_stepping = false;
+static int s_async_ec = 0;
+static double s_async_elapsed = 0.0;
+static std::vector<double> s_step_values;    // Outputs gathered by the worker
+
+// Result memo (memo section): calls whose input stream matches a stored
+// run are answered from disk; SWMM starts only when the stream diverges
+static ResultMemo s_memo;
+static bool s_memo_serving = false;          // Answering from the store, SWMM not started
+static bool s_memo_recording = false;        // Live outputs are added to the store
+static unsigned long long s_memo_chain = 0;  // Key of the current call
+static bool s_memo_base_ready = false;
+static unsigned long long s_memo_base = 0;   // Hash of model.inp, mapping, series files and DLL version
+static ModelStamp s_memo_stamp;              // model.inp when s_memo_base was computed
+static unsigned long long s_memo_series = 0; // HashSeriesStamps(0) when s_memo_base was computed
+static size_t s_memo_served = 0;             // Calls answered this realization
+static std::vector<double> s_memo_history;   // Their inputs, replayed on divergence
+
+// Worker processes (worker section): INITIALIZE/CALCULATE/CLEANUP are
+// forwarded to a process hosting its own SWMM; s_in_worker is set in that
+// process so it runs the calls itself
+static WorkerPool s_workers;
+static bool s_in_worker = false;             // This process is a worker host
+static bool s_forwarding = false;            // The current realization runs in a worker
+static const std::string s_worker_dir;       // Binding: the worker shares our working directory
+#ifdef _WIN32
+static HINSTANCE s_module = NULL;            // This DLL, for the default worker command
+#endif
+
+// Ensemble (ensemble section): members 1..K each run in their own worker;
+// member 0 is a plain worker or the in-process bridge
+static int s_member = 0;                     // This worker's member number
+static int s_first_member = 0;               // Members the current realization runs
+static int s_last_member = 0;
+
+/**
+ * @brief File name for this ensemble member: "model.rpt" -> "model_m3.rpt"
+ * @note Unchanged for member 0, so plain runs keep their file names
+ */
+static std::string MemberPath(const std::string& path) {
+    if (s_member <= 0) return path;
+    char tag[16];
+    sprintf_s(tag, "_m%d", s_member);
+    size_t slash = path.find_last_of("\\/");
+    size_t dot = path.rfind('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return path + tag;
+    return path.substr(0, dot) + tag + path.substr(dot);
+}
+
+/**
+ * @brief File name for this realization: "bridge_trace.json" -> "bridge_trace_3.json"
+ */
+static std::string RealizationPath(const std::string& path) {
+    char tag[16];
+    sprintf_s(tag, "_%d", s_realization);
+    size_t slash = path.find_last_of("\\/");
+    size_t dot = path.rfind('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return MemberPath(path + tag);
+    return MemberPath(path.substr(0, dot) + tag + path.substr(dot));
+}
+
+/**
+ * @brief Write the flight recorder's last steps after a failure
+ * @param reason Why, written as the first line of the dump
+ */
+static void DumpFlight(const char* reason) {
+    if (!s_flight_on) return;
+    const std::string file = RealizationPath(s_mapping.GetFlightRecorder().file);
+    if (s_flight.Dump(file, reason)) Log(1, "Flight recorder: last %d steps written to %s", s_flight.GetCount(), file.c_str());
+    else Log(1, "Cannot write flight recorder dump: %s", file.c_str());
+}
+
 static void SetError(double* outargs, int* status, const char* msg) {
     strncpy_s(s_error_buf, sizeof(s_error_buf), msg, _TRUNCATE);
-    *(ULONG_PTR*)outargs = (ULONG_PTR)s_error_buf;
+    *(uintptr_t*)outargs = (uintptr_t)s_error_buf;
     *status = XF_FAILURE_WITH_MSG;
 }
 
 static void HandleSwmmError(double* outargs, int* status) {
     swmm_getError(s_error_buf, sizeof(s_error_buf));
-    *(ULONG_PTR*)outargs = (ULONG_PTR)s_error_buf;
+    DumpFlight(s_error_buf);
+    s_telemetry.SetState(Telemetry::STATE_FAILED);
+    *(uintptr_t*)outargs = (uintptr_t)s_error_buf;
     *status = XF_FAILURE_WITH_MSG;
 }
 
@@ -133,35 +346,414 @@ static bool ParseCompositeID(const std::string& name,
     return true;
 }
 
+/**
+ * @brief Index of a named element of an object type
+ * @param obj swmm_GAGE, swmm_SUBCATCH, swmm_NODE or swmm_LINK
+ * @return Element index, or -1 if there is no such element
+ * @note The first lookup of a type enumerates it once into a hash table;
+ *       names match without regard to case, as in swmm_getIndex()
+ */
+static int FindElement(int obj, const std::string& name) {
+    if (obj < swmm_GAGE || obj > swmm_LINK) return -1;
+    if (!s_names_built[obj]) {
+        NameIndex& index = s_names[obj];
+        int count = swmm_getCount(obj);
+        index.Clear();
+        index.Reserve(count > 0 ? (size_t)count : 0);
+        char buf[256];
+        for (int i = 0; i < count; i++) {
+            swmm_getName(obj, i, buf, sizeof(buf));
+            index.Add(buf, strlen(buf), i);
+        }
+        s_names_built[obj] = true;
+        Log(2, "Name index for object type %d: %d elements", obj, count);
+    }
+    return s_names[obj].Find(name);
+}
+
+static std::string LidKey(int subcatch_idx, const char* lid_name, size_t length) {
+    std::string key((const char*)&subcatch_idx, sizeof(subcatch_idx));
+    key.append(lid_name, length);
+    return key;
+}
+
 /**
  * @brief Resolve LID unit index by name within a subcatchment
  * @param subcatch_idx Zero-based subcatchment index
  * @param lid_name LID control name to search for
  * @return LID unit index (>= 0) if found, -1 if not found
- * @note Enumerates all LID units in the subcatchment using swmm_getLidUCount()
- * @note Matches LID control name using swmm_getLidUName()
+ * @note The first call enumerates the LID units of every subcatchment
+ *       (swmm_getLidUCount/swmm_getLidUName) into a hash table. The first
+ *       unit with a given control name wins, as a linear search would.
  */
 static int ResolveLidIndex(int subcatch_idx, const std::string& lid_name) {
-    int lid_count = swmm_getLidUCount(subcatch_idx);
-    if (lid_count < 0) {
-        Log(1, "ResolveLidIndex: swmm_getLidUCount returned %d for subcatch_idx=%d", lid_count, subcatch_idx);
-        return -1;  // Invalid subcatchment index
+    if (!s_lid_names_built) {
+        s_lid_names.Clear();
+        int subcatch_count = swmm_getCount(swmm_SUBCATCH);
+        char buf[256];
+        for (int s = 0; s < subcatch_count; s++) {
+            int lid_count = swmm_getLidUCount(s);
+            for (int i = 0; i < lid_count; i++) {
+                swmm_getLidUName(s, i, buf, sizeof(buf));
+                s_lid_names.Add(LidKey(s, buf, strlen(buf)), i);
+            }
+        }
+        s_lid_names_built = true;
+        Log(2, "Name index for LID units: %zu units in %d subcatchments", s_lid_names.GetCount(), subcatch_count);
     }
-    
-    Log(2, "ResolveLidIndex: Searching for '%s' among %d LID units in subcatch_idx=%d", lid_name.c_str(), lid_count, subcatch_idx);
-    
-    char name_buf[64];
-    for (int i = 0; i < lid_count; i++) {
-        swmm_getLidUName(subcatch_idx, i, name_buf, sizeof(name_buf));
-        Log(2, "  LID[%d]: '%s'", i, name_buf);
-        if (lid_name == name_buf) {
-            Log(2, "  Match found at index %d", i);
-            return i;  // Found matching LID unit
+    return s_lid_names.Find(LidKey(subcatch_idx, lid_name.data(), lid_name.size()));
+}
+
+/**
+ * @brief Check an element against a specific node or link type name
+ * @note Generic names (NODE, LINK, SUBCATCH, ...) match every element
+ */
+static bool ElementIsOfType(const std::string& ot, int obj, int idx) {
+    if (obj == swmm_NODE) {
+        int t = (int)swmm_getValue(swmm_NODE_TYPE, idx);
+        if (ot == "JUNCTION") return t == swmm_JUNCTION;
+        if (ot == "OUTFALL") return t == swmm_OUTFALL;
+        if (ot == "STORAGE") return t == swmm_STORAGE;
+        if (ot == "DIVIDER") return t == swmm_DIVIDER;
+    } else if (obj == swmm_LINK) {
+        int t = (int)swmm_getValue(swmm_LINK_TYPE, idx);
+        if (ot == "CONDUIT") return t == swmm_CONDUIT;
+        if (ot == "PUMP") return t == swmm_PUMP;
+        if (ot == "ORIFICE") return t == swmm_ORIFICE;
+        if (ot == "WEIR") return t == swmm_WEIR;
+        if (ot == "OUTLET") return t == swmm_OUTLET;
+    }
+    return true;
+}
+
+/**
+ * @brief Resolve every reference of an expression output to (property, index)
+ * @param prog Program compiled by MappingLoader
+ * @param error Receives the first unresolved reference
+ * @return false if a reference names an unknown or ambiguous element/property
+ * @note References without a TYPE: prefix are looked up as NODE, LINK and
+ *       SUBCATCH; the name must match exactly one type that has the property
+ */
+static bool ResolveExpression(ExpressionProgram& prog, std::string& error) {
+    static const char* kInferTypes[] = { "NODE", "LINK", "SUBCATCH" };
+    for (int i = 0; i < prog.GetReferenceCount(); i++) {
+        const ExpressionProgram::Reference& ref = prog.GetReference(i);
+        int prop = -1, idx = -1, matches = 0;
+        if (!ref.object_type.empty()) {
+            int obj = ObjTypeToSwmm(ref.object_type);
+            prop = OutputPropToEnum(ref.object_type, ref.property);
+            if (obj < 0 || prop < 0) {
+                error = "Unknown reference: " + ref.object_type + ":" + ref.name + "." + ref.property;
+                return false;
+            }
+            idx = FindElement(obj, ref.name);
+            matches = idx >= 0 ? 1 : 0;
+        } else {
+            for (const char* type : kInferTypes) {
+                int p = OutputPropToEnum(type, ref.property);
+                if (p < 0) continue;
+                int k = FindElement(ObjTypeToSwmm(type), ref.name);
+                if (k < 0) continue;
+                prop = p;
+                idx = k;
+                matches++;
+            }
+            if (matches > 1) {
+                error = "Ambiguous reference " + ref.name + "." + ref.property + " (use a NODE: or LINK: prefix)";
+                return false;
+            }
+        }
+        if (matches == 0) {
+            error = "Element not found: " + ref.name + "." + ref.property;
+            return false;
         }
+        prog.ResolveReference(i, prop, idx);
     }
-    
-    Log(1, "ResolveLidIndex: No match found for '%s'", lid_name.c_str());
-    return -1;  // Not found
+    return true;
+}
+
+/**
+ * @brief Write gathered output values to the log at DEBUG level
+ * @param outargs Output array filled by the output plan
+ * @note Kept out of the gather loop so the hot path has no per-output logging
+ */
+static void LogOutputs(const double* outargs) {
+    if (LogGetLevel() < LOG_LEVEL_DEBUG) return;
+    for (const auto& r : s_outputs) {
+        if (r.is_statistic) {
+            LogDebug("  Output[%d]: statistic, value=%.6f", r.iface_idx, outargs[r.iface_idx]);
+        } else if (r.is_expression) {
+            LogDebug("  Output[%d]: expression \"%s\", value=%.6f",
+                r.iface_idx, r.expression.GetText().c_str(), outargs[r.iface_idx]);
+        } else if (r.reduce >= 0) {
+            LogDebug("  Output[%d]: reduce=%d over %zu elements, prop=%d, value=%.6f",
+                r.iface_idx, r.reduce, r.members.size(), r.prop_enum, outargs[r.iface_idx]);
+        } else if (r.is_lid) {
+            LogDebug("  Output[%d]: LID getter=%d, subcatch_idx=%d, lid_idx=%d, value=%.6f",
+                r.iface_idx, (int)r.getter, r.swmm_idx, r.lid_idx, outargs[r.iface_idx]);
+        } else {
+            LogDebug("  Output[%d]: prop=%d, idx=%d, value=%.6f", r.iface_idx, r.prop_enum, r.swmm_idx, outargs[r.iface_idx]);
+        }
+    }
+}
+
+/**
+ * @brief Check whether an input value differs from the one SWMM already has
+ * @note Never-applied inputs hold NaN and always compare as changed
+ */
+static bool InputChanged(const Resolved& r, double value) {
+    if (r.tolerance < 0.0) return true;
+    return !(std::fabs(value - s_applied_inputs[r.iface_idx]) <= r.tolerance);
+}
+
+static void SetInput(const Resolved& r, double value) {
+    if (r.prop_enum >= PROPERTY_CONTROLLER) s_controllers.SetParam(r.swmm_idx, r.prop_enum - PROPERTY_CONTROLLER, value);
+    else swmm_setValue(r.prop_enum, r.swmm_idx, value);
+    s_applied_inputs[r.iface_idx] = value;
+}
+
+/**
+ * @brief Apply the inputs staged by the previous XF_CALCULATE
+ * @note Only inputs that changed since they were last applied are pushed;
+ *       when StoreInputs() saw no change at all this returns immediately
+ */
+static void ApplyInputs() {
+    if (!s_inputs_dirty) {
+        LogDebug("Inputs unchanged, nothing to apply");
+        return;
+    }
+    int applied = 0;
+    for (const auto& r : s_inputs) {
+        double v = s_pending_inputs[r.iface_idx];
+        if (r.prop_enum == PROPERTY_SKIP || !InputChanged(r, v)) continue;
+        Log(2, "  Setting input[%d]: prop=%d, idx=%d, value=%.4f", r.iface_idx, r.prop_enum, r.swmm_idx, v);
+        SetInput(r, v);
+        applied++;
+    }
+    s_inputs_dirty = false;
+    Log(2, "Applied %d of %zu inputs from previous timestep", applied, s_inputs.size());
+}
+
+/**
+ * @brief Set LINEAR inputs to their value at a fraction of the interval
+ * @param next_inputs This call's inputs (the values at the end of the interval)
+ * @param frac Position in the interval, 0 = previous call, 1 = this call
+ */
+static void ApplyLinearInputs(const double* next_inputs, double frac) {
+    for (const auto& r : s_inputs) {
+        if (r.mode != INTERP_LINEAR || r.prop_enum == PROPERTY_SKIP) continue;
+        double a = s_pending_inputs[r.iface_idx];
+        double v = a + (next_inputs[r.iface_idx] - a) * frac;
+        if (InputChanged(r, v)) SetInput(r, v);
+    }
+}
+
+/**
+ * @brief Set every preloaded series to its value for the coming routing step
+ * @param t Bridge clock at the start of the step (s)
+ * @note HOLD series take the value in effect at t, LINEAR series the value
+ *       at the middle of the step, as LINEAR GoldSim inputs do. The cursors
+ *       only move forward, so no lookup searches.
+ */
+static void ApplySeries(double t) {
+    for (size_t k = 0; k < s_series.size(); k++) {
+        InputSeries* s = s_series[k];
+        double v = s->ValueAt(s->GetInterp() == InputSeries::LINEAR ? t + 0.5 * s_route_step : t);
+        if (v == s_series_applied[k]) continue;
+        swmm_setValue(s_series_prop[k], s_series_idx[k], v);
+        s_series_applied[k] = v;
+    }
+}
+
+/**
+ * @brief Remember the watched states delivered for the interval just completed
+ */
+static void NoteFastForwardStates(const double* outputs) {
+    for (size_t k = 0; k < s_ff_slots.size(); k++) s_ff_states[k] = outputs[s_ff_slots[k]];
+}
+
+/**
+ * @brief Check whether the coming interval can be strided
+ * @param next_inputs This call's inputs, checked too when LINEAR inputs
+ *        ramp towards them (NULL in look-ahead mode)
+ * @param target Bridge clock at the end of the interval (s)
+ * @note States are the values at the start of the interval; with no
+ *       forcing they only recede, so they stay quiet to its end. Preloaded
+ *       series are known ahead, so they are checked over the whole interval.
+ */
+static bool FastForwardQuiet(const double* next_inputs, double target) {
+    const double limit = s_mapping.GetFastForward().input_threshold;
+    for (int i : s_ff_inputs) {
+        if (!(std::fabs(s_pending_inputs[i]) <= limit)) return false;
+        if (s_has_linear && next_inputs && !(std::fabs(next_inputs[i]) <= limit)) return false;
+    }
+    for (int k : s_ff_series) {
+        if (!(s_series[k]->PeakAbs(s_swmm_elapsed_sec, target) <= limit)) return false;
+    }
+    for (size_t k = 0; k < s_ff_slots.size(); k++) {
+        if (!(std::fabs(s_ff_states[k]) <= s_ff_max[k])) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Advance a quiet interval with one swmm_stride
+ * @note Outputs for the interval are the values at its end; aggregated
+ *       outputs and statistics weight them over the whole interval.
+ *       Routing steps are counted from the routing step length, which
+ *       keeps update_every schedules running.
+ */
+static int StrideInterval(double target, double* elapsed, double* dst) {
+    int seconds = (int)std::ceil(target - s_swmm_elapsed_sec - TIME_TOLERANCE);
+    if (seconds < 1) seconds = 1;
+    long long t0 = s_profiler.Begin();
+    if (!s_series.empty()) ApplySeries(s_swmm_elapsed_sec);
+    int ec = swmm_stride(seconds, elapsed);
+    s_profiler.End(Profiler::PHASE_STEP, t0);
+    Log(2, "Fast-forward: swmm_stride(%d) returned %d, elapsed=%.6f days", seconds, ec, *elapsed);
+    if (ec != 0) return ec;
+    if (*elapsed <= 0.0) return 1;  // End of the run, as in AdvanceInterval
+    *elapsed += s_time_offset_days;
+
+    const double t = *elapsed * 86400.0;
+    const double dt = t - s_swmm_elapsed_sec;
+    long steps = s_route_step > 0.0 ? (long)std::floor(dt / s_route_step + 0.5) : 1;
+    s_route_steps += steps < 1 ? 1 : steps;
+
+    t0 = s_profiler.Begin();
+    if (s_aggregator.NeedsSubsteps() || s_stats_active) {
+        double* values = s_substep_values.data();
+        s_output_plan.Gather(values, s_route_steps, t);
+        if (s_stats_active) {
+            s_stats.Update(values, *elapsed, dt);
+            s_stats.Fill(values);
+        }
+        s_aggregator.Begin();
+        s_aggregator.Accumulate(values, dt);
+        s_aggregator.Finish(values, dst);
+    } else {
+        s_output_plan.Gather(dst, s_route_steps, t);
+    }
+    s_profiler.End(Profiler::PHASE_GATHER, t0);
+
+    s_swmm_elapsed_sec = t;
+    s_interval_count++;
+    s_ff_intervals++;
+    NoteFastForwardStates(dst);
+    return 0;
+}
+
+/**
+ * @brief Apply the staged inputs and advance SWMM over one interval
+ * @param next_inputs This call's inputs, used by LINEAR interpolation (NULL in look-ahead mode)
+ * @param elapsed Receives SWMM elapsed time (days)
+ * @param dst Receives the aggregated outputs when the return code is 0
+ * @return swmm_step return code (<0 error, >0 simulation ended); a step that
+ *         returns 0 with elapsed 0 (end of run in stock SWMM) is reported as 1
+ * @note The interval is one routing step, or in GOLDSIM_TIME mode as many
+ *       routing steps as it takes to reach the next GoldSim time. Targets are
+ *       absolute, so a routing step that does not divide the GoldSim step
+ *       never accumulates drift.
+ * @note Runs on the step worker thread in look-ahead mode
+ */
+static int AdvanceInterval(const double* next_inputs, double* elapsed, double* dst) {
+    long long t0 = s_profiler.Begin();
+    ApplyInputs();
+    s_profiler.End(Profiler::PHASE_APPLY, t0);
+
+    const double t_start = s_swmm_elapsed_sec;
+    const double target = s_goldsim_time ? (double)(s_interval_count + 1) * s_interval_seconds : 0.0;
+    const double length = s_goldsim_time ? s_interval_seconds : s_route_step;
+    if (s_ff_on && FastForwardQuiet(next_inputs, target)) return StrideInterval(target, elapsed, dst);
+
+    const bool per_step = s_aggregator.NeedsSubsteps() || s_stats_active;
+    if (per_step) s_aggregator.Begin();
+
+    int ec = 0;
+    int substeps = 0;
+    do {
+        if (s_has_linear && next_inputs && length > 0.0) {
+            // Value at the middle of the coming routing step
+            double frac = (s_swmm_elapsed_sec + 0.5 * s_route_step - t_start) / length;
+            t0 = s_profiler.Begin();
+            ApplyLinearInputs(next_inputs, (std::min)(1.0, (std::max)(0.0, frac)));
+            s_profiler.End(Profiler::PHASE_APPLY, t0);
+        }
+        if (!s_series.empty()) {
+            t0 = s_profiler.Begin();
+            ApplySeries(s_swmm_elapsed_sec);
+            s_profiler.End(Profiler::PHASE_APPLY, t0);
+        }
+        if (!s_controllers.IsEmpty()) s_controllers.Update(s_swmm_elapsed_sec);
+        t0 = s_profiler.Begin();
+        ec = swmm_step(elapsed);
+        s_profiler.End(Profiler::PHASE_STEP, t0);
+        LogDebug("  swmm_step returned: %d, elapsed=%.6f days", ec, *elapsed);
+        if (ec != 0) break;
+        if (*elapsed <= 0.0) {
+            ec = 1;  // Stock SWMM reports the end of the run as 0 with elapsed 0
+            break;
+        }
+        *elapsed += s_time_offset_days;
+
+        double t = *elapsed * 86400.0;
+        s_route_steps++;
+        if (per_step) {
+            double* values = s_substep_values.data();
+            t0 = s_profiler.Begin();
+            s_output_plan.Gather(values, s_route_steps, t);
+            s_profiler.End(Profiler::PHASE_GATHER, t0);
+            if (s_stats_active) {
+                s_stats.Update(values, *elapsed, t - s_swmm_elapsed_sec);
+                s_stats.Fill(values);
+            }
+            s_aggregator.Accumulate(values, t - s_swmm_elapsed_sec);
+        }
+        s_swmm_elapsed_sec = t;
+        substeps++;
+    } while (s_goldsim_time && s_swmm_elapsed_sec < target - TIME_TOLERANCE);
+
+    Log(2, "Advanced %d routing step(s): ec=%d, elapsed=%.6f days (%.2f minutes)", substeps, ec, *elapsed, *elapsed * 1440.0);
+    if (ec != 0) return ec;
+
+    s_interval_count++;
+    if (per_step) {
+        s_aggregator.Finish(s_substep_values.data(), dst);
+    } else {
+        t0 = s_profiler.Begin();
+        s_output_plan.Gather(dst, s_route_steps, s_swmm_elapsed_sec);
+        s_profiler.End(Profiler::PHASE_GATHER, t0);
+    }
+    if (s_ff_on) NoteFastForwardStates(dst);
+    return 0;
+}
+
+/**
+ * @brief Stage this call's inputs; they are applied before the next step
+ * @note Also decides whether the next ApplyInputs() has anything to do
+ */
+static void StoreInputs(const double* inargs) {
+    bool dirty = false;
+    for (const auto& r : s_inputs) {
+        double v = inargs[r.iface_idx];
+        s_pending_inputs[r.iface_idx] = v;
+        if (r.prop_enum != PROPERTY_SKIP && InputChanged(r, v)) dirty = true;
+        LogDebug("  Stored input[%d] for next step: value=%.4f", r.iface_idx, v);
+    }
+    s_inputs_dirty = dirty;
+}
+
+/**
+ * @brief Start stepping the next interval on the worker thread
+ * @note The staged inputs are already final, so the result is identical to
+ *       stepping synchronously at the start of the next XF_CALCULATE
+ */
+static void LaunchLookAheadStep() {
+    if (s_stats_active) s_stats_consumed = s_stats;
+    s_step_worker.Submit([]() {
+        s_tracer.NameThread("Look-ahead step");
+        s_async_ec = AdvanceInterval(NULL, &s_async_elapsed, s_step_values.data());
+    });
 }
 
 static bool LoadMapping(double* outargs, int* status) {
@@ -175,324 +767,1585 @@ static bool LoadMapping(double* outargs, int* status) {
     
     // Set log level from JSON
     std::string level = s_mapping.GetLoggingLevel();
-    if (level == "DEBUG") s_log_level = 3;
-    else if (level == "INFO") s_log_level = 2;
-    else if (level == "ERROR") s_log_level = 1;
-    else if (level == "OFF" || level == "NONE") s_log_level = 0;
+    if (level == "DEBUG") LogSetLevel(LOG_LEVEL_DEBUG);
+    else if (level == "INFO") LogSetLevel(LOG_LEVEL_INFO);
+    else if (level == "ERROR") LogSetLevel(LOG_LEVEL_ERROR);
+    else if (level == "OFF" || level == "NONE") LogSetLevel(LOG_LEVEL_OFF);
     
-    Log(2, "Log level set to: %s (%d)", level.c_str(), s_log_level);
+    Log(2, "Log level set to: %s (%d)", level.c_str(), LogGetLevel());
     s_mapping_loaded = true;
     return true;
 }
 
+/**
+ * @brief Read the size and last-write time of a file
+ * @return false if the file cannot be queried
+ */
+static bool GetModelStamp(const char* path, ModelStamp* stamp) {
+    return GetFileStamp(path, &stamp->size, &stamp->write_time);
+}
+
+/**
+ * @brief Close the SWMM project and drop everything resolved against it
+ * @return swmm_close return code (0 if no project was open)
+ */
+static int CloseProject() {
+    if (!s_project_open) return 0;
+    int c = swmm_close();
+    s_project_open = false;
+    s_resolved = false;
+    s_inputs.clear();
+    s_outputs.clear();
+    for (int t = 0; t < 4; t++) {
+        s_names[t].Clear();
+        s_names_built[t] = false;
+    }
+    s_lid_names.Clear();
+    s_lid_names_built = false;
+    s_output_plan.Clear();
+    s_aggregator.Clear();
+    s_controllers.Clear();
+    return c;
+}
+
+/**
+ * @brief Append this realization's whole-run statistics to the summary file
+ * @note In look-ahead mode the step GoldSim never collected is left out
+ */
+static void WriteStatistics() {
+    const MappingLoader::StatisticsOptions& opts = s_mapping.GetStatistics();
+    if (!s_stats_active || !opts.enabled) return;
+    const OutputStats& stats = s_async_stepping ? s_stats_consumed : s_stats;
+    const std::string file = MemberPath(opts.file);
+    if (!stats.WriteSummary(file, s_stats_names, s_realization, s_stats_file_started)) {
+        Log(1, "Cannot write statistics summary: %s", file.c_str());
+        return;
+    }
+    s_stats_file_started = true;
+    Log(2, "Statistics for %d outputs over %ld steps written to %s",
+        stats.GetTrackedCount(), stats.GetSampleCount(), file.c_str());
+}
+
+/**
+ * @brief Rewrite the profile report with the totals so far
+ * @note The log drain that follows XF_CLEANUP shows up in the next report
+ */
+static void WriteProfile() {
+    if (!s_profiler.IsEnabled()) return;
+    const std::string file = MemberPath(s_mapping.GetProfile().file);
+    if (!s_profiler.WriteReport(file, s_realization)) Log(1, "Cannot write profile report: %s", file.c_str());
+    else Log(2, "Profile report written to %s", file.c_str());
+}
+
+/**
+ * @brief Write this realization's trace
+ * @note Runs after Cleanup(), when the look-ahead worker has stopped
+ */
+static void WriteTrace() {
+    if (!s_tracer.IsActive()) return;
+    s_tracer.Stop();
+    const std::string file = RealizationPath(s_mapping.GetTrace().file);
+    if (!s_tracer.Write(file)) Log(1, "Cannot write trace: %s", file.c_str());
+    else Log(2, "Trace with %lld events (%lld dropped) written to %s",
+             s_tracer.GetEventCount(), s_tracer.GetDroppedCount(), file.c_str());
+}
+
 static void Cleanup(int* status, double* outargs) {
     if (!s_swmm_running) return;
     
+    // A look-ahead step may still be running; SWMM must be idle before swmm_end
+    if (s_step_worker.IsRunning()) {
+        s_step_worker.Stop();
+        Log(2, "Look-ahead worker stopped");
+    }
+    WriteStatistics();
+    if (s_checkpoints.IsOpen()) {
+        if (!s_checkpoints.Close()) Log(1, "Checkpoint write failed: %s", s_checkpoints.GetLastError().c_str());
+        else if (s_checkpoints.GetCommittedCount() > 0) Log(2, "%d checkpoint(s) kept for resuming", s_checkpoints.GetCommittedCount());
+    }
+    if (s_ff_on) Log(2, "Fast-forward: %ld of %ld intervals strided", s_ff_intervals, s_interval_count);
+    if (s_recorder.IsOpen()) {
+        long long rows = s_recorder.GetRowCount();
+        if (s_recorder.Close()) Log(2, "Recording closed: %lld rows", rows);
+        else Log(1, "Recording incomplete: a write failed");
+    }
+    
+    ProfileScope scope(s_profiler, Profiler::PHASE_CLEANUP);
     int e = swmm_end();
-    int c = swmm_close();
+    int c = 0;
     s_swmm_running = false;
     s_first_calculate = true;
-    s_inputs.clear();
-    s_outputs.clear();
     s_pending_inputs.clear();
+    s_applied_inputs.clear();
+    
+    // Recycling keeps the project and its resolved indices for the next
+    // realization; anything that went wrong closes it for a clean reopen
+    if (s_recycle && s_resolved && e == 0 && *status == XF_SUCCESS) {
+        Log(2, "Project kept open for the next realization");
+    } else {
+        c = CloseProject();
+    }
     if (e != 0 && *status == XF_SUCCESS) HandleSwmmError(outargs, status);
     else if (c != 0 && *status == XF_SUCCESS) HandleSwmmError(outargs, status);
+    if (s_telemetry.GetState() == Telemetry::STATE_RUNNING) {
+        s_telemetry.SetState(*status == XF_SUCCESS ? Telemetry::STATE_ENDED : Telemetry::STATE_FAILED);
+    }
 }
 
-extern "C" void __declspec(dllexport) SwmmGoldSimBridge(int methodID, int* status, double* inargs, double* outargs) {
-    *status = XF_SUCCESS;
-    Log(2, "=== Method called: %d ===", methodID);
+/**
+ * @brief Configure whole-run statistics for the resolved outputs
+ * @return false on failure (SWMM has been cleaned up and the error set)
+ * @note Every output except STATISTIC ones is tracked when the summary file
+ *       is on or any STATISTIC output is mapped
+ */
+static bool ResolveStatistics(int* status, double* outargs) {
+    const MappingLoader::StatisticsOptions& opts = s_mapping.GetStatistics();
+    const std::vector<MappingLoader::OutputMapping>& outs = s_mapping.GetOutputs();
+    s_stats.Clear();
+    s_stats_names.clear();
+    s_stats_active = false;
 
-    switch (methodID) {
-    case XF_REP_VERSION:
-        Log(2, "XF_REP_VERSION called");
-        outargs[0] = DLL_VERSION;
-        Log(2, "XF_REP_VERSION returning: %.1f", DLL_VERSION);
-        break;
+    bool wanted = opts.enabled;
+    for (const auto& out : outs) {
+        if (out.object_type == "STATISTIC") wanted = true;
+    }
+    if (!wanted) return true;
 
-    case XF_REP_ARGUMENTS:
-        Log(2, "XF_REP_ARGUMENTS called");
-        if (!LoadMapping(outargs, status)) {
-            Log(1, "XF_REP_ARGUMENTS: LoadMapping failed");
-            break;
+    std::vector<int> tracked(outs.size(), -1);
+    for (size_t i = 0; i < outs.size(); i++) {
+        if (outs[i].object_type == "STATISTIC") continue;
+        tracked[i] = s_stats.Track(outs[i].interface_index, outs[i].exceed_threshold);
+        s_stats_names.push_back(outs[i].name);
+    }
+    for (double p : opts.quantiles) s_stats.AddQuantile(p);
+
+    for (const auto& out : outs) {
+        if (out.object_type != "STATISTIC") continue;
+        double p = 0.0;
+        int stat = StatNameToStat(out.property, &p);
+        if (stat < 0) {
+            sprintf_s(s_error_buf, "Unknown statistic: %s (output %s)", out.property.c_str(), out.name.c_str());
+            Log(1, "%s", s_error_buf);
+            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
         }
-        outargs[0] = (double)s_mapping.GetInputCount();
-        outargs[1] = (double)s_mapping.GetOutputCount();
-        Log(2, "REP_ARGUMENTS: %d inputs, %d outputs", s_mapping.GetInputCount(), s_mapping.GetOutputCount());
-        break;
+        int source = -1, matches = 0;
+        for (size_t i = 0; i < outs.size(); i++) {
+            if (tracked[i] >= 0 && outs[i].name == out.source) { source = tracked[i]; matches++; }
+        }
+        if (matches != 1) {
+            sprintf_s(s_error_buf, "%s statistic source: %s (output %s)",
+                matches == 0 ? "Unknown" : "Ambiguous", out.source.c_str(), out.name.c_str());
+            Log(1, "%s", s_error_buf);
+            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+        }
+        int quantile = (stat == OutputStats::STAT_QUANTILE) ? s_stats.AddQuantile(p) : 0;
+        s_stats.AddOutput(out.interface_index, source, (OutputStats::Stat)stat, quantile);
+        Log(2, "  Output[%d]: %s of %s", out.interface_index, out.property.c_str(), out.source.c_str());
+    }
+    s_stats_active = true;
+    Log(2, "Statistics: %d outputs tracked, %d quantiles, summary %s",
+        s_stats.GetTrackedCount(), s_stats.GetQuantileCount(), opts.enabled ? opts.file.c_str() : "off");
+    return true;
+}
 
-    case XF_INITIALIZE:
-        {
-            Log(2, "XF_INITIALIZE called");
-            if (s_swmm_running) { 
-                Log(2, "SWMM already running, cleaning up first");
-                Cleanup(status, outargs); 
-                if (*status != XF_SUCCESS) {
-                    Log(1, "Cleanup failed during re-initialization");
-                    break;
-                }
+/**
+ * @brief Resolve controller sensors and actuators and fill the controller bank
+ * @return false on failure (SWMM has been cleaned up and the error set)
+ */
+static bool ResolveControllers(int* status, double* outargs) {
+    Log(2, "Resolving %zu controllers", s_mapping.GetControllers().size());
+    s_controllers.Clear();
+    for (const auto& c : s_mapping.GetControllers()) {
+        ControllerBank::Definition def;
+        def.type = ControllerTypeFromName(c.type);
+        int sensor_obj = ObjTypeToSwmm(c.sensor_type);
+        def.sensor_prop = OutputPropToEnum(c.sensor_type, c.sensor_property);
+        if (sensor_obj < 0 || def.sensor_prop < 0) {
+            sprintf_s(s_error_buf, "Unknown controller sensor: %s/%s (controller %s)", c.sensor_type.c_str(), c.sensor_property.c_str(), c.name.c_str());
+            Log(1, "%s", s_error_buf);
+            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+        }
+        def.sensor_index = FindElement(sensor_obj, c.sensor);
+        if (def.sensor_index < 0) {
+            sprintf_s(s_error_buf, "Element not found: %s (controller %s)", c.sensor.c_str(), c.name.c_str());
+            Log(1, "%s", s_error_buf);
+            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+        }
+        if (InputPropToEnum(c.actuator_type, "SETTING") != swmm_LINK_SETTING) {
+            sprintf_s(s_error_buf, "Controller actuator must be a PUMP, ORIFICE, WEIR or LINK: %s (controller %s)", c.actuator_type.c_str(), c.name.c_str());
+            Log(1, "%s", s_error_buf);
+            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+        }
+        def.actuator_index = FindElement(swmm_LINK, c.actuator);
+        if (def.actuator_index < 0) {
+            sprintf_s(s_error_buf, "Element not found: %s (controller %s)", c.actuator.c_str(), c.name.c_str());
+            Log(1, "%s", s_error_buf);
+            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+        }
+        def.setpoint = c.setpoint;
+        def.kp = c.kp;
+        def.ki = c.ki;
+        def.kd = c.kd;
+        def.min_setting = c.min_setting;
+        def.max_setting = c.max_setting;
+        def.on_level = c.on_level;
+        def.off_level = c.off_level;
+        def.on_setting = c.on_setting;
+        def.off_setting = c.off_setting;
+        for (size_t i = 0; i + 1 < c.table.size(); i += 2) {
+            def.table_x.push_back(c.table[i]);
+            def.table_y.push_back(c.table[i + 1]);
+        }
+        def.table_step = (c.interpolate == "STEP");
+        int slot = s_controllers.Add(def);
+        Log(2, "  Controller[%d]: %s %s, sensor prop=%d idx=%d, actuator idx=%d", slot, c.name.c_str(), c.type.c_str(),
+            def.sensor_prop, def.sensor_index, def.actuator_index);
+    }
+    return true;
+}
+
+/**
+ * @brief Resolve a CONTROLLER input to its controller slot and parameter
+ * @return false if the controller or parameter does not exist
+ */
+static bool ResolveControllerInput(const MappingLoader::InputMapping& inp, int* prop, int* slot) {
+    const std::vector<MappingLoader::ControllerMapping>& ctrls = s_mapping.GetControllers();
+    for (size_t i = 0; i < ctrls.size(); i++) {
+        if (ctrls[i].name != inp.name) continue;
+        int param = ControllerParamFromName(ControllerTypeFromName(ctrls[i].type), inp.property);
+        if (param < 0) return false;
+        *prop = PROPERTY_CONTROLLER + param;
+        *slot = (int)i;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Resolve mapped names to SWMM indices and compile the output plan
+ * @return false on failure (SWMM has been cleaned up and the error set)
+ * @note Needs an open, started project. The result stays valid for as long
+ *       as the project is open, so recycled realizations skip this.
+ */
+static bool ResolveMapping(int* status, double* outargs) {
+    if (!ResolveControllers(status, outargs)) return false;
+
+    // Resolve inputs
+    Log(2, "Resolving %d inputs", s_mapping.GetInputCount());
+    s_inputs.clear();
+    for (const auto& inp : s_mapping.GetInputs()) {
+        Log(2, "  Input[%d]: %s (%s/%s)", inp.interface_index, inp.name.c_str(), inp.object_type.c_str(), inp.property.c_str());
+        int interp = INTERP_HOLD;
+        if (inp.interpolate == "LINEAR") interp = INTERP_LINEAR;
+        else if (!inp.interpolate.empty() && inp.interpolate != "HOLD") {
+            sprintf_s(s_error_buf, "Unknown interpolate: %s (input %s)", inp.interpolate.c_str(), inp.name.c_str());
+            Log(1, "%s", s_error_buf);
+            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+        }
+        if (inp.object_type == "CONTROLLER") {
+            int prop = 0, slot = 0;
+            if (!ResolveControllerInput(inp, &prop, &slot)) {
+                sprintf_s(s_error_buf, "Unknown controller input: %s/%s", inp.name.c_str(), inp.property.c_str());
+                Log(1, "%s", s_error_buf);
+                Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
             }
-            
-            if (!LoadMapping(outargs, status)) {
-                Log(1, "XF_INITIALIZE: LoadMapping failed");
-                break;
+            Log(2, "    Resolved: controller slot=%d, param=%d", slot, prop - PROPERTY_CONTROLLER);
+            s_inputs.push_back(Resolved(inp.interface_index, prop, slot, interp));
+            s_inputs.back().tolerance = inp.tolerance;
+            continue;
+        }
+        int obj = ObjTypeToSwmm(inp.object_type);
+        int prop = InputPropToEnum(inp.object_type, inp.property);
+        
+        // PROPERTY_SKIP is valid (for SYSTEM/ELAPSEDTIME)
+        if (obj < 0 || (prop < 0 && prop != PROPERTY_SKIP)) {
+            sprintf_s(s_error_buf, "Unknown input: %s/%s", inp.object_type.c_str(), inp.property.c_str());
+            Log(1, "%s", s_error_buf);
+            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+        }
+        
+        int idx = (inp.object_type == "SYSTEM") ? 0 : FindElement(obj, inp.name);
+        if (inp.object_type != "SYSTEM" && idx < 0) {
+            sprintf_s(s_error_buf, "Element not found: %s", inp.name.c_str());
+            Log(1, "%s", s_error_buf);
+            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+        }
+        Log(2, "    Resolved: obj=%d, prop=%d, idx=%d, interpolate=%d, tolerance=%g", obj, prop, idx, interp, inp.tolerance);
+        for (const auto& c : s_mapping.GetControllers()) {
+            if (prop == swmm_LINK_SETTING && c.actuator == inp.name) {
+                sprintf_s(s_error_buf, "Input %s sets a link driven by controller %s", inp.name.c_str(), c.name.c_str());
+                Log(1, "%s", s_error_buf);
+                Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
             }
-            Log(2, "Mapping loaded successfully");
+        }
+        s_inputs.push_back(Resolved(inp.interface_index, prop, idx, interp));
+        s_inputs.back().tolerance = inp.tolerance;
+    }
+
+    // Resolve preloaded series inputs (the files are already loaded)
+    const std::vector<MappingLoader::SeriesInputMapping>& series = s_mapping.GetSeriesInputs();
+    s_series_prop.assign(series.size(), -1);
+    s_series_idx.assign(series.size(), -1);
+    for (size_t k = 0; k < series.size(); k++) {
+        const MappingLoader::SeriesInputMapping& s = series[k];
+        int obj = ObjTypeToSwmm(s.object_type);
+        int prop = InputPropToEnum(s.object_type, s.property);
+        if (obj < 0 || prop < 0) {
+            sprintf_s(s_error_buf, "Unknown timeseries input: %s/%s", s.object_type.c_str(), s.property.c_str());
+            Log(1, "%s", s_error_buf);
+            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+        }
+        int idx = FindElement(obj, s.name);
+        if (idx < 0) {
+            sprintf_s(s_error_buf, "Element not found: %s (timeseries input)", s.name.c_str());
+            Log(1, "%s", s_error_buf);
+            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+        }
+        for (const auto& c : s_mapping.GetControllers()) {
+            if (prop == swmm_LINK_SETTING && c.actuator == s.name) {
+                sprintf_s(s_error_buf, "Timeseries input %s sets a link driven by controller %s", s.name.c_str(), c.name.c_str());
+                Log(1, "%s", s_error_buf);
+                Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+            }
+        }
+        s_series_prop[k] = prop;
+        s_series_idx[k] = idx;
+        Log(2, "  Series input %s (%s/%s): prop=%d, idx=%d, %zu rows from %s",
+            s.name.c_str(), s.object_type.c_str(), s.property.c_str(), prop, idx, s_series[k]->GetRowCount(), s.file.c_str());
+    }
 
-            // Open SWMM
-            Log(2, "Opening SWMM model: model.inp");
-            int open_err = swmm_open("model.inp", "model.rpt", "model.out");
-            if (open_err != 0) { 
-                Log(1, "swmm_open failed with error: %d", open_err);
-                HandleSwmmError(outargs, status); 
-                break; 
+    // Resolve outputs
+    Log(2, "Resolving %d outputs", s_mapping.GetOutputCount());
+    s_outputs.clear();
+    for (const auto& out : s_mapping.GetOutputs()) {
+        Log(2, "  Output[%d]: %s (%s/%s)", out.interface_index, out.name.c_str(), out.object_type.c_str(), out.property.c_str());
+        
+        int aggregate = AggregateNameToMode(out.aggregate);
+        if (aggregate < 0) {
+            sprintf_s(s_error_buf, "Unknown aggregate: %s (output %s)", out.aggregate.c_str(), out.name.c_str());
+            Log(1, "%s", s_error_buf);
+            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+        }
+        
+        // Whole-run statistic of another output, configured below
+        if (out.object_type == "STATISTIC") {
+            Resolved r(out.interface_index, -1, -1, aggregate);
+            r.is_statistic = true;
+            s_outputs.push_back(r);
+            continue;
+        }
+        
+        // Expression over element properties, compiled by MappingLoader
+        if (out.object_type == "EXPRESSION") {
+            Resolved r(out.interface_index, -1, -1, aggregate);
+            r.is_expression = true;
+            r.expression = out.program;
+            std::string err;
+            if (!ResolveExpression(r.expression, err)) {
+                sprintf_s(s_error_buf, "%s (output %s)", err.c_str(), out.name.c_str());
+                Log(1, "%s", s_error_buf);
+                Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
             }
-            Log(2, "swmm_open succeeded");
-            
-            Log(2, "Starting SWMM simulation");
-            int start_err = swmm_start(1);
-            if (start_err != 0) { 
-                Log(1, "swmm_start failed with error: %d", start_err);
-                swmm_close(); 
-                HandleSwmmError(outargs, status); 
-                break; 
+            Log(2, "    Resolved expression: %d references, %d instructions",
+                r.expression.GetReferenceCount(), r.expression.GetInstructionCount());
+            s_outputs.push_back(r);
+            continue;
+        }
+        
+        // Reduction over an element list, or over every element of the type
+        if (!out.reduce.empty()) {
+            int op = ReduceNameToOp(out.reduce);
+            int obj = ObjTypeToSwmm(out.object_type);
+            int prop = OutputPropToEnum(out.object_type, out.property);
+            if (op < 0) {
+                sprintf_s(s_error_buf, "Unknown reduce: %s (output %s)", out.reduce.c_str(), out.name.c_str());
+                Log(1, "%s", s_error_buf);
+                Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
             }
-            Log(2, "swmm_start succeeded");
-
-            // Resolve inputs
-            Log(2, "Resolving %d inputs", s_mapping.GetInputCount());
-            s_inputs.clear();
-            for (const auto& inp : s_mapping.GetInputs()) {
-                Log(2, "  Input[%d]: %s (%s/%s)", inp.interface_index, inp.name.c_str(), inp.object_type.c_str(), inp.property.c_str());
-                int obj = ObjTypeToSwmm(inp.object_type);
-                int prop = InputPropToEnum(inp.object_type, inp.property);
-                
-                // PROPERTY_SKIP is valid (for SYSTEM/ELAPSEDTIME)
-                if (obj < 0 || (prop < 0 && prop != PROPERTY_SKIP)) {
-                    sprintf_s(s_error_buf, "Unknown input: %s/%s", inp.object_type.c_str(), inp.property.c_str());
-                    Log(1, "%s", s_error_buf);
-                    Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return;
+            if (obj < 0 || prop < 0) {
+                sprintf_s(s_error_buf, "Unknown output: %s/%s", out.object_type.c_str(), out.property.c_str());
+                Log(1, "%s", s_error_buf);
+                Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+            }
+            Resolved r(out.interface_index, prop, -1, aggregate);
+            r.reduce = op;
+            r.threshold = out.threshold;
+            if (out.elements.empty()) {
+                int count = swmm_getCount(obj);
+                for (int i = 0; i < count; i++) {
+                    if (ElementIsOfType(out.object_type, obj, i)) r.members.push_back(i);
                 }
-                
-                int idx = (inp.object_type == "SYSTEM") ? 0 : swmm_getIndex((swmm_Object)obj, inp.name.c_str());
-                if (inp.object_type != "SYSTEM" && idx < 0) {
-                    sprintf_s(s_error_buf, "Element not found: %s", inp.name.c_str());
-                    Log(1, "%s", s_error_buf);
-                    Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return;
+            } else {
+                for (const auto& name : out.elements) {
+                    int idx = FindElement(obj, name);
+                    if (idx < 0) {
+                        sprintf_s(s_error_buf, "Element not found: %s (output %s)", name.c_str(), out.name.c_str());
+                        Log(1, "%s", s_error_buf);
+                        Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+                    }
+                    r.members.push_back(idx);
                 }
-                Log(2, "    Resolved: obj=%d, prop=%d, idx=%d", obj, prop, idx);
-                s_inputs.push_back({ inp.interface_index, prop, idx });
             }
-
-            // Resolve outputs
-            Log(2, "Resolving %d outputs", s_mapping.GetOutputCount());
-            s_outputs.clear();
-            for (const auto& out : s_mapping.GetOutputs()) {
-                Log(2, "  Output[%d]: %s (%s/%s)", out.interface_index, out.name.c_str(), out.object_type.c_str(), out.property.c_str());
-                
-                // Check if this is an LID output (either by object_type or composite ID)
-                std::string subcatch_name, lid_name;
-                bool is_lid_output = (out.object_type == "LID") || ParseCompositeID(out.name, subcatch_name, lid_name);
-                
-                if (is_lid_output) {
-                    // This is an LID output
-                    // If object_type is "LID" but name isn't composite, parse it now
-                    if (out.object_type == "LID" && subcatch_name.empty()) {
-                        if (!ParseCompositeID(out.name, subcatch_name, lid_name)) {
-                            sprintf_s(s_error_buf, "LID output must use composite ID format 'Subcatchment/LIDControl': %s", out.name.c_str());
-                            Log(1, "%s", s_error_buf);
-                            Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return;
-                        }
-                    }
-                    
-                    Log(2, "    Detected LID output: subcatch='%s', lid='%s'", subcatch_name.c_str(), lid_name.c_str());
-                    
-                    // Resolve subcatchment index
-                    int subcatch_idx = swmm_getIndex(swmm_SUBCATCH, subcatch_name.c_str());
-                    if (subcatch_idx < 0) {
-                        sprintf_s(s_error_buf, "Subcatchment not found in composite ID: %s", out.name.c_str());
-                        Log(1, "%s", s_error_buf);
-                        Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return;
-                    }
-                    
-                    // Debug: Check LID count for this subcatchment
-                    int lid_count = swmm_getLidUCount(subcatch_idx);
-                    Log(2, "    Subcatchment '%s' (idx=%d) has %d LID units", subcatch_name.c_str(), subcatch_idx, lid_count);
-                    
-                    // Resolve LID unit index
-                    int lid_idx = ResolveLidIndex(subcatch_idx, lid_name);
-                    if (lid_idx < 0) {
-                        sprintf_s(s_error_buf, "LID unit not found in composite ID: %s (subcatch has %d LID units)", out.name.c_str(), lid_count);
-                        Log(1, "%s", s_error_buf);
-                        Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return;
-                    }
-                    
-                    Log(2, "    Resolved LID: subcatch_idx=%d, lid_idx=%d, property=%s", subcatch_idx, lid_idx, out.property.c_str());
-                    s_outputs.push_back(Resolved::CreateLidOutput(out.interface_index, subcatch_idx, lid_idx, out.property));
-                } else {
-                    // Regular (non-LID) output - use existing logic
-                    int obj = ObjTypeToSwmm(out.object_type);
-                    int prop = OutputPropToEnum(out.object_type, out.property);
-                    if (obj < 0 || prop < 0) {
-                        sprintf_s(s_error_buf, "Unknown output: %s/%s", out.object_type.c_str(), out.property.c_str());
-                        Log(1, "%s", s_error_buf);
-                        Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return;
-                    }
-                    int idx = swmm_getIndex((swmm_Object)obj, out.name.c_str());
-                    if (idx < 0) {
-                        sprintf_s(s_error_buf, "Element not found: %s", out.name.c_str());
-                        Log(1, "%s", s_error_buf);
-                        Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return;
-                    }
-                    Log(2, "    Resolved: obj=%d, prop=%d, idx=%d", obj, prop, idx);
-                    s_outputs.push_back(Resolved(out.interface_index, prop, idx));
+            Log(2, "    Resolved reduction: op=%d, prop=%d, %zu elements", op, prop, r.members.size());
+            s_outputs.push_back(r);
+            continue;
+        }
+        
+        // Check if this is an LID output (either by object_type or composite ID)
+        std::string subcatch_name, lid_name;
+        bool is_lid_output = (out.object_type == "LID") || ParseCompositeID(out.name, subcatch_name, lid_name);
+        
+        if (is_lid_output) {
+            // This is an LID output
+            // If object_type is "LID" but name isn't composite, parse it now
+            if (out.object_type == "LID" && subcatch_name.empty()) {
+                if (!ParseCompositeID(out.name, subcatch_name, lid_name)) {
+                    sprintf_s(s_error_buf, "LID output must use composite ID format 'Subcatchment/LIDControl': %s", out.name.c_str());
+                    Log(1, "%s", s_error_buf);
+                    Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
                 }
             }
+            
+            Log(2, "    Detected LID output: subcatch='%s', lid='%s'", subcatch_name.c_str(), lid_name.c_str());
+            
+            int getter = LidPropertyToGetter(out.property);
+            if (getter < 0) {
+                sprintf_s(s_error_buf, "Unknown LID property: %s", out.property.c_str());
+                Log(1, "%s", s_error_buf);
+                Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+            }
+            
+            // Resolve subcatchment index
+            int subcatch_idx = FindElement(swmm_SUBCATCH, subcatch_name);
+            if (subcatch_idx < 0) {
+                sprintf_s(s_error_buf, "Subcatchment not found in composite ID: %s", out.name.c_str());
+                Log(1, "%s", s_error_buf);
+                Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+            }
+            
+            // Resolve LID unit index
+            int lid_idx = ResolveLidIndex(subcatch_idx, lid_name);
+            if (lid_idx < 0) {
+                int lid_count = swmm_getLidUCount(subcatch_idx);
+                sprintf_s(s_error_buf, "LID unit not found in composite ID: %s (subcatch has %d LID units)", out.name.c_str(), lid_count);
+                Log(1, "%s", s_error_buf);
+                Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+            }
+            
+            Log(2, "    Resolved LID: subcatch_idx=%d, lid_idx=%d, property=%s", subcatch_idx, lid_idx, out.property.c_str());
+            s_outputs.push_back(Resolved::CreateLidOutput(out.interface_index, subcatch_idx, lid_idx, (OutputPlan::Getter)getter));
+            s_outputs.back().mode = aggregate;
+            s_outputs.back().update_steps = out.update_every;
+            s_outputs.back().update_seconds = out.update_every_seconds;
+        } else {
+            // Regular (non-LID) output - use existing logic
+            int obj = ObjTypeToSwmm(out.object_type);
+            int prop = OutputPropToEnum(out.object_type, out.property);
+            if (obj < 0 || prop < 0) {
+                sprintf_s(s_error_buf, "Unknown output: %s/%s", out.object_type.c_str(), out.property.c_str());
+                Log(1, "%s", s_error_buf);
+                Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+            }
+            int idx = FindElement(obj, out.name);
+            if (idx < 0) {
+                sprintf_s(s_error_buf, "Element not found: %s", out.name.c_str());
+                Log(1, "%s", s_error_buf);
+                Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+            }
+            Log(2, "    Resolved: obj=%d, prop=%d, idx=%d", obj, prop, idx);
+            s_outputs.push_back(Resolved(out.interface_index, prop, idx, aggregate));
+            s_outputs.back().update_steps = out.update_every;
+            s_outputs.back().update_seconds = out.update_every_seconds;
+        }
+    }
 
-            s_swmm_running = true;
-            s_first_calculate = true;
-            s_pending_inputs.clear();
-            s_pending_inputs.resize(s_mapping.GetInputCount(), 0.0);
-            Log(2, "INITIALIZE complete: %zu inputs, %zu outputs resolved", s_inputs.size(), s_outputs.size());
+    // Compile outputs into per-getter tables for the per-step gather
+    s_output_plan.Clear();
+    for (const auto& r : s_outputs) {
+        if (r.is_statistic) {
+            continue;
+        } else if (r.is_expression) {
+            s_output_plan.AddExpression(r.expression, r.iface_idx);
+        } else if (r.reduce >= 0) {
+            int group = s_output_plan.AddReduction((OutputPlan::Reduce)r.reduce, r.threshold, r.iface_idx);
+            for (int m : r.members) s_output_plan.AddMember(group, OutputPlan::GET_VALUE, r.prop_enum, m, -1);
+        } else {
+            s_output_plan.Add(r.getter, r.prop_enum, r.swmm_idx, r.lid_idx, r.iface_idx, r.update_steps, r.update_seconds);
         }
-        break;
+    }
+    s_output_plan.Compile();
+    Log(2, "Output plan compiled: %d outputs (%d reduced/referenced values) in %d tables, %d update schedules",
+        s_output_plan.GetOutputCount(), s_output_plan.GetMemberCount(), s_output_plan.GetTableCount(),
+        s_output_plan.GetCadenceCount());
 
-    case XF_CALCULATE:
-        {
-            Log(2, "XF_CALCULATE called");
-            if (!s_swmm_running) { 
-                Log(1, "XF_CALCULATE called but SWMM not running!");
-                *status = XF_FAILURE; 
-                break; 
-            }
+    if (!ResolveStatistics(status, outargs)) return false;
 
-            // On first call, we need to get initial outputs before any stepping
-            if (s_first_calculate) {
-                Log(2, "First calculate - getting initial outputs and storing inputs for next step");
-                
-                // Get initial outputs (before any stepping)
-                Log(2, "Getting %zu initial outputs", s_outputs.size());
-                for (const auto& r : s_outputs) {
-                    double val;
-                    if (r.is_lid) {
-                        // LID output - use appropriate API based on property
-                        if (r.lid_property == "STORAGE_VOLUME") {
-                            val = swmm_getLidUStorageVolume(r.swmm_idx, r.lid_idx);
-                            Log(3, "  Output[%d]: LID storage volume, subcatch_idx=%d, lid_idx=%d, value=%.6f", 
-                                r.iface_idx, r.swmm_idx, r.lid_idx, val);
-                        } else if (r.lid_property == "SURFACE_OUTFLOW") {
-                            val = swmm_getLidUSurfaceOutflow(r.swmm_idx, r.lid_idx);
-                            Log(3, "  Output[%d]: LID surface outflow, subcatch_idx=%d, lid_idx=%d, value=%.6f", 
-                                r.iface_idx, r.swmm_idx, r.lid_idx, val);
-                        } else if (r.lid_property == "SURFACE_INFLOW") {
-                            val = swmm_getLidUSurfaceInflow(r.swmm_idx, r.lid_idx);
-                            Log(3, "  Output[%d]: LID surface inflow, subcatch_idx=%d, lid_idx=%d, value=%.6f", 
-                                r.iface_idx, r.swmm_idx, r.lid_idx, val);
-                        } else if (r.lid_property == "DRAIN_FLOW") {
-                            val = swmm_getLidUDrainFlow(r.swmm_idx, r.lid_idx);
-                            Log(3, "  Output[%d]: LID drain flow, subcatch_idx=%d, lid_idx=%d, value=%.6f", 
-                                r.iface_idx, r.swmm_idx, r.lid_idx, val);
-                        } else {
-                            Log(1, "Unknown LID property: %s", r.lid_property.c_str());
-                            val = 0.0;
-                        }
-                    } else {
-                        // Regular output - use existing API
-                        val = swmm_getValue(r.prop_enum, r.swmm_idx);
-                        Log(3, "  Output[%d]: prop=%d, idx=%d, value=%.6f", r.iface_idx, r.prop_enum, r.swmm_idx, val);
-                    }
-                    outargs[r.iface_idx] = val;
-                }
-                
-                // Store the inputs for the next timestep
-                for (const auto& r : s_inputs) {
-                    s_pending_inputs[r.iface_idx] = inargs[r.iface_idx];
-                    Log(2, "  Stored input[%d] for next step: value=%.4f", r.iface_idx, inargs[r.iface_idx]);
-                }
-                
-                s_first_calculate = false;
-                Log(2, "XF_CALCULATE complete (first call)");
-                break;
+    // Interval stepping and per-output aggregation
+    const MappingLoader::SteppingOptions& stepping = s_mapping.GetStepping();
+    s_aggregator.Clear();
+    for (const auto& r : s_outputs) {
+        s_aggregator.SetMode(r.iface_idx, (OutputAggregator::Mode)r.mode);
+    }
+    s_slot_count = 0;
+    for (const auto& r : s_outputs) {
+        if (r.iface_idx + 1 > s_slot_count) s_slot_count = r.iface_idx + 1;
+    }
+    s_substep_values.assign(s_slot_count, 0.0);
+    s_has_linear = false;
+    for (const auto& r : s_inputs) {
+        if (r.mode == INTERP_LINEAR) s_has_linear = true;
+    }
+    if (s_has_linear && stepping.async) {
+        // Look-ahead steps before this call's inputs are known
+        Cleanup(status, outargs);
+        SetError(outargs, status, "LINEAR input interpolation cannot be combined with stepping.async");
+        return false;
+    }
+    s_goldsim_time = (stepping.mode == "GOLDSIM_TIME");
+    s_interval_seconds = stepping.timestep_seconds;
+    s_route_step = swmm_getValue(swmm_ROUTESTEP, 0);
+    Log(2, "Stepping: mode=%s, interval=%.1f s, routing step=%.1f s, per-step aggregation=%d",
+        stepping.mode.c_str(), s_interval_seconds, s_route_step, (int)s_aggregator.NeedsSubsteps());
+    return true;
+}
+
+/**
+ * @brief Create this realization's recording when the recorder is enabled
+ * @return false if the file cannot be created (error text in s_error_buf)
+ */
+static bool StartRecording() {
+    const MappingLoader::RecorderOptions& opts = s_mapping.GetRecorder();
+    if (!opts.enabled) return true;
+
+    std::vector<Recorder::Column> columns;
+    for (const auto& out : s_mapping.GetOutputs()) {
+        Recorder::Column c;
+        c.name = out.name;
+        c.kind = Recorder::COLUMN_OUTPUT;
+        c.index = out.interface_index;
+        columns.push_back(c);
+    }
+    if (opts.inputs) {
+        for (const auto& inp : s_mapping.GetInputs()) {
+            Recorder::Column c;
+            c.name = inp.name;
+            c.kind = Recorder::COLUMN_INPUT;
+            c.index = inp.interface_index;
+            columns.push_back(c);
+        }
+    }
+
+    std::string path;
+    if (!opts.dir.empty()) {
+        MakeDirectory(opts.dir);
+        path = opts.dir;
+        if (path[path.size() - 1] != '\\' && path[path.size() - 1] != '/') path += PATH_SEP;
+    }
+    char name[64];
+    sprintf_s(name, "realization_%d.gsr", s_realization);
+    path = MemberPath(path + name);
+
+    std::string err;
+    if (!s_recorder.Open(path, columns, opts.chunk_rows, err)) {
+        sprintf_s(s_error_buf, "%s", err.c_str());
+        Log(1, "%s", s_error_buf);
+        return false;
+    }
+    Log(2, "Recording %zu columns to %s", columns.size(), path.c_str());
+    return true;
+}
+
+/**
+ * @brief Mark a mapped element in the per-type keep sets of
+ *        ClearUnmappedReportFlags
+ * @param type Mapping object type; "" looks the name up as every type
+ */
+static void KeepReported(std::vector<char>* keep, const std::string& type, const std::string& name) {
+    static const int kTypes[3] = { swmm_SUBCATCH, swmm_NODE, swmm_LINK };
+    int obj = type.empty() ? -1 : ObjTypeToSwmm(type);
+    for (int t = 0; t < 3; t++) {
+        if (!type.empty() && obj != kTypes[t]) continue;
+        int idx = FindElement(kTypes[t], name);
+        if (idx >= 0) keep[t][idx] = 1;
+    }
+}
+
+/**
+ * @brief Clear RPTFLAG on every subcatchment, node and link the mapping does
+ *        not name, so SWMM keeps no results for them (minimal_io)
+ * @note Must run between swmm_open and swmm_start. Only affects what SWMM
+ *       writes; values read through the API are unchanged. Names resolve
+ *       through FindElement, so they match as SWMM matches them.
+ */
+static void ClearUnmappedReportFlags() {
+    static const int kTypes[3] = { swmm_SUBCATCH, swmm_NODE, swmm_LINK };
+    static const int kFlags[3] = { swmm_SUBCATCH_RPTFLAG, swmm_NODE_RPTFLAG, swmm_LINK_RPTFLAG };
+    std::vector<char> keep[3];
+    for (int t = 0; t < 3; t++) keep[t].assign((size_t)(std::max)(swmm_getCount(kTypes[t]), 0), 0);
+
+    std::string subcatch_name, lid_name;
+    for (const auto& inp : s_mapping.GetInputs()) {
+        if (ObjTypeToSwmm(inp.object_type) >= 0) KeepReported(keep, inp.object_type, inp.name);
+    }
+    for (const auto& ser : s_mapping.GetSeriesInputs()) KeepReported(keep, ser.object_type, ser.name);
+    for (const auto& out : s_mapping.GetOutputs()) {
+        if (ParseCompositeID(out.name, subcatch_name, lid_name)) {
+            KeepReported(keep, "SUBCATCH", subcatch_name);
+        } else if (out.object_type == "EXPRESSION") {
+            for (int i = 0; i < out.program.GetReferenceCount(); i++) {
+                const ExpressionProgram::Reference& ref = out.program.GetReference(i);
+                KeepReported(keep, ref.object_type, ref.name);
             }
+        } else if (!out.reduce.empty() && out.elements.empty()) {
+            // Reduction over every element of the type
+            int obj = ObjTypeToSwmm(out.object_type);
+            for (int t = 0; t < 3; t++) {
+                if (kTypes[t] == obj) std::fill(keep[t].begin(), keep[t].end(), 1);
+            }
+        } else if (!out.reduce.empty()) {
+            for (const auto& name : out.elements) KeepReported(keep, out.object_type, name);
+        } else if (ObjTypeToSwmm(out.object_type) >= 0) {
+            KeepReported(keep, out.object_type, out.name);
+        }
+    }
+    for (const auto& ctrl : s_mapping.GetControllers()) {
+        if (ObjTypeToSwmm(ctrl.sensor_type) >= 0) KeepReported(keep, ctrl.sensor_type, ctrl.sensor);
+        KeepReported(keep, "LINK", ctrl.actuator);
+    }
 
-            // For subsequent calls: apply the PREVIOUS inputs, step, then get outputs
-            // This ensures outputs correspond to the same time period as the inputs
-            
-            // Apply the inputs that were provided in the PREVIOUS call
-            Log(2, "Applying %zu inputs from previous timestep", s_inputs.size());
-            for (const auto& r : s_inputs) {
-                if (r.prop_enum != PROPERTY_SKIP) {
-                    Log(2, "  Setting input[%d]: prop=%d, idx=%d, value=%.4f", r.iface_idx, r.prop_enum, r.swmm_idx, s_pending_inputs[r.iface_idx]);
-                    swmm_setValue(r.prop_enum, r.swmm_idx, s_pending_inputs[r.iface_idx]);
-                } else {
-                    Log(2, "  Skipping input[%d] (PROPERTY_SKIP), value=%.4f", r.iface_idx, s_pending_inputs[r.iface_idx]);
+    int cleared = 0;
+    for (int t = 0; t < 3; t++) {
+        for (size_t i = 0; i < keep[t].size(); i++) {
+            if (keep[t][i]) continue;
+            swmm_setValue(kFlags[t], (int)i, 0.0);
+            cleared++;
+        }
+    }
+    Log(2, "Minimal I/O: report flag cleared on %d unmapped elements", cleared);
+}
+
+/**
+ * @brief Size the flight recorder for the resolved mapping, or just empty it
+ *        when the project was recycled
+ */
+static void StartFlightRecorder(bool recycled) {
+    const MappingLoader::FlightRecorderOptions& opts = s_mapping.GetFlightRecorder();
+    s_flight_on = opts.enabled;
+    if (!s_flight_on) return;
+    if (recycled && s_flight.IsConfigured()) {
+        s_flight.Clear();
+        return;
+    }
+    std::vector<std::string> in_names(s_mapping.GetInputCount()), out_names(s_mapping.GetOutputCount());
+    for (const auto& inp : s_mapping.GetInputs()) in_names[inp.interface_index] = inp.name;
+    for (const auto& out : s_mapping.GetOutputs()) out_names[out.interface_index] = out.name;
+    s_flight.Configure(opts.steps, in_names, out_names);
+}
+
+/**
+ * @brief Create the telemetry segment for the resolved mapping, once per
+ *        process, and publish the start of the realization
+ * @note A segment that cannot be created is logged and skipped; monitoring
+ *       never fails a realization
+ */
+static void StartTelemetry() {
+    const MappingLoader::TelemetryOptions& opts = s_mapping.GetTelemetry();
+    if (!opts.enabled) {
+        s_telemetry.Close();
+        return;
+    }
+    if (!s_telemetry.IsOpen() || s_telemetry.GetInputNames().size() != (size_t)s_mapping.GetInputCount() ||
+        s_telemetry.GetOutputNames().size() != (size_t)s_mapping.GetOutputCount()) {
+        std::vector<std::string> in_names(s_mapping.GetInputCount()), out_names(s_mapping.GetOutputCount());
+        for (const auto& inp : s_mapping.GetInputs()) in_names[inp.interface_index] = inp.name;
+        for (const auto& out : s_mapping.GetOutputs()) out_names[out.interface_index] = out.name;
+        const std::string name = MemberPath(opts.name);
+        std::string err;
+        if (!s_telemetry.Create(name, in_names, out_names, err)) {
+            Log(1, "Telemetry disabled: %s", err.c_str());
+            return;
+        }
+        Log(2, "Telemetry published as %s", name.c_str());
+    }
+    s_telemetry.Publish(s_realization, Telemetry::STATE_RUNNING, 0, 0, 0.0, s_pending_inputs.data(), NULL);
+}
+
+/**
+ * @brief Resolve the fast-forward inputs and states for this realization
+ * @note States start unknown (NaN), so the first interval is always stepped
+ */
+static void StartFastForward() {
+    const MappingLoader::FastForwardOptions& opts = s_mapping.GetFastForward();
+    s_ff_on = opts.enabled && s_goldsim_time;
+    s_ff_intervals = 0;
+    s_ff_inputs.clear();
+    s_ff_slots.clear();
+    s_ff_max.clear();
+    s_ff_states.clear();
+    s_ff_series.clear();
+    if (!s_ff_on) return;
+
+    // s_inputs follows the mapping's input order
+    const std::vector<MappingLoader::InputMapping>& inputs = s_mapping.GetInputs();
+    for (size_t i = 0; i < s_inputs.size(); i++) {
+        const Resolved& r = s_inputs[i];
+        bool watched = opts.inputs.empty()
+            ? (r.prop_enum != PROPERTY_SKIP && r.prop_enum < PROPERTY_CONTROLLER)
+            : std::find(opts.inputs.begin(), opts.inputs.end(), inputs[i].name) != opts.inputs.end();
+        if (watched) s_ff_inputs.push_back(r.iface_idx);
+    }
+    const std::vector<MappingLoader::SeriesInputMapping>& series = s_mapping.GetSeriesInputs();
+    for (size_t k = 0; k < series.size(); k++) {
+        if (opts.inputs.empty() || std::find(opts.inputs.begin(), opts.inputs.end(), series[k].name) != opts.inputs.end()) {
+            s_ff_series.push_back((int)k);
+        }
+    }
+    for (const auto& s : opts.states) {
+        for (const auto& out : s_mapping.GetOutputs()) {
+            if (out.name != s.output) continue;
+            s_ff_slots.push_back(out.interface_index);
+            s_ff_max.push_back(s.max);
+        }
+    }
+    s_ff_states.assign(s_ff_slots.size(), std::numeric_limits<double>::quiet_NaN());
+    Log(2, "Fast-forward: watching %zu inputs, %zu series and %zu states", s_ff_inputs.size(), s_ff_series.size(), s_ff_slots.size());
+}
+
+/**
+ * @brief Load the timeseries_inputs files, reloading any that changed
+ * @return false on failure (error set)
+ * @note Binary files are mapped, not read; a file that is unchanged since
+ *       the last realization is not touched again
+ */
+static bool LoadSeriesInputs(double* outargs, int* status) {
+    const std::vector<MappingLoader::SeriesInputMapping>& series = s_mapping.GetSeriesInputs();
+    while (s_series.size() < series.size()) s_series.push_back(new InputSeries());
+    s_series_stamps.resize(series.size());
+    s_series_applied.assign(series.size(), std::numeric_limits<double>::quiet_NaN());
+    for (size_t k = 0; k < series.size(); k++) {
+        const MappingLoader::SeriesInputMapping& s = series[k];
+        ModelStamp stamp;
+        bool have_stamp = GetModelStamp(s.file.c_str(), &stamp);
+        if (s_series[k]->GetRowCount() > 0 && have_stamp && stamp == s_series_stamps[k]) continue;
+
+        std::string err;
+        InputSeries::Interp interp = s.interpolate == "LINEAR" ? InputSeries::LINEAR : InputSeries::HOLD;
+        if (!s_series[k]->Load(s.file, s.column, s.seconds_per_unit, interp, err)) {
+            sprintf_s(s_error_buf, "Timeseries input %s: %s", s.name.c_str(), err.c_str());
+            Log(1, "%s", s_error_buf);
+            SetError(outargs, status, s_error_buf);
+            return false;
+        }
+        s_series_stamps[k] = have_stamp ? stamp : ModelStamp();
+        Log(2, "Series input %s: %zu rows, %.1f to %.1f s (%s)", s.name.c_str(), s_series[k]->GetRowCount(),
+            s_series[k]->GetStartSeconds(), s_series[k]->GetEndSeconds(), s_series[k]->IsMapped() ? "mapped" : "CSV");
+    }
+    return true;
+}
+
+static bool ReadWholeFile(const char* path, std::string& text) {
+    FILE* f = NULL;
+    if (fopen_s(&f, path, "rb") != 0 || !f) return false;
+    char buf[65536];
+    size_t n;
+    text.clear();
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+    fclose(f);
+    return true;
+}
+
+/**
+ * @brief Fold the size and write time of every timeseries_inputs file into
+ *        a hash
+ * @note A file that cannot be queried adds a zero stamp; loading it fails
+ */
+static unsigned long long HashSeriesStamps(unsigned long long h) {
+    const std::vector<MappingLoader::SeriesInputMapping>& series = s_mapping.GetSeriesInputs();
+    for (size_t k = 0; k < series.size(); k++) {
+        ModelStamp stamp;
+        GetModelStamp(series[k].file.c_str(), &stamp);
+        unsigned long long v[2] = { stamp.size, stamp.write_time };
+        h = Fnv1a64(v, sizeof(v), h);
+    }
+    return h;
+}
+
+/**
+ * @brief Hash of what a checkpoint must match: model.inp, the timeseries_inputs
+ *        files, the spin-up window, the interface sizes and the DLL version
+ */
+static bool ComputeCheckpointHash(unsigned long long* hash) {
+    std::string model;
+    if (!ReadWholeFile(MODEL_FILE, model)) return false;
+    double header[2] = { DLL_VERSION, s_mapping.GetSpinup().duration_days };
+    int counts[2] = { s_mapping.GetInputCount(), s_mapping.GetOutputCount() };
+    unsigned long long h = Fnv1a64(model);
+    h = Fnv1a64(header, sizeof(header), h);
+    h = Fnv1a64(counts, sizeof(counts), h);
+    *hash = HashSeriesStamps(h);
+    return true;
+}
+
+/**
+ * @brief START_DATE/START_TIME of an .inp file in days since 01/01/1900
+ */
+static bool ReadInpStart(const std::string& path, double* days) {
+    std::string inp;
+    if (!ReadWholeFile(path.c_str(), inp)) return false;
+    std::map<std::string, std::string> opts = ReadInpOptions(inp);
+    return opts.count("START_DATE") &&
+           InpDateTimeToDays(opts["START_DATE"], opts.count("START_TIME") ? opts["START_TIME"] : "", days);
+}
+
+/**
+ * @brief Look up swmm_saveHotstart when checkpoints or resume are configured
+ * @return false if they are and the SWMM library does not export it (error set)
+ * @note Looked up at run time, not imported, so GSswmm.dll still loads
+ *       against a stock swmm5.dll without the hotstart extension
+ */
+static bool FindSaveHotstart(double* outargs, int* status) {
+    const MappingLoader::CheckpointOptions& opts = s_mapping.GetCheckpoint();
+    if (!opts.enabled && !opts.resume) return true;
+    if (!s_save_hotstart) s_save_hotstart = (SaveHotstartFn)FindLibraryFunction(SWMM_LIBRARY, "swmm_saveHotstart");
+    if (s_save_hotstart) return true;
+    sprintf_s(s_error_buf, "Checkpoints need swmm_saveHotstart, which this SWMM library does not export "
+              "(build SWMM with swmm5_integration/SWMM5_HOTSTART_API_CODE.c or turn checkpoint off)");
+    Log(1, "%s", s_error_buf);
+    SetError(outargs, status, s_error_buf);
+    return false;
+}
+
+/**
+ * @brief Open the checkpoint store and pick the checkpoint to resume, if any
+ * @param resume Receives the checkpoint
+ * @param inp_path Receives a copy of model.inp that starts at the checkpoint
+ *        from its hotstart file
+ * @return true when this realization resumes
+ * @note Only the first realization in a process resumes, and a realization
+ *       that ends normally deletes its checkpoints, so a finished run is
+ *       never resumed. Problems are logged; the realization then starts
+ *       from the beginning.
+ */
+static bool StartCheckpoints(CheckpointState& resume, std::string& inp_path) {
+    const MappingLoader::CheckpointOptions& opts = s_mapping.GetCheckpoint();
+    s_ckpt_on = false;
+    s_time_offset_days = 0.0;
+    if (!s_checkpoints.Close()) Log(1, "Checkpoint write failed: %s", s_checkpoints.GetLastError().c_str());
+    if (!opts.enabled && !opts.resume) return false;
+
+    unsigned long long hash = 0;
+    std::string err;
+    if (!ComputeCheckpointHash(&hash)) {
+        Log(1, "Checkpoints disabled: cannot read %s", MODEL_FILE);
+        return false;
+    }
+    if (!s_checkpoints.Open(MemberPath(opts.dir), hash, opts.keep, err)) {
+        Log(1, "Checkpoints disabled: %s", err.c_str());
+        return false;
+    }
+    s_ckpt_on = opts.enabled;
+    if (!opts.resume || s_realization != 1) return false;
+
+    std::string hotstart;
+    if (!s_checkpoints.FindLatest(resume, hotstart, err)) {
+        Log(2, "Not resuming: %s", err.c_str());
+        return false;
+    }
+
+    // SWMM starts over at the checkpoint, on a whole second
+    std::string inp;
+    if (!ReadWholeFile(MODEL_FILE, inp)) return false;
+    resume.elapsed_sec = std::floor(resume.elapsed_sec + 0.5);
+    const double start = resume.start_days + resume.elapsed_sec / 86400.0;
+    std::string date, time;
+    DaysToInpDateTime(start, date, time);
+    std::map<std::string, std::string> inp_opts = ReadInpOptions(inp);
+    std::map<std::string, std::string> run_opts;
+    run_opts["START_DATE"] = date;
+    run_opts["START_TIME"] = time;
+    double report_start = 0.0;
+    if (!inp_opts.count("REPORT_START_DATE") ||
+        !InpDateTimeToDays(inp_opts["REPORT_START_DATE"],
+                           inp_opts.count("REPORT_START_TIME") ? inp_opts["REPORT_START_TIME"] : "", &report_start) ||
+        report_start < start) {
+        run_opts["REPORT_START_DATE"] = date;
+        run_opts["REPORT_START_TIME"] = time;
+    }
+    std::vector<std::string> files(1, "USE HOTSTART \"" + hotstart + "\"");
+    std::string text = RewriteInp(inp, run_opts, files);
+    inp_path = MemberPath("model_resume.inp");
+    FILE* f = NULL;
+    if (fopen_s(&f, inp_path.c_str(), "wb") != 0 || !f) {
+        Log(1, "Not resuming: cannot write %s", inp_path.c_str());
+        return false;
+    }
+    bool ok = fwrite(text.data(), 1, text.size(), f) == text.size();
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        Log(1, "Not resuming: cannot write %s", inp_path.c_str());
+        return false;
+    }
+    Log(2, "Resuming realization %d from checkpoint at %.4f days (%s %s), interval %ld",
+        resume.realization, resume.elapsed_sec / 86400.0, date.c_str(), time.c_str(), resume.interval_count);
+    return true;
+}
+
+/**
+ * @brief Bridge state a checkpoint carries besides the clock and inputs:
+ *        output statistics, controllers, then the fast-forward stride count
+ *        and watched states
+ */
+static void SaveRuntimeState(std::vector<double>& out) {
+    s_stats.SaveState(out);
+    s_controllers.SaveState(out);
+    out.push_back((double)s_ff_intervals);
+    out.push_back((double)s_ff_states.size());
+    out.insert(out.end(), s_ff_states.begin(), s_ff_states.end());
+}
+
+/**
+ * @brief Restore what SaveRuntimeState() wrote
+ * @note A part that does not match the current mapping is logged and left
+ *       as reset, so that part starts over at the checkpoint
+ */
+static void RestoreRuntimeState(const std::vector<double>& data) {
+    size_t pos = 0;
+    if (!s_stats.RestoreState(data, pos)) {
+        Log(1, "Checkpoint statistics do not match the mapping; statistics restart at the checkpoint");
+        return;
+    }
+    if (!s_controllers.RestoreState(data, pos)) {
+        Log(1, "Checkpoint controller state does not match the mapping; controllers restart at the checkpoint");
+        return;
+    }
+    if (data.size() < pos + 2 || data[pos + 1] != (double)s_ff_states.size() ||
+        data.size() - pos - 2 < s_ff_states.size()) {
+        Log(1, "Checkpoint fast-forward state does not match the mapping; watched states restart at the checkpoint");
+        return;
+    }
+    s_ff_intervals = (long)data[pos];
+    std::copy(data.begin() + pos + 2, data.begin() + pos + 2 + s_ff_states.size(), s_ff_states.begin());
+}
+
+/**
+ * @brief Save a checkpoint once the bridge clock reaches the next one due
+ * @note Runs between calls, while SWMM is idle and the staged inputs are
+ *       those the next XF_CALCULATE applies. The caller waits only for SWMM
+ *       to write the hotstart; a failed save is logged and the run goes on.
+ */
+static void SaveCheckpoint() {
+    const double every = s_mapping.GetCheckpoint().every_days * 86400.0;
+    while (s_ckpt_next_sec <= s_swmm_elapsed_sec + TIME_TOLERANCE) s_ckpt_next_sec += every;
+
+    const std::string hotstart = s_checkpoints.HotstartTempPath(s_swmm_elapsed_sec);
+    int ec = s_save_hotstart(hotstart.c_str());
+    if (ec != 0) {
+        Log(1, "Checkpoint at %.4f days skipped: swmm_saveHotstart returned %d", s_swmm_elapsed_sec / 86400.0, ec);
+        return;
+    }
+    CheckpointState st;
+    st.start_days = s_ckpt_start_days;
+    st.elapsed_sec = s_swmm_elapsed_sec;
+    st.interval_count = s_interval_count;
+    st.route_steps = s_route_steps;
+    st.first_calculate = s_first_calculate ? 1 : 0;
+    st.realization = s_realization;
+    st.pending_inputs = s_pending_inputs;
+    SaveRuntimeState(st.runtime);
+    s_checkpoints.Commit(st);
+    Log(2, "Checkpoint at %.4f days queued", s_swmm_elapsed_sec / 86400.0);
+}
+
+/**
+ * @brief Open (or reuse) model.inp, start SWMM and reset per-realization state
+ * @return false on failure (error set)
+ */
+static bool StartSimulation(int* status, double* outargs) {
+    s_flight.Clear();
+    if (!LoadSeriesInputs(outargs, status)) return false;
+    if (!FindSaveHotstart(outargs, status)) return false;
+    CheckpointState resume;
+    std::string resume_inp;
+    const bool resuming = StartCheckpoints(resume, resume_inp);
+
+    // Reuse the project left open by the previous realization if
+    // recycling is on and model.inp has not been touched since
+    s_recycle = s_mapping.GetRealization().recycle;
+    const bool minimal_io = s_mapping.GetRealization().minimal_io;
+    ModelStamp stamp;
+    bool have_stamp = GetModelStamp(MODEL_FILE, &stamp);
+    bool recycled = !resuming && s_project_open && s_resolved && s_recycle && have_stamp && stamp == s_model_stamp;
+    if (s_project_open && !recycled) {
+        Log(2, "Closing recycled project (model.inp changed or recycling off)");
+        CloseProject();
+    }
+
+    // Open SWMM
+    long long t_open = s_profiler.Begin();
+    if (recycled) {
+        Log(2, "Recycling open project, skipping swmm_open and name resolution");
+    } else {
+        std::string inp_path = MODEL_FILE;
+        const MappingLoader::SpinupOptions& spinup = s_mapping.GetSpinup();
+        if (resuming) {
+            inp_path = resume_inp;
+        } else if (spinup.duration_days > 0.0) {
+            // Hashes model.inp and runs the spin-up only when it changed
+            if (!s_spinup_ready || !have_stamp || !(stamp == s_spinup_stamp)) {
+                std::string err;
+                if (!s_spinup.Prepare(MODEL_FILE, spinup.duration_days, spinup.cache_dir, s_spinup_inp, err)) {
+                    Log(1, "%s", err.c_str());
+                    s_spinup_ready = false;
+                    SetError(outargs, status, err.c_str());
+                    return false;
                 }
+                s_spinup_ready = true;
+                s_spinup_stamp = stamp;
+                Log(2, "Spin-up hotstart %s (%s)", s_spinup.GetHotstartPath().c_str(), s_spinup.RanSpinup() ? "created" : "cached");
             }
+            inp_path = s_spinup_inp;
+        }
 
-            // Step SWMM forward - may need multiple internal steps
-            Log(2, "Calling swmm_step");
-            double elapsed;
-            int ec = swmm_step(&elapsed);
-            Log(2, "swmm_step returned: %d, elapsed=%.6f days (%.2f minutes)", ec, elapsed, elapsed * 1440.0);
-            
-            if (ec < 0) { 
-                Log(1, "swmm_step failed with error: %d", ec);
-                HandleSwmmError(outargs, status); 
-                break; 
+        Log(2, "Opening SWMM model: %s", inp_path.c_str());
+        // minimal_io: report to the null device and a blank results file
+        // name, which makes SWMM use a temporary scratch file
+        int open_err = minimal_io ? swmm_open(inp_path.c_str(), NULL_REPORT_FILE, "")
+                                  : swmm_open(inp_path.c_str(), MemberPath(REPORT_FILE).c_str(), MemberPath(RESULTS_FILE).c_str());
+        if (open_err != 0) { 
+            Log(1, "swmm_open failed with error: %d", open_err);
+            HandleSwmmError(outargs, status); 
+            return false;
+        }
+        Log(2, "swmm_open succeeded");
+        s_project_open = true;
+        s_model_stamp = resuming ? ModelStamp() : stamp;    // A resumed project starts late; never recycle it
+        if (resuming) s_ckpt_start_days = resume.start_days;
+        else if (s_ckpt_on && !ReadInpStart(inp_path, &s_ckpt_start_days)) {
+            Log(1, "Checkpoints disabled: no START_DATE in %s", inp_path.c_str());
+            s_ckpt_on = false;
+        }
+        if (minimal_io) ClearUnmappedReportFlags();
+    }
+
+    Log(2, "Starting SWMM simulation%s", minimal_io ? " (results not saved)" : "");
+    int start_err = swmm_start(minimal_io ? 0 : 1);
+    if (start_err != 0) { 
+        Log(1, "swmm_start failed with error: %d", start_err);
+        CloseProject(); 
+        HandleSwmmError(outargs, status); 
+        return false;
+    }
+    Log(2, "swmm_start succeeded");
+    s_profiler.End(Profiler::PHASE_OPEN, t_open);
+
+    // From here on Cleanup() must end the run (and close the project on error)
+    s_swmm_running = true;
+
+    if (!recycled) {
+        ProfileScope scope(s_profiler, Profiler::PHASE_RESOLVE);
+        if (!ResolveMapping(status, outargs)) return false;
+        s_resolved = true;
+    }
+
+    const MappingLoader::SteppingOptions& stepping = s_mapping.GetStepping();
+    s_interval_count = 0;
+    s_swmm_elapsed_sec = 0.0;
+    s_route_steps = 0;
+    s_first_calculate = true;
+    s_pending_inputs.clear();
+    s_pending_inputs.resize(s_mapping.GetInputCount(), 0.0);
+    s_applied_inputs.assign(s_mapping.GetInputCount(), std::numeric_limits<double>::quiet_NaN());
+    s_inputs_dirty = true;
+    s_controllers.Reset();
+    s_stats.Reset();
+    if (resuming) {
+        // Carry on from the checkpointed call; every input is re-applied
+        s_time_offset_days = resume.elapsed_sec / 86400.0;
+        s_swmm_elapsed_sec = resume.elapsed_sec;
+        s_interval_count = resume.interval_count;
+        s_route_steps = resume.route_steps;
+        s_first_calculate = resume.first_calculate != 0;
+        s_pending_inputs = resume.pending_inputs;
+    }
+    for (InputSeries* s : s_series) s->Seek(s_swmm_elapsed_sec);
+    if (s_ckpt_on) {
+        const double every = s_mapping.GetCheckpoint().every_days * 86400.0;
+        s_ckpt_next_sec = (std::floor(s_swmm_elapsed_sec / every + 1e-9) + 1.0) * every;
+    }
+
+    s_async_stepping = stepping.async;
+    if (s_async_stepping) {
+        s_step_values.assign(s_slot_count, 0.0);
+        s_step_worker.Start();
+        Log(2, "Look-ahead stepping enabled");
+    }
+    if (!StartRecording()) {
+        Cleanup(status, outargs); SetError(outargs, status, s_error_buf); return false;
+    }
+    StartFlightRecorder(recycled);
+    StartTelemetry();
+    StartFastForward();
+    if (resuming) {
+        RestoreRuntimeState(resume.runtime);
+        // The checkpointed call had launched the next interval's step
+        if (s_async_stepping && !s_first_calculate) LaunchLookAheadStep();
+    }
+    Log(2, "INITIALIZE complete: %zu inputs, %zu outputs resolved", s_inputs.size(), s_outputs.size());
+    return true;
+}
+
+/**
+ * @brief One live XF_CALCULATE: step SWMM (or collect the look-ahead step)
+ *        and write the outputs for the completed interval
+ * @return 0 on success, >0 if the simulation ended (outputs untouched),
+ *         <0 on error (status set)
+ */
+static int Calculate(int* status, double* inargs, double* outargs) {
+    if (!s_swmm_running) { 
+        Log(1, "XF_CALCULATE called but SWMM not running!");
+        *status = XF_FAILURE; 
+        return -1;
+    }
+
+    // On first call, we need to get initial outputs before any stepping
+    if (s_first_calculate) {
+        Log(2, "First calculate - getting initial outputs and storing inputs for next step");
+
+        // Get initial outputs (before any stepping)
+        Log(2, "Getting %zu initial outputs", s_outputs.size());
+        long long t0 = s_profiler.Begin();
+        s_output_plan.Gather(outargs);
+        s_profiler.End(Profiler::PHASE_GATHER, t0);
+        s_output_plan.ResetSchedule();
+        if (s_stats_active) s_stats.Fill(outargs);
+        if (s_aggregator.NeedsSubsteps()) {
+            s_aggregator.Begin();
+            s_aggregator.Finish(outargs, outargs);
+        }
+        if (s_ff_on) NoteFastForwardStates(outargs);
+        LogOutputs(outargs);
+        if (s_recorder.IsOpen()) s_recorder.Append(s_swmm_elapsed_sec / 86400.0, outargs, NULL);
+        if (s_flight_on) s_flight.Record(s_route_steps, s_swmm_elapsed_sec / 86400.0, 0, NULL, outargs);
+        s_telemetry.Publish(s_realization, Telemetry::STATE_RUNNING, 0, 0, s_swmm_elapsed_sec / 86400.0, NULL, outargs);
+
+        // Store the inputs for the next timestep
+        StoreInputs(inargs);
+
+        s_first_calculate = false;
+        if (s_async_stepping) LaunchLookAheadStep();
+        Log(2, "XF_CALCULATE complete (first call)");
+        return 0;
+    }
+
+    // For subsequent calls: apply the PREVIOUS inputs, step, then get outputs
+    // This ensures outputs correspond to the same time period as the inputs
+
+    // Apply the inputs that were provided in the PREVIOUS call and step.
+    // In look-ahead mode that already happened on the worker thread.
+    // AdvanceInterval writes the outputs for the interval it completed.
+    double elapsed;
+    int ec;
+    if (s_async_stepping) {
+        s_step_worker.Wait();
+        ec = s_async_ec;
+        elapsed = s_async_elapsed;
+    } else {
+        ec = AdvanceInterval(inargs, &elapsed, outargs);
+    }
+
+    if (ec < 0) { 
+        Log(1, "swmm_step failed with error: %d", ec);
+        if (s_flight_on) s_flight.Record(s_route_steps, s_swmm_elapsed_sec / 86400.0, ec, s_pending_inputs.data(), NULL);
+        HandleSwmmError(outargs, status); 
+        return ec;
+    }
+    if (ec > 0) { 
+        Log(2, "Simulation ended normally");
+        if (s_checkpoints.IsOpen()) s_checkpoints.Discard();
+        Cleanup(status, outargs); 
+        return ec;
+    }
+
+    // Outputs for the interval we just completed
+    if (s_async_stepping) {
+        std::copy(s_step_values.begin(), s_step_values.end(), outargs);
+    }
+    LogOutputs(outargs);
+    if (s_recorder.IsOpen()) s_recorder.Append(elapsed, outargs, s_pending_inputs.data());
+    if (s_flight_on) s_flight.Record(s_route_steps, elapsed, 0, s_pending_inputs.data(), outargs);
+    s_telemetry.Publish(s_realization, Telemetry::STATE_RUNNING, s_route_steps, s_interval_count, elapsed,
+                        s_pending_inputs.data(), outargs);
+
+    // Store the NEW inputs for the next timestep
+    StoreInputs(inargs);
+    if (s_ckpt_on && s_swmm_elapsed_sec >= s_ckpt_next_sec - TIME_TOLERANCE) SaveCheckpoint();
+    if (s_async_stepping) LaunchLookAheadStep();
+
+    Log(2, "XF_CALCULATE complete, elapsed=%.6f days", elapsed);
+    return 0;
+}
+
+/**
+ * @brief Hash everything a run's outputs depend on besides its inputs
+ * @note timeseries_inputs files add their size and write time. Files
+ *       referenced from model.inp (rainfall, time series, hotstart inputs)
+ *       are not hashed; clear the memo directory when they change
+ */
+static bool ComputeMemoBase(unsigned long long* base) {
+    std::string model, config;
+    if (!ReadWholeFile(MODEL_FILE, model) || !ReadWholeFile(CONFIG_FILE, config)) return false;
+    double version = DLL_VERSION;
+    int counts[2] = { s_mapping.GetInputCount(), s_mapping.GetOutputCount() };
+    unsigned long long h = Fnv1a64(model);
+    h = Fnv1a64(config, h);
+    h = Fnv1a64(&version, sizeof(version), h);
+    h = Fnv1a64(counts, sizeof(counts), h);
+    *base = HashSeriesStamps(h);
+    return true;
+}
+
+static void FlushMemo() {
+    std::string err;
+    if (s_memo.IsOpen() && !s_memo.Flush(err)) Log(1, "%s", err.c_str());
+}
+
+/**
+ * @brief Open the result memo for this realization
+ * @return false on failure (error set)
+ * @note Sets s_memo_serving when the store already holds records, in which
+ *       case SWMM is not started until the input stream misses
+ */
+static bool StartMemo(int* status, double* outargs) {
+    FlushMemo();
+    s_memo_serving = false;
+    s_memo_recording = false;
+    s_memo_served = 0;
+    s_memo_history.clear();
+
+    const MappingLoader::MemoOptions& memo = s_mapping.GetMemo();
+    ModelStamp stamp;
+    if (!memo.enabled || !GetModelStamp(MODEL_FILE, &stamp)) {
+        s_memo.Close();
+        return true;
+    }
+    unsigned long long series = HashSeriesStamps(0);
+    if (!s_memo_base_ready || !(stamp == s_memo_stamp) || series != s_memo_series) {
+        s_memo_base_ready = ComputeMemoBase(&s_memo_base);
+        s_memo_stamp = stamp;
+        s_memo_series = series;
+        if (!s_memo_base_ready) {
+            Log(1, "Result memo disabled: cannot read %s or %s", MODEL_FILE, CONFIG_FILE);
+            s_memo.Close();
+            return true;
+        }
+    }
+
+    std::string err;
+    if (!s_memo.Open(memo.dir, s_memo_base, s_mapping.GetOutputCount(), err)) {
+        Log(1, "%s", err.c_str());
+        SetError(outargs, status, err.c_str());
+        return false;
+    }
+    s_memo_chain = s_memo_base;
+    s_memo_recording = true;
+    s_memo_serving = s_memo.GetRecordCount() > 0;
+    return true;
+}
+
+/**
+ * @brief Answer an XF_CALCULATE from the store
+ * @return false on a miss (serving stops; the caller must go live)
+ */
+static bool ServeFromMemo(const double* inargs, double* outargs) {
+    bool ended = false;
+    if (!s_memo.Lookup(s_memo_chain, outargs, &ended)) {
+        Log(2, "Result memo miss after %zu served calls, starting SWMM", s_memo_served);
+        s_memo_serving = false;
+        return false;
+    }
+    if (ended) {
+        // Same as a live run reaching its end: no outputs, later calls fail
+        Log(2, "Memoized simulation ended normally");
+        s_memo_serving = false;
+        s_memo_recording = false;
+        return true;
+    }
+    s_memo_history.insert(s_memo_history.end(), inargs, inargs + s_mapping.GetInputCount());
+    s_memo_served++;
+    LogOutputs(outargs);
+    return true;
+}
+
+/**
+ * @brief Start SWMM and re-run the calls served from the store so it
+ *        reaches the state the diverging call expects
+ * @return false on failure (error set)
+ */
+static bool ReplayMemoHistory(int* status, double* inargs, double* outargs) {
+    if (!StartSimulation(status, outargs)) {
+        s_memo_recording = false;
+        return false;
+    }
+    const int n_in = s_mapping.GetInputCount();
+    for (size_t i = 0; i < s_memo_served; i++) {
+        double* in = n_in > 0 ? &s_memo_history[i * n_in] : inargs;
+        int ec = Calculate(status, in, outargs);
+        if (*status != XF_SUCCESS) {
+            s_memo_recording = false;
+            return false;
+        }
+        if (ec > 0) {
+            s_memo_recording = false;
+            SetError(outargs, status, "Result memo does not match the model; delete the memo files");
+            return false;
+        }
+    }
+    Log(2, "Replayed %zu memoized calls", s_memo_served);
+    s_memo_history.clear();
+    s_memo_served = 0;
+    return true;
+}
+
+/**
+ * @brief Command line that starts a worker process for this DLL
+ */
+static std::string DefaultWorkerCommand() {
+#ifdef _WIN32
+    // rundll32 loads a second copy of this DLL in its own process
+    char path[MAX_PATH];
+    DWORD n = GetModuleFileNameA(s_module, path, MAX_PATH);
+    if (n == 0 || n >= MAX_PATH) return "";
+    return std::string("rundll32.exe \"") + path + "\",SwmmWorkerRundll {channel}";
+#else
+    return "./swmm_worker {channel}";
+#endif
+}
+
+/**
+ * @brief Number of input/output vectors per GoldSim call
+ */
+static int EnsembleSize() {
+    int k = s_mapping.GetEnsemble().members;
+    return (k > 1 && !s_in_worker) ? k : 1;
+}
+
+/**
+ * @brief Prefix an error with the ensemble member it came from
+ */
+static std::string MemberError(int member, const std::string& msg) {
+    if (member <= 0) return msg;
+    char prefix[48];
+    sprintf_s(prefix, "Ensemble member %d: ", member);
+    return prefix + msg;
+}
+
+/**
+ * @brief Start the workers if needed and bind this realization to them
+ * @return false on failure (error set)
+ */
+static bool BindWorker(int* status, double* outargs) {
+    const MappingLoader::WorkerOptions& opts = s_mapping.GetWorker();
+    std::string command = opts.command.empty() ? DefaultWorkerCommand() : opts.command;
+    int capacity = (std::max)(2, (std::max)(s_mapping.GetInputCount(), s_mapping.GetOutputCount()));
+    int members = EnsembleSize();
+    s_first_member = members > 1 ? 1 : 0;
+    s_last_member = members > 1 ? members : 0;
+
+    // Workers left from a differently sized ensemble would sit idle
+    if (s_workers.IsBound(s_worker_dir, s_first_member == 0 ? 1 : 0) || s_workers.IsBound(s_worker_dir, s_last_member + 1)) {
+        Log(2, "Ensemble size changed, restarting SWMM workers");
+        s_workers.Release(s_worker_dir);
+    }
+
+    s_workers.SetSpin(opts.spin_microseconds);
+    for (int m = s_first_member; m <= s_last_member; m++) {
+        bool running = s_workers.IsBound(s_worker_dir, m);
+        std::string err;
+        if (!s_workers.Bind(s_worker_dir, m, command, capacity, (int)(opts.startup_seconds * 1000.0), err)) {
+            err = MemberError(m, err);
+            Log(1, "%s", err.c_str());
+            SetError(outargs, status, err.c_str());
+            return false;
+        }
+        if (!running) Log(2, "Started SWMM worker %d: %s", m, command.c_str());
+    }
+    return true;
+}
+
+/**
+ * @brief Run a GoldSim call in the worker processes when the mapping asks for them
+ * @return true if the call was handled here (forwarded, or failed to bind)
+ * @note XF_REP_VERSION and XF_REP_ARGUMENTS always run locally. In an
+ *       ensemble, member m reads inputs and writes outputs at (m - 1)
+ *       times the per-member counts. CALCULATE and CLEANUP run on all
+ *       members at once; INITIALIZE runs them one after another so a
+ *       spin-up cache is built once and then shared.
+ */
+static bool ForwardCall(int methodID, int* status, double* inargs, double* outargs) {
+    if (methodID == XF_INITIALIZE) {
+        if (!LoadMapping(outargs, status)) {
+            Log(1, "XF_INITIALIZE: LoadMapping failed");
+            return true;
+        }
+        if (!s_mapping.GetWorker().enabled && EnsembleSize() == 1) return false;
+        if (!BindWorker(status, outargs)) return true;
+        s_forwarding = true;
+    } else if (methodID != XF_CALCULATE && methodID != XF_CLEANUP) {
+        return false;
+    } else if (!s_forwarding) {
+        return false;
+    }
+
+    const MappingLoader::WorkerOptions& opts = s_mapping.GetWorker();
+    int nin = methodID == XF_CALCULATE ? s_mapping.GetInputCount() : 0;
+    int nout = methodID == XF_CALCULATE ? s_mapping.GetOutputCount() : 0;
+    int timeout_ms = opts.timeout_seconds > 0.0 ? (int)(opts.timeout_seconds * 1000.0) : -1;
+    bool serial = methodID == XF_INITIALIZE;
+
+    // Send to every member, then collect every reply so none is left
+    // queued; the first failure is reported
+    bool lost = false;
+    std::string first_error;
+    int first_status = XF_SUCCESS;
+    for (int pass = 0; pass < (serial ? 1 : 2); pass++) {
+        for (int m = s_first_member; m <= s_last_member; m++) {
+            if (pass == 1 && !s_workers.IsBound(s_worker_dir, m)) continue;    // Send failed
+            int k = m - s_first_member;
+            std::string text, err;
+            bool ok = true;
+            if (pass == 0) ok = s_workers.Send(s_worker_dir, m, methodID, inargs + k * nin, nin, nout, err);
+            if (ok && (serial || pass == 1)) {
+                int member_status = XF_SUCCESS;
+                ok = s_workers.Wait(s_worker_dir, m, &member_status, outargs + k * nout, nout, timeout_ms, text, err);
+                if (ok && member_status != XF_SUCCESS && first_status == XF_SUCCESS) {
+                    first_status = member_status;
+                    first_error = MemberError(m, text);
+                }
             }
-            if (ec > 0) { 
-                Log(2, "Simulation ended normally");
-                Cleanup(status, outargs); 
-                break; 
+            if (!ok) {
+                // The worker has been stopped; the next INITIALIZE starts a new one
+                Log(1, "%s", MemberError(m, err).c_str());
+                if (!lost) first_error = MemberError(m, err);
+                lost = true;
             }
+            if (serial && (lost || first_status != XF_SUCCESS)) break;
+        }
+    }
 
-            // Get outputs for the timestep we just completed
-            Log(2, "Getting %zu outputs", s_outputs.size());
-            for (const auto& r : s_outputs) {
-                double val;
-                if (r.is_lid) {
-                    // LID output - use appropriate API based on property
-                    if (r.lid_property == "STORAGE_VOLUME") {
-                        val = swmm_getLidUStorageVolume(r.swmm_idx, r.lid_idx);
-                        Log(3, "  Output[%d]: LID storage volume, subcatch_idx=%d, lid_idx=%d, value=%.6f", 
-                            r.iface_idx, r.swmm_idx, r.lid_idx, val);
-                    } else if (r.lid_property == "SURFACE_OUTFLOW") {
-                        val = swmm_getLidUSurfaceOutflow(r.swmm_idx, r.lid_idx);
-                        Log(3, "  Output[%d]: LID surface outflow, subcatch_idx=%d, lid_idx=%d, value=%.6f", 
-                            r.iface_idx, r.swmm_idx, r.lid_idx, val);
-                    } else if (r.lid_property == "SURFACE_INFLOW") {
-                        val = swmm_getLidUSurfaceInflow(r.swmm_idx, r.lid_idx);
-                        Log(3, "  Output[%d]: LID surface inflow, subcatch_idx=%d, lid_idx=%d, value=%.6f", 
-                            r.iface_idx, r.swmm_idx, r.lid_idx, val);
-                    } else if (r.lid_property == "DRAIN_FLOW") {
-                        val = swmm_getLidUDrainFlow(r.swmm_idx, r.lid_idx);
-                        Log(3, "  Output[%d]: LID drain flow, subcatch_idx=%d, lid_idx=%d, value=%.6f", 
-                            r.iface_idx, r.swmm_idx, r.lid_idx, val);
-                    } else {
-                        Log(1, "Unknown LID property: %s", r.lid_property.c_str());
-                        val = 0.0;
-                    }
-                } else {
-                    // Regular output - use existing API
-                    val = swmm_getValue(r.prop_enum, r.swmm_idx);
-                    Log(3, "  Output[%d]: prop=%d, idx=%d, value=%.6f", r.iface_idx, r.prop_enum, r.swmm_idx, val);
+    if (lost) {
+        // Members still running are mid-realization; restart them all
+        s_workers.Release(s_worker_dir);
+        s_forwarding = false;
+        if (methodID == XF_CLEANUP) *status = XF_SUCCESS;
+        else SetError(outargs, status, first_error.c_str());
+        return true;
+    }
+    if (first_status == XF_FAILURE_WITH_MSG) SetError(outargs, status, first_error.c_str());
+    else *status = first_status;
+
+    if (methodID == XF_CLEANUP) {
+        s_forwarding = false;
+        if (!opts.keep_alive) s_workers.Release(s_worker_dir);
+    }
+    return true;
+}
+
+extern "C" void BRIDGE_EXPORT SwmmGoldSimBridge(int methodID, int* status, double* inargs, double* outargs) {
+    *status = XF_SUCCESS;
+    Log(2, "=== Method called: %d ===", methodID);
+
+    if (!s_in_worker && ForwardCall(methodID, status, inargs, outargs)) {
+        Log(2, "=== Method %d done in worker, status=%d ===", methodID, *status);
+        return;
+    }
+
+    switch (methodID) {
+    case XF_REP_VERSION:
+        Log(2, "XF_REP_VERSION called");
+        outargs[0] = DLL_VERSION;
+        Log(2, "XF_REP_VERSION returning: %.1f", DLL_VERSION);
+        break;
+
+    case XF_REP_ARGUMENTS:
+        Log(2, "XF_REP_ARGUMENTS called");
+        if (!LoadMapping(outargs, status)) {
+            Log(1, "XF_REP_ARGUMENTS: LoadMapping failed");
+            break;
+        }
+        outargs[0] = (double)(s_mapping.GetInputCount() * EnsembleSize());
+        outargs[1] = (double)(s_mapping.GetOutputCount() * EnsembleSize());
+        Log(2, "REP_ARGUMENTS: %d inputs, %d outputs, %d member(s)",
+            s_mapping.GetInputCount(), s_mapping.GetOutputCount(), EnsembleSize());
+        break;
+
+    case XF_INITIALIZE:
+        {
+            Log(2, "XF_INITIALIZE called");
+            if (s_swmm_running) { 
+                Log(2, "SWMM already running, cleaning up first");
+                DumpFlight("Realization was not cleaned up before the next XF_INITIALIZE");
+                Cleanup(status, outargs); 
+                if (*status != XF_SUCCESS) {
+                    Log(1, "Cleanup failed during re-initialization");
+                    break;
                 }
-                outargs[r.iface_idx] = val;
             }
             
-            // Store the NEW inputs for the next timestep
-            for (const auto& r : s_inputs) {
-                s_pending_inputs[r.iface_idx] = inargs[r.iface_idx];
-                Log(2, "  Stored input[%d] for next step: value=%.4f", r.iface_idx, inargs[r.iface_idx]);
+            if (!LoadMapping(outargs, status)) {
+                Log(1, "XF_INITIALIZE: LoadMapping failed");
+                break;
+            }
+            Log(2, "Mapping loaded successfully");
+            s_realization++;
+            s_profiler.SetEnabled(s_mapping.GetProfile().enabled);
+            if (s_mapping.GetTrace().enabled) {
+                s_tracer.Start(s_mapping.GetTrace().max_events);
+                s_tracer.NameThread("GoldSim");
+                s_profiler.SetTracer(&s_tracer);
+            } else {
+                s_profiler.SetTracer(NULL);
             }
+            ProfileScope scope(s_profiler, Profiler::PHASE_INITIALIZE);
             
-            Log(2, "XF_CALCULATE complete");
+            // Hand logging to the background writer for the rest of the realization
+            long long t_log = s_profiler.Begin();
+            LogStart();
+            s_profiler.End(Profiler::PHASE_LOG, t_log);
+
+            if (!StartMemo(status, outargs)) break;
+            if (s_memo_serving) {
+                Log(2, "INITIALIZE complete: serving from result memo (%zu records), SWMM not started", s_memo.GetRecordCount());
+                break;
+            }
+            StartSimulation(status, outargs);
+        }
+        break;
+
+    case XF_CALCULATE:
+        {
+            ProfileScope scope(s_profiler, Profiler::PHASE_CALCULATE);
+            Log(2, "XF_CALCULATE called");
+            if (s_memo.IsOpen()) s_memo_chain = Fnv1a64(inargs, s_mapping.GetInputCount() * sizeof(double), s_memo_chain);
+            if (s_memo_serving) {
+                if (ServeFromMemo(inargs, outargs)) break;
+                if (!ReplayMemoHistory(status, inargs, outargs)) break;
+            }
+
+            int ec = Calculate(status, inargs, outargs);
+            if (s_memo_recording) {
+                if (*status != XF_SUCCESS) s_memo_recording = false;
+                else s_memo.Add(s_memo_chain, outargs, ec > 0);
+            }
+            if (ec > 0) FlushMemo();
         }
         break;
 
     case XF_CLEANUP:
         Log(2, "XF_CLEANUP called");
         Cleanup(status, outargs);
+        FlushMemo();
+        WriteProfile();
+        WriteTrace();
         *status = XF_SUCCESS;
         Log(2, "XF_CLEANUP complete");
         break;
@@ -503,4 +2356,98 @@ extern "C" void __declspec(dllexport) SwmmGoldSimBridge(int methodID, int* statu
         break;
     }
     Log(2, "=== Method %d complete, status=%d ===", methodID, *status);
+    
+    // Drain and close the log at the end of each realization
+    if (methodID == XF_CLEANUP) {
+        long long t_log = s_profiler.Begin();
+        LogStop();
+        s_profiler.End(Profiler::PHASE_LOG, t_log);
+    }
+}
+
+/**
+ * @brief Worker process main loop: run forwarded calls until told to stop
+ * @param channel Name of the channel created by the client's WorkerPool
+ * @return Process exit code
+ * @note Called by rundll32 (SwmmWorkerRundll) on Windows or by the
+ *       SwmmWorkerHost console program. Exits when the client process does.
+ */
+extern "C" int BRIDGE_EXPORT SwmmWorkerMain(const char* channel_name) {
+    s_in_worker = true;
+    LogSetFile(WORKER_LOG_FILE);
+
+    SharedChannel channel;
+    std::string err;
+    if (!channel_name || !channel.Open(channel_name, err)) {
+        Log(1, "Worker: %s", err.empty() ? "no channel name" : err.c_str());
+        return 1;
+    }
+    const int capacity = channel.GetCapacity();
+    std::vector<double> in(capacity), out(capacity);
+    channel.Post(SharedChannel::TO_CLIENT, WORKER_READY, 0, 0, NULL, 0, NULL);
+
+    SharedChannel::Message msg;
+    for (;;) {
+        int spin = s_mapping_loaded ? s_mapping.GetWorker().spin_microseconds : 0;
+        if (channel.Receive(SharedChannel::TO_WORKER, msg, in.data(), capacity, 1000, spin) == 0) {
+            if (!channel.IsCreatorAlive()) break;
+            continue;
+        }
+        if (msg.method == WORKER_SHUTDOWN) break;
+        if (msg.status != s_member) {
+            // Ensemble members keep their files apart
+            s_member = msg.status;
+            LogSetFile(MemberPath(WORKER_LOG_FILE));
+        }
+
+        int status = XF_SUCCESS;
+        std::fill(out.begin(), out.end(), 0.0);
+        SwmmGoldSimBridge(msg.method, &status, in.data(), out.data());
+
+        // An error message is a pointer into this process; send the text
+        const char* text = (status == XF_FAILURE_WITH_MSG) ? (const char*)*(uintptr_t*)out.data() : NULL;
+        int n = text ? 0 : (std::min)(msg.aux, capacity);
+        channel.Post(SharedChannel::TO_CLIENT, msg.method, status, 0, out.data(), n, text);
+    }
+
+    if (s_swmm_running) {
+        DumpFlight("Worker stopped during a realization");
+        int status = XF_SUCCESS;
+        SwmmGoldSimBridge(XF_CLEANUP, &status, in.data(), out.data());
+    }
+    if (s_project_open) CloseProject();
+    channel.Close();
+    return 0;
+}
+
+#ifdef _WIN32
+/**
+ * @brief rundll32 entry point: rundll32.exe GSswmm.dll,SwmmWorkerRundll <channel>
+ */
+extern "C" void BRIDGE_EXPORT CALLBACK SwmmWorkerRundll(HWND hwnd, HINSTANCE hinst, LPSTR cmd_line, int show) {
+    (void)hwnd; (void)hinst; (void)show;
+    std::string name = cmd_line ? cmd_line : "";
+    while (!name.empty() && (name.back() == ' ' || name.back() == '\r' || name.back() == '\n')) name.pop_back();
+    SwmmWorkerMain(name.c_str());
+}
+
+/**
+ * @brief Stop worker processes, close a project still held open by
+ *        realization recycling and unmap the preloaded series
+ * @note Only on FreeLibrary; at process exit the OS reclaims everything and
+ *       other DLLs may already be gone
+ */
+BOOL WINAPI DllMain(HINSTANCE hinst, DWORD reason, LPVOID reserved) {
+    if (reason == DLL_PROCESS_ATTACH) s_module = hinst;
+    if (reason == DLL_PROCESS_DETACH && reserved == NULL) s_workers.Shutdown();
+    if (reason == DLL_PROCESS_DETACH && reserved == NULL && s_project_open && !s_swmm_running) {
+        swmm_close();
+        s_project_open = false;
+    }
+    if (reason == DLL_PROCESS_DETACH && reserved == NULL) {
+        for (InputSeries* s : s_series) delete s;      // Unmaps the series files
+        s_series.clear();
+    }
+    return TRUE;
 }
+#endif
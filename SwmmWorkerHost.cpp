@@ -0,0 +1,20 @@
+//-----------------------------------------------------------------------------
+//   SwmmWorkerHost.cpp
+//   Console host for a SWMM worker process: links the bridge sources and
+//   SWMM, and serves one channel (see WorkerPool). Windows uses rundll32 on
+//   GSswmm.dll instead; this host is for platforms without it.
+//
+//   usage: swmm_worker <channel>
+//-----------------------------------------------------------------------------
+
+#include <cstdio>
+
+extern "C" int SwmmWorkerMain(const char* channel_name);
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        fprintf(stderr, "usage: swmm_worker <channel>\n");
+        return 2;
+    }
+    return SwmmWorkerMain(argv[1]);
+}
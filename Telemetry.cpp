@@ -0,0 +1,166 @@
+//-----------------------------------------------------------------------------
+//   Telemetry.cpp
+//   Seqlock-protected live state in shared memory
+//-----------------------------------------------------------------------------
+
+#include "include/Telemetry.h"
+#include "include/Platform.h"
+#include <cstring>
+#include <thread>
+
+static const char kMagic[8] = { 'G', 'S', 'T', 'E', 'L', '0', '0', '1' };
+
+Telemetry::Telemetry() : header_(NULL) {}
+
+Telemetry::~Telemetry() {
+    Close();
+}
+
+size_t Telemetry::RegionBytes(size_t inputs, size_t outputs) {
+    return sizeof(Header) + (inputs + outputs) * (sizeof(double) + kNameBytes);
+}
+
+double* Telemetry::Inputs() const { return (double*)((char*)header_ + sizeof(Header)); }
+double* Telemetry::Outputs() const { return Inputs() + header_->input_count; }
+char* Telemetry::Names() const { return (char*)(Outputs() + header_->output_count); }
+
+bool Telemetry::Create(const std::string& name, const std::vector<std::string>& input_names,
+                       const std::vector<std::string>& output_names, std::string& error) {
+    Close();
+    const std::string path = PlatformName(name);
+    const size_t bytes = RegionBytes(input_names.size(), output_names.size());
+    if (!region_.Create(path, bytes, error)) {
+        // Replace a segment whose writer is gone (POSIX names outlive their process)
+        Telemetry old;
+        std::string ignored;
+        if (old.Open(name, ignored)) {
+            long long pid = old.header_->writer_pid;
+            old.Close();
+            if (SharedMemory::IsProcessAlive(pid)) {
+                error = "Telemetry segment " + name + " is in use by process " + std::to_string(pid);
+                return false;
+            }
+        }
+        SharedMemory::Remove(path);
+        if (!region_.Create(path, bytes, error)) return false;
+    }
+
+    header_ = (Header*)region_.GetData();
+    header_->input_count = (unsigned int)input_names.size();
+    header_->output_count = (unsigned int)output_names.size();
+    header_->writer_pid = SharedMemory::CurrentProcessId();
+    header_->seq.store(0);
+    header_->state = STATE_IDLE;
+    char* names = Names();
+    for (const std::string& n : input_names) { strncpy_s(names, kNameBytes, n.c_str(), _TRUNCATE); names += kNameBytes; }
+    for (const std::string& n : output_names) { strncpy_s(names, kNameBytes, n.c_str(), _TRUNCATE); names += kNameBytes; }
+    input_names_ = input_names;
+    output_names_ = output_names;
+
+    // Readers check the magic last, so everything above is in place
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(header_->magic, kMagic, sizeof(kMagic));
+    return true;
+}
+
+bool Telemetry::Open(const std::string& name, std::string& error) {
+    Close();
+    if (!region_.Open(PlatformName(name), error)) return false;
+    header_ = (Header*)region_.GetData();
+    size_t bytes = region_.GetSize();
+    if (bytes < sizeof(Header) || memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0 ||
+        bytes < RegionBytes(header_->input_count, header_->output_count)) {
+        Close();
+        error = "Not a bridge telemetry segment: " + name;
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const char* names = Names();
+    for (unsigned int i = 0; i < header_->input_count; i++, names += kNameBytes) {
+        input_names_.push_back(std::string(names, strnlen(names, kNameBytes)));
+    }
+    for (unsigned int i = 0; i < header_->output_count; i++, names += kNameBytes) {
+        output_names_.push_back(std::string(names, strnlen(names, kNameBytes)));
+    }
+    return true;
+}
+
+void Telemetry::Close() {
+    region_.Close();
+    header_ = NULL;
+    input_names_.clear();
+    output_names_.clear();
+}
+
+bool Telemetry::IsOpen() const { return header_ != NULL; }
+const std::vector<std::string>& Telemetry::GetInputNames() const { return input_names_; }
+const std::vector<std::string>& Telemetry::GetOutputNames() const { return output_names_; }
+
+void Telemetry::Publish(int realization, int state, long long route_steps, long long intervals, double elapsed_days,
+                        const double* inputs, const double* outputs) {
+    if (!header_) return;
+    unsigned int s = header_->seq.load(std::memory_order_relaxed);
+    header_->seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    header_->realization = realization;
+    header_->state = state;
+    header_->route_steps = route_steps;
+    header_->intervals = intervals;
+    header_->elapsed_days = elapsed_days;
+    if (inputs) memcpy(Inputs(), inputs, header_->input_count * sizeof(double));
+    if (outputs) memcpy(Outputs(), outputs, header_->output_count * sizeof(double));
+
+    header_->seq.store(s + 2, std::memory_order_release);
+}
+
+void Telemetry::SetState(int state) {
+    if (!header_) return;
+    unsigned int s = header_->seq.load(std::memory_order_relaxed);
+    header_->seq.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->state = state;
+    header_->seq.store(s + 2, std::memory_order_release);
+}
+
+bool Telemetry::Read(Snapshot& snap, int max_attempts) const {
+    if (!header_) return false;
+    snap.inputs.resize(header_->input_count);
+    snap.outputs.resize(header_->output_count);
+    snap.writer_pid = header_->writer_pid;
+    for (int attempt = 0; attempt < max_attempts; attempt++) {
+        unsigned int s1 = header_->seq.load(std::memory_order_acquire);
+        if (s1 & 1) {
+            std::this_thread::yield();      // Writer is mid-update
+            continue;
+        }
+        snap.realization = header_->realization;
+        snap.state = header_->state;
+        snap.route_steps = header_->route_steps;
+        snap.intervals = header_->intervals;
+        snap.elapsed_days = header_->elapsed_days;
+        if (!snap.inputs.empty()) memcpy(snap.inputs.data(), Inputs(), snap.inputs.size() * sizeof(double));
+        if (!snap.outputs.empty()) memcpy(snap.outputs.data(), Outputs(), snap.outputs.size() * sizeof(double));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (header_->seq.load(std::memory_order_relaxed) == s1) return true;
+    }
+    return false;
+}
+
+const char* Telemetry::StateName(int state) {
+    switch (state) {
+    case STATE_IDLE:    return "idle";
+    case STATE_RUNNING: return "running";
+    case STATE_ENDED:   return "ended";
+    case STATE_FAILED:  return "failed";
+    default:            return "unknown";
+    }
+}
+
+std::string Telemetry::PlatformName(const std::string& name) {
+#ifdef _WIN32
+    return "Local\\" + name;
+#else
+    return "/" + name;
+#endif
+}
@@ -0,0 +1,69 @@
+//-----------------------------------------------------------------------------
+//   TelemetryMonitor.cpp
+//   Console reader for the bridge's live telemetry (telemetry section).
+//   It only reads the segment, so a monitor never holds the bridge up.
+//
+//   usage: telemetry_monitor [name] [interval_ms] [count]
+//     name         Segment name from the mapping (default gsswmm_telemetry)
+//     interval_ms  Print a summary line every interval (default: print the
+//                  full state once and exit)
+//     count        Lines to print in interval mode (default: until the
+//                  realization ends or fails)
+//-----------------------------------------------------------------------------
+
+#include "include/Telemetry.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+static const int kReadAttempts = 10000;
+
+static void PrintFull(const Telemetry& t, const Telemetry::Snapshot& s) {
+    printf("writer pid   %lld\n", s.writer_pid);
+    printf("realization  %d (%s)\n", s.realization, Telemetry::StateName(s.state));
+    printf("elapsed      %.6f days\n", s.elapsed_days);
+    printf("route steps  %lld\n", s.route_steps);
+    printf("intervals    %lld\n", s.intervals);
+    for (size_t i = 0; i < s.inputs.size(); i++) printf("  in   %-32s %.6g\n", t.GetInputNames()[i].c_str(), s.inputs[i]);
+    for (size_t i = 0; i < s.outputs.size(); i++) printf("  out  %-32s %.6g\n", t.GetOutputNames()[i].c_str(), s.outputs[i]);
+}
+
+int main(int argc, char** argv) {
+    const std::string name = argc > 1 ? argv[1] : "gsswmm_telemetry";
+    const int interval_ms = argc > 2 ? atoi(argv[2]) : 0;
+    const long count = argc > 3 ? atol(argv[3]) : 0;
+
+    Telemetry t;
+    std::string err;
+    if (!t.Open(name, err)) {
+        fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+    }
+
+    Telemetry::Snapshot s;
+    if (interval_ms <= 0) {
+        if (!t.Read(s, kReadAttempts)) {
+            fprintf(stderr, "Writer too busy for a consistent read\n");
+            return 1;
+        }
+        PrintFull(t, s);
+        return 0;
+    }
+
+    printf("realization,state,elapsed_days,route_steps,intervals");
+    for (const std::string& n : t.GetOutputNames()) printf(",%s", n.c_str());
+    printf("\n");
+    for (long line = 0; count <= 0 || line < count; line++) {
+        if (t.Read(s, kReadAttempts)) {
+            printf("%d,%s,%.6f,%lld,%lld", s.realization, Telemetry::StateName(s.state), s.elapsed_days,
+                   s.route_steps, s.intervals);
+            for (double v : s.outputs) printf(",%.6g", v);
+            printf("\n");
+            fflush(stdout);
+            if (count <= 0 && (s.state == Telemetry::STATE_ENDED || s.state == Telemetry::STATE_FAILED)) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+    }
+    return 0;
+}
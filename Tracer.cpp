@@ -0,0 +1,126 @@
+//-----------------------------------------------------------------------------
+//   Tracer.cpp
+//   Per-thread event buffers written as Chrome trace-event JSON
+//-----------------------------------------------------------------------------
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#include "include/Tracer.h"
+#include "include/Platform.h"
+#include "include/Profiler.h"
+#include <cstdio>
+
+// The calling thread's buffer in the tracer it last used
+struct TraceCache {
+    const Tracer* owner;
+    unsigned int generation;
+    void* buffer;
+};
+static thread_local TraceCache t_cache = { NULL, 0, NULL };
+
+Tracer::Tracer() : active_(false), generation_(0), capacity_(0), origin_ns_(0) {}
+
+Tracer::~Tracer() {
+    for (ThreadBuffer* b : buffers_) delete b;
+}
+
+void Tracer::Start(int events_per_thread) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (ThreadBuffer* b : buffers_) delete b;
+    buffers_.clear();
+    generation_++;
+    capacity_ = events_per_thread < 1 ? 1 : events_per_thread;
+    origin_ns_ = Profiler::Now();
+    active_.store(true);
+}
+
+void Tracer::Stop() {
+    active_.store(false);
+}
+
+Tracer::ThreadBuffer* Tracer::Local() {
+    if (t_cache.owner == this && t_cache.generation == generation_) return (ThreadBuffer*)t_cache.buffer;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    ThreadBuffer* b = new ThreadBuffer();
+    b->tid = (int)buffers_.size() + 1;
+    b->name = NULL;
+    b->events.resize((size_t)capacity_);
+    b->count.store(0);
+    b->dropped = 0;
+    buffers_.push_back(b);
+    t_cache.owner = this;
+    t_cache.generation = generation_;
+    t_cache.buffer = b;
+    return b;
+}
+
+void Tracer::Add(const char* name, long long begin_ns, long long duration_ns) {
+    if (!IsActive()) return;
+    ThreadBuffer* b = Local();
+    size_t n = b->count.load(std::memory_order_relaxed);
+    if (n >= b->events.size()) {
+        b->dropped++;
+        return;
+    }
+    Event& e = b->events[n];
+    e.name = name;
+    e.begin_ns = begin_ns;
+    e.duration_ns = duration_ns;
+    b->count.store(n + 1, std::memory_order_release);
+}
+
+void Tracer::NameThread(const char* name) {
+    if (!IsActive()) return;
+    Local()->name = name;
+}
+
+long long Tracer::GetEventCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    long long n = 0;
+    for (const ThreadBuffer* b : buffers_) n += (long long)b->count.load(std::memory_order_acquire);
+    return n;
+}
+
+long long Tracer::GetDroppedCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    long long n = 0;
+    for (const ThreadBuffer* b : buffers_) n += b->dropped;
+    return n;
+}
+
+bool Tracer::Write(const std::string& path) const {
+    FILE* f = NULL;
+    if (fopen_s(&f, path.c_str(), "w") != 0 || !f) return false;
+#ifdef _WIN32
+    long pid = (long)GetCurrentProcessId();
+#else
+    long pid = (long)getpid();
+#endif
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    long long dropped = 0;
+    fprintf(f, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    fprintf(f, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %ld, \"tid\": 0, \"args\": {\"name\": \"GSswmm bridge\"}}", pid);
+    for (const ThreadBuffer* b : buffers_) {
+        char fallback[32];
+        sprintf_s(fallback, "thread %d", b->tid);
+        fprintf(f, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %ld, \"tid\": %d, \"args\": {\"name\": \"%s\"}}",
+            pid, b->tid, b->name ? b->name : fallback);
+        size_t n = b->count.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; i++) {
+            const Event& e = b->events[i];
+            // Microseconds, as the format expects
+            fprintf(f, ",\n{\"name\": \"%s\", \"cat\": \"bridge\", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": %ld, \"tid\": %d}",
+                e.name, (e.begin_ns - origin_ns_) / 1e3, e.duration_ns / 1e3, pid, b->tid);
+        }
+        dropped += b->dropped;
+    }
+    fprintf(f, "\n], \"otherData\": {\"dropped_events\": %lld}}\n", dropped);
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
@@ -0,0 +1,254 @@
+//-----------------------------------------------------------------------------
+//   WorkerPool.cpp
+//   Worker processes that each host a private SWMM instance
+//-----------------------------------------------------------------------------
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <csignal>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+#include "include/WorkerPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+static const int kLivenessSliceMs = 250;    // Worker exit is noticed within this
+static const int kStopWaitMs = 2000;        // Grace period after WORKER_SHUTDOWN
+
+WorkerPool::WorkerPool() : sequence_(0), spin_us_(50) {}
+
+WorkerPool::~WorkerPool() {
+    Shutdown();
+}
+
+void WorkerPool::SetSpin(int spin_us) { spin_us_ = spin_us < 0 ? 0 : spin_us; }
+int WorkerPool::GetWorkerCount() const { return (int)workers_.size(); }
+bool WorkerPool::IsBound(const std::string& dir, int member) const { return Find(dir, member) != NULL; }
+
+WorkerPool::Worker* WorkerPool::Find(const std::string& dir, int member) const {
+    for (Worker* w : workers_) {
+        if (w->dir == dir && w->member == member) return w;
+    }
+    return NULL;
+}
+
+bool WorkerPool::Bind(const std::string& dir, int member, const std::string& command, int capacity, int timeout_ms, std::string& error) {
+    Worker* w = Find(dir, member);
+    if (w && (w->capacity < capacity || !IsAlive(*w))) {
+        Stop(w, true);
+        w = NULL;
+    }
+    if (w) return true;
+
+    w = new Worker();
+    w->dir = dir;
+    w->member = member;
+    w->pid = 0;
+    w->process = NULL;
+    w->capacity = capacity;
+    if (!w->channel.Create(SharedChannel::MakeName(++sequence_), capacity, error) || !Launch(*w, command, error)) {
+        delete w;
+        return false;
+    }
+    workers_.push_back(w);
+
+    // The worker announces itself once it has opened the channel
+    SharedChannel::Message msg;
+    int waited = 0;
+    for (;;) {
+        int slice = timeout_ms - waited < kLivenessSliceMs ? timeout_ms - waited : kLivenessSliceMs;
+        if (slice > 0 && w->channel.Receive(SharedChannel::TO_CLIENT, msg, NULL, 0, slice, 0) == 1) {
+            if (msg.method == WORKER_READY) return true;
+            continue;
+        }
+        waited += slice;
+        if (!IsAlive(*w)) {
+            error = "SWMM worker exited during startup: " + command;
+            break;
+        }
+        if (waited >= timeout_ms) {
+            error = "SWMM worker did not start in time: " + command;
+            break;
+        }
+    }
+    Stop(w, false);
+    return false;
+}
+
+bool WorkerPool::Send(const std::string& dir, int member, int method, const double* inargs, int nin, int nout, std::string& error) {
+    Worker* w = Find(dir, member);
+    if (!w) {
+        error = "No SWMM worker bound to " + dir;
+        return false;
+    }
+    if (!w->channel.Post(SharedChannel::TO_WORKER, method, member, nout, inargs, nin, NULL)) {
+        error = "SWMM worker channel is full or too small";
+        Stop(w, false);
+        return false;
+    }
+    return true;
+}
+
+bool WorkerPool::Wait(const std::string& dir, int member, int* status, double* outargs, int nout,
+                      int timeout_ms, std::string& text, std::string& error) {
+    text.clear();
+    Worker* w = Find(dir, member);
+    if (!w) {
+        error = "No SWMM worker bound to " + dir;
+        return false;
+    }
+
+    SharedChannel::Message msg;
+    if ((int)reply_.size() < w->capacity) reply_.resize(w->capacity);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (;;) {
+        int slice = kLivenessSliceMs;
+        if (timeout_ms >= 0) {
+            long long left = timeout_ms - std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            if (left <= 0) {
+                error = "SWMM worker did not reply in time";
+                Stop(w, false);
+                return false;
+            }
+            if (left < slice) slice = (int)left;
+        }
+        if (w->channel.Receive(SharedChannel::TO_CLIENT, msg, reply_.data(), w->capacity, slice, spin_us_) == 1) break;
+        if (!IsAlive(*w)) {
+            error = "SWMM worker exited unexpectedly";
+            Stop(w, false);
+            return false;
+        }
+    }
+
+    *status = msg.status;
+    int n = msg.count < nout ? msg.count : nout;
+    if (n > 0) memcpy(outargs, reply_.data(), (size_t)n * sizeof(double));
+    text = msg.text;
+    return true;
+}
+
+bool WorkerPool::Call(const std::string& dir, int member, int method, int* status, const double* inargs, int nin,
+                      double* outargs, int nout, int timeout_ms, std::string& text, std::string& error) {
+    return Send(dir, member, method, inargs, nin, nout, error) &&
+           Wait(dir, member, status, outargs, nout, timeout_ms, text, error);
+}
+
+void WorkerPool::Release(const std::string& dir) {
+    // Ask them all first so they exit in parallel
+    for (Worker* w : workers_) {
+        if (w->dir == dir && IsAlive(*w)) w->channel.Post(SharedChannel::TO_WORKER, WORKER_SHUTDOWN, 0, 0, NULL, 0, NULL);
+    }
+    for (size_t i = workers_.size(); i-- > 0;) {
+        if (workers_[i]->dir == dir) Stop(workers_[i], true);
+    }
+}
+
+void WorkerPool::Shutdown() {
+    for (Worker* w : workers_) {
+        if (IsAlive(*w)) w->channel.Post(SharedChannel::TO_WORKER, WORKER_SHUTDOWN, 0, 0, NULL, 0, NULL);
+    }
+    while (!workers_.empty()) Stop(workers_.back(), true);
+}
+
+//-----------------------------------------------------------------------------
+//   Process control
+//-----------------------------------------------------------------------------
+
+static std::string ExpandCommand(const std::string& command, const std::string& channel) {
+    std::string cmd = command;
+    size_t pos = cmd.find("{channel}");
+    if (pos != std::string::npos) cmd.replace(pos, 9, channel);
+    else cmd += " " + channel;
+    return cmd;
+}
+
+#ifdef _WIN32
+
+bool WorkerPool::Launch(Worker& w, const std::string& command, std::string& error) {
+    std::string cmd = ExpandCommand(command, w.channel.GetName());
+    std::vector<char> line(cmd.begin(), cmd.end());
+    line.push_back('\0');
+    STARTUPINFOA si;
+    PROCESS_INFORMATION pi;
+    memset(&si, 0, sizeof(si));
+    si.cb = sizeof(si);
+    memset(&pi, 0, sizeof(pi));
+    if (!CreateProcessA(NULL, line.data(), NULL, NULL, FALSE, CREATE_NO_WINDOW, NULL,
+                        w.dir.empty() ? NULL : w.dir.c_str(), &si, &pi)) {
+        error = "Cannot start SWMM worker: " + cmd;
+        return false;
+    }
+    CloseHandle(pi.hThread);
+    w.process = pi.hProcess;
+    w.pid = (long long)pi.dwProcessId;
+    return true;
+}
+
+bool WorkerPool::IsAlive(Worker& w) {
+    return w.process && WaitForSingleObject((HANDLE)w.process, 0) == WAIT_TIMEOUT;
+}
+
+void WorkerPool::Stop(Worker* w, bool ask) {
+    if (ask && IsAlive(*w) && w->channel.Post(SharedChannel::TO_WORKER, WORKER_SHUTDOWN, 0, 0, NULL, 0, NULL)) {
+        WaitForSingleObject((HANDLE)w->process, kStopWaitMs);
+    }
+    if (w->process) {
+        if (IsAlive(*w)) TerminateProcess((HANDLE)w->process, 1);
+        CloseHandle((HANDLE)w->process);
+    }
+    w->channel.Close();
+    workers_.erase(std::find(workers_.begin(), workers_.end(), w));
+    delete w;
+}
+
+#else
+
+bool WorkerPool::Launch(Worker& w, const std::string& command, std::string& error) {
+    std::string cmd = ExpandCommand(command, w.channel.GetName());
+    // exec so the shell is replaced and pid is the worker itself. Built
+    // before fork(): the child of a threaded process must not allocate.
+    std::string line = "exec " + cmd;
+    pid_t pid = fork();
+    if (pid < 0) {
+        error = "Cannot start SWMM worker: " + cmd;
+        return false;
+    }
+    if (pid == 0) {
+        if (!w.dir.empty() && chdir(w.dir.c_str()) != 0) _exit(126);
+        execl("/bin/sh", "sh", "-c", line.c_str(), (char*)NULL);
+        _exit(127);
+    }
+    w.pid = (long long)pid;
+    return true;
+}
+
+bool WorkerPool::IsAlive(Worker& w) {
+    if (w.pid <= 0) return false;
+    int st = 0;
+    if (waitpid((pid_t)w.pid, &st, WNOHANG) == 0) return true;
+    w.pid = 0;      // Reaped
+    return false;
+}
+
+void WorkerPool::Stop(Worker* w, bool ask) {
+    if (ask && IsAlive(*w) && w->channel.Post(SharedChannel::TO_WORKER, WORKER_SHUTDOWN, 0, 0, NULL, 0, NULL)) {
+        for (int waited = 0; waited < kStopWaitMs && IsAlive(*w); waited += 10) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    if (IsAlive(*w)) {
+        kill((pid_t)w->pid, SIGKILL);
+        waitpid((pid_t)w->pid, NULL, 0);
+    }
+    w->channel.Close();
+    workers_.erase(std::find(workers_.begin(), workers_.end(), w));
+    delete w;
+}
+
+#endif
@@ -0,0 +1,241 @@
+//-----------------------------------------------------------------------------
+//   BridgeLog.h
+//   Asynchronous logging to bridge_debug.log
+//
+//   Log() packs its arguments into a binary record in a preallocated
+//   lock-free ring buffer; a background writer thread formats the records
+//   and appends them to a file it keeps open. Outside LogStart()/LogStop()
+//   records are formatted and written synchronously.
+//-----------------------------------------------------------------------------
+
+#ifndef BRIDGE_LOG_H
+#define BRIDGE_LOG_H
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Logging: 0=OFF, 1=ERROR, 2=INFO, 3=DEBUG
+#define LOG_LEVEL_OFF   0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_INFO  2
+#define LOG_LEVEL_DEBUG 3
+
+// Highest level compiled into the DLL. Build with /DBRIDGE_LOG_MAX_LEVEL=2
+// to strip every LogDebug() call (including argument evaluation).
+#ifndef BRIDGE_LOG_MAX_LEVEL
+#define BRIDGE_LOG_MAX_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+#define LOG_FILE "bridge_debug.log"
+
+// Runtime level (set from SwmmGoldSimBridge.json)
+extern int g_log_level;
+
+void LogSetLevel(int level);
+int LogGetLevel();
+
+/**
+ * @brief Write to another file than LOG_FILE (e.g. a worker process)
+ * @note Call before the first Log(); the new file is truncated when first opened
+ */
+void LogSetFile(const std::string& path);
+
+/**
+ * @brief Open the log file and start the background writer thread
+ * @note Call from the GoldSim thread; no-op if already running
+ */
+void LogStart();
+
+/**
+ * @brief Drain all queued records, stop the writer thread and close the file
+ * @note Must not be called while other threads are still logging
+ */
+void LogStop();
+
+/**
+ * @brief Block until every record queued so far has been written and flushed
+ */
+void LogFlush();
+
+namespace BridgeLogDetail {
+
+const int kPayloadBytes = 224;
+
+typedef int (*FormatFn)(char* out, size_t size, const char* fmt, const unsigned char* payload);
+
+// One ring buffer cell. seq follows the bounded MPMC queue protocol
+// (D. Vyukov): seq == pos means free for producer pos, seq == pos + 1
+// means published for the consumer.
+struct Record {
+    std::atomic<size_t> seq;
+    size_t pos;
+    int level;
+    time_t timestamp;
+    const char* fmt;
+    FormatFn format;
+    unsigned char payload[kPayloadBytes];
+};
+
+// Claim a ring cell; returns NULL when the writer thread is not running
+Record* BeginRecord();
+void CommitRecord(Record* r);
+void WriteNow(Record* r);
+int FormatTruncated(char* out, size_t size, const char* fmt, const unsigned char* payload);
+
+class Packer {
+public:
+    Packer(unsigned char* buf, size_t cap) : buf_(buf), cap_(cap), used_(0), overflow_(false) {}
+
+    template<typename T>
+    void Put(const T& v) {
+        if (used_ + sizeof(T) > cap_) { overflow_ = true; return; }
+        memcpy(buf_ + used_, &v, sizeof(T));
+        used_ += sizeof(T);
+    }
+
+    // Strings are copied inline (length-prefixed, NUL-terminated) and
+    // truncated so a few scalar arguments after them still fit
+    void PutString(const char* s) {
+        const size_t kScalarReserve = 32;
+        if (!s) s = "(null)";
+        if (used_ + sizeof(unsigned short) + 1 > cap_) { overflow_ = true; return; }
+        size_t room = cap_ - used_ - sizeof(unsigned short) - 1;
+        room = (room > kScalarReserve) ? room - kScalarReserve : 0;
+        size_t len = strlen(s);
+        if (len > room) len = room;
+        Put((unsigned short)len);
+        memcpy(buf_ + used_, s, len);
+        buf_[used_ + len] = '\0';
+        used_ += len + 1;
+    }
+
+    bool Overflow() const { return overflow_; }
+
+private:
+    unsigned char* buf_;
+    size_t cap_;
+    size_t used_;
+    bool overflow_;
+};
+
+class Unpacker {
+public:
+    explicit Unpacker(const unsigned char* p) : p_(p) {}
+
+    template<typename T>
+    T Get() {
+        T v;
+        memcpy(&v, p_, sizeof(T));
+        p_ += sizeof(T);
+        return v;
+    }
+
+    const char* GetString() {
+        unsigned short len = Get<unsigned short>();
+        const char* s = (const char*)p_;
+        p_ += len + 1;
+        return s;
+    }
+
+private:
+    const unsigned char* p_;
+};
+
+// Scalars are stored by value; strings are copied into the record
+template<typename T>
+struct ArgCodec {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value,
+                  "Log() arguments must be scalars, pointers or strings");
+    typedef T Out;
+    static void Pack(Packer& p, const T& v) { p.Put(v); }
+    static Out Unpack(Unpacker& u) { return u.Get<T>(); }
+};
+
+template<>
+struct ArgCodec<const char*> {
+    typedef const char* Out;
+    static void Pack(Packer& p, const char* v) { p.PutString(v); }
+    static Out Unpack(Unpacker& u) { return u.GetString(); }
+};
+
+template<>
+struct ArgCodec<char*> {
+    typedef const char* Out;
+    static void Pack(Packer& p, const char* v) { p.PutString(v); }
+    static Out Unpack(Unpacker& u) { return u.GetString(); }
+};
+
+template<>
+struct ArgCodec<std::string> {
+    typedef const char* Out;
+    static void Pack(Packer& p, const std::string& v) { p.PutString(v.c_str()); }
+    static Out Unpack(Unpacker& u) { return u.GetString(); }
+};
+
+// Formatting is deferred to the writer thread: one instantiation per
+// argument list unpacks the record and calls snprintf.
+template<typename... A>
+struct Formatter {
+    static int Format(char* out, size_t size, const char* fmt, const unsigned char* payload) {
+        Unpacker u(payload);
+        // Braced initialization evaluates the Unpack calls left to right
+        std::tuple<typename ArgCodec<A>::Out...> vals{ ArgCodec<A>::Unpack(u)... };
+        return Call(out, size, fmt, vals, std::index_sequence_for<A...>());
+    }
+
+    template<typename Tuple, size_t... I>
+    static int Call(char* out, size_t size, const char* fmt, const Tuple& vals, std::index_sequence<I...>) {
+        (void)vals;
+        return snprintf(out, size, fmt, std::get<I>(vals)...);
+    }
+};
+
+template<typename... A>
+inline void PackAll(Packer& p, const A&... args) {
+    int expand[] = { 0, (ArgCodec<typename std::decay<A>::type>::Pack(p, args), 0)... };
+    (void)expand;
+}
+
+} // namespace BridgeLogDetail
+
+/**
+ * @brief Log a printf-style message
+ * @param level LOG_LEVEL_ERROR, LOG_LEVEL_INFO or LOG_LEVEL_DEBUG
+ * @param fmt Format string; must be a string literal (it is formatted later)
+ * @note ERROR records are flushed to disk before returning
+ */
+template<typename... A>
+inline void Log(int level, const char* fmt, const A&... args) {
+    if (level > BRIDGE_LOG_MAX_LEVEL || level > g_log_level) return;
+
+    using namespace BridgeLogDetail;
+    Record local;
+    Record* r = BeginRecord();
+    bool async = (r != NULL);
+    if (!async) r = &local;
+
+    r->level = level;
+    r->timestamp = time(NULL);
+    r->fmt = fmt;
+    Packer p(r->payload, sizeof(r->payload));
+    PackAll(p, args...);
+    r->format = p.Overflow() ? &FormatTruncated : &Formatter<typename std::decay<A>::type...>::Format;
+
+    if (async) CommitRecord(r);
+    else WriteNow(r);
+    if (level == LOG_LEVEL_ERROR && async) LogFlush();
+}
+
+#if BRIDGE_LOG_MAX_LEVEL >= LOG_LEVEL_DEBUG
+#define LogDebug(...) Log(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define LogDebug(...) ((void)0)
+#endif
+
+#endif
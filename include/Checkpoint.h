@@ -0,0 +1,121 @@
+//-----------------------------------------------------------------------------
+//   Checkpoint.h
+//   Mid-run checkpoints: a SWMM hotstart file plus the bridge state needed to
+//   continue a realization, and lookup of the newest valid one for resuming
+//
+//   Files in the checkpoint directory, for model hash H:
+//     ckpt_H_<seconds>.hsf     SWMM hotstart (swmm_saveHotstart)
+//     ckpt_H_<seconds>.state   Bridge state with a checksum
+//     ckpt_H.list              Committed checkpoints, newest first
+//   Every file is written under a temporary name and renamed into place,
+//   and a checkpoint counts only once the list names it, so a crash at any
+//   point leaves the previous checkpoints usable. The renames, the state
+//   file and pruning run on a background thread; the caller only waits for
+//   SWMM to write the hotstart.
+//-----------------------------------------------------------------------------
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct CheckpointState {
+    unsigned long long model_hash;
+    double start_days;              // SWMM start of the checkpointed run (days since 01/01/1900)
+    double elapsed_sec;             // Bridge clock (SWMM elapsed time) at the checkpoint
+    long interval_count;
+    long route_steps;
+    int first_calculate;
+    int realization;
+    std::vector<double> pending_inputs;
+    std::vector<double> runtime;    // Statistics, controller and fast-forward state (bridge layout)
+    CheckpointState()
+        : model_hash(0), start_days(0.0), elapsed_sec(0.0), interval_count(0), route_steps(0),
+          first_calculate(1), realization(0) {}
+};
+
+class CheckpointStore {
+public:
+    CheckpointStore();
+    ~CheckpointStore();
+    CheckpointStore(const CheckpointStore&) = delete;
+    CheckpointStore& operator=(const CheckpointStore&) = delete;
+
+    /**
+     * @brief Use a directory for one model and start the writer thread
+     * @param keep Checkpoints kept; older ones are deleted as new ones commit
+     */
+    bool Open(const std::string& dir, unsigned long long model_hash, int keep, std::string& error);
+
+    /**
+     * @brief Finish queued commits and stop the writer thread
+     * @return false if any commit failed
+     */
+    bool Close();
+
+    bool IsOpen() const { return thread_ != NULL; }
+
+    /**
+     * @brief Where SWMM should write the hotstart for a checkpoint at elapsed_sec
+     */
+    std::string HotstartTempPath(double elapsed_sec) const;
+
+    /**
+     * @brief Queue a checkpoint whose hotstart is at HotstartTempPath()
+     * @note Returns at once; the state is copied
+     */
+    void Commit(const CheckpointState& state);
+
+    /**
+     * @brief Wait until every queued checkpoint is committed
+     */
+    void Flush();
+
+    /**
+     * @brief Delete every checkpoint of this model (the run it belongs to ended)
+     */
+    void Discard();
+
+    /**
+     * @brief Newest committed checkpoint whose files are intact
+     * @param hotstart_path Receives its hotstart file
+     * @return false if there is none (error says why)
+     */
+    bool FindLatest(CheckpointState& state, std::string& hotstart_path, std::string& error) const;
+
+    int GetCommittedCount() const;
+    const std::string& GetLastError() const { return last_error_; }
+
+private:
+    std::string BaseName(double elapsed_sec) const;
+    std::string ListPath() const;
+    bool WriteCheckpoint(const CheckpointState& state, std::string& error);
+    bool WriteList(std::string& error);
+    void Run();
+
+    std::string dir_;
+    unsigned long long hash_;
+    int keep_;
+    std::deque<std::string> committed_;     // Base names, newest first (writer thread)
+
+    std::thread* thread_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<CheckpointState> queue_;
+    bool busy_;
+    bool stop_;
+    bool failed_;
+    std::string last_error_;
+};
+
+/**
+ * @brief Replace a file by renaming another over it
+ */
+bool ReplaceFileAtomic(const std::string& from, const std::string& to);
+
+#endif
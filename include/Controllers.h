@@ -0,0 +1,126 @@
+//-----------------------------------------------------------------------------
+//   Controllers.h
+//   Native controllers (deadband, PID, lookup table) evaluated before every
+//   routing step: each reads one SWMM sensor through swmm_getValue and
+//   writes one link setting through swmm_setValue
+//
+//   GoldSim only supplies setpoints (CONTROLLER inputs), so it can run at a
+//   coarse time step while control decisions keep routing-step resolution.
+//-----------------------------------------------------------------------------
+
+#ifndef CONTROLLERS_H
+#define CONTROLLERS_H
+
+#include <string>
+#include <vector>
+
+class ControllerBank {
+public:
+    enum Type {
+        DEADBAND = 0,   // On/off with hysteresis between two levels
+        PID,            // Proportional-integral-derivative on setpoint error
+        TABLE,          // Setting looked up from the sensor value
+        TYPE_COUNT
+    };
+
+    // Parameters GoldSim can drive through CONTROLLER inputs
+    enum Param {
+        SETPOINT = 0,   // PID
+        ON_LEVEL,       // DEADBAND
+        OFF_LEVEL,      // DEADBAND
+        ENABLED,        // All types; 0 leaves the actuator at its last setting
+        PARAM_COUNT
+    };
+
+    struct Definition {
+        int type;
+        int sensor_prop;        // swmm_getValue property
+        int sensor_index;
+        int actuator_index;     // Link whose swmm_LINK_SETTING is written
+        double setpoint, kp, ki, kd;        // PID (error = sensor - setpoint)
+        double min_setting, max_setting;    // PID output limits
+        double on_level, off_level;         // DEADBAND switch levels
+        double on_setting, off_setting;     // DEADBAND settings
+        std::vector<double> table_x, table_y; // TABLE points, x ascending
+        bool table_step;                    // TABLE: hold instead of interpolate
+        Definition()
+            : type(DEADBAND), sensor_prop(0), sensor_index(-1), actuator_index(-1),
+              setpoint(0.0), kp(0.0), ki(0.0), kd(0.0), min_setting(0.0), max_setting(1.0),
+              on_level(0.0), off_level(0.0), on_setting(1.0), off_setting(0.0), table_step(false) {}
+    };
+
+    ControllerBank();
+    ~ControllerBank();
+    ControllerBank(const ControllerBank&) = delete;
+    ControllerBank& operator=(const ControllerBank&) = delete;
+
+    /**
+     * @brief Add a compiled controller
+     * @return Slot used by SetParam()
+     */
+    int Add(const Definition& def);
+
+    /**
+     * @brief Restore configured parameters and clear PID/deadband state
+     * @note Call at the start of every realization
+     */
+    void Reset();
+
+    /**
+     * @brief Override a parameter until the next Reset()
+     */
+    void SetParam(int slot, int param, double value);
+
+    /**
+     * @brief Evaluate every enabled controller at SWMM time elapsed_sec
+     * @return Number of settings written (unchanged settings are not rewritten)
+     */
+    int Update(double elapsed_sec);
+
+    /**
+     * @brief Append parameters, PID and deadband state to a checkpoint's state
+     */
+    void SaveState(std::vector<double>& out) const;
+
+    /**
+     * @brief Restore state written by SaveState()
+     * @param pos Read position in data, moved past this object's state
+     * @return false if the saved controller count does not match (nothing changed)
+     * @note Settings are written again on the next Update()
+     */
+    bool RestoreState(const std::vector<double>& data, size_t& pos);
+
+    void Clear();
+    int GetCount() const;
+    bool IsEmpty() const;
+
+private:
+    struct State {
+        double params[PARAM_COUNT];
+        double integral;
+        double prev_measured;
+        double last_setting;    // NaN until first written
+        bool on;
+        bool primed;            // prev_measured is valid
+    };
+
+    double Evaluate(const Definition& def, State& st, double measured, double dt) const;
+
+    std::vector<Definition> defs_;
+    std::vector<State> states_;
+    double last_time_;
+};
+
+/**
+ * @brief Map a controller "type" name from SwmmGoldSimBridge.json
+ * @return ControllerBank::Type, or -1 if the name is unknown
+ */
+int ControllerTypeFromName(const std::string& name);
+
+/**
+ * @brief Map a CONTROLLER input property to a parameter of the given type
+ * @return ControllerBank::Param, or -1 if that type has no such parameter
+ */
+int ControllerParamFromName(int type, const std::string& name);
+
+#endif
@@ -0,0 +1,82 @@
+//-----------------------------------------------------------------------------
+//   Expression.h
+//   Arithmetic expression outputs ("ST1.VOLUME + ST2.VOLUME") compiled once
+//   to stack bytecode and evaluated after every gather
+//
+//   Grammar:
+//     expr    := term (('+' | '-') term)*
+//     term    := unary (('*' | '/') unary)*
+//     unary   := '-' unary | power
+//     power   := primary ('^' unary)?
+//     primary := number | ref | func '(' expr (',' expr)* ')' | '(' expr ')'
+//     ref     := [TYPE ':'] name '.' PROPERTY
+//   name is letters, digits and '_' or any text in single quotes; func is
+//   min, max (any number of arguments), abs or sqrt. Constant
+//   sub-expressions are folded at compile time.
+//-----------------------------------------------------------------------------
+
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <string>
+#include <vector>
+
+class ExpressionProgram {
+public:
+    // Element/property read by the program; resolved by the bridge
+    struct Reference {
+        std::string object_type;    // Optional TYPE: prefix ("" = infer from name)
+        std::string name;
+        std::string property;
+        int prop;                   // swmm_getValue property (-1 until resolved)
+        int index;                  // Element index (-1 until resolved)
+    };
+
+    ExpressionProgram();
+
+    /**
+     * @brief Parse text into bytecode; identical references share one slot
+     * @return false on a syntax error (error describes the position)
+     */
+    bool Compile(const std::string& text, std::string& error);
+
+    int GetReferenceCount() const;
+    const Reference& GetReference(int i) const;
+    void ResolveReference(int i, int prop, int index);
+
+    /**
+     * @brief Run the program on the current reference values
+     * @param ref_values One value per reference, indexed like GetReference()
+     */
+    double Evaluate(const double* ref_values) const;
+
+    const std::string& GetText() const;
+    int GetInstructionCount() const;
+    int GetMaxStack() const;
+
+    enum { MAX_STACK = 32 };
+
+private:
+    enum Op {
+        OP_CONST = 0, OP_REF,
+        OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_MIN, OP_MAX,
+        OP_NEG, OP_ABS, OP_SQRT
+    };
+    struct Instr {
+        int op;
+        int arg;        // OP_REF: reference slot
+        double value;   // OP_CONST: constant
+    };
+
+    friend class ExpressionParser;
+    void Emit(int op, int arg, double value);   // Appends, folding constant operands
+    static double Fold(int op, double a, double b);
+
+    std::string text_;
+    std::vector<Instr> code_;
+    std::vector<Reference> refs_;
+    int depth_;
+    int max_stack_;
+};
+
+#endif
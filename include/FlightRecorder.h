@@ -0,0 +1,74 @@
+//-----------------------------------------------------------------------------
+//   FlightRecorder.h
+//   Fixed-size in-memory ring of the last N calculate steps (applied
+//   inputs, swmm_step return code, elapsed time and gathered outputs),
+//   written to disk only when something goes wrong
+//
+//   Records are fixed-length rows of doubles in one buffer allocated by
+//   Configure(), so recording a step is a copy and never allocates.
+//-----------------------------------------------------------------------------
+
+#ifndef FLIGHT_RECORDER_H
+#define FLIGHT_RECORDER_H
+
+#include <string>
+#include <vector>
+
+class FlightRecorder {
+public:
+    FlightRecorder();
+    ~FlightRecorder();
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    /**
+     * @brief Size the ring and forget all records
+     * @param steps Records kept (the oldest is overwritten)
+     * @param input_names Column names, one per input value
+     * @param output_names Column names, one per output value
+     */
+    void Configure(int steps, const std::vector<std::string>& input_names,
+                   const std::vector<std::string>& output_names);
+
+    /**
+     * @brief Forget the records, keep the configuration
+     */
+    void Clear();
+
+    bool IsConfigured() const;
+
+    /**
+     * @brief Record one step
+     * @param step Routing steps completed
+     * @param elapsed_days SWMM elapsed time
+     * @param code swmm_step return code
+     * @param inputs Inputs applied over the step (NULL = none, written as NaN)
+     * @param outputs Gathered outputs (NULL = none, written as NaN)
+     */
+    void Record(long step, double elapsed_days, int code, const double* inputs, const double* outputs);
+
+    /**
+     * @brief Records currently held (at most the configured steps)
+     */
+    int GetCount() const;
+
+    /**
+     * @brief Write the records oldest first as CSV
+     * @param reason First line of the file
+     */
+    bool Dump(const std::string& path, const std::string& reason) const;
+
+private:
+    enum { FIELD_STEP = 0, FIELD_ELAPSED, FIELD_CODE, FIELD_COUNT };
+
+    int steps_;
+    int inputs_;
+    int outputs_;
+    size_t row_;                    // Doubles per record
+    std::vector<double> ring_;
+    long long written_;             // Records ever written since Clear()
+    std::vector<std::string> input_names_;
+    std::vector<std::string> output_names_;
+};
+
+#endif
@@ -0,0 +1,33 @@
+//-----------------------------------------------------------------------------
+//   Hash.h
+//   64-bit FNV-1a hashing for cache keys
+//-----------------------------------------------------------------------------
+
+#ifndef BRIDGE_HASH_H
+#define BRIDGE_HASH_H
+
+#include <cstddef>
+#include <string>
+
+#define FNV64_OFFSET_BASIS 14695981039346656037ULL
+#define FNV64_PRIME        1099511628211ULL
+
+/**
+ * @brief 64-bit FNV-1a hash of a byte range
+ * @param seed Previous hash to chain from (FNV64_OFFSET_BASIS to start)
+ */
+inline unsigned long long Fnv1a64(const void* data, size_t size, unsigned long long seed = FNV64_OFFSET_BASIS) {
+    const unsigned char* p = (const unsigned char*)data;
+    unsigned long long h = seed;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= FNV64_PRIME;
+    }
+    return h;
+}
+
+inline unsigned long long Fnv1a64(const std::string& data, unsigned long long seed = FNV64_OFFSET_BASIS) {
+    return Fnv1a64(data.data(), data.size(), seed);
+}
+
+#endif
@@ -0,0 +1,97 @@
+//-----------------------------------------------------------------------------
+//   InputSeries.h
+//   Preloaded input time series (timeseries_inputs section): one value
+//   column of a CSV or binary file, read through a cursor that moves forward
+//   with the bridge clock, so a lookup costs no search
+//
+//   Binary format, memory-mapped: InputSeries::FileHeader, then
+//   rows x (1 + columns) doubles, row-major: time, value 1 .. columns
+//   CSV: "time,value1,value2,..." per line (commas, semicolons, tabs or
+//   spaces); a first line that does not start with a number is a header,
+//   and lines starting with ';' or '#' are comments. Parsed once.
+//   Times are measured from the start of the bridge clock, in the unit given
+//   at Load(), and must increase.
+//-----------------------------------------------------------------------------
+
+#ifndef INPUT_SERIES_H
+#define INPUT_SERIES_H
+
+#include <string>
+#include <vector>
+
+class InputSeries {
+public:
+    enum Interp { HOLD = 0, LINEAR = 1 };
+
+    struct FileHeader {
+        char magic[8];              // "GSTSER01"
+        unsigned int columns;       // Values per row, not counting the time
+        unsigned int reserved;
+        unsigned long long rows;
+        unsigned long long data_offset;     // Bytes from the file start to row 0
+    };
+
+    InputSeries();
+    ~InputSeries();
+    InputSeries(const InputSeries&) = delete;
+    InputSeries& operator=(const InputSeries&) = delete;
+
+    /**
+     * @brief Map or parse a series file
+     * @param column Value column, 1 = the first after the time
+     * @param seconds_per_unit Length of one file time unit in seconds
+     * @param interp HOLD steps from row to row, LINEAR interpolates between rows
+     * @return false if the file is missing, malformed or has no such column
+     */
+    bool Load(const std::string& path, int column, double seconds_per_unit, Interp interp, std::string& error);
+    void Close();
+
+    bool IsMapped() const { return view_ != NULL; }
+    Interp GetInterp() const { return interp_; }
+    size_t GetRowCount() const { return rows_; }
+    double GetStartSeconds() const { return rows_ ? Time(0) * scale_ : 0.0; }
+    double GetEndSeconds() const { return rows_ ? Time(rows_ - 1) * scale_ : 0.0; }
+
+    /**
+     * @brief Place the cursor at a time (binary search; start of a realization)
+     */
+    void Seek(double seconds);
+
+    /**
+     * @brief Value at a time, moving the cursor forward to it
+     * @note Before the first row the first value holds, after the last row
+     *       the last value holds. Stepping back in time re-seeks.
+     */
+    double ValueAt(double seconds);
+
+    /**
+     * @brief Largest |value| from t0 to t1, without moving the cursor
+     * @note Scans forward from the cursor; used to decide whether an
+     *       interval is quiet enough to fast-forward
+     */
+    double PeakAbs(double t0, double t1) const;
+
+private:
+    double Time(size_t i) const { return data_[i * stride_]; }
+    double Value(size_t i) const { return data_[i * stride_ + column_]; }
+    size_t Find(double t) const;
+    bool LoadBinary(const std::string& path, int column, std::string& error);
+    bool LoadCsv(const std::string& path, int column, std::string& error);
+    void Unmap();
+
+    const double* data_;
+    size_t rows_;
+    size_t stride_;                 // Doubles per row
+    size_t column_;                 // Offset of the value within a row
+    double scale_;                  // Seconds per file time unit
+    Interp interp_;
+    size_t cursor_;                 // Last row with time <= the last lookup (0 before the first row)
+    std::vector<double> parsed_;    // CSV rows as (time, value) pairs
+
+    void* file_;                    // Binary: file, mapping and view
+    void* mapping_;
+    void* view_;
+    size_t view_bytes_;
+};
+
+#endif
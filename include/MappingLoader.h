@@ -6,6 +6,8 @@
 #ifndef MAPPING_LOADER_H
 #define MAPPING_LOADER_H
 
+#include "Expression.h"
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -16,8 +18,10 @@ public:
         std::string name;
         std::string object_type;
         std::string property;
+        std::string interpolate;    // Optional: HOLD (default) or LINEAR
+        double tolerance;           // Optional: change needed to re-apply (<0 = always)
         int swmm_index;
-        InputMapping() : interface_index(0), swmm_index(-1) {}
+        InputMapping() : interface_index(0), tolerance(0.0), swmm_index(-1) {}
     };
     
     struct OutputMapping {
@@ -25,8 +29,174 @@ public:
         std::string name;
         std::string object_type;
         std::string property;
+        std::string aggregate;      // Optional: INSTANT (default), MEAN, MAX, MIN, INTEGRAL
+        std::string reduce;         // Optional: SUM, MEAN, MAX, MIN, COUNT_ABOVE over elements
+        double threshold;           // COUNT_ABOVE threshold
+        std::vector<std::string> elements;  // Reduction members ("" = every element of object_type)
+        std::string expression;     // object_type EXPRESSION: arithmetic over element properties
+        ExpressionProgram program;  // Compiled from expression at load
+        std::string source;         // object_type STATISTIC: name of the summarized output
+        double exceed_threshold;    // Level for EXCEED_HOURS/EXCEED_EVENTS (NaN = none)
+        int update_every;           // Re-read every N routing steps (0 = every step)
+        double update_every_seconds;    // Re-read every N simulated seconds (0 = every step)
         int swmm_index;
-        OutputMapping() : interface_index(0), swmm_index(-1) {}
+        OutputMapping()
+            : interface_index(0), threshold(0.0),
+              exceed_threshold(std::numeric_limits<double>::quiet_NaN()),
+              update_every(0), update_every_seconds(0.0), swmm_index(-1) {}
+    };
+
+    // Optional "controllers" array: native controllers run every routing step
+    struct ControllerMapping {
+        std::string name;               // Referenced by CONTROLLER inputs
+        std::string type;               // DEADBAND, PID or TABLE
+        std::string sensor_type;        // e.g. STORAGE, NODE, LINK
+        std::string sensor;
+        std::string sensor_property;    // e.g. DEPTH, VOLUME, FLOW
+        std::string actuator_type;      // PUMP, ORIFICE, WEIR or LINK
+        std::string actuator;
+        double setpoint, kp, ki, kd;    // PID
+        double min_setting, max_setting;
+        double on_level, off_level;     // DEADBAND
+        double on_setting, off_setting;
+        std::vector<double> table;      // TABLE: flattened [x, setting] pairs
+        std::string interpolate;        // TABLE: LINEAR (default) or STEP
+        ControllerMapping()
+            : setpoint(0.0), kp(0.0), ki(0.0), kd(0.0), min_setting(0.0), max_setting(1.0),
+              on_level(0.0), off_level(0.0), on_setting(1.0), off_setting(0.0) {}
+    };
+
+    // Optional "stepping" section
+    struct SteppingOptions {
+        bool async;              // Step the next interval on a worker thread (look-ahead)
+        std::string mode;        // ROUTING_STEP (one swmm_step per call) or GOLDSIM_TIME
+        double timestep_seconds; // GoldSim time step for GOLDSIM_TIME mode
+        SteppingOptions() : async(false), mode("ROUTING_STEP"), timestep_seconds(0.0) {}
+    };
+
+    // Optional "realization" section
+    struct RealizationOptions {
+        bool recycle;         // Keep the SWMM project open between realizations
+        bool minimal_io;      // Start SWMM without saving results or writing a report
+        RealizationOptions() : recycle(false), minimal_io(false) {}
+    };
+
+    // Optional "spinup" section
+    struct SpinupOptions {
+        double duration_days;  // Antecedent period simulated once and cached (0 = off)
+        std::string cache_dir; // Where hotstart files are kept ("" = working directory)
+        SpinupOptions() : duration_days(0.0) {}
+    };
+
+    // Optional "memo" section
+    struct MemoOptions {
+        bool enabled;          // Serve repeated input streams from stored results
+        std::string dir;       // Where memo files are kept ("" = working directory)
+        MemoOptions() : enabled(false) {}
+    };
+
+    // Optional "statistics" section
+    struct StatisticsOptions {
+        bool enabled;                   // Write the whole-run summary file
+        std::string file;               // Summary CSV
+        std::vector<double> quantiles;  // Probabilities estimated for every output
+        StatisticsOptions() : enabled(false), file("bridge_stats.csv"), quantiles({ 0.5, 0.9, 0.99 }) {}
+    };
+
+    // Optional "recorder" section
+    struct RecorderOptions {
+        bool enabled;          // Record outputs each XF_CALCULATE
+        std::string dir;       // Where recordings are written ("" = working directory)
+        bool inputs;           // Also record the inputs applied over each interval
+        int chunk_rows;        // Rows per chunk (buffered before a write)
+        RecorderOptions() : enabled(false), inputs(true), chunk_rows(1024) {}
+    };
+
+    // Optional "worker" section: run SWMM in a separate worker process
+    struct WorkerOptions {
+        bool enabled;               // Forward INITIALIZE/CALCULATE/CLEANUP to a worker
+        std::string command;        // Worker command line ("" = platform default)
+        double timeout_seconds;     // Per-call limit (0 = none)
+        double startup_seconds;     // Time allowed for the worker to attach
+        int spin_microseconds;      // Poll this long before blocking on a reply
+        bool keep_alive;            // Keep the worker between realizations
+        WorkerOptions()
+            : enabled(false), timeout_seconds(0.0), startup_seconds(30.0), spin_microseconds(50), keep_alive(true) {}
+    };
+
+    // Optional "profile" section: per-phase timing report
+    struct ProfileOptions {
+        bool enabled;               // Time every bridge phase
+        std::string file;           // JSON report, rewritten at each cleanup
+        ProfileOptions() : enabled(false), file("bridge_profile.json") {}
+    };
+
+    // Optional "trace" section: timeline of bridge activity
+    struct TraceOptions {
+        bool enabled;               // Record every phase as a trace event
+        std::string file;           // Chrome trace JSON; "_<realization>" is added before the extension
+        int max_events;             // Buffer capacity per thread; later events are dropped
+        TraceOptions() : enabled(false), file("bridge_trace.json"), max_events(200000) {}
+    };
+
+    // Optional "flight_recorder" section: last steps kept for post-mortems
+    struct FlightRecorderOptions {
+        bool enabled;               // Keep the ring (on unless turned off)
+        int steps;                  // Steps kept
+        std::string file;           // CSV dump; "_<realization>" is added before the extension
+        FlightRecorderOptions() : enabled(true), steps(256), file("bridge_flight.csv") {}
+    };
+
+    // Optional "telemetry" section: live state in shared memory
+    struct TelemetryOptions {
+        bool enabled;               // Publish inputs, outputs and progress every step
+        std::string name;           // Segment name; "_m<member>" is added in ensembles
+        TelemetryOptions() : enabled(false), name("gsswmm_telemetry") {}
+    };
+
+    // Optional "fast_forward" section: quiet GOLDSIM_TIME intervals advanced
+    // with one swmm_stride instead of a swmm_step per routing step
+    struct FastForwardState {
+        std::string output;         // Mapped output name
+        double max;                 // Quiet while |value| <= max
+        FastForwardState() : max(0.0) {}
+    };
+    struct FastForwardOptions {
+        bool enabled;
+        double input_threshold;     // Inputs are quiet while |value| <= this
+        std::vector<std::string> inputs;        // "watch_inputs" (empty = every input set in SWMM)
+        std::vector<FastForwardState> states;   // Outputs that must also be quiet
+        FastForwardOptions() : enabled(false), input_threshold(0.0) {}
+    };
+
+    // Optional "timeseries_inputs" array: inputs read from a file by the
+    // bridge and applied every routing step, not passed by GoldSim
+    struct SeriesInputMapping {
+        std::string name;
+        std::string object_type;
+        std::string property;
+        std::string file;           // CSV or binary series (see InputSeries.h)
+        int column;                 // Value column, 1 = first after the time
+        std::string interpolate;    // HOLD (default) or LINEAR
+        std::string time_unit;      // SECONDS, MINUTES, HOURS (default) or DAYS
+        double seconds_per_unit;    // From time_unit
+        SeriesInputMapping() : column(1), interpolate("HOLD"), time_unit("HOURS"), seconds_per_unit(3600.0) {}
+    };
+
+    // Optional "checkpoint" section: periodic mid-run state for resuming
+    struct CheckpointOptions {
+        bool enabled;               // Write checkpoints
+        double every_days;          // Simulated days between checkpoints
+        std::string dir;            // Checkpoint directory ("" = working directory)
+        int keep;                   // Checkpoints kept per model
+        bool resume;                // Start from the newest checkpoint of this model
+        CheckpointOptions() : enabled(false), every_days(30.0), dir("checkpoints"), keep(2), resume(false) {}
+    };
+
+    // Optional "ensemble" section: K members in worker processes per call
+    struct EnsembleOptions {
+        int members;                // Input/output vectors per call (1 = off)
+        EnsembleOptions() : members(1) {}
     };
 
     MappingLoader();
@@ -40,12 +210,44 @@ public:
     int GetOutputCount() const;
     const std::vector<InputMapping>& GetInputs() const;
     const std::vector<OutputMapping>& GetOutputs() const;
+    const std::vector<ControllerMapping>& GetControllers() const;
     const std::string& GetLoggingLevel() const;
+    const SteppingOptions& GetStepping() const;
+    const RealizationOptions& GetRealization() const;
+    const SpinupOptions& GetSpinup() const;
+    const MemoOptions& GetMemo() const;
+    const StatisticsOptions& GetStatistics() const;
+    const RecorderOptions& GetRecorder() const;
+    const WorkerOptions& GetWorker() const;
+    const EnsembleOptions& GetEnsemble() const;
+    const ProfileOptions& GetProfile() const;
+    const TraceOptions& GetTrace() const;
+    const FlightRecorderOptions& GetFlightRecorder() const;
+    const TelemetryOptions& GetTelemetry() const;
+    const FastForwardOptions& GetFastForward() const;
+    const CheckpointOptions& GetCheckpoint() const;
+    const std::vector<SeriesInputMapping>& GetSeriesInputs() const;
 
 private:
     std::vector<InputMapping> inputs_;
     std::vector<OutputMapping> outputs_;
+    std::vector<ControllerMapping> controllers_;
     std::string logging_level_;
+    SteppingOptions stepping_;
+    RealizationOptions realization_;
+    SpinupOptions spinup_;
+    MemoOptions memo_;
+    StatisticsOptions statistics_;
+    RecorderOptions recorder_;
+    WorkerOptions worker_;
+    EnsembleOptions ensemble_;
+    ProfileOptions profile_;
+    TraceOptions trace_;
+    FlightRecorderOptions flight_;
+    TelemetryOptions telemetry_;
+    FastForwardOptions fast_forward_;
+    CheckpointOptions checkpoint_;
+    std::vector<SeriesInputMapping> series_inputs_;
 };
 
 #endif
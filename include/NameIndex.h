@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------------
+//   NameIndex.h
+//   Open-addressing hash table from element names to indices, filled once
+//   per object type at XF_INITIALIZE so every mapping entry resolves in O(1)
+//   Names are kept back to back in one pool; slots hold the hash, the name's
+//   place in the pool and the index, and are probed linearly.
+//-----------------------------------------------------------------------------
+
+#ifndef NAME_INDEX_H
+#define NAME_INDEX_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class NameIndex {
+public:
+    /**
+     * @param ignore_case Compare names without regard to ASCII case, as
+     *        SWMM's own ID lookup does
+     */
+    explicit NameIndex(bool ignore_case = true);
+
+    void Clear();
+
+    /**
+     * @brief Size the table for a number of names so filling it never rehashes
+     */
+    void Reserve(size_t count);
+
+    /**
+     * @brief Add a name
+     * @param value Index returned by Find(); must be >= 0
+     * @return false if the name is already present (the first value is kept)
+     */
+    bool Add(const char* name, size_t length, int value);
+    bool Add(const std::string& name, int value) { return Add(name.data(), name.size(), value); }
+
+    /**
+     * @return The value added for name, or -1
+     */
+    int Find(const char* name, size_t length) const;
+    int Find(const std::string& name) const { return Find(name.data(), name.size()); }
+
+    size_t GetCount() const { return count_; }
+    size_t GetCapacity() const { return slots_.size(); }
+
+private:
+    struct Slot {
+        unsigned long long hash;
+        size_t offset;              // Name in pool_
+        size_t length;
+        int value;                  // -1 = empty
+    };
+
+    unsigned long long Hash(const char* name, size_t length) const;
+    bool Equal(const Slot& slot, const char* name, size_t length) const;
+    size_t Probe(unsigned long long hash, const char* name, size_t length) const;
+    void Rehash(size_t capacity);
+
+    bool ignore_case_;
+    std::vector<Slot> slots_;       // Power-of-two size, at most half full
+    std::string pool_;
+    size_t count_;
+};
+
+#endif
@@ -0,0 +1,78 @@
+//-----------------------------------------------------------------------------
+//   OutputAggregator.h
+//   Reduces the routing steps inside one GoldSim time step to one value
+//   per output (instantaneous, mean, max, min or time integral)
+//-----------------------------------------------------------------------------
+
+#ifndef OUTPUT_AGGREGATOR_H
+#define OUTPUT_AGGREGATOR_H
+
+#include <string>
+#include <vector>
+
+class OutputAggregator {
+public:
+    enum Mode {
+        INSTANT = 0,    // Value at the end of the interval
+        MEAN,           // Time-weighted mean over the interval
+        MAX,            // Largest sub-step value
+        MIN,            // Smallest sub-step value
+        INTEGRAL,       // Sum of value * dt (seconds), e.g. flow -> volume
+        MODE_COUNT
+    };
+
+    OutputAggregator();
+    ~OutputAggregator();
+    OutputAggregator(const OutputAggregator&) = delete;
+    OutputAggregator& operator=(const OutputAggregator&) = delete;
+
+    /**
+     * @brief Set the aggregation of one output slot
+     * @note Call once for every slot, including INSTANT ones; Finish()
+     *       only writes slots that have been set
+     */
+    void SetMode(int slot, Mode mode);
+
+    /**
+     * @brief True if any slot needs the value of every sub-step
+     * @note When false the caller can gather once at the end of the interval
+     */
+    bool NeedsSubsteps() const;
+
+    /**
+     * @brief Reset the accumulators at the start of an interval
+     */
+    void Begin();
+
+    /**
+     * @brief Fold one routing step into the accumulators
+     * @param values Outputs gathered at the end of the step, indexed by slot
+     * @param dt Length of the step in seconds
+     */
+    void Accumulate(const double* values, double dt);
+
+    /**
+     * @brief Write the interval result for every slot
+     * @param last Outputs gathered at the end of the last step
+     * @param dst Destination array (normally GoldSim outargs); may alias last
+     * @note With no Accumulate() since Begin(), INTEGRAL slots are 0 and
+     *       every other slot takes its value from last
+     */
+    void Finish(const double* last, double* dst) const;
+
+    void Clear();
+
+private:
+    std::vector<int> slots_[MODE_COUNT];    // Slots grouped by mode
+    std::vector<double> acc_;               // Running sum / extreme per slot
+    double total_dt_;
+    int steps_;
+};
+
+/**
+ * @brief Map an "aggregate" name from SwmmGoldSimBridge.json to a mode
+ * @return OutputAggregator::Mode, or -1 if the name is unknown
+ */
+int AggregateNameToMode(const std::string& name);
+
+#endif
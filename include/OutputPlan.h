@@ -0,0 +1,190 @@
+//-----------------------------------------------------------------------------
+//   OutputPlan.h
+//   Compiled gather plan for reading mapped SWMM outputs each time step
+//-----------------------------------------------------------------------------
+
+#ifndef OUTPUT_PLAN_H
+#define OUTPUT_PLAN_H
+
+#include "Expression.h"
+#include <string>
+#include <vector>
+
+class OutputPlan {
+public:
+    // SWMM API function used to read an output. Resolved once at
+    // XF_INITIALIZE so the per-step gather does no string work.
+    enum Getter {
+        GET_VALUE = 0,              // swmm_getValue(prop, index)
+        GET_LID_STORAGE_VOLUME,     // swmm_getLidUStorageVolume(subcatch, lid)
+        GET_LID_SURFACE_OUTFLOW,    // swmm_getLidUSurfaceOutflow(subcatch, lid)
+        GET_LID_SURFACE_INFLOW,     // swmm_getLidUSurfaceInflow(subcatch, lid)
+        GET_LID_DRAIN_FLOW,         // swmm_getLidUDrainFlow(subcatch, lid)
+        GETTER_COUNT
+    };
+
+    // Reduction of a group of elements to one output slot
+    enum Reduce {
+        REDUCE_SUM = 0,
+        REDUCE_MEAN,
+        REDUCE_MAX,
+        REDUCE_MIN,
+        REDUCE_COUNT_ABOVE,     // Number of members > threshold
+        REDUCE_COUNT
+    };
+
+    OutputPlan();
+    ~OutputPlan();
+    OutputPlan(const OutputPlan&) = delete;
+    OutputPlan& operator=(const OutputPlan&) = delete;
+
+    /**
+     * @brief Queue one output for compilation
+     * @param getter SWMM getter to call
+     * @param prop SWMM property enum (GET_VALUE only, ignored otherwise)
+     * @param index Element index (subcatchment index for LID getters)
+     * @param lid LID unit index (LID getters only, -1 otherwise)
+     * @param slot Destination index in the gathered value array
+     * @param every_steps Re-read every N routing steps (0 = every gather)
+     * @param every_seconds Re-read every N simulated seconds (0 = every gather)
+     * @note Between refreshes a decimated output returns its cached value
+     */
+    void Add(Getter getter, int prop, int index, int lid, int slot, int every_steps = 0, double every_seconds = 0.0);
+
+    /**
+     * @brief Queue a reduction output
+     * @param op Reduction applied to the members
+     * @param threshold REDUCE_COUNT_ABOVE only
+     * @param slot Destination index in the gathered value array
+     * @return Group id for AddMember()
+     */
+    int AddReduction(Reduce op, double threshold, int slot);
+
+    /**
+     * @brief Queue one member of a reduction (same arguments as Add())
+     */
+    void AddMember(int group, Getter getter, int prop, int index, int lid);
+
+    /**
+     * @brief Queue an expression output, evaluated after every other output
+     * @param program Compiled program with every reference resolved
+     * @param slot Destination index in the gathered value array
+     */
+    void AddExpression(const ExpressionProgram& program, int slot);
+
+    /**
+     * @brief Group queued outputs into per-getter tables sorted by element index
+     * @note Must be called after the last Add() and before Gather()
+     */
+    void Compile();
+
+    /**
+     * @brief Read every compiled output from SWMM into dst[slot]
+     * @param dst Destination array (normally GoldSim outargs)
+     * @note Reduction members are read into a contiguous scratch buffer, one
+     *       run per group, and each group is reduced in a single pass.
+     *       Expression references are read the same way and each program
+     *       runs on its run of scratch_ after the reductions.
+     */
+    void Gather(double* dst) const;
+
+    /**
+     * @brief Gather, re-reading decimated outputs only when they are due
+     * @param step Routing steps completed since the start of the run
+     * @param elapsed_sec SWMM elapsed time (seconds)
+     * @note Outputs that are not due are copied from their cache, so each
+     *       call reads SWMM only for every-step outputs and the due groups
+     */
+    void Gather(double* dst, long step, double elapsed_sec);
+
+    /**
+     * @brief Restart every decimation schedule at step 0, time 0
+     * @note Call after the initial full Gather() of a run
+     */
+    void ResetSchedule();
+
+    void Clear();
+    int GetOutputCount() const;    // Plain outputs, reductions and expressions
+    int GetMemberCount() const;    // Values read for reductions and expressions
+    int GetTableCount() const;
+    int GetSlotCount() const;      // Highest destination slot + 1
+    int GetCadenceCount() const;   // Distinct update_every schedules
+
+private:
+    // Structure-of-arrays table: every entry shares the same getter and,
+    // for GET_VALUE, the same property enum.
+    struct Table {
+        Getter getter;
+        int prop;
+        std::vector<int> index;
+        std::vector<int> lid;
+        std::vector<int> slot;
+    };
+
+    struct Entry {
+        Getter getter;
+        int prop;
+        int index;
+        int lid;
+        int slot;
+        int cadence;    // Index into cadences_, -1 = every gather
+    };
+
+    // Outputs sharing one update_every schedule. Their tables write to
+    // cache, which is copied to the destination slots on every gather.
+    struct Cadence {
+        int every_steps;
+        double every_seconds;
+        long next_step;
+        double next_time;
+        std::vector<Table> tables;
+        std::vector<int> slot;          // cache[i] goes to dst[slot[i]]
+        mutable std::vector<double> cache;
+        std::vector<Entry> pending;
+    };
+
+    struct Reduction {
+        Reduce op;
+        double threshold;
+        int slot;
+        int begin;      // First member in scratch_
+        int count;
+    };
+
+    struct Expression {
+        ExpressionProgram program;
+        int slot;
+        int begin;      // First reference value in scratch_
+    };
+
+    static void BuildTables(std::vector<Entry>& entries, std::vector<Table>& tables);
+    static void GatherTables(const std::vector<Table>& tables, double* dst);
+    static void CopyCache(const Cadence& c, double* dst);
+    void GatherComputed(double* dst) const;
+
+    std::vector<Entry> pending_;
+    std::vector<Entry> pending_members_;    // slot = group id until Compile()
+    std::vector<Table> tables_;             // Write to dst
+    std::vector<Table> member_tables_;      // Reduction members and expression references, write to scratch_
+    std::vector<Reduction> reductions_;
+    std::vector<Expression> expressions_;
+    std::vector<Cadence> cadences_;
+    mutable std::vector<double> scratch_;
+    int output_count_;
+    int slot_count_;
+};
+
+/**
+ * @brief Map an LID output property name to its getter
+ * @param property LID property name (e.g., "STORAGE_VOLUME")
+ * @return Getter enum, or -1 if the property is not an LID property
+ */
+int LidPropertyToGetter(const std::string& property);
+
+/**
+ * @brief Map a "reduce" name from SwmmGoldSimBridge.json to a reduction
+ * @return OutputPlan::Reduce, or -1 if the name is unknown
+ */
+int ReduceNameToOp(const std::string& name);
+
+#endif
@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------------
+//   OutputStats.h
+//   Whole-run statistics per output in constant memory: time-weighted mean
+//   and variance (weighted Welford), min/max with their times, time above a
+//   threshold, and P-square quantile estimates, updated after every routing
+//   step
+//-----------------------------------------------------------------------------
+
+#ifndef OUTPUT_STATS_H
+#define OUTPUT_STATS_H
+
+#include <string>
+#include <vector>
+
+class OutputStats {
+public:
+    enum Stat {
+        STAT_MEAN = 0,          // Time-weighted mean
+        STAT_STDDEV,            // Time-weighted standard deviation
+        STAT_MIN,
+        STAT_MAX,
+        STAT_TIME_OF_MIN,       // Elapsed days
+        STAT_TIME_OF_MAX,
+        STAT_EXCEED_HOURS,      // Time above the output's threshold
+        STAT_EXCEED_EVENTS,     // Upward crossings of the threshold
+        STAT_QUANTILE,          // Quantile estimate (see AddOutput)
+        STAT_COUNT
+    };
+
+    OutputStats();
+    ~OutputStats();
+
+    /**
+     * @brief Forget all tracked slots, quantiles and statistic outputs
+     */
+    void Clear();
+
+    /**
+     * @brief Track one gathered value slot
+     * @param threshold Level for the EXCEED statistics (NaN = none)
+     * @return Tracked id
+     */
+    int Track(int slot, double threshold);
+
+    /**
+     * @brief Estimate a quantile for every tracked slot
+     * @param p Probability in (0, 1); repeated values share one estimator
+     * @return Quantile id
+     */
+    int AddQuantile(double p);
+
+    /**
+     * @brief Write a statistic of a tracked slot to another slot on Fill()
+     * @param quantile Quantile id (STAT_QUANTILE only)
+     */
+    void AddOutput(int slot, int tracked, Stat stat, int quantile);
+
+    /**
+     * @brief Start a new run (accumulators only; the configuration is kept)
+     */
+    void Reset();
+
+    /**
+     * @brief Fold one routing step into the accumulators
+     * @param values Gathered values, indexed by slot
+     * @param elapsed_days Time at the end of the step
+     * @param dt Length of the step in seconds (the sample weight)
+     */
+    void Update(const double* values, double elapsed_days, double dt);
+
+    /**
+     * @brief Write the current value of every statistic output into dst
+     */
+    void Fill(double* dst) const;
+
+    /**
+     * @brief Current statistic of a tracked slot (0 before the first Update)
+     */
+    double Get(int tracked, Stat stat, int quantile) const;
+
+    /**
+     * @brief Append the accumulators to a checkpoint's state
+     */
+    void SaveState(std::vector<double>& out) const;
+
+    /**
+     * @brief Restore accumulators written by SaveState()
+     * @param pos Read position in data, moved past this object's state
+     * @return false if the saved counts do not match the tracked slots and
+     *         quantiles (nothing changed)
+     */
+    bool RestoreState(const std::vector<double>& data, size_t& pos);
+
+    /**
+     * @brief Write one CSV row per tracked slot
+     * @param names Label per tracked id
+     * @param realization Value of the realization column
+     * @param append Append to path instead of starting a new file with a header
+     * @return false if the file cannot be written
+     */
+    bool WriteSummary(const std::string& path, const std::vector<std::string>& names,
+                      int realization, bool append) const;
+
+    bool IsEmpty() const;
+    int GetTrackedCount() const;
+    int GetQuantileCount() const;
+    long GetSampleCount() const;
+
+private:
+    // P-square estimator (Jain & Chlamtac 1985): five markers per quantile
+    struct Psq {
+        double q[5];    // Marker heights
+        double n[5];    // Actual positions
+        double np[5];   // Desired positions
+        int count;
+    };
+
+    struct Series {
+        int slot;
+        double threshold;
+        double weight;      // Sum of dt
+        double mean;
+        double m2;          // Weighted sum of squared deviations
+        double min, max;
+        double t_min, t_max;
+        double exceed_sec;
+        double events;
+        bool above;
+    };
+
+    struct Output {
+        int slot;
+        int tracked;
+        Stat stat;
+        int quantile;
+    };
+
+    static void PsqInit(Psq& e);
+    static void PsqAdd(Psq& e, double p, double x);
+    static double PsqValue(const Psq& e, double p);
+
+    std::vector<Series> series_;
+    std::vector<double> probs_;
+    std::vector<Psq> psq_;          // [tracked * quantiles + quantile]
+    std::vector<Output> outputs_;
+    long samples_;
+};
+
+/**
+ * @brief Map a STATISTIC output property (MEAN, STDDEV, MIN, MAX,
+ *        TIME_OF_MIN, TIME_OF_MAX, EXCEED_HOURS, EXCEED_EVENTS, Pnn)
+ * @param p Receives the probability for Pnn (e.g. P95 -> 0.95, P99.9 -> 0.999)
+ * @return OutputStats::Stat, or -1 if the name is unknown
+ */
+int StatNameToStat(const std::string& name, double* p);
+
+#endif
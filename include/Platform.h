@@ -0,0 +1,136 @@
+//-----------------------------------------------------------------------------
+//   Platform.h
+//   The OS layer shared by GSswmm.dll and the Linux worker host
+//   (SwmmWorkerHost): export macro, null device, file stamps, directory
+//   creation and, outside Windows, the MSVC secure CRT calls the bridge
+//   sources use
+//-----------------------------------------------------------------------------
+
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+#include <cstdio>
+#include <string>
+
+#ifdef _WIN32
+
+#include <windows.h>
+
+#define BRIDGE_EXPORT __declspec(dllexport)
+#define PATH_SEP "\\"
+#define NULL_DEVICE "NUL"
+
+#else
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstring>
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#define BRIDGE_EXPORT __attribute__((visibility("default")))
+#define PATH_SEP "/"
+#define NULL_DEVICE "/dev/null"
+
+#ifndef _TRUNCATE
+#define _TRUNCATE ((size_t)-1)
+#endif
+
+inline int fopen_s(FILE** f, const char* path, const char* mode) {
+    *f = fopen(path, mode);
+    return *f ? 0 : errno;
+}
+
+// Truncates instead of raising the invalid-parameter handler
+inline int sprintf_s(char* buf, size_t size, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, size, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+template <size_t N>
+inline int sprintf_s(char (&buf)[N], const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, N, fmt, ap);
+    va_end(ap);
+    return n;
+}
+
+inline int strncpy_s(char* dest, size_t size, const char* src, size_t count) {
+    if (!dest || size == 0) return EINVAL;
+    size_t n = strlen(src);
+    if (count != _TRUNCATE && count < n) n = count;
+    if (n >= size) n = size - 1;
+    memcpy(dest, src, n);
+    dest[n] = '\0';
+    return 0;
+}
+
+template <size_t N>
+inline int strncpy_s(char (&dest)[N], const char* src, size_t count) {
+    return strncpy_s(dest, N, src, count);
+}
+
+inline int _fseeki64(FILE* f, long long offset, int origin) {
+    return fseeko(f, (off_t)offset, origin);
+}
+
+inline long long _ftelli64(FILE* f) {
+    return (long long)ftello(f);
+}
+
+#endif
+
+/**
+ * @brief Read the size and last-write time of a file
+ * @param write_time Platform ticks; only comparable with stamps taken on
+ *        the same platform
+ * @return false if the file cannot be queried
+ */
+inline bool GetFileStamp(const char* path, unsigned long long* size, unsigned long long* write_time) {
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (!GetFileAttributesExA(path, GetFileExInfoStandard, &data)) return false;
+    *size = ((unsigned long long)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+    *write_time = ((unsigned long long)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    *size = (unsigned long long)st.st_size;
+    *write_time = (unsigned long long)st.st_mtim.tv_sec * 1000000000ull + (unsigned long long)st.st_mtim.tv_nsec;
+#endif
+    return true;
+}
+
+/**
+ * @brief Look up a function exported by a library this process has loaded
+ * @param library Module name on Windows (e.g. "swmm5.dll"); elsewhere every
+ *        loaded library is searched
+ * @return The function, or NULL if it is not exported
+ */
+inline void* FindLibraryFunction(const char* library, const char* name) {
+#ifdef _WIN32
+    HMODULE module = GetModuleHandleA(library);
+    return module ? (void*)GetProcAddress(module, name) : NULL;
+#else
+    (void)library;
+    return dlsym(RTLD_DEFAULT, name);
+#endif
+}
+
+/**
+ * @brief Create a directory; does nothing if it already exists
+ */
+inline void MakeDirectory(const std::string& path) {
+#ifdef _WIN32
+    CreateDirectoryA(path.c_str(), NULL);
+#else
+    mkdir(path.c_str(), 0777);
+#endif
+}
+
+#endif
@@ -0,0 +1,152 @@
+//-----------------------------------------------------------------------------
+//   Profiler.h
+//   Per-phase timing of the bridge: call counts, log-linear latency
+//   histograms (HDR-style, ~6% relative resolution) and sampled resident
+//   memory, written as a JSON report with the process's peak resident set
+//
+//   With a Tracer attached every phase is also added to the timeline.
+//   Begin()/End() cost one branch while both are off. Each phase
+//   must be recorded from one thread at a time (in look-ahead mode the step
+//   phases run on the step worker, the GoldSim calls on the caller).
+//-----------------------------------------------------------------------------
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+
+class Tracer;
+
+class Profiler {
+public:
+    enum Phase {
+        PHASE_INITIALIZE = 0,   // Whole XF_INITIALIZE
+        PHASE_OPEN,             // Spin-up, swmm_open and swmm_start
+        PHASE_RESOLVE,          // Name resolution and output plan compilation
+        PHASE_CALCULATE,        // Whole XF_CALCULATE
+        PHASE_APPLY,            // swmm_setValue of staged and interpolated inputs
+        PHASE_STEP,             // One swmm_step
+        PHASE_GATHER,           // One output gather
+        PHASE_CLEANUP,          // swmm_end and swmm_close
+        PHASE_LOG,              // Starting and draining the log writer
+        PHASE_COUNT
+    };
+
+    static const int kSubBuckets = 16;                  // Per power of two
+    static const int kBuckets = (64 - 3) * kSubBuckets;
+    static const long long kRssEvery = 64;              // Sample RSS on every 64th end of a phase
+
+    Profiler();
+    ~Profiler();
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    void SetEnabled(bool enabled) { enabled_ = enabled; active_ = enabled_ || tracer_; }
+    bool IsEnabled() const { return enabled_; }
+
+    /**
+     * @brief Also add every phase to a timeline (NULL = none)
+     */
+    void SetTracer(Tracer* tracer) { tracer_ = tracer; active_ = enabled_ || tracer_; }
+
+    /**
+     * @brief Forget all samples
+     */
+    void Reset();
+
+    /**
+     * @brief Timestamp for a phase about to start (0 when disabled)
+     */
+    long long Begin() const { return active_ ? Now() : 0; }
+
+    /**
+     * @brief Record a phase that started at Begin()
+     */
+    void End(Phase phase, long long begin) {
+        if (active_ && begin != 0) Finish(phase, begin);
+    }
+
+    /**
+     * @brief Add one duration in nanoseconds
+     */
+    void Record(Phase phase, long long ns);
+
+    long long GetCount(Phase phase) const;
+    long long GetTotalNs(Phase phase) const;
+    long long GetMaxNs(Phase phase) const;
+
+    /**
+     * @brief Duration below which a fraction q of the samples fall
+     * @return Midpoint of the histogram bucket, or 0 without samples
+     */
+    long long GetPercentileNs(Phase phase, double q) const;
+
+    /**
+     * @brief Largest resident set sampled at the end of a phase (bytes)
+     * @note Sampled on every kRssEvery-th end, so short spikes can be missed;
+     *       PeakRss() has the true high-water mark of the process
+     */
+    long long GetRssSampled(Phase phase) const;
+
+    /**
+     * @brief Write every phase with samples as JSON
+     * @param realizations Realizations covered, reported as-is
+     */
+    bool WriteReport(const std::string& path, int realizations) const;
+
+    static const char* PhaseName(Phase phase);
+
+    /**
+     * @brief Monotonic clock in nanoseconds
+     */
+    static long long Now();
+
+    /**
+     * @brief Current resident set of this process in bytes (0 if unknown)
+     */
+    static long long CurrentRss();
+
+    /**
+     * @brief Peak resident set of this process in bytes as kept by the OS
+     *        (PeakWorkingSetSize, VmHWM; 0 if unknown)
+     */
+    static long long PeakRss();
+
+private:
+    struct PhaseData {
+        long long count;
+        long long total_ns;
+        long long min_ns;
+        long long max_ns;
+        long long rss_sampled;
+        long long buckets[kBuckets];
+    };
+
+    void Finish(Phase phase, long long begin);
+    static int BucketOf(long long ns);
+    static long long BucketMid(int bucket);
+
+    bool enabled_;
+    bool active_;               // enabled_ or a tracer attached
+    Tracer* tracer_;
+    PhaseData phases_[PHASE_COUNT];
+};
+
+/**
+ * @brief Records the enclosing block as one phase
+ */
+class ProfileScope {
+public:
+    ProfileScope(Profiler& profiler, Profiler::Phase phase)
+        : profiler_(profiler), phase_(phase), begin_(profiler.Begin()) {}
+    ~ProfileScope() { profiler_.End(phase_, begin_); }
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    Profiler& profiler_;
+    Profiler::Phase phase_;
+    long long begin_;
+};
+
+#endif
@@ -0,0 +1,160 @@
+//-----------------------------------------------------------------------------
+//   Recorder.h
+//   Columnar binary recording of the values GoldSim exchanges each step,
+//   written by a background thread, and a reader that slices one column
+//   without touching the others
+//
+//   File layout (little-endian, every block a multiple of 8 bytes):
+//     FileHeader                 magic "GSREC001", column count, chunk_rows
+//     ColumnDesc[columns]        kind, interface index, name
+//     Chunk 0, Chunk 1, ...      all chunk_bytes long
+//   Chunk:
+//     ChunkHeader                magic, rows used, first row
+//     double time[chunk_rows]    SWMM elapsed days
+//     double col0[chunk_rows], col1[chunk_rows], ...
+//   Chunks have a fixed size, so the file can be memory-mapped and the
+//   offset of any (column, row) is computed directly. The last chunk is
+//   padded; its header gives the rows in use.
+//-----------------------------------------------------------------------------
+
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace RecordingFormat {
+    struct FileHeader {
+        char magic[8];              // "GSREC001"
+        unsigned int columns;
+        unsigned int chunk_rows;
+        unsigned long long header_bytes;    // Offset of chunk 0
+    };
+    struct ColumnDesc {
+        int kind;                   // Recorder::COLUMN_OUTPUT or COLUMN_INPUT
+        int index;                  // GoldSim interface index
+        char name[56];
+    };
+    struct ChunkHeader {
+        unsigned int magic;         // CHUNK_MAGIC
+        unsigned int rows;
+        unsigned long long first_row;
+    };
+    enum { CHUNK_MAGIC = 0x4b435347 };  // "GSCK"
+}
+
+class Recorder {
+public:
+    enum ColumnKind { COLUMN_OUTPUT = 0, COLUMN_INPUT = 1 };
+
+    struct Column {
+        std::string name;
+        int kind;
+        int index;              // Index into the outputs or inputs passed to Append()
+    };
+
+    Recorder();
+    ~Recorder();
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    /**
+     * @brief Create the file, write the header and start the writer thread
+     * @param chunk_rows Rows per chunk (rows buffered before a write)
+     * @return false if the file cannot be created
+     */
+    bool Open(const std::string& path, const std::vector<Column>& columns, int chunk_rows, std::string& error);
+
+    /**
+     * @brief Append one row
+     * @param inputs Input values, or NULL to record NaN in input columns
+     * @note Copies into the current chunk; full chunks are handed to the
+     *       writer thread. Blocks only if the writer falls several chunks behind.
+     */
+    void Append(double elapsed_days, const double* outputs, const double* inputs);
+
+    /**
+     * @brief Write the partial chunk, stop the writer and close the file
+     * @return false if any write failed
+     */
+    bool Close();
+
+    bool IsOpen() const;
+    long long GetRowCount() const;
+
+private:
+    void Run();
+    void Submit();
+    std::vector<double>* TakeBuffer();
+
+    FILE* file_;
+    std::vector<Column> columns_;
+    int chunk_rows_;
+    size_t chunk_doubles_;          // Chunk size in doubles, header included
+    std::vector<double>* current_;
+    int rows_;                      // Rows in current_
+    long long total_rows_;
+
+    std::thread* thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<std::vector<double>*> full_;     // Waiting for the writer
+    std::vector<std::vector<double>*> free_;    // Written, ready for reuse
+    int buffers_;                   // Buffers allocated
+    bool stop_;
+    bool failed_;
+};
+
+class RecordingReader {
+public:
+    RecordingReader();
+    ~RecordingReader();
+    RecordingReader(const RecordingReader&) = delete;
+    RecordingReader& operator=(const RecordingReader&) = delete;
+
+    /**
+     * @brief Read the header and chunk table of a recording
+     * @note A torn last chunk (file cut short) is ignored
+     */
+    bool Open(const std::string& path, std::string& error);
+    void Close();
+
+    int GetColumnCount() const;
+    const std::string& GetColumnName(int col) const;
+    int GetColumnKind(int col) const;
+    int GetColumnIndex(int col) const;
+
+    /**
+     * @brief Find a column by name
+     * @param kind Recorder::COLUMN_OUTPUT/COLUMN_INPUT, or -1 for either
+     * @return Column number, or -1
+     */
+    int FindColumn(const std::string& name, int kind) const;
+
+    long long GetRowCount() const;
+
+    /**
+     * @brief Read one column (or the time column, col = -1) over a row range
+     * @note Reads only that column's run in each chunk it overlaps
+     */
+    bool ReadColumn(int col, long long first_row, long long rows, double* out) const;
+    bool ReadColumn(int col, std::vector<double>& out) const;
+    bool ReadTimes(std::vector<double>& out) const;
+
+private:
+    FILE* file_;
+    std::vector<std::string> names_;
+    std::vector<int> kinds_;
+    std::vector<int> indices_;
+    unsigned int chunk_rows_;
+    unsigned long long header_bytes_;
+    unsigned long long chunk_bytes_;
+    long long rows_;
+};
+
+#endif
@@ -0,0 +1,78 @@
+//-----------------------------------------------------------------------------
+//   ResultMemo.h
+//   On-disk store of per-call outputs keyed by a hash chain over the
+//   model, the mapping and every input vector GoldSim has passed so far
+//
+//   Key k = FNV-1a(inputs of call k, key k-1), key -1 = hash of model.inp,
+//   SwmmGoldSimBridge.json and the DLL version. Two realizations share a
+//   key exactly as long as their input streams are identical, so one
+//   lookup per call both finds the stored outputs and detects divergence.
+//-----------------------------------------------------------------------------
+
+#ifndef RESULT_MEMO_H
+#define RESULT_MEMO_H
+
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ResultMemo {
+public:
+    ResultMemo();
+    ~ResultMemo();
+    ResultMemo(const ResultMemo&) = delete;
+    ResultMemo& operator=(const ResultMemo&) = delete;
+
+    /**
+     * @brief Open (or create) the store for one model/mapping and index it
+     * @param dir Directory holding the store files ("" = working directory)
+     * @param base Hash of model.inp, the mapping and the DLL version
+     * @param output_count Doubles stored per call
+     * @return false if the file cannot be opened or belongs to another layout
+     * @note No-op if the same store is already open
+     */
+    bool Open(const std::string& dir, unsigned long long base, int output_count, std::string& error);
+    void Close();
+    bool IsOpen() const;
+
+    /**
+     * @brief Read the outputs stored for a key
+     * @param outputs Receives output_count values (untouched if ended)
+     * @param ended Receives true if the recorded run ended at this call
+     * @return false if the key is not stored
+     */
+    bool Lookup(unsigned long long key, double* outputs, bool* ended);
+
+    /**
+     * @brief Queue the outputs of a live call; keys already stored are skipped
+     */
+    void Add(unsigned long long key, const double* outputs, bool ended);
+
+    /**
+     * @brief Append queued records to the store file
+     */
+    bool Flush(std::string& error);
+
+    size_t GetRecordCount() const;     // Stored and queued records
+    unsigned long long GetBase() const;
+
+private:
+    struct Record {
+        unsigned long long key;
+        int flags;
+        int reserved;
+        // followed by output_count doubles
+    };
+
+    size_t RecordBytes() const;
+
+    FILE* file_;
+    unsigned long long base_;
+    int output_count_;
+    long long end_offset_;                                     // Bytes on disk
+    std::unordered_map<unsigned long long, long long> index_;  // key -> file offset, or -1 - queue position
+    std::vector<unsigned char> queue_;
+};
+
+#endif
@@ -0,0 +1,124 @@
+//-----------------------------------------------------------------------------
+//   SharedChannel.h
+//   Cross-process message channel over named shared memory: one
+//   single-producer/single-consumer ring per direction, with a short spin
+//   and then a blocking wait (futex on Linux, named event on Windows)
+//
+//   Layout of the shared region:
+//     Header                     magic, capacity, creator pid, two Rings
+//     Slot[kSlots] to worker     SlotHeader + double values[capacity]
+//     Slot[kSlots] to client
+//   The creator (client) owns the name and removes it on Close().
+//-----------------------------------------------------------------------------
+
+#ifndef SHARED_CHANNEL_H
+#define SHARED_CHANNEL_H
+
+#include "SharedMemory.h"
+#include <atomic>
+#include <string>
+
+class SharedChannel {
+public:
+    enum Direction { TO_WORKER = 0, TO_CLIENT = 1 };
+
+    static const int kSlots = 4;            // Messages in flight per direction
+    static const int kTextBytes = 512;      // Error text carried with a reply
+
+    // One received message (values are copied to the caller's buffer)
+    struct Message {
+        int method;
+        int status;
+        int aux;            // Requests: values expected in the reply
+        int count;          // Values carried
+        char text[kTextBytes];
+    };
+
+    SharedChannel();
+    ~SharedChannel();
+    SharedChannel(const SharedChannel&) = delete;
+    SharedChannel& operator=(const SharedChannel&) = delete;
+
+    /**
+     * @brief Create a new channel (client side)
+     * @param name Unique name; see MakeName()
+     * @param capacity Largest number of values in one message
+     */
+    bool Create(const std::string& name, int capacity, std::string& error);
+
+    /**
+     * @brief Attach to a channel created by another process (worker side)
+     */
+    bool Open(const std::string& name, std::string& error);
+
+    void Close();
+    bool IsOpen() const;
+    int GetCapacity() const;
+    const std::string& GetName() const;
+
+    /**
+     * @brief Copy a message into the next free slot and wake the reader
+     * @return false if the ring is full or count exceeds the capacity
+     */
+    bool Post(Direction dir, int method, int status, int aux, const double* values, int count, const char* text);
+
+    /**
+     * @brief Wait for the next message and copy it out
+     * @param values Receives min(count, max_values) values
+     * @param timeout_ms Give up after this long (-1 = wait forever)
+     * @param spin_us Poll this long before blocking
+     * @return 1 received, 0 timed out
+     */
+    int Receive(Direction dir, Message& msg, double* values, int max_values, int timeout_ms, int spin_us);
+
+    /**
+     * @brief True while the process that created the channel is running
+     */
+    bool IsCreatorAlive() const;
+
+    /**
+     * @brief Channel name unique to this process and sequence number
+     */
+    static std::string MakeName(int sequence);
+
+private:
+    struct Ring {
+        std::atomic<unsigned int> head;         // Next slot the producer writes (futex word)
+        char pad0[60];
+        std::atomic<unsigned int> tail;         // Next slot the consumer reads
+        std::atomic<unsigned int> waiting;      // Consumer is (about to be) blocked
+        char pad1[56];
+    };
+
+    struct Header {
+        char magic[8];              // "GSCHAN01"
+        unsigned int capacity;
+        unsigned int slot_bytes;
+        long long creator_pid;
+        Ring rings[2];
+    };
+
+    struct SlotHeader {
+        int method;
+        int status;
+        int aux;
+        int count;
+        char text[kTextBytes];
+    };
+
+    static size_t SlotBytes(int capacity);
+    static size_t RegionBytes(int capacity);
+    bool CreateSignals(std::string& error);
+    char* SlotAt(Direction dir, unsigned int index) const;
+    void Wake(Direction dir);
+    void Block(Direction dir, unsigned int seen_head, int timeout_ms);
+
+    std::string name_;
+    bool owner_;
+    SharedMemory region_;
+    Header* header_;            // Start of region_
+    void* events_[2];           // Windows: one auto-reset event per direction
+    mutable void* creator_;     // Windows: creator process handle, opened lazily
+};
+
+#endif
@@ -0,0 +1,56 @@
+//-----------------------------------------------------------------------------
+//   SharedMemory.h
+//   Named shared-memory region: file mapping on Windows, POSIX shm
+//   elsewhere. The creator owns the name and removes it on Close().
+//-----------------------------------------------------------------------------
+
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+
+#include <string>
+
+class SharedMemory {
+public:
+    SharedMemory();
+    ~SharedMemory();
+    SharedMemory(const SharedMemory&) = delete;
+    SharedMemory& operator=(const SharedMemory&) = delete;
+
+    /**
+     * @brief Create a zeroed region
+     * @param name Platform name ("Local\\..." on Windows, "/..." on POSIX)
+     * @return false if the name exists or the region cannot be mapped
+     */
+    bool Create(const std::string& name, size_t bytes, std::string& error);
+
+    /**
+     * @brief Map a region created by another process
+     */
+    bool Open(const std::string& name, std::string& error);
+
+    void Close();
+    bool IsOpen() const;
+    void* GetData() const;
+    size_t GetSize() const;             // Mapped bytes (Windows rounds up to pages)
+    const std::string& GetName() const;
+
+    /**
+     * @brief Remove a name left behind by a process that died (POSIX only;
+     *        Windows removes a region with its last handle)
+     */
+    static void Remove(const std::string& name);
+
+    static long long CurrentProcessId();
+    static bool IsProcessAlive(long long pid);
+
+private:
+    bool Map(bool create, size_t bytes, std::string& error);
+
+    std::string name_;
+    bool owner_;
+    void* data_;
+    size_t bytes_;
+    void* mapping_;             // Windows: file mapping handle; POSIX: unused
+};
+
+#endif
@@ -0,0 +1,80 @@
+//-----------------------------------------------------------------------------
+//   SpinupCache.h
+//   Runs the antecedent spin-up period once and starts every realization
+//   from the SWMM hotstart file it saved
+//
+//   The spin-up is simulated from a copy of model.inp whose END_DATE is moved
+//   to the end of the spin-up window and whose [FILES] section saves a
+//   hotstart file. Realizations then open a second copy whose START_DATE is
+//   the end of the window and which uses that hotstart file. Cache entries
+//   are keyed by a hash of model.inp and the window, so editing the model
+//   invalidates them.
+//-----------------------------------------------------------------------------
+
+#ifndef SPINUP_CACHE_H
+#define SPINUP_CACHE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+class SpinupCache {
+public:
+    SpinupCache();
+    ~SpinupCache();
+    SpinupCache(const SpinupCache&) = delete;
+    SpinupCache& operator=(const SpinupCache&) = delete;
+
+    /**
+     * @brief Make sure the hotstart for this model and window exists
+     * @param model_path Original model (model.inp)
+     * @param duration_days Length of the spin-up window from START_DATE/START_TIME
+     * @param cache_dir Directory for hotstart files ("" = working directory)
+     * @param run_inp Receives the .inp realizations should open
+     * @param error Receives a message on failure
+     * @return false on failure
+     * @note Runs the spin-up through the SWMM API when the hotstart is not
+     *       cached yet, so no other project may be open
+     */
+    bool Prepare(const std::string& model_path, double duration_days, const std::string& cache_dir,
+                 std::string& run_inp, std::string& error);
+
+    bool RanSpinup() const;                     // Last Prepare() simulated the window
+    const std::string& GetHotstartPath() const;
+
+private:
+    bool ran_spinup_;
+    std::string hotstart_path_;
+};
+
+//-----------------------------------------------------------------------------
+//   .inp helpers (exposed for unit tests)
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Convert SWMM date ("MM/DD/YYYY", "MM-DD-YYYY" or "JAN/01/2007") and
+ *        time ("HH:MM[:SS]" or decimal hours) to days since 01/01/1900
+ */
+bool InpDateTimeToDays(const std::string& date, const std::string& time, double* days);
+
+/**
+ * @brief Format days since 01/01/1900 as "MM/DD/YYYY" and "HH:MM:SS"
+ */
+void DaysToInpDateTime(double days, std::string& date, std::string& time);
+
+/**
+ * @brief Read the [OPTIONS] section as upper-case key -> first value token
+ */
+std::map<std::string, std::string> ReadInpOptions(const std::string& inp);
+
+/**
+ * @brief Rewrite an .inp file
+ * @param inp Original file contents
+ * @param options [OPTIONS] keys to replace or add
+ * @param files_lines Lines for [FILES]; existing USE/SAVE HOTSTART lines are dropped
+ * @return Rewritten contents
+ */
+std::string RewriteInp(const std::string& inp, const std::map<std::string, std::string>& options,
+                       const std::vector<std::string>& files_lines);
+
+#endif
@@ -0,0 +1,54 @@
+//-----------------------------------------------------------------------------
+//   StepWorker.h
+//   Dedicated thread that runs one SWMM step job at a time
+//-----------------------------------------------------------------------------
+
+#ifndef STEP_WORKER_H
+#define STEP_WORKER_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class StepWorker {
+public:
+    StepWorker();
+    ~StepWorker();
+    StepWorker(const StepWorker&) = delete;
+    StepWorker& operator=(const StepWorker&) = delete;
+
+    void Start();
+
+    /**
+     * @brief Wait for any pending job, then stop and join the thread
+     */
+    void Stop();
+
+    /**
+     * @brief Hand a job to the worker thread
+     * @note At most one job is in flight; Submit() waits for the previous one
+     */
+    void Submit(const std::function<void()>& job);
+
+    /**
+     * @brief Block until the submitted job (if any) has finished
+     * @note Everything the job wrote is visible to the caller afterwards
+     */
+    void Wait();
+
+    bool IsRunning() const;
+    bool IsBusy();
+
+private:
+    void Run();
+
+    std::thread* thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::function<void()> job_;
+    bool has_job_;
+    bool stop_;
+};
+
+#endif
@@ -0,0 +1,124 @@
+//-----------------------------------------------------------------------------
+//   Telemetry.h
+//   Live bridge state in a named shared-memory segment: the latest applied
+//   inputs and gathered outputs, SWMM elapsed time and step counters
+//
+//   One writer (the bridge) and any number of readers. Updates use a
+//   sequence lock: the writer makes the counter odd, copies the values and
+//   makes it even again; a reader retries when the counter was odd or
+//   changed while it copied. Readers never block the writer, and a
+//   Publish() is one memcpy per vector.
+//
+//   Layout:
+//     Header                     magic, counts, writer pid, seq, scalars
+//     double inputs[input_count]
+//     double outputs[output_count]
+//     char names[input_count + output_count][kNameBytes]
+//-----------------------------------------------------------------------------
+
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include "SharedMemory.h"
+#include <atomic>
+#include <string>
+#include <vector>
+
+class Telemetry {
+public:
+    enum State { STATE_IDLE = 0, STATE_RUNNING, STATE_ENDED, STATE_FAILED };
+
+    static const int kNameBytes = 64;
+
+    struct Snapshot {
+        long long writer_pid;
+        int realization;
+        int state;
+        long long route_steps;      // Routing steps completed this realization
+        long long intervals;        // GoldSim intervals completed this realization
+        double elapsed_days;        // SWMM elapsed time
+        std::vector<double> inputs;
+        std::vector<double> outputs;
+    };
+
+    Telemetry();
+    ~Telemetry();
+    Telemetry(const Telemetry&) = delete;
+    Telemetry& operator=(const Telemetry&) = delete;
+
+    /**
+     * @brief Create the segment (writer side)
+     * @param name Segment name without platform prefix
+     * @note A segment left behind by a process that no longer runs is
+     *       replaced; one owned by a running process is an error
+     */
+    bool Create(const std::string& name, const std::vector<std::string>& input_names,
+                const std::vector<std::string>& output_names, std::string& error);
+
+    /**
+     * @brief Attach to a segment (reader side)
+     */
+    bool Open(const std::string& name, std::string& error);
+
+    void Close();
+    bool IsOpen() const;
+    const std::vector<std::string>& GetInputNames() const;
+    const std::vector<std::string>& GetOutputNames() const;
+
+    /**
+     * @brief Publish a new state (writer side)
+     * @param inputs, outputs NULL keeps the previous values
+     */
+    void Publish(int realization, int state, long long route_steps, long long intervals, double elapsed_days,
+                 const double* inputs, const double* outputs);
+
+    /**
+     * @brief Change only the state (writer side)
+     */
+    void SetState(int state);
+
+    /**
+     * @brief State last published (writer side)
+     */
+    int GetState() const { return header_ ? header_->state : STATE_IDLE; }
+
+    /**
+     * @brief Copy a consistent snapshot (reader side)
+     * @return false if the writer kept updating for max_attempts tries
+     */
+    bool Read(Snapshot& snap, int max_attempts) const;
+
+    static const char* StateName(int state);
+
+    /**
+     * @brief Platform name for a segment: "Local\\name" or "/name"
+     */
+    static std::string PlatformName(const std::string& name);
+
+private:
+    struct Header {
+        char magic[8];              // "GSTEL001", written last by Create()
+        unsigned int input_count;
+        unsigned int output_count;
+        long long writer_pid;
+        std::atomic<unsigned int> seq;
+        unsigned int pad;
+        int realization;            // From here on guarded by seq
+        int state;
+        long long route_steps;
+        long long intervals;
+        double elapsed_days;
+    };
+
+    static size_t RegionBytes(size_t inputs, size_t outputs);
+    double* Inputs() const;
+    double* Outputs() const;
+    char* Names() const;
+
+    SharedMemory region_;
+    Header* header_;
+    std::vector<std::string> input_names_;
+    std::vector<std::string> output_names_;
+};
+
+#endif
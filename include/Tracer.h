@@ -0,0 +1,86 @@
+//-----------------------------------------------------------------------------
+//   Tracer.h
+//   Timeline of bridge activity as Chrome/Perfetto trace-event JSON
+//
+//   Each thread appends complete events (name, begin, duration) to its own
+//   fixed-size buffer, registered under a lock on first use and written
+//   without one after that. Events beyond a buffer's capacity are counted
+//   and dropped. Write() must run while no thread is adding events.
+//-----------------------------------------------------------------------------
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Tracer {
+public:
+    Tracer();
+    ~Tracer();
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @brief Drop all buffers and start a new trace
+     * @param events_per_thread Capacity of each thread's buffer
+     * @note No thread may be adding events during the call
+     */
+    void Start(int events_per_thread);
+
+    /**
+     * @brief Stop accepting events (buffers are kept for Write())
+     */
+    void Stop();
+
+    bool IsActive() const { return active_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Append one event for the calling thread
+     * @param name Static string; the pointer is kept until Write()
+     * @param begin_ns Start on the Profiler::Now() clock
+     */
+    void Add(const char* name, long long begin_ns, long long duration_ns);
+
+    /**
+     * @brief Label the calling thread in the viewer
+     * @param name Static string
+     */
+    void NameThread(const char* name);
+
+    /**
+     * @brief Write every buffered event as trace-event JSON
+     */
+    bool Write(const std::string& path) const;
+
+    long long GetEventCount() const;
+    long long GetDroppedCount() const;
+
+private:
+    struct Event {
+        const char* name;
+        long long begin_ns;
+        long long duration_ns;
+    };
+
+    struct ThreadBuffer {
+        int tid;                        // 1-based registration order
+        const char* name;
+        std::vector<Event> events;      // Sized once at registration
+        std::atomic<size_t> count;
+        long long dropped;
+    };
+
+    ThreadBuffer* Local();
+
+    std::atomic<bool> active_;
+    unsigned int generation_;           // Bumped by Start(); stale thread caches re-register
+    int capacity_;
+    long long origin_ns_;               // Trace time zero
+    mutable std::mutex mutex_;          // Guards buffers_ (registration only)
+    std::vector<ThreadBuffer*> buffers_;
+};
+
+#endif
@@ -0,0 +1,109 @@
+//-----------------------------------------------------------------------------
+//   WorkerPool.h
+//   Worker processes that each host a private SWMM instance, bound to a
+//   model directory and member number and driven over a SharedChannel
+//
+//   SWMM keeps its state in globals, so one process can run one model.
+//   The pool starts one worker per (directory, member) on first use, keeps
+//   it between realizations and forwards each GoldSim call as one request
+//   and one reply. Member 0 is the plain worker; ensemble members are
+//   numbered from 1 and run concurrently between Send() and Wait(). A
+//   worker that dies or stops answering is removed and restarted on the
+//   next Bind().
+//-----------------------------------------------------------------------------
+
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include "SharedChannel.h"
+#include <string>
+#include <vector>
+
+// Protocol methods besides the GoldSim method IDs
+#define WORKER_READY     -100   // Worker -> client once the channel is open
+#define WORKER_SHUTDOWN  -101   // Client -> worker: leave the loop and exit
+
+// Requests carry the member number in the message status field
+
+class WorkerPool {
+public:
+    WorkerPool();
+    ~WorkerPool();
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * @brief Start (or reuse) the worker for a model directory and member
+     * @param dir Working directory of the worker (model.inp and mapping)
+     * @param member 0 for a plain worker, 1..K for ensemble members
+     * @param command Command line; "{channel}" is replaced by the channel name
+     * @param capacity Largest number of values in one call (inputs or outputs)
+     * @param timeout_ms How long to wait for the worker to attach
+     * @return false if the worker cannot be started or does not attach
+     * @note A running worker whose channel is too small is restarted
+     */
+    bool Bind(const std::string& dir, int member, const std::string& command, int capacity, int timeout_ms, std::string& error);
+
+    /**
+     * @brief Post one call without waiting for the reply
+     * @param nout Values expected in the reply
+     * @return false if the worker is not bound or its channel is full; a
+     *         worker with a full channel is stopped and removed
+     */
+    bool Send(const std::string& dir, int member, int method, const double* inargs, int nin, int nout, std::string& error);
+
+    /**
+     * @brief Wait for the reply to the last Send()
+     * @param status Receives the worker's status
+     * @param outargs Receives nout values from the reply
+     * @param text Receives the worker's error text, if any
+     * @param timeout_ms Per-call limit (-1 = none); the worker is also
+     *        checked for exit while waiting
+     * @return false if the worker died, timed out or is not bound; it is
+     *         then stopped and removed
+     */
+    bool Wait(const std::string& dir, int member, int* status, double* outargs, int nout,
+              int timeout_ms, std::string& text, std::string& error);
+
+    /**
+     * @brief Send() and Wait() for one worker
+     */
+    bool Call(const std::string& dir, int member, int method, int* status, const double* inargs, int nin,
+              double* outargs, int nout, int timeout_ms, std::string& text, std::string& error);
+
+    /**
+     * @brief Ask every worker for a directory to exit and wait for them
+     */
+    void Release(const std::string& dir);
+
+    /**
+     * @brief Release every worker
+     */
+    void Shutdown();
+
+    bool IsBound(const std::string& dir, int member) const;
+    int GetWorkerCount() const;
+    void SetSpin(int spin_us);
+
+private:
+    struct Worker {
+        std::string dir;
+        int member;
+        SharedChannel channel;
+        long long pid;
+        void* process;          // Windows: process handle
+        int capacity;
+    };
+
+    Worker* Find(const std::string& dir, int member) const;
+    bool Launch(Worker& w, const std::string& command, std::string& error);
+    bool IsAlive(Worker& w);
+    void Stop(Worker* w, bool ask);
+
+    std::vector<Worker*> workers_;
+    std::vector<double> reply_;
+    int sequence_;
+    int spin_us_;
+};
+
+#endif
@@ -158,6 +158,11 @@ double DLLEXPORT swmm_getLidUSurfaceOutflow(int subcatchIndex, int lidIndex);
 double DLLEXPORT swmm_getLidUSurfaceInflow(int subcatchIndex, int lidIndex);
 double DLLEXPORT swmm_getLidUDrainFlow(int subcatchIndex, int lidIndex);
 
+// Hotstart API Extension - save the current state mid-run:
+//   int swmm_saveHotstart(const char *hsfile);
+// Stock swmm5.dll builds do not export it, so it is not declared here for
+// linking; the bridge looks it up at run time (FindLibraryFunction)
+
 #ifdef __cplusplus 
 }   // matches the linkage specification from above */ 
 #endif
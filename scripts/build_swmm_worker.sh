@@ -0,0 +1,29 @@
+#!/bin/sh
+# Build the SWMM worker host (swmm_worker) on Linux
+#
+# usage: scripts/build_swmm_worker.sh [dir with libswmm5.so] [output]
+#
+# The SWMM library must be built from the EPA sources with the bridge's API
+# additions applied (see swmm5_integration/). Its directory is recorded as
+# the worker's rpath.
+
+set -e
+
+ROOT=$(cd "$(dirname "$0")/.." && pwd)
+SWMM_LIB_DIR=${1:-$ROOT/lib}
+OUT=${2:-swmm_worker}
+CXX=${CXX:-g++}
+
+# Bridge translation units; keep in step with GSswmm.vcxproj
+BRIDGE_SRCS="SwmmGoldSimBridge.cpp MappingLoader.cpp OutputPlan.cpp BridgeLog.cpp StepWorker.cpp
+    OutputAggregator.cpp SpinupCache.cpp ResultMemo.cpp Controllers.cpp Expression.cpp OutputStats.cpp
+    Recorder.cpp SharedChannel.cpp WorkerPool.cpp Profiler.cpp Tracer.cpp FlightRecorder.cpp
+    SharedMemory.cpp Telemetry.cpp Checkpoint.cpp InputSeries.cpp NameIndex.cpp"
+
+SRCS="$ROOT/SwmmWorkerHost.cpp"
+for f in $BRIDGE_SRCS; do SRCS="$SRCS $ROOT/$f"; done
+
+echo "Building $OUT against $SWMM_LIB_DIR/libswmm5.so"
+$CXX -std=c++14 -O2 -Wall -pthread -I"$ROOT" $SRCS \
+    -L"$SWMM_LIB_DIR" -Wl,-rpath,"$SWMM_LIB_DIR" -lswmm5 -lrt -ldl -o "$OUT"
+echo "[OK] $OUT created"
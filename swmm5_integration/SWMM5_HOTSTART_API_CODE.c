@@ -0,0 +1,63 @@
+// =============================================================================
+// ADD THIS CODE TO: SWMM5-source/src/hotstart.c
+// Location: At the end of the file
+// =============================================================================
+
+//=============================================================================
+// Hotstart API Extension - save the current state mid-run
+//=============================================================================
+
+/**
+ * @brief Write the current runoff and routing state to a hotstart file
+ * @param path File to write (replaced if it exists)
+ * @return 0 on success, or ERR_HOTSTART_FILE_OPEN
+ * @note Uses the same writers as the SAVE HOTSTART file written at the end
+ *       of a run, so the file can be given to USE HOTSTART. The run's own
+ *       SAVE HOTSTART file (if any) is untouched, and a failed save does not
+ *       stop the simulation.
+ */
+int hotstart_save(const char* path)
+{
+    TFile saved = Fhotstart2;
+    int   savedError = ErrorCode;
+    int   ok;
+
+    sstrncpy(Fhotstart2.name, path, MAXFNAME);
+    Fhotstart2.mode = SAVE_FILE;
+    Fhotstart2.file = NULL;
+    ok = openHotstartFile2();
+    if ( ok )
+    {
+        saveRunoff();
+        saveRouting();
+        if ( fclose(Fhotstart2.file) != 0 ) ok = FALSE;
+    }
+    Fhotstart2 = saved;
+    ErrorCode = savedError;
+    return ok ? 0 : ERR_HOTSTART_FILE_OPEN;
+}
+
+// =============================================================================
+// ADD THIS LINE TO: SWMM5-source/src/funcs.h
+// Location: In the "Hotstart File Methods" group, after hotstart_close()
+// =============================================================================
+
+int     hotstart_save(const char* path);
+
+// =============================================================================
+// ADD THIS CODE TO: SWMM5-source/src/swmm5.c
+// Location: After swmm_stride()
+// =============================================================================
+
+int DLLEXPORT swmm_saveHotstart(const char* hsfile)
+//
+//  Input:   hsfile = name of the hotstart file to write
+//  Output:  returns an error code
+//  Purpose: saves the current state of a running simulation to a hotstart
+//           file, e.g. for checkpoints of long runs.
+//
+{
+    if ( ErrorCode ) return error_getCode(ErrorCode);
+    if ( !IsStartedFlag ) return error_getCode(ERR_API_SIM_NRUNNING);
+    return error_getCode(hotstart_save(hsfile));
+}
@@ -10,3 +10,7 @@ void   DLLEXPORT swmm_getLidUName(int subcatchIndex, int lidIndex, char* name, i
 double DLLEXPORT swmm_getLidUStorageVolume(int subcatchIndex, int lidIndex);
 double DLLEXPORT swmm_getLidUSurfaceOutflow(int subcatchIndex, int lidIndex);
 double DLLEXPORT swmm_getLidUSurfaceInflow(int subcatchIndex, int lidIndex);
+
+// Hotstart API Extension - save the current state mid-run
+// (implementation in SWMM5_HOTSTART_API_CODE.c)
+int    DLLEXPORT swmm_saveHotstart(const char *hsfile);
@@ -29,7 +29,30 @@ if %ERRORLEVEL% NEQ 0 (
     exit /b 1
 )
 
-echo [1/4] Compiling LID API stub...
+REM Bridge translation units; keep in step with GSswmm.vcxproj
+set BRIDGE_SRCS=..\SwmmGoldSimBridge.cpp ..\MappingLoader.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\OutputPlan.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\BridgeLog.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\StepWorker.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\OutputAggregator.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\SpinupCache.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\ResultMemo.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Controllers.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Expression.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\OutputStats.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Recorder.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\SharedChannel.cpp ..\WorkerPool.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Profiler.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Tracer.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\FlightRecorder.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\SharedMemory.cpp ..\Telemetry.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Checkpoint.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\InputSeries.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\NameIndex.cpp
+set "BRIDGE_OBJS="
+for %%f in (%BRIDGE_SRCS%) do call set "BRIDGE_OBJS=%%BRIDGE_OBJS%% %%~nf.obj"
+
+echo [1/3] Compiling LID API stub...
 cl /c /EHsc /W3 /MD /DDLLEXPORT=__declspec(dllexport) /I.. swmm_lid_api_stub.cpp >nul 2>&1
 if %ERRORLEVEL% NEQ 0 (
     echo ERROR: Failed to compile LID API stub
@@ -37,28 +60,20 @@ if %ERRORLEVEL% NEQ 0 (
 )
 echo [OK] LID API stub compiled
 
-echo [2/4] Compiling MappingLoader...
-cl /c /EHsc /W3 /MD /I.. ..\MappingLoader.cpp >nul 2>&1
-if %ERRORLEVEL% NEQ 0 (
-    echo ERROR: Failed to compile MappingLoader
-    exit /b 1
-)
-echo [OK] MappingLoader compiled
-
-echo [3/4] Compiling SwmmGoldSimBridge...
-cl /c /EHsc /W3 /MD /I.. ..\SwmmGoldSimBridge.cpp >nul 2>&1
+echo [2/3] Compiling bridge sources...
+cl /c /EHsc /W3 /MD /I.. %BRIDGE_SRCS% >nul 2>&1
 if %ERRORLEVEL% NEQ 0 (
-    echo ERROR: Failed to compile SwmmGoldSimBridge
+    echo ERROR: Failed to compile bridge sources
     exit /b 1
 )
-echo [OK] SwmmGoldSimBridge compiled
+echo [OK] Bridge sources compiled
 
-echo [4/4] Linking test bridge DLL...
-link /DLL /OUT:GSswmm.dll SwmmGoldSimBridge.obj MappingLoader.obj swmm_lid_api_stub.obj ..\lib\swmm5.lib kernel32.lib user32.lib msvcrt.lib msvcprt.lib >nul 2>&1
+echo [3/3] Linking test bridge DLL...
+link /DLL /OUT:GSswmm.dll %BRIDGE_OBJS% swmm_lid_api_stub.obj ..\lib\swmm5.lib kernel32.lib user32.lib msvcrt.lib msvcprt.lib >nul 2>&1
 if %ERRORLEVEL% NEQ 0 (
     echo ERROR: Failed to link bridge DLL
     echo Trying with additional libraries...
-    link /DLL /OUT:GSswmm.dll SwmmGoldSimBridge.obj MappingLoader.obj swmm_lid_api_stub.obj ..\lib\swmm5.lib kernel32.lib user32.lib
+    link /DLL /OUT:GSswmm.dll %BRIDGE_OBJS% swmm_lid_api_stub.obj ..\lib\swmm5.lib kernel32.lib user32.lib
     if %ERRORLEVEL% NEQ 0 (
         echo ERROR: Link failed
         exit /b 1
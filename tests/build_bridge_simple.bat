@@ -4,24 +4,42 @@ REM Simple build script for bridge DLL with LID API stub
 echo Building Bridge DLL with LID API Stub...
 echo.
 
+REM Bridge translation units; keep in step with GSswmm.vcxproj
+set BRIDGE_SRCS=..\SwmmGoldSimBridge.cpp ..\MappingLoader.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\OutputPlan.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\BridgeLog.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\StepWorker.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\OutputAggregator.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\SpinupCache.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\ResultMemo.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Controllers.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Expression.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\OutputStats.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Recorder.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\SharedChannel.cpp ..\WorkerPool.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Profiler.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Tracer.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\FlightRecorder.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\SharedMemory.cpp ..\Telemetry.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Checkpoint.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\InputSeries.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\NameIndex.cpp
+set "BRIDGE_OBJS="
+for %%f in (%BRIDGE_SRCS%) do call set "BRIDGE_OBJS=%%BRIDGE_OBJS%% %%~nf.obj"
+
 REM Compile LID API stub
 echo [1/3] Compiling LID API stub...
 cl /c /EHsc /W3 /MD /DDLLEXPORT=__declspec(dllexport) /I.. swmm_lid_api_stub.cpp
 if %ERRORLEVEL% NEQ 0 exit /b 1
 
-REM Compile MappingLoader
-echo [2/3] Compiling MappingLoader...
-cl /c /EHsc /W3 /MD /I.. ..\MappingLoader.cpp
-if %ERRORLEVEL% NEQ 0 exit /b 1
-
-REM Compile SwmmGoldSimBridge
-echo [2/3] Compiling SwmmGoldSimBridge...
-cl /c /EHsc /W3 /MD /I.. ..\SwmmGoldSimBridge.cpp
+REM Compile bridge sources
+echo [2/3] Compiling bridge sources...
+cl /c /EHsc /W3 /MD /I.. %BRIDGE_SRCS%
 if %ERRORLEVEL% NEQ 0 exit /b 1
 
 REM Link DLL
 echo [3/3] Linking bridge DLL...
-link /DLL /OUT:GSswmm.dll SwmmGoldSimBridge.obj MappingLoader.obj swmm_lid_api_stub.obj ..\lib\swmm5.lib
+link /DLL /OUT:GSswmm.dll %BRIDGE_OBJS% swmm_lid_api_stub.obj ..\lib\swmm5.lib
 if %ERRORLEVEL% NEQ 0 exit /b 1
 
 echo.
@@ -23,6 +23,29 @@ echo Initializing build environment...
 call "%VSINSTALLDIR%\VC\Auxiliary\Build\vcvars64.bat"
 
 echo.
+REM Bridge translation units; keep in step with GSswmm.vcxproj
+set BRIDGE_SRCS=..\SwmmGoldSimBridge.cpp ..\MappingLoader.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\OutputPlan.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\BridgeLog.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\StepWorker.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\OutputAggregator.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\SpinupCache.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\ResultMemo.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Controllers.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Expression.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\OutputStats.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Recorder.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\SharedChannel.cpp ..\WorkerPool.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Profiler.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Tracer.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\FlightRecorder.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\SharedMemory.cpp ..\Telemetry.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\Checkpoint.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\InputSeries.cpp
+set BRIDGE_SRCS=%BRIDGE_SRCS% ..\NameIndex.cpp
+set "BRIDGE_OBJS="
+for %%f in (%BRIDGE_SRCS%) do call set "BRIDGE_OBJS=%%BRIDGE_OBJS%% %%~nf.obj"
+
 echo [1/3] Compiling LID API stub...
 cl /c /EHsc /W3 /MD /DDLLEXPORT=__declspec(dllexport) /I.. swmm_lid_api_stub.cpp
 
@@ -35,15 +58,9 @@ echo [OK] LID API stub compiled
 echo.
 
 echo [2/3] Compiling bridge components...
-cl /c /EHsc /W3 /MD /I.. ..\MappingLoader.cpp >nul 2>&1
-if %ERRORLEVEL% NEQ 0 (
-    echo ERROR: Failed to compile MappingLoader.cpp
-    exit /b 1
-)
-
-cl /c /EHsc /W3 /MD /I.. ..\SwmmGoldSimBridge.cpp >nul 2>&1
+cl /c /EHsc /W3 /MD /I.. %BRIDGE_SRCS% >nul 2>&1
 if %ERRORLEVEL% NEQ 0 (
-    echo ERROR: Failed to compile SwmmGoldSimBridge.cpp
+    echo ERROR: Failed to compile bridge components
     exit /b 1
 )
 
@@ -51,7 +68,7 @@ echo [OK] Bridge components compiled
 echo.
 
 echo [3/3] Linking bridge DLL...
-link /DLL /OUT:GSswmm.dll SwmmGoldSimBridge.obj MappingLoader.obj swmm_lid_api_stub.obj ..\lib\swmm5.lib >nul 2>&1
+link /DLL /OUT:GSswmm.dll %BRIDGE_OBJS% swmm_lid_api_stub.obj ..\lib\swmm5.lib >nul 2>&1
 
 if %ERRORLEVEL% NEQ 0 (
     echo ERROR: Failed to link bridge DLL
@@ -0,0 +1,94 @@
+@echo off
+REM Build and run unit tests for bridge modules that do not need swmm5.dll
+
+echo ========================================
+echo Building Module Tests
+echo ========================================
+echo.
+
+call :build test_output_plan "test_output_plan.cpp ..\OutputPlan.cpp ..\Expression.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_bridge_log "test_bridge_log.cpp ..\BridgeLog.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_mapping_options "test_mapping_options.cpp ..\MappingLoader.cpp ..\Expression.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_output_aggregator "test_output_aggregator.cpp ..\OutputAggregator.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_spinup_cache "test_spinup_cache.cpp ..\SpinupCache.cpp ..\BridgeLog.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_result_memo "test_result_memo.cpp ..\ResultMemo.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_controllers "test_controllers.cpp ..\Controllers.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_expression "test_expression.cpp ..\Expression.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_output_stats "test_output_stats.cpp ..\OutputStats.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_recorder "test_recorder.cpp ..\Recorder.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_shared_channel "test_shared_channel.cpp ..\SharedChannel.cpp ..\SharedMemory.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_profiler "test_profiler.cpp ..\Profiler.cpp ..\Tracer.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_tracer "test_tracer.cpp ..\Tracer.cpp ..\Profiler.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_flight_recorder "test_flight_recorder.cpp ..\FlightRecorder.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_telemetry "test_telemetry.cpp ..\Telemetry.cpp ..\SharedMemory.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_checkpoint "test_checkpoint.cpp ..\Checkpoint.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_input_series "test_input_series.cpp ..\InputSeries.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+call :build test_name_index "test_name_index.cpp ..\NameIndex.cpp"
+if %ERRORLEVEL% NEQ 0 exit /b 1
+
+echo.
+echo ========================================
+echo Running Module Tests
+echo ========================================
+echo.
+
+set FAILED=0
+call :run test_output_plan
+call :run test_bridge_log
+call :run test_mapping_options
+call :run test_output_aggregator
+call :run test_spinup_cache
+call :run test_result_memo
+call :run test_controllers
+call :run test_expression
+call :run test_output_stats
+call :run test_recorder
+call :run test_shared_channel
+call :run test_profiler
+call :run test_tracer
+call :run test_flight_recorder
+call :run test_telemetry
+call :run test_checkpoint
+call :run test_input_series
+call :run test_name_index
+
+echo.
+if %FAILED% EQU 0 (
+    echo ALL MODULE TESTS PASSED!
+    exit /b 0
+) else (
+    echo SOME MODULE TESTS FAILED!
+    exit /b 1
+)
+
+:build
+echo Compiling %1...
+cl /nologo /EHsc /W3 /MD /I.. %~2 /Fe:%1.exe >nul
+if %ERRORLEVEL% NEQ 0 (
+    echo ERROR: Failed to compile %1
+    exit /b 1
+)
+echo [OK] %1.exe created
+exit /b 0
+
+:run
+%1.exe
+if %ERRORLEVEL% NEQ 0 set FAILED=1
+exit /b 0
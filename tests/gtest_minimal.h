@@ -141,6 +141,19 @@ public:
         } \
     } while (0)
 
+#define EXPECT_NEAR(val1, val2, abs_error) \
+    do { \
+        double v1 = (val1); \
+        double v2 = (val2); \
+        double d = v1 - v2; \
+        if (!((d < 0 ? -d : d) <= (abs_error))) { \
+            std::ostringstream oss; \
+            oss << "Expected: " << #val1 << " near " << #val2 << " within " << #abs_error << std::endl; \
+            oss << "  Actual: " << v1 << " vs " << v2; \
+            TestRegistry::Instance().RecordFailure(__FILE__, __LINE__, oss.str()); \
+        } \
+    } while (0)
+
 #define EXPECT_TRUE(condition) \
     do { \
         if (!(condition)) { \
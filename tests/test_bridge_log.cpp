@@ -0,0 +1,100 @@
+//-----------------------------------------------------------------------------
+//   test_bridge_log.cpp
+//
+//   Unit tests for the asynchronous logging backend (BridgeLog)
+//   Tests: deferred formatting, string capture, level filtering and
+//   multi-threaded producers against the lock-free ring buffer
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/BridgeLog.h"
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::vector<std::string> ReadLogLines() {
+    std::vector<std::string> lines;
+    std::ifstream f(LOG_FILE);
+    std::string line;
+    while (std::getline(f, line)) lines.push_back(line);
+    return lines;
+}
+
+static bool EndsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+TEST(BridgeLog, SynchronousWriteFormatsArguments) {
+    LogSetLevel(LOG_LEVEL_INFO);
+    Log(2, "sync %d %.2f %s %zu", 7, 1.5, "abc", (size_t)42);
+    std::vector<std::string> lines = ReadLogLines();
+    ASSERT_TRUE(!lines.empty());
+    EXPECT_TRUE(EndsWith(lines.back(), "[INFO ] sync 7 1.50 abc 42"));
+}
+
+TEST(BridgeLog, AsyncCapturesStringsByValue) {
+    LogSetLevel(LOG_LEVEL_INFO);
+    LogStart();
+    {
+        // The buffer is overwritten before the writer formats the record
+        std::string name = "POND1";
+        Log(2, "element %s", name.c_str());
+        name = "XXXXX";
+        std::string stored = "S1/InfilTrench";
+        Log(2, "lid %s", stored);
+    }
+    LogStop();
+    std::vector<std::string> lines = ReadLogLines();
+    ASSERT_GE(lines.size(), (size_t)2);
+    EXPECT_TRUE(EndsWith(lines[lines.size() - 2], "element POND1"));
+    EXPECT_TRUE(EndsWith(lines.back(), "lid S1/InfilTrench"));
+}
+
+TEST(BridgeLog, LevelFiltering) {
+    LogSetLevel(LOG_LEVEL_ERROR);
+    size_t before = ReadLogLines().size();
+    Log(2, "info is filtered");
+    LogDebug("debug is filtered %d", 1);
+    Log(1, "error %d", 5);
+    std::vector<std::string> lines = ReadLogLines();
+    ASSERT_EQ(lines.size(), before + 1);
+    EXPECT_TRUE(EndsWith(lines.back(), "[ERROR] error 5"));
+    LogSetLevel(LOG_LEVEL_INFO);
+}
+
+TEST(BridgeLog, ConcurrentProducersLoseNothing) {
+    const int kThreads = 4;
+    const int kPerThread = 20000;   // Several times the ring capacity
+    LogSetLevel(LOG_LEVEL_INFO);
+    size_t before = ReadLogLines().size();
+    LogStart();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; t++) {
+        threads.push_back(std::thread([t]() {
+            for (int i = 0; i < kPerThread; i++) Log(2, "t%d i%d", t, i);
+        }));
+    }
+    for (auto& th : threads) th.join();
+    LogStop();
+    std::vector<std::string> lines = ReadLogLines();
+    EXPECT_EQ(lines.size(), before + (size_t)(kThreads * kPerThread));
+}
+
+TEST(BridgeLog, OversizedStringIsTruncated) {
+    LogSetLevel(LOG_LEVEL_INFO);
+    LogStart();
+    std::string big(1000, 'x');
+    Log(2, "big %s end %d", big.c_str(), 3);
+    LogStop();
+    std::vector<std::string> lines = ReadLogLines();
+    ASSERT_TRUE(!lines.empty());
+    EXPECT_TRUE(lines.back().find("big xxx") != std::string::npos);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    int failed = RUN_ALL_TESTS();
+    std::remove(LOG_FILE);
+    return failed;
+}
@@ -2,12 +2,19 @@
 //   test_calculate.cpp
 //
 //   Test program to verify XF_CALCULATE handler implementation
-//   Tests: Calculate handler with rainfall input and runoff output
+//   Tests: Calculate handler with rainfall input and runoff output, and
+//   stepping, aggregation and memo options run against their own
+//   SwmmGoldSimBridge.json
 //-----------------------------------------------------------------------------
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
 #include <windows.h>
 #include <cmath>
+#include <algorithm>
 
 // Function pointer type for the bridge function
 typedef void (*BridgeFunctionType)(int, int*, double*, double*);
@@ -24,6 +31,107 @@ typedef void (*BridgeFunctionType)(int, int*, double*, double*);
 #define XF_FAILURE              1
 #define XF_FAILURE_WITH_MSG    -1
 
+#define CONFIG_FILE "SwmmGoldSimBridge.json"
+
+static std::string ReadFileText(const char* path)
+{
+    std::ifstream f(path, std::ios::binary);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+}
+
+static void WriteFileText(const char* path, const std::string& text)
+{
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f << text;
+}
+
+#define DEFAULT_OUTPUTS \
+    "    {\"index\": 0, \"name\": \"S1\", \"object_type\": \"SUBCATCH\", \"property\": \"RUNOFF\"},\n" \
+    "    {\"index\": 1, \"name\": \"O1\", \"object_type\": \"OUTFALL\", \"property\": \"FLOW\"}\n"
+
+// Mapping for model.inp (ElapsedTime and RainGage rainfall in; by default
+// S1 runoff and O1 flow out) with extra top-level sections such as "stepping"
+static std::string BridgeConfig(const std::string& sections,
+                                const std::string& outputs = DEFAULT_OUTPUTS)
+{
+    return "{\n"
+           "  \"version\": \"1.0\",\n"
+           "  \"logging_level\": \"ERROR\",\n" + sections +
+           "  \"inputs\": [\n"
+           "    {\"index\": 0, \"name\": \"ElapsedTime\", \"object_type\": \"SYSTEM\", \"property\": \"ELAPSEDTIME\"},\n"
+           "    {\"index\": 1, \"name\": \"RainGage\", \"object_type\": \"GAGE\", \"property\": \"RAINFALL\"}\n"
+           "  ],\n"
+           "  \"outputs\": [\n" + outputs +
+           "  ]\n"
+           "}\n";
+}
+
+// The bridge reads its configuration once per load, so every case with its
+// own configuration loads a fresh copy of the DLL
+static BridgeFunctionType LoadBridge(HMODULE* dll)
+{
+    *dll = LoadLibraryA("GSswmm.dll");
+    if (!*dll) return NULL;
+    return (BridgeFunctionType)GetProcAddress(*dll, "SwmmGoldSimBridge");
+}
+
+// One realization: XF_INITIALIZE, one XF_CALCULATE per rainfall value with the
+// elapsed time input step_seconds apart, then XF_CLEANUP. The first n_out
+// outputs of every call are appended to outputs
+static bool RunRealization(BridgeFunctionType Bridge, const std::vector<double>& rain,
+                           double step_seconds, int n_out, std::vector<double>& outputs)
+{
+    int status;
+    double inargs[10] = {0};
+    double outargs[10] = {0};
+    Bridge(XF_INITIALIZE, &status, inargs, outargs);
+    if (status != XF_SUCCESS) return false;
+    bool ok = true;
+    for (size_t k = 0; k < rain.size() && ok; k++)
+    {
+        inargs[0] = k * step_seconds;
+        inargs[1] = rain[k];
+        Bridge(XF_CALCULATE, &status, inargs, outargs);
+        if (status == XF_SUCCESS) outputs.insert(outputs.end(), outargs, outargs + n_out);
+        else ok = false;
+    }
+    Bridge(XF_CLEANUP, &status, inargs, outargs);
+    return ok;
+}
+
+// Loads a fresh copy of the DLL, writes config first, and runs one realization
+static bool RunFresh(const std::string& config, const std::vector<double>& rain,
+                     double step_seconds, int n_out, std::vector<double>& outputs)
+{
+    WriteFileText(CONFIG_FILE, config);
+    HMODULE hCase;
+    BridgeFunctionType Bridge = LoadBridge(&hCase);
+    if (!Bridge) return false;
+    bool ok = RunRealization(Bridge, rain, step_seconds, n_out, outputs);
+    FreeLibrary(hCase);
+    return ok;
+}
+
+// Deletes the files in dir and then dir itself
+static void RemoveTestDir(const char* dir)
+{
+    WIN32_FIND_DATAA fd;
+    std::string pattern = std::string(dir) + "\\*";
+    HANDLE h = FindFirstFileA(pattern.c_str(), &fd);
+    if (h != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            std::string path = std::string(dir) + "\\" + fd.cFileName;
+            DeleteFileA(path.c_str());
+        } while (FindNextFileA(h, &fd));
+        FindClose(h);
+    }
+    RemoveDirectoryA(dir);
+}
+
 int main()
 {
     std::cout << "=== GoldSim-SWMM Bridge XF_CALCULATE Test ===" << std::endl;
@@ -304,6 +412,194 @@ int main()
     // Clean up
     FreeLibrary(hDll);
 
+    const std::string saved_config = ReadFileText(CONFIG_FILE);
+
+    // Test 10: GOLDSIM_TIME run until END_DATE (model.inp runs 12 hours)
+    std::cout << "Test 10: GOLDSIM_TIME stepping until END_DATE" << std::endl;
+    test_count++;
+    WriteFileText(CONFIG_FILE, BridgeConfig(
+        "  \"stepping\": {\"mode\": \"GOLDSIM_TIME\", \"timestep_seconds\": 3600},\n"));
+    {
+        HMODULE hCase;
+        BridgeFunctionType Bridge = LoadBridge(&hCase);
+        int calls = 0;
+        int last_status = XF_SUCCESS;
+        if (Bridge)
+        {
+            Bridge(XF_INITIALIZE, &status, inargs, outargs);
+            if (status == XF_SUCCESS)
+            {
+                // One call at time 0, one per hour, then the end of the run;
+                // the call after that finds the simulation closed
+                inargs[1] = 0.5;
+                while (calls < 20 && last_status == XF_SUCCESS)
+                {
+                    inargs[0] = calls * 3600.0;
+                    Bridge(XF_CALCULATE, &last_status, inargs, outargs);
+                    calls++;
+                }
+            }
+            Bridge(XF_CLEANUP, &status, inargs, outargs);
+            FreeLibrary(hCase);
+        }
+        std::cout << "  [INFO] " << calls << " calls, last status = " << last_status << std::endl;
+        if (last_status == XF_FAILURE && calls == 14)
+        {
+            std::cout << "  [PASS] Run ended at END_DATE and closed SWMM" << std::endl;
+            pass_count++;
+        }
+        else
+        {
+            std::cout << "  [FAIL] Expected 13 calls to reach END_DATE and the 14th to find SWMM closed" << std::endl;
+        }
+    }
+    std::cout << std::endl;
+
+    // Test 11: Fast-forward strides until END_DATE (no rain, so every interval is quiet)
+    std::cout << "Test 11: Fast-forward until END_DATE" << std::endl;
+    test_count++;
+    WriteFileText(CONFIG_FILE, BridgeConfig(
+        "  \"stepping\": {\"mode\": \"GOLDSIM_TIME\", \"timestep_seconds\": 3600},\n"
+        "  \"fast_forward\": {\"enabled\": true},\n"));
+    {
+        HMODULE hCase;
+        BridgeFunctionType Bridge = LoadBridge(&hCase);
+        int calls = 0;
+        int last_status = XF_SUCCESS;
+        bool finite = true;
+        if (Bridge)
+        {
+            Bridge(XF_INITIALIZE, &status, inargs, outargs);
+            if (status == XF_SUCCESS)
+            {
+                inargs[1] = 0.0;
+                while (calls < 20 && last_status == XF_SUCCESS)
+                {
+                    inargs[0] = calls * 3600.0;
+                    Bridge(XF_CALCULATE, &last_status, inargs, outargs);
+                    if (last_status == XF_SUCCESS && !(std::isfinite(outargs[0]) && std::isfinite(outargs[1]))) finite = false;
+                    calls++;
+                }
+            }
+            Bridge(XF_CLEANUP, &status, inargs, outargs);
+            FreeLibrary(hCase);
+        }
+        std::cout << "  [INFO] " << calls << " calls, last status = " << last_status << std::endl;
+        if (last_status == XF_FAILURE && calls == 14 && finite)
+        {
+            std::cout << "  [PASS] Strided run ended at END_DATE and closed SWMM" << std::endl;
+            pass_count++;
+        }
+        else
+        {
+            std::cout << "  [FAIL] Expected 13 finite calls to reach END_DATE and the 14th to find SWMM closed" << std::endl;
+        }
+    }
+    std::cout << std::endl;
+
+    // Test 12: Look-ahead stepping returns the same outputs as synchronous stepping
+    std::cout << "Test 12: Async look-ahead stepping matches sync" << std::endl;
+    test_count++;
+    {
+        std::vector<double> rain;
+        for (int k = 0; k < 60; k++) rain.push_back((k / 10) % 2 ? 2.0 : 0.25);
+        std::vector<double> sync_out, async_out;
+        bool ok = RunFresh(BridgeConfig(""), rain, 60.0, 2, sync_out) &&
+                  RunFresh(BridgeConfig("  \"stepping\": {\"async\": true},\n"), rain, 60.0, 2, async_out);
+        if (ok && !sync_out.empty() && async_out == sync_out)
+        {
+            std::cout << "  [PASS] " << rain.size() << " async calls returned the sync outputs" << std::endl;
+            pass_count++;
+        }
+        else
+        {
+            std::cout << "  [FAIL] Async outputs differ from sync (or a run failed)" << std::endl;
+        }
+    }
+    std::cout << std::endl;
+
+    // Test 13: GOLDSIM_TIME aggregation of one output over each hour
+    std::cout << "Test 13: GOLDSIM_TIME output aggregation" << std::endl;
+    test_count++;
+    {
+        const char* outputs =
+            "    {\"index\": 0, \"name\": \"S1\", \"object_type\": \"SUBCATCH\", \"property\": \"RUNOFF\"},\n"
+            "    {\"index\": 1, \"name\": \"S1\", \"object_type\": \"SUBCATCH\", \"property\": \"RUNOFF\", \"aggregate\": \"MAX\"},\n"
+            "    {\"index\": 2, \"name\": \"S1\", \"object_type\": \"SUBCATCH\", \"property\": \"RUNOFF\", \"aggregate\": \"MIN\"},\n"
+            "    {\"index\": 3, \"name\": \"S1\", \"object_type\": \"SUBCATCH\", \"property\": \"RUNOFF\", \"aggregate\": \"MEAN\"},\n"
+            "    {\"index\": 4, \"name\": \"S1\", \"object_type\": \"SUBCATCH\", \"property\": \"RUNOFF\", \"aggregate\": \"INTEGRAL\"}\n";
+        // Rain for two hours, then dry hours in which runoff recedes
+        double storm[] = {1.0, 1.0, 0.0, 0.0, 0.0, 0.0};
+        std::vector<double> rain(storm, storm + 6);
+        std::vector<double> out;
+        bool ok = RunFresh(BridgeConfig("  \"stepping\": {\"mode\": \"GOLDSIM_TIME\", \"timestep_seconds\": 3600},\n", outputs),
+                           rain, 3600.0, 5, out) && out.size() == 30;
+        bool consistent = ok;
+        bool receded = false;
+        // Call 0 only reads the initial state; every later call covers one hour
+        for (size_t k = 1; ok && k < rain.size(); k++)
+        {
+            double instant = out[k * 5], mx = out[k * 5 + 1], mn = out[k * 5 + 2];
+            double mean = out[k * 5 + 3], integral = out[k * 5 + 4];
+            std::cout << "    Hour " << k << ": instant = " << instant << ", max = " << mx << ", min = " << mn
+                      << ", mean = " << mean << ", integral = " << integral << std::endl;
+            if (!(mn <= mean && mean <= mx && mn <= instant && instant <= mx)) consistent = false;
+            if (std::fabs(integral - mean * 3600.0) > 1e-6 * std::max(1.0, std::fabs(integral))) consistent = false;
+            if (mx > instant) receded = true;
+        }
+        if (consistent && receded)
+        {
+            std::cout << "  [PASS] MIN <= MEAN, INSTANT <= MAX, INTEGRAL = MEAN x 3600 s, and MAX kept a receded peak" << std::endl;
+            pass_count++;
+        }
+        else
+        {
+            std::cout << "  [FAIL] Aggregated outputs are inconsistent (or the run failed)" << std::endl;
+        }
+    }
+    std::cout << std::endl;
+
+    // Test 14: Memo serves a repeated stream, then replays it when the stream diverges
+    std::cout << "Test 14: Memo replay after divergence" << std::endl;
+    test_count++;
+    {
+        const char* memo_dir = "test_memo";
+        RemoveTestDir(memo_dir);
+        std::vector<double> first(40, 1.0);
+        std::vector<double> second(first);
+        for (size_t k = 20; k < second.size(); k++) second[k] = 3.0;
+
+        // Realization 1 records the stream; realization 2 starts with the same
+        // inputs, is served from the store, and diverges at call 20
+        std::vector<double> recorded, diverged, reference;
+        WriteFileText(CONFIG_FILE, BridgeConfig(
+            "  \"memo\": {\"enabled\": true, \"dir\": \"test_memo\"},\n"));
+        HMODULE hCase;
+        BridgeFunctionType Bridge = LoadBridge(&hCase);
+        bool ok = Bridge != NULL;
+        if (ok)
+        {
+            ok = RunRealization(Bridge, first, 60.0, 2, recorded) &&
+                 RunRealization(Bridge, second, 60.0, 2, diverged);
+            FreeLibrary(hCase);
+        }
+        ok = ok && RunFresh(BridgeConfig(""), second, 60.0, 2, reference);
+        if (ok && diverged == reference && recorded != reference &&
+            std::equal(recorded.begin(), recorded.begin() + 40, diverged.begin()))
+        {
+            std::cout << "  [PASS] Diverged realization matches a run without memo" << std::endl;
+            pass_count++;
+        }
+        else
+        {
+            std::cout << "  [FAIL] Replayed realization differs from a run without memo (or a run failed)" << std::endl;
+        }
+        RemoveTestDir(memo_dir);
+    }
+    std::cout << std::endl;
+
+    WriteFileText(CONFIG_FILE, saved_config);
+
     // Print summary
     std::cout << "=== Test Summary ===" << std::endl;
     std::cout << "Tests run: " << test_count << std::endl;
@@ -0,0 +1,169 @@
+//-----------------------------------------------------------------------------
+//   test_checkpoint.cpp
+//
+//   Unit tests for the checkpoint store (CheckpointStore) used by the
+//   checkpoint section of SwmmGoldSimBridge.json
+//   Tests: commit and lookup, pruning, fallback past a damaged checkpoint,
+//   and discarding a finished run
+//-----------------------------------------------------------------------------
+
+#include "../include/Platform.h"
+#include "gtest_minimal.h"
+#include "../include/Checkpoint.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+static const unsigned long long kHash = 0x00c0ffee12345678ULL;
+
+static bool Exists(const std::string& path) {
+    std::ifstream f(path.c_str());
+    return f.is_open();
+}
+
+// Stand-in for swmm_saveHotstart: write the hotstart where the store expects it
+static void WriteHotstart(const CheckpointStore& store, double elapsed_sec) {
+    std::ofstream f(store.HotstartTempPath(elapsed_sec).c_str(), std::ios::binary);
+    f << "hotstart " << elapsed_sec;
+}
+
+static void CommitAt(CheckpointStore& store, double elapsed_sec, long interval) {
+    WriteHotstart(store, elapsed_sec);
+    CheckpointState state;
+    state.model_hash = kHash;
+    state.start_days = 39082.0;
+    state.elapsed_sec = elapsed_sec;
+    state.interval_count = interval;
+    state.route_steps = interval * 4;
+    state.first_calculate = 0;
+    state.realization = 1;
+    state.pending_inputs.push_back(interval * 0.5);
+    state.pending_inputs.push_back(-1.0);
+    state.runtime.assign(3, 0.25);
+    state.runtime.push_back((double)interval);
+    store.Commit(state);
+}
+
+static void DiscardAll() {
+    std::string error;
+    CheckpointStore store;
+    if (store.Open("", kHash, 1, error)) store.Discard();
+    store.Close();
+}
+
+TEST(CheckpointStore, CommitsAndFindsLatest) {
+    DiscardAll();
+    std::string error;
+    {
+        CheckpointStore store;
+        ASSERT_TRUE(store.Open("", kHash, 3, error));
+        CheckpointState none;
+        std::string hsf;
+        EXPECT_FALSE(store.FindLatest(none, hsf, error));
+        CommitAt(store, 3600.0, 1);
+        CommitAt(store, 7200.0, 2);
+        store.Flush();
+        EXPECT_EQ(store.GetCommittedCount(), 2);
+        EXPECT_TRUE(store.Close());
+    }
+
+    CheckpointStore store;
+    ASSERT_TRUE(store.Open("", kHash, 3, error));
+    CheckpointState state;
+    std::string hsf;
+    ASSERT_TRUE(store.FindLatest(state, hsf, error));
+    EXPECT_DOUBLE_EQ(state.elapsed_sec, 7200.0);
+    EXPECT_DOUBLE_EQ(state.start_days, 39082.0);
+    EXPECT_EQ(state.interval_count, 2);
+    EXPECT_EQ(state.route_steps, 8);
+    EXPECT_EQ(state.first_calculate, 0);
+    EXPECT_EQ(state.realization, 1);
+    ASSERT_EQ(state.pending_inputs.size(), (size_t)2);
+    EXPECT_DOUBLE_EQ(state.pending_inputs[0], 1.0);
+    EXPECT_DOUBLE_EQ(state.pending_inputs[1], -1.0);
+    ASSERT_EQ(state.runtime.size(), (size_t)4);
+    EXPECT_DOUBLE_EQ(state.runtime[0], 0.25);
+    EXPECT_DOUBLE_EQ(state.runtime[3], 2.0);
+    EXPECT_TRUE(Exists(hsf));
+    EXPECT_FALSE(Exists(store.HotstartTempPath(7200.0)));
+    store.Discard();
+    store.Close();
+}
+
+TEST(CheckpointStore, PrunesBeyondKeep) {
+    DiscardAll();
+    std::string error;
+    CheckpointStore store;
+    ASSERT_TRUE(store.Open("", kHash, 2, error));
+    CommitAt(store, 100.0, 1);
+    CommitAt(store, 200.0, 2);
+    CommitAt(store, 300.0, 3);
+    store.Flush();
+    EXPECT_EQ(store.GetCommittedCount(), 2);
+
+    std::string oldest = store.HotstartTempPath(100.0);
+    oldest.erase(oldest.size() - 4);                 // Committed name drops ".tmp"
+    EXPECT_FALSE(Exists(oldest));
+    std::string newest = store.HotstartTempPath(300.0);
+    newest.erase(newest.size() - 4);
+    EXPECT_TRUE(Exists(newest));
+    store.Discard();
+    store.Close();
+}
+
+TEST(CheckpointStore, SkipsDamagedCheckpoint) {
+    DiscardAll();
+    std::string error;
+    CheckpointStore store;
+    ASSERT_TRUE(store.Open("", kHash, 2, error));
+    CommitAt(store, 100.0, 1);
+    CommitAt(store, 200.0, 2);
+    store.Flush();
+
+    // Truncate the newest state file as a crash mid-write would
+    std::string state_path = store.HotstartTempPath(200.0);
+    state_path.replace(state_path.size() - 8, 8, ".state");
+    {
+        std::ofstream f(state_path.c_str(), std::ios::binary | std::ios::trunc);
+        f << "GSCKPT02";
+    }
+
+    CheckpointState state;
+    std::string hsf;
+    ASSERT_TRUE(store.FindLatest(state, hsf, error));
+    EXPECT_DOUBLE_EQ(state.elapsed_sec, 100.0);
+    EXPECT_EQ(state.interval_count, 1);
+
+    // A checkpoint of another model is never picked up
+    CheckpointStore other;
+    ASSERT_TRUE(other.Open("", kHash + 1, 2, error));
+    EXPECT_FALSE(other.FindLatest(state, hsf, error));
+    other.Close();
+    store.Discard();
+    store.Close();
+}
+
+TEST(CheckpointStore, DiscardRemovesEverything) {
+    DiscardAll();
+    std::string error;
+    CheckpointStore store;
+    ASSERT_TRUE(store.Open("", kHash, 2, error));
+    CommitAt(store, 100.0, 1);
+    store.Flush();
+    std::string hsf = store.HotstartTempPath(100.0);
+    hsf.erase(hsf.size() - 4);
+    EXPECT_TRUE(Exists(hsf));
+
+    store.Discard();
+    EXPECT_EQ(store.GetCommittedCount(), 0);
+    EXPECT_FALSE(Exists(hsf));
+    CheckpointState state;
+    std::string path;
+    EXPECT_FALSE(store.FindLatest(state, path, error));
+    EXPECT_TRUE(store.Close());
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
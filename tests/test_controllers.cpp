@@ -0,0 +1,196 @@
+//-----------------------------------------------------------------------------
+//   test_controllers.cpp
+//
+//   Unit tests for the native controllers (ControllerBank)
+//   swmm_getValue returns a settable sensor value and swmm_setValue records
+//   the settings written, so each controller can be driven step by step.
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/Controllers.h"
+#include "../include/swmm5.h"
+#include <vector>
+
+static double g_sensor = 0.0;
+static std::vector<double> g_written;
+
+extern "C" {
+double DLLEXPORT swmm_getValue(int property, int index) { (void)property; (void)index; return g_sensor; }
+void DLLEXPORT swmm_setValue(int property, int index, double value) {
+    (void)property; (void)index;
+    g_written.push_back(value);
+}
+}
+
+// Evaluate once at time t with the given sensor value; returns the setting
+// written, or -1 if the setting did not change
+static double Step(ControllerBank& bank, double t, double sensor) {
+    g_sensor = sensor;
+    g_written.clear();
+    bank.Update(t);
+    return g_written.empty() ? -1.0 : g_written.back();
+}
+
+TEST(Controllers, DeadbandHysteresis) {
+    ControllerBank bank;
+    ControllerBank::Definition d;
+    d.type = ControllerBank::DEADBAND;
+    d.on_level = 4.0;
+    d.off_level = 1.0;
+    bank.Add(d);
+
+    EXPECT_DOUBLE_EQ(Step(bank, 0, 2.0), 0.0);      // Starts off, first setting written
+    EXPECT_DOUBLE_EQ(Step(bank, 30, 4.0), 1.0);     // Reaches on_level
+    EXPECT_DOUBLE_EQ(Step(bank, 60, 2.0), -1.0);    // Inside the band: stays on, nothing written
+    EXPECT_DOUBLE_EQ(Step(bank, 90, 1.0), 0.0);     // Reaches off_level
+    EXPECT_DOUBLE_EQ(Step(bank, 120, 3.9), -1.0);
+}
+
+TEST(Controllers, DeadbandFillAndSetParam) {
+    ControllerBank bank;
+    ControllerBank::Definition d;
+    d.type = ControllerBank::DEADBAND;
+    d.on_level = 1.0;        // Below off_level: switch on when the sensor falls
+    d.off_level = 3.0;
+    int slot = bank.Add(d);
+
+    EXPECT_DOUBLE_EQ(Step(bank, 0, 0.5), 1.0);
+    EXPECT_DOUBLE_EQ(Step(bank, 30, 3.0), 0.0);
+    bank.SetParam(slot, ControllerBank::ON_LEVEL, 2.5);
+    EXPECT_DOUBLE_EQ(Step(bank, 60, 2.4), 1.0);
+
+    bank.Reset();            // Back to the configured levels
+    EXPECT_DOUBLE_EQ(Step(bank, 0, 2.4), 0.0);
+}
+
+TEST(Controllers, PidProportionalIntegralAndLimits) {
+    ControllerBank bank;
+    ControllerBank::Definition d;
+    d.type = ControllerBank::PID;
+    d.setpoint = 2.0;
+    d.kp = 0.5;
+    d.ki = 0.01;
+    d.min_setting = 0.0;
+    d.max_setting = 1.0;
+    bank.Add(d);
+
+    EXPECT_DOUBLE_EQ(Step(bank, 0, 2.5), 0.25);                 // dt = 0: proportional only
+    EXPECT_DOUBLE_EQ(Step(bank, 10, 2.5), 0.25 + 0.01 * 5.0);   // Integral of 0.5 over 10 s
+    EXPECT_DOUBLE_EQ(Step(bank, 20, 10.0), 1.0);                // Clamped at max_setting
+    EXPECT_DOUBLE_EQ(Step(bank, 30, 0.0), 0.0);                 // Clamped at min_setting
+}
+
+TEST(Controllers, PidDoesNotWindUpWhileSaturated) {
+    ControllerBank bank;
+    ControllerBank::Definition d;
+    d.type = ControllerBank::PID;
+    d.setpoint = 0.0;
+    d.kp = 1.0;
+    d.ki = 1.0;
+    bank.Add(d);
+
+    Step(bank, 0, 5.0);
+    for (int i = 1; i <= 100; i++) Step(bank, i * 60.0, 5.0);  // Saturated at 1.0 for 100 steps
+    // Without anti-windup the integral would hold the output at 1.0 here
+    EXPECT_DOUBLE_EQ(Step(bank, 6001, -0.5), 0.0);
+}
+
+TEST(Controllers, TableLinearAndStep) {
+    ControllerBank bank;
+    ControllerBank::Definition d;
+    d.type = ControllerBank::TABLE;
+    d.table_x = { 0.0, 2.0, 4.0 };
+    d.table_y = { 0.0, 0.5, 1.0 };
+    int linear = bank.Add(d);
+    EXPECT_EQ(linear, 0);
+    EXPECT_DOUBLE_EQ(Step(bank, 0, 1.0), 0.25);
+    EXPECT_DOUBLE_EQ(Step(bank, 30, 5.0), 1.0);
+    EXPECT_DOUBLE_EQ(Step(bank, 60, -1.0), 0.0);
+
+    ControllerBank stepped;
+    d.table_step = true;
+    stepped.Add(d);
+    EXPECT_DOUBLE_EQ(Step(stepped, 0, 1.9), 0.0);
+    EXPECT_DOUBLE_EQ(Step(stepped, 30, 2.0), 0.5);
+    EXPECT_DOUBLE_EQ(Step(stepped, 60, 3.5), -1.0);
+}
+
+TEST(Controllers, DisabledControllerLeavesActuator) {
+    ControllerBank bank;
+    ControllerBank::Definition d;
+    d.type = ControllerBank::TABLE;
+    d.table_x = { 0.0, 1.0 };
+    d.table_y = { 0.0, 1.0 };
+    int slot = bank.Add(d);
+    EXPECT_DOUBLE_EQ(Step(bank, 0, 0.5), 0.5);
+    bank.SetParam(slot, ControllerBank::ENABLED, 0.0);
+    EXPECT_DOUBLE_EQ(Step(bank, 30, 0.9), -1.0);
+}
+
+TEST(Controllers, RestoredStateContinuesPidAndDeadband) {
+    ControllerBank::Definition pid;
+    pid.type = ControllerBank::PID;
+    pid.setpoint = 2.0;
+    pid.kp = 0.1;
+    pid.ki = 0.001;
+    pid.kd = 5.0;
+    ControllerBank::Definition band;
+    band.type = ControllerBank::DEADBAND;
+    band.on_level = 4.0;
+    band.off_level = 1.0;
+
+    ControllerBank whole, resumed;
+    whole.Add(pid);
+    whole.Add(band);
+    resumed.Add(pid);
+    resumed.Add(band);
+
+    Step(whole, 0, 3.0);
+    Step(whole, 60, 4.5);               // Deadband switches on
+    whole.SetParam(0, ControllerBank::SETPOINT, 2.5);
+    std::vector<double> saved;
+    whole.SaveState(saved);
+    size_t pos = 0;
+    ASSERT_TRUE(resumed.RestoreState(saved, pos));
+    EXPECT_EQ(pos, saved.size());
+
+    // Same integral, derivative and deadband state: same settings from here.
+    // The first update writes every setting again, the deadband still on.
+    for (int i = 2; i <= 6; i++) {
+        g_sensor = 4.5 - 0.6 * i;       // Falls to off_level at i = 6
+        g_written.clear();
+        whole.Update(i * 60.0);
+        std::vector<double> expected = g_written;
+        g_written.clear();
+        resumed.Update(i * 60.0);
+        if (i == 2) {
+            ASSERT_EQ(g_written.size(), (size_t)2);
+            EXPECT_DOUBLE_EQ(g_written[0], expected[0]);
+            EXPECT_DOUBLE_EQ(g_written[1], 1.0);
+        } else {
+            ASSERT_EQ(g_written.size(), expected.size());
+            for (size_t k = 0; k < expected.size(); k++) EXPECT_DOUBLE_EQ(g_written[k], expected[k]);
+        }
+    }
+    EXPECT_DOUBLE_EQ(g_written.back(), 0.0);
+
+    ControllerBank other;
+    other.Add(pid);
+    pos = 0;
+    EXPECT_FALSE(other.RestoreState(saved, pos));
+    EXPECT_EQ(pos, (size_t)0);
+}
+
+TEST(Controllers, NamesMapToTypesAndParams) {
+    EXPECT_EQ(ControllerTypeFromName("PID"), (int)ControllerBank::PID);
+    EXPECT_EQ(ControllerTypeFromName("RULE"), -1);
+    EXPECT_EQ(ControllerParamFromName(ControllerBank::PID, "SETPOINT"), (int)ControllerBank::SETPOINT);
+    EXPECT_EQ(ControllerParamFromName(ControllerBank::DEADBAND, "SETPOINT"), -1);
+    EXPECT_EQ(ControllerParamFromName(ControllerBank::DEADBAND, "OFF_LEVEL"), (int)ControllerBank::OFF_LEVEL);
+    EXPECT_EQ(ControllerParamFromName(ControllerBank::TABLE, "ENABLED"), (int)ControllerBank::ENABLED);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
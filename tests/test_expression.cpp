@@ -0,0 +1,108 @@
+//-----------------------------------------------------------------------------
+//   test_expression.cpp
+//
+//   Unit tests for expression outputs (ExpressionProgram)
+//   Programs are evaluated on supplied reference values, so no SWMM fakes
+//   are needed.
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/Expression.h"
+#include <cmath>
+#include <string>
+
+static double Eval(const std::string& text, const double* refs = nullptr) {
+    ExpressionProgram prog;
+    std::string error;
+    if (!prog.Compile(text, error)) return -999.0;
+    return prog.Evaluate(refs);
+}
+
+TEST(Expression, PrecedenceAndAssociativity) {
+    EXPECT_DOUBLE_EQ(Eval("1 + 2 * 3"), 7.0);
+    EXPECT_DOUBLE_EQ(Eval("(1 + 2) * 3"), 9.0);
+    EXPECT_DOUBLE_EQ(Eval("10 - 4 - 3"), 3.0);
+    EXPECT_DOUBLE_EQ(Eval("2 ^ 3 ^ 2"), 512.0);     // Right-associative
+    EXPECT_DOUBLE_EQ(Eval("-2 ^ 2"), -4.0);         // Unary minus binds looser than ^
+    EXPECT_DOUBLE_EQ(Eval("1.5e2 / 3"), 50.0);
+}
+
+TEST(Expression, Functions) {
+    EXPECT_DOUBLE_EQ(Eval("min(3, 1, 2)"), 1.0);
+    EXPECT_DOUBLE_EQ(Eval("max(3, 7, 2)"), 7.0);
+    EXPECT_DOUBLE_EQ(Eval("abs(-4) + sqrt(9)"), 7.0);
+}
+
+TEST(Expression, ReferencesShareSlots) {
+    ExpressionProgram prog;
+    std::string error;
+    ASSERT_TRUE(prog.Compile("ST1.VOLUME + ST2.volume - ST1.VOLUME * 0.5", error));
+    ASSERT_EQ(prog.GetReferenceCount(), 2);
+    EXPECT_EQ(prog.GetReference(0).name, "ST1");
+    EXPECT_EQ(prog.GetReference(1).property, "VOLUME");
+    EXPECT_EQ(prog.GetReference(0).object_type, "");
+
+    double refs[2] = { 10.0, 4.0 };
+    EXPECT_DOUBLE_EQ(prog.Evaluate(refs), 10.0 + 4.0 - 5.0);
+}
+
+TEST(Expression, TypedAndQuotedReferences) {
+    ExpressionProgram prog;
+    std::string error;
+    ASSERT_TRUE(prog.Compile("link:'C 1'.FLOW / 2 + 12.DEPTH", error));
+    ASSERT_EQ(prog.GetReferenceCount(), 2);
+    EXPECT_EQ(prog.GetReference(0).object_type, "LINK");
+    EXPECT_EQ(prog.GetReference(0).name, "C 1");
+    EXPECT_EQ(prog.GetReference(1).name, "12");
+
+    double refs[2] = { 3.0, 0.5 };
+    EXPECT_DOUBLE_EQ(prog.Evaluate(refs), 2.0);
+}
+
+TEST(Expression, FoldsConstants) {
+    ExpressionProgram prog;
+    std::string error;
+    ASSERT_TRUE(prog.Compile("N1.DEPTH * (60 * 60 * 24) + -(2 ^ 2)", error));
+    // REF, CONST, MUL, CONST, ADD
+    EXPECT_EQ(prog.GetInstructionCount(), 5);
+    double refs[1] = { 0.5 };
+    EXPECT_DOUBLE_EQ(prog.Evaluate(refs), 43200.0 - 4.0);
+}
+
+TEST(Expression, DivisionByZeroIsIeee) {
+    double refs[1] = { 0.0 };
+    ExpressionProgram prog;
+    std::string error;
+    ASSERT_TRUE(prog.Compile("1 / N1.DEPTH", error));
+    EXPECT_TRUE(std::isinf(prog.Evaluate(refs)));
+}
+
+TEST(Expression, SyntaxErrorsReportPosition) {
+    ExpressionProgram prog;
+    std::string error;
+    EXPECT_FALSE(prog.Compile("ST1.VOLUME +", error));
+    EXPECT_NE(error.find("end of expression"), std::string::npos);
+    EXPECT_FALSE(prog.Compile("ST1 + 2", error));
+    EXPECT_NE(error.find(".PROPERTY"), std::string::npos);
+    EXPECT_FALSE(prog.Compile("median(A.FLOW)", error));
+    EXPECT_NE(error.find("unknown function"), std::string::npos);
+    EXPECT_FALSE(prog.Compile("(1 + 2", error));
+    EXPECT_FALSE(prog.Compile("1 2", error));
+    EXPECT_NE(error.find("position 3"), std::string::npos);
+}
+
+TEST(Expression, RejectsDeepNesting) {
+    std::string text;
+    for (int i = 0; i < ExpressionProgram::MAX_STACK + 1; i++) text += "A.FLOW + (";
+    text += "A.FLOW";
+    for (int i = 0; i < ExpressionProgram::MAX_STACK + 1; i++) text += ")";
+    ExpressionProgram prog;
+    std::string error;
+    EXPECT_FALSE(prog.Compile(text, error));
+    EXPECT_NE(error.find("nested too deeply"), std::string::npos);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,79 @@
+//-----------------------------------------------------------------------------
+//   test_flight_recorder.cpp
+//
+//   Unit tests for the in-memory ring of recent steps (FlightRecorder)
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/FlightRecorder.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+static const char* kTestFile = "test_flight_recorder.csv";
+
+static std::vector<std::string> ReadLines(const char* path) {
+    std::vector<std::string> lines;
+    std::ifstream f(path);
+    std::string line;
+    while (std::getline(f, line)) lines.push_back(line);
+    return lines;
+}
+
+static void Configure(FlightRecorder& flight, int steps) {
+    std::vector<std::string> in(1, "R1");
+    std::vector<std::string> out;
+    out.push_back("POND");
+    out.push_back("OUT1");
+    flight.Configure(steps, in, out);
+}
+
+TEST(FlightRecorder, KeepsLastStepsOldestFirst) {
+    FlightRecorder flight;
+    EXPECT_FALSE(flight.IsConfigured());
+    Configure(flight, 3);
+    EXPECT_TRUE(flight.IsConfigured());
+
+    for (int k = 1; k <= 5; k++) {
+        double in[1] = { (double)k };
+        double out[2] = { 10.0 * k, 0.5 };
+        flight.Record(k, k / 1440.0, 0, in, out);
+    }
+    EXPECT_EQ(flight.GetCount(), 3);
+
+    ASSERT_TRUE(flight.Dump(kTestFile, "test reason"));
+    std::vector<std::string> lines = ReadLines(kTestFile);
+    std::remove(kTestFile);
+    ASSERT_EQ(lines.size(), (size_t)5);
+    EXPECT_EQ(lines[0], std::string("# test reason"));
+    EXPECT_EQ(lines[1], std::string("step,elapsed_days,return_code,in:R1,out:POND,out:OUT1"));
+    EXPECT_EQ(lines[2].substr(0, 2), std::string("3,"));
+    EXPECT_EQ(lines[4].substr(0, 2), std::string("5,"));
+    EXPECT_TRUE(lines[4].find(",5,50,0.5") != std::string::npos);
+}
+
+TEST(FlightRecorder, MissingValuesAreBlank) {
+    FlightRecorder flight;
+    Configure(flight, 4);
+    double out[2] = { 1.0, 2.0 };
+    flight.Record(0, 0.0, 0, NULL, out);
+    double in[1] = { 7.0 };
+    flight.Record(1, 0.01, -317, in, NULL);
+
+    ASSERT_TRUE(flight.Dump(kTestFile, "swmm_step failed"));
+    std::vector<std::string> lines = ReadLines(kTestFile);
+    std::remove(kTestFile);
+    ASSERT_EQ(lines.size(), (size_t)4);
+    EXPECT_EQ(lines[2], std::string("0,0,0,,1,2"));
+    EXPECT_EQ(lines[3], std::string("1,0.01,-317,7,,"));
+
+    flight.Clear();
+    EXPECT_EQ(flight.GetCount(), 0);
+    EXPECT_TRUE(flight.IsConfigured());
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
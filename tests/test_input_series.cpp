@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------------
+//   test_input_series.cpp
+//
+//   Unit tests for preloaded input time series (InputSeries) used by the
+//   timeseries_inputs section of SwmmGoldSimBridge.json
+//   Tests: CSV parsing, HOLD/LINEAR lookups through the cursor, window
+//   peaks, the memory-mapped binary format and malformed files
+//-----------------------------------------------------------------------------
+
+#include "../include/Platform.h"
+#include "gtest_minimal.h"
+#include "../include/InputSeries.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+static const char* kCsvFile = "test_series.csv";
+static const char* kBinFile = "test_series.gts";
+
+static void WriteText(const char* path, const char* text) {
+    std::ofstream f(path, std::ios::binary);
+    f << text;
+}
+
+static void WriteBinary(const char* path, unsigned int columns, const double* rows, unsigned long long count,
+                        unsigned long long declared_rows) {
+    InputSeries::FileHeader h;
+    memcpy(h.magic, "GSTSER01", 8);
+    h.columns = columns;
+    h.reserved = 0;
+    h.rows = declared_rows;
+    h.data_offset = sizeof(h);
+    std::ofstream f(path, std::ios::binary);
+    f.write((const char*)&h, sizeof(h));
+    f.write((const char*)rows, (std::streamsize)(count * (1 + columns) * sizeof(double)));
+}
+
+TEST(InputSeries, ParsesCsvWithHeaderAndComments) {
+    WriteText(kCsvFile,
+        "hours,rain,flow\r\n"
+        "; design storm\r\n"
+        "0, 0.0, 5\r\n"
+        "\r\n"
+        "0.5;2.0;6\r\n"
+        "1.0\t4.0\t7\r\n"
+        "# tail\r\n"
+        "2.0 0.0 8\r\n");
+    std::string error;
+    InputSeries s;
+    ASSERT_TRUE(s.Load(kCsvFile, 1, 3600.0, InputSeries::HOLD, error));
+    EXPECT_FALSE(s.IsMapped());
+    EXPECT_EQ(s.GetRowCount(), (size_t)4);
+    EXPECT_DOUBLE_EQ(s.GetStartSeconds(), 0.0);
+    EXPECT_DOUBLE_EQ(s.GetEndSeconds(), 7200.0);
+    EXPECT_DOUBLE_EQ(s.ValueAt(1800.0), 2.0);
+
+    InputSeries flow;
+    ASSERT_TRUE(flow.Load(kCsvFile, 2, 3600.0, InputSeries::HOLD, error));
+    EXPECT_DOUBLE_EQ(flow.ValueAt(3600.0), 7.0);
+    std::remove(kCsvFile);
+}
+
+TEST(InputSeries, HoldAndLinearLookups) {
+    WriteText(kCsvFile, "10,1\n20,3\n40,-5\n");
+    std::string error;
+    InputSeries hold, linear;
+    ASSERT_TRUE(hold.Load(kCsvFile, 1, 1.0, InputSeries::HOLD, error));
+    ASSERT_TRUE(linear.Load(kCsvFile, 1, 1.0, InputSeries::LINEAR, error));
+
+    // Before the first row and after the last the end values hold
+    EXPECT_DOUBLE_EQ(hold.ValueAt(0.0), 1.0);
+    EXPECT_DOUBLE_EQ(linear.ValueAt(0.0), 1.0);
+    EXPECT_DOUBLE_EQ(hold.ValueAt(15.0), 1.0);
+    EXPECT_DOUBLE_EQ(linear.ValueAt(15.0), 2.0);
+    EXPECT_DOUBLE_EQ(hold.ValueAt(20.0), 3.0);
+    EXPECT_DOUBLE_EQ(linear.ValueAt(30.0), -1.0);
+    EXPECT_DOUBLE_EQ(hold.ValueAt(100.0), -5.0);
+    EXPECT_DOUBLE_EQ(linear.ValueAt(100.0), -5.0);
+
+    // Stepping back in time re-seeks
+    EXPECT_DOUBLE_EQ(hold.ValueAt(12.0), 1.0);
+    EXPECT_DOUBLE_EQ(linear.ValueAt(25.0), 1.0);
+    hold.Seek(35.0);
+    EXPECT_DOUBLE_EQ(hold.ValueAt(35.0), 3.0);
+    std::remove(kCsvFile);
+}
+
+TEST(InputSeries, PeakOverWindow) {
+    WriteText(kCsvFile, "0,0\n60,0\n120,4\n180,-6\n240,0\n");
+    std::string error;
+    InputSeries hold, linear;
+    ASSERT_TRUE(hold.Load(kCsvFile, 1, 1.0, InputSeries::HOLD, error));
+    ASSERT_TRUE(linear.Load(kCsvFile, 1, 1.0, InputSeries::LINEAR, error));
+    EXPECT_DOUBLE_EQ(hold.PeakAbs(0.0, 120.0), 0.0);
+    EXPECT_DOUBLE_EQ(linear.PeakAbs(0.0, 120.0), 4.0);       // Ramps towards the 120 s row
+    EXPECT_DOUBLE_EQ(hold.PeakAbs(100.0, 200.0), 6.0);
+    EXPECT_DOUBLE_EQ(hold.PeakAbs(240.0, 900.0), 0.0);
+
+    // The window does not move the cursor
+    hold.ValueAt(10.0);
+    EXPECT_DOUBLE_EQ(hold.PeakAbs(130.0, 170.0), 4.0);
+    EXPECT_DOUBLE_EQ(hold.ValueAt(10.0), 0.0);
+    std::remove(kCsvFile);
+}
+
+TEST(InputSeries, MapsBinaryFile) {
+    const double rows[] = {
+        0.0,  1.0, 10.0,
+        1.0,  2.0, 20.0,
+        2.5,  3.0, 30.0,
+    };
+    WriteBinary(kBinFile, 2, rows, 3, 3);
+    std::string error;
+    {
+        InputSeries s;
+        ASSERT_TRUE(s.Load(kBinFile, 2, 60.0, InputSeries::HOLD, error));
+        EXPECT_TRUE(s.IsMapped());
+        EXPECT_EQ(s.GetRowCount(), (size_t)3);
+        EXPECT_DOUBLE_EQ(s.GetEndSeconds(), 150.0);
+        EXPECT_DOUBLE_EQ(s.ValueAt(30.0), 10.0);
+        EXPECT_DOUBLE_EQ(s.ValueAt(60.0), 20.0);
+        EXPECT_DOUBLE_EQ(s.ValueAt(200.0), 30.0);
+        EXPECT_FALSE(s.Load(kBinFile, 3, 60.0, InputSeries::HOLD, error));
+    }
+
+    // Rows promised by the header but missing from the file
+    WriteBinary(kBinFile, 2, rows, 3, 4);
+    InputSeries s;
+    EXPECT_FALSE(s.Load(kBinFile, 1, 1.0, InputSeries::HOLD, error));
+    EXPECT_EQ(s.GetRowCount(), (size_t)0);
+    std::remove(kBinFile);
+}
+
+TEST(InputSeries, RejectsMalformedFiles) {
+    std::string error;
+    InputSeries s;
+    EXPECT_FALSE(s.Load("no_such_series.csv", 1, 1.0, InputSeries::HOLD, error));
+
+    WriteText(kCsvFile, "0,1\n10,2\n10,3\n");
+    EXPECT_FALSE(s.Load(kCsvFile, 1, 1.0, InputSeries::HOLD, error));
+
+    WriteText(kCsvFile, "0,1\n10\n");
+    EXPECT_FALSE(s.Load(kCsvFile, 1, 1.0, InputSeries::HOLD, error));
+
+    WriteText(kCsvFile, "time,value\n");
+    EXPECT_FALSE(s.Load(kCsvFile, 1, 1.0, InputSeries::HOLD, error));
+
+    WriteText(kCsvFile, "time,value\n0,1\nx,2\n");
+    EXPECT_FALSE(s.Load(kCsvFile, 1, 1.0, InputSeries::HOLD, error));
+    std::remove(kCsvFile);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -2,11 +2,17 @@
 //   test_lifecycle.cpp
 //
 //   Minimal test program to verify SWMM lifecycle management
-//   Tests: Initialize -> Cleanup sequence
+//   Tests: Initialize -> Cleanup sequence, realization recycling and
+//   checkpoint resume run against their own SwmmGoldSimBridge.json
 //-----------------------------------------------------------------------------
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
 #include <windows.h>
+#include <cmath>
 
 // Function pointer type for the bridge function
 typedef void (*BridgeFunctionType)(int, int*, double*, double*);
@@ -23,6 +29,92 @@ typedef void (*BridgeFunctionType)(int, int*, double*, double*);
 #define XF_FAILURE              1
 #define XF_FAILURE_WITH_MSG    -1
 
+#define CONFIG_FILE "SwmmGoldSimBridge.json"
+
+static std::string ReadFileText(const char* path)
+{
+    std::ifstream f(path, std::ios::binary);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+}
+
+static void WriteFileText(const char* path, const std::string& text)
+{
+    std::ofstream f(path, std::ios::binary | std::ios::trunc);
+    f << text;
+}
+
+// Mapping for model.inp (ElapsedTime and RainGage rainfall in; S1 runoff and
+// O1 flow out) with extra top-level sections such as "realization"
+static std::string BridgeConfig(const std::string& sections)
+{
+    return "{\n"
+           "  \"version\": \"1.0\",\n"
+           "  \"logging_level\": \"ERROR\",\n" + sections +
+           "  \"inputs\": [\n"
+           "    {\"index\": 0, \"name\": \"ElapsedTime\", \"object_type\": \"SYSTEM\", \"property\": \"ELAPSEDTIME\"},\n"
+           "    {\"index\": 1, \"name\": \"RainGage\", \"object_type\": \"GAGE\", \"property\": \"RAINFALL\"}\n"
+           "  ],\n"
+           "  \"outputs\": [\n"
+           "    {\"index\": 0, \"name\": \"S1\", \"object_type\": \"SUBCATCH\", \"property\": \"RUNOFF\"},\n"
+           "    {\"index\": 1, \"name\": \"O1\", \"object_type\": \"OUTFALL\", \"property\": \"FLOW\"}\n"
+           "  ]\n"
+           "}\n";
+}
+
+// The bridge reads its configuration once per load, so every case with its
+// own configuration loads a fresh copy of the DLL
+static BridgeFunctionType LoadBridge(HMODULE* dll)
+{
+    *dll = LoadLibraryA("GSswmm.dll");
+    if (!*dll) return NULL;
+    return (BridgeFunctionType)GetProcAddress(*dll, "SwmmGoldSimBridge");
+}
+
+// One realization: XF_INITIALIZE, then XF_CALCULATE for calls first..last-1
+// (rainfall rain[k], elapsed time input k * step_seconds), then XF_CLEANUP.
+// Both outputs of every call are appended to outputs
+static bool RunRealization(BridgeFunctionType Bridge, const std::vector<double>& rain,
+                           size_t first, size_t last, double step_seconds,
+                           std::vector<double>& outputs)
+{
+    int status;
+    double inargs[10] = {0};
+    double outargs[10] = {0};
+    Bridge(XF_INITIALIZE, &status, inargs, outargs);
+    if (status != XF_SUCCESS) return false;
+    bool ok = true;
+    for (size_t k = first; k < last && ok; k++)
+    {
+        inargs[0] = k * step_seconds;
+        inargs[1] = rain[k];
+        Bridge(XF_CALCULATE, &status, inargs, outargs);
+        if (status == XF_SUCCESS) outputs.insert(outputs.end(), outargs, outargs + 2);
+        else ok = false;
+    }
+    Bridge(XF_CLEANUP, &status, inargs, outargs);
+    return ok;
+}
+
+// Deletes the files in dir and then dir itself
+static void RemoveTestDir(const char* dir)
+{
+    WIN32_FIND_DATAA fd;
+    std::string pattern = std::string(dir) + "\\*";
+    HANDLE h = FindFirstFileA(pattern.c_str(), &fd);
+    if (h != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            std::string path = std::string(dir) + "\\" + fd.cFileName;
+            DeleteFileA(path.c_str());
+        } while (FindNextFileA(h, &fd));
+        FindClose(h);
+    }
+    RemoveDirectoryA(dir);
+}
+
 int main()
 {
     std::cout << "=== GoldSim-SWMM Bridge Lifecycle Test ===" << std::endl;
@@ -212,6 +304,114 @@ int main()
     // Clean up
     FreeLibrary(hDll);
 
+    const std::string saved_config = ReadFileText(CONFIG_FILE);
+    std::vector<double> rain;
+    for (int k = 0; k < 24; k++) rain.push_back((k / 3) % 2 ? 0.0 : 1.5);
+
+    // Test 8: Recycled realizations return the same outputs as a fresh project
+    std::cout << "Test 8: Realization recycling" << std::endl;
+    test_count++;
+    {
+        std::vector<double> fresh, first, second;
+        WriteFileText(CONFIG_FILE, BridgeConfig(""));
+        HMODULE hCase;
+        BridgeFunctionType Bridge = LoadBridge(&hCase);
+        bool ok = Bridge != NULL;
+        if (ok)
+        {
+            ok = RunRealization(Bridge, rain, 0, rain.size(), 60.0, fresh);
+            FreeLibrary(hCase);
+        }
+        WriteFileText(CONFIG_FILE, BridgeConfig("  \"realization\": {\"recycle\": true},\n"));
+        Bridge = ok ? LoadBridge(&hCase) : NULL;
+        ok = Bridge != NULL;
+        if (ok)
+        {
+            // The second realization only calls swmm_start on the open project
+            ok = RunRealization(Bridge, rain, 0, rain.size(), 60.0, first) &&
+                 RunRealization(Bridge, rain, 0, rain.size(), 60.0, second);
+            FreeLibrary(hCase);
+        }
+        if (ok && !fresh.empty() && first == fresh && second == fresh)
+        {
+            std::cout << "  [PASS] Both recycled realizations match a fresh project" << std::endl;
+            pass_count++;
+        }
+        else
+        {
+            std::cout << "  [FAIL] Recycled outputs differ from a fresh project (or a run failed)" << std::endl;
+        }
+    }
+    std::cout << std::endl;
+
+    // Test 9: Resume from a checkpoint after an interrupted realization
+    std::cout << "Test 9: Checkpoint resume" << std::endl;
+    test_count++;
+    {
+        const char* ckpt_dir = "test_checkpoints";
+        RemoveTestDir(ckpt_dir);
+        const char* stepping = "  \"stepping\": {\"mode\": \"GOLDSIM_TIME\", \"timestep_seconds\": 1800},\n";
+        const std::string checkpoint =
+            "  \"checkpoint\": {\"enabled\": true, \"every_days\": 0.125, \"dir\": \"test_checkpoints\", \"resume\": true},\n";
+
+        // Reference: the whole realization without checkpoints
+        std::vector<double> full, stopped, resumed;
+        WriteFileText(CONFIG_FILE, BridgeConfig(stepping));
+        HMODULE hCase;
+        BridgeFunctionType Bridge = LoadBridge(&hCase);
+        bool ok = Bridge != NULL;
+        if (ok)
+        {
+            ok = RunRealization(Bridge, rain, 0, rain.size(), 1800.0, full);
+            FreeLibrary(hCase);
+        }
+
+        // Checkpoints at 3, 6 and 9 hours; the realization is cleaned up at
+        // 10 hours before it ends, so its checkpoints are kept
+        WriteFileText(CONFIG_FILE, BridgeConfig(stepping + checkpoint));
+        Bridge = ok ? LoadBridge(&hCase) : NULL;
+        ok = Bridge != NULL;
+        if (ok)
+        {
+            ok = RunRealization(Bridge, rain, 0, 21, 1800.0, stopped);
+            FreeLibrary(hCase);
+        }
+
+        // A new GoldSim run resumes from the 9 hour checkpoint; its first call
+        // is the one for 9.5 hours
+        const size_t resume_call = 19;
+        Bridge = ok ? LoadBridge(&hCase) : NULL;
+        ok = Bridge != NULL;
+        if (ok)
+        {
+            ok = RunRealization(Bridge, rain, resume_call, rain.size(), 1800.0, resumed);
+            FreeLibrary(hCase);
+        }
+
+        // SWMM hotstart files store single precision states
+        bool same = ok && resumed.size() == full.size() - resume_call * 2;
+        for (size_t i = 0; same && i < resumed.size(); i++)
+        {
+            double expected = full[resume_call * 2 + i];
+            if (std::fabs(resumed[i] - expected) > 1e-4 * (std::fabs(expected) + 1e-6)) same = false;
+        }
+        if (same)
+        {
+            std::cout << "  [PASS] Resumed calls " << resume_call << "-" << (rain.size() - 1)
+                      << " match the uninterrupted run" << std::endl;
+            pass_count++;
+        }
+        else
+        {
+            std::cout << "  [FAIL] Resumed outputs differ from the uninterrupted run (or a run failed)" << std::endl;
+        }
+        RemoveTestDir(ckpt_dir);
+        DeleteFileA("model_resume.inp");
+    }
+    std::cout << std::endl;
+
+    WriteFileText(CONFIG_FILE, saved_config);
+
     // Print summary
     std::cout << "=== Test Summary ===" << std::endl;
     std::cout << "Tests run: " << test_count << std::endl;
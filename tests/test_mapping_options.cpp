@@ -0,0 +1,459 @@
+//-----------------------------------------------------------------------------
+//   test_mapping_options.cpp
+//
+//   Unit tests for the optional sections of SwmmGoldSimBridge.json
+//   parsed by MappingLoader
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/MappingLoader.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+static const char* kTestFile = "test_mapping_options.json";
+
+// Minimal valid mapping with extra top-level content spliced in
+static bool LoadWith(MappingLoader& loader, const std::string& extra, std::string& error) {
+    std::ofstream f(kTestFile);
+    f << "{\n"
+      << "  \"version\": \"1.0\",\n"
+      << "  \"logging_level\": \"ERROR\",\n"
+      << extra
+      << "  \"inputs\": [\n"
+      << "    {\"index\": 0, \"name\": \"ElapsedTime\", \"object_type\": \"SYSTEM\", \"property\": \"ELAPSEDTIME\"},\n"
+      << "    {\"index\": 1, \"name\": \"R1\", \"object_type\": \"GAGE\", \"property\": \"RAINFALL\"}\n"
+      << "  ],\n"
+      << "  \"outputs\": [\n"
+      << "    {\"index\": 0, \"name\": \"POND\", \"object_type\": \"STORAGE\", \"property\": \"VOLUME\"}\n"
+      << "  ]\n"
+      << "}\n";
+    f.close();
+    error.clear();  // LoadFromFile fails on any error text, including one left by an earlier case
+    bool ok = loader.LoadFromFile(kTestFile, error);
+    std::remove(kTestFile);
+    return ok;
+}
+
+TEST(MappingOptions, SteppingDefaults) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_FALSE(loader.GetStepping().async);
+}
+
+TEST(MappingOptions, SteppingAsync) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "  \"stepping\": { \"async\": true },\n", error));
+    EXPECT_TRUE(loader.GetStepping().async);
+    EXPECT_EQ(loader.GetInputCount(), 2);
+    EXPECT_EQ(loader.GetOutputCount(), 1);
+}
+
+TEST(MappingOptions, GoldSimTimeStepping) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "  \"stepping\": { \"mode\": \"GOLDSIM_TIME\", \"timestep_seconds\": 3600 },\n", error));
+    EXPECT_EQ(loader.GetStepping().mode, std::string("GOLDSIM_TIME"));
+    EXPECT_DOUBLE_EQ(loader.GetStepping().timestep_seconds, 3600.0);
+    EXPECT_FALSE(loader.GetStepping().async);
+}
+
+TEST(MappingOptions, GoldSimTimeRequiresTimestep) {
+    MappingLoader loader;
+    std::string error;
+    EXPECT_FALSE(LoadWith(loader, "  \"stepping\": { \"mode\": \"GOLDSIM_TIME\" },\n", error));
+    EXPECT_FALSE(error.empty());
+}
+
+TEST(MappingOptions, RealizationRecycle) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_FALSE(loader.GetRealization().recycle);
+    ASSERT_TRUE(LoadWith(loader, "  \"realization\": { \"recycle\": true },\n", error));
+    EXPECT_TRUE(loader.GetRealization().recycle);
+}
+
+TEST(MappingOptions, RealizationMinimalIO) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_FALSE(loader.GetRealization().minimal_io);
+    ASSERT_TRUE(LoadWith(loader, "  \"realization\": { \"minimal_io\": true },\n", error));
+    EXPECT_TRUE(loader.GetRealization().minimal_io);
+    EXPECT_FALSE(loader.GetRealization().recycle);
+}
+
+TEST(MappingOptions, Spinup) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "  \"spinup\": { \"duration_days\": 21, \"cache_dir\": \"hotstart\" },\n", error));
+    EXPECT_DOUBLE_EQ(loader.GetSpinup().duration_days, 21.0);
+    EXPECT_EQ(loader.GetSpinup().cache_dir, std::string("hotstart"));
+    EXPECT_FALSE(LoadWith(loader, "  \"spinup\": { \"duration_days\": -1 },\n", error));
+}
+
+TEST(MappingOptions, Memo) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_FALSE(loader.GetMemo().enabled);
+    ASSERT_TRUE(LoadWith(loader, "  \"memo\": { \"enabled\": true, \"dir\": \"memo\" },\n", error));
+    EXPECT_TRUE(loader.GetMemo().enabled);
+    EXPECT_EQ(loader.GetMemo().dir, std::string("memo"));
+
+    // A served realization never runs, so per-realization files and live state would be missing
+    const std::string memo = "  \"memo\": {\"enabled\": true},\n";
+    ASSERT_TRUE(LoadWith(loader, memo + "  \"flight_recorder\": {\"enabled\": true},\n", error));
+    EXPECT_FALSE(LoadWith(loader, memo + "  \"statistics\": {\"enabled\": true},\n", error));
+    EXPECT_FALSE(LoadWith(loader, memo + "  \"recorder\": {\"enabled\": true},\n", error));
+    EXPECT_FALSE(LoadWith(loader, memo + "  \"telemetry\": {\"enabled\": true},\n", error));
+}
+
+TEST(MappingOptions, Statistics) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_FALSE(loader.GetStatistics().enabled);
+    EXPECT_EQ(loader.GetStatistics().quantiles.size(), (size_t)3);
+    EXPECT_TRUE(std::isnan(loader.GetOutputs()[0].exceed_threshold));
+    ASSERT_TRUE(LoadWith(loader, "  \"statistics\": { \"enabled\": true, \"file\": \"run.csv\", \"quantiles\": [0.25, 0.75] },\n", error));
+    EXPECT_TRUE(loader.GetStatistics().enabled);
+    EXPECT_EQ(loader.GetStatistics().file, std::string("run.csv"));
+    ASSERT_EQ(loader.GetStatistics().quantiles.size(), (size_t)2);
+    EXPECT_DOUBLE_EQ(loader.GetStatistics().quantiles[1], 0.75);
+    EXPECT_FALSE(LoadWith(loader, "  \"statistics\": { \"quantiles\": [50] },\n", error));
+}
+
+TEST(MappingOptions, Recorder) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_FALSE(loader.GetRecorder().enabled);
+    EXPECT_TRUE(loader.GetRecorder().inputs);
+    EXPECT_EQ(loader.GetRecorder().chunk_rows, 1024);
+    ASSERT_TRUE(LoadWith(loader,
+        "  \"recorder\": { \"enabled\": true, \"dir\": \"rec\", \"record_inputs\": false, \"chunk_rows\": 256 },\n", error));
+    EXPECT_TRUE(loader.GetRecorder().enabled);
+    EXPECT_EQ(loader.GetRecorder().dir, std::string("rec"));
+    EXPECT_FALSE(loader.GetRecorder().inputs);
+    EXPECT_EQ(loader.GetRecorder().chunk_rows, 256);
+    EXPECT_EQ(loader.GetInputs().size(), (size_t)2);
+    EXPECT_FALSE(LoadWith(loader, "  \"recorder\": { \"chunk_rows\": 0 },\n", error));
+}
+
+TEST(MappingOptions, Controllers) {
+    MappingLoader loader;
+    std::string error;
+    const char* ok =
+        "  \"controllers\": [\n"
+        "    {\"name\": \"P1Level\", \"type\": \"DEADBAND\", \"sensor_type\": \"STORAGE\", \"sensor\": \"POND\",\n"
+        "     \"sensor_property\": \"DEPTH\", \"actuator_type\": \"PUMP\", \"actuator\": \"P1\", \"on_level\": 4, \"off_level\": 1},\n"
+        "    {\"name\": \"W1Table\", \"type\": \"TABLE\", \"sensor_type\": \"NODE\", \"sensor\": \"J1\",\n"
+        "     \"sensor_property\": \"DEPTH\", \"actuator_type\": \"WEIR\", \"actuator\": \"W1\",\n"
+        "     \"table\": [[0, 0], [2.5, 0.5], [5, 1]], \"interpolate\": \"STEP\"}\n"
+        "  ],\n";
+    ASSERT_TRUE(LoadWith(loader, ok, error));
+    ASSERT_EQ(loader.GetControllers().size(), (size_t)2);
+    const MappingLoader::ControllerMapping& d = loader.GetControllers()[0];
+    EXPECT_EQ(d.type, std::string("DEADBAND"));
+    EXPECT_EQ(d.sensor, std::string("POND"));
+    EXPECT_EQ(d.actuator, std::string("P1"));
+    EXPECT_DOUBLE_EQ(d.on_level, 4.0);
+    EXPECT_DOUBLE_EQ(d.on_setting, 1.0);
+    const MappingLoader::ControllerMapping& t = loader.GetControllers()[1];
+    ASSERT_EQ(t.table.size(), (size_t)6);
+    EXPECT_DOUBLE_EQ(t.table[2], 2.5);
+    EXPECT_EQ(t.interpolate, std::string("STEP"));
+
+    EXPECT_FALSE(LoadWith(loader,
+        "  \"controllers\": [ {\"name\": \"X\", \"type\": \"TABLE\", \"sensor_type\": \"NODE\", \"sensor\": \"J1\",\n"
+        "     \"sensor_property\": \"DEPTH\", \"actuator_type\": \"PUMP\", \"actuator\": \"P1\", \"table\": [[2, 0], [1, 1]]} ],\n", error));
+    EXPECT_FALSE(LoadWith(loader,
+        "  \"controllers\": [ {\"name\": \"X\", \"type\": \"FUZZY\", \"sensor_type\": \"NODE\", \"sensor\": \"J1\",\n"
+        "     \"sensor_property\": \"DEPTH\", \"actuator_type\": \"PUMP\", \"actuator\": \"P1\"} ],\n", error));
+}
+
+TEST(MappingOptions, PerItemOptions) {
+    std::ofstream f(kTestFile);
+    f << "{ \"version\": \"1.0\",\n"
+      << "  \"inputs\": [ {\"index\": 0, \"name\": \"R1\", \"object_type\": \"GAGE\", \"property\": \"RAINFALL\", \"interpolate\": \"LINEAR\"},\n"
+      << "              {\"index\": 1, \"name\": \"P1\", \"object_type\": \"PUMP\", \"property\": \"SETTING\", \"tolerance\": 0.01} ],\n"
+      << "  \"outputs\": [ {\"index\": 0, \"name\": \"OUT1\", \"object_type\": \"OUTFALL\", \"property\": \"FLOW\", \"aggregate\": \"INTEGRAL\"},\n"
+      << "               {\"index\": 1, \"name\": \"POND\", \"object_type\": \"STORAGE\", \"property\": \"VOLUME\"} ] }\n";
+    f.close();
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(loader.LoadFromFile(kTestFile, error));
+    std::remove(kTestFile);
+    EXPECT_EQ(loader.GetInputs()[0].interpolate, std::string("LINEAR"));
+    EXPECT_TRUE(loader.GetInputs()[1].interpolate.empty());
+    EXPECT_DOUBLE_EQ(loader.GetInputs()[0].tolerance, 0.0);
+    EXPECT_DOUBLE_EQ(loader.GetInputs()[1].tolerance, 0.01);
+    EXPECT_EQ(loader.GetOutputs()[0].aggregate, std::string("INTEGRAL"));
+    EXPECT_TRUE(loader.GetOutputs()[1].aggregate.empty());
+}
+
+TEST(MappingOptions, ReductionOutputs) {
+    std::ofstream f(kTestFile);
+    f << "{ \"version\": \"1.0\",\n"
+      << "  \"inputs\": [ {\"index\": 0, \"name\": \"ElapsedTime\", \"object_type\": \"SYSTEM\", \"property\": \"ELAPSEDTIME\"} ],\n"
+      << "  \"outputs\": [ {\"index\": 0, \"name\": \"TotalRunoff\", \"object_type\": \"SUBCATCH\", \"property\": \"RUNOFF\", \"reduce\": \"SUM\"},\n"
+      << "               {\"index\": 1, \"name\": \"TrunkWet\", \"object_type\": \"JUNCTION\", \"property\": \"DEPTH\",\n"
+      << "                \"reduce\": \"COUNT_ABOVE\", \"threshold\": 0.5, \"elements\": [\"J1\", \"J2\", \"J3\"]} ] }\n";
+    f.close();
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(loader.LoadFromFile(kTestFile, error));
+    std::remove(kTestFile);
+    const MappingLoader::OutputMapping& sum = loader.GetOutputs()[0];
+    EXPECT_EQ(sum.reduce, std::string("SUM"));
+    EXPECT_TRUE(sum.elements.empty());
+    const MappingLoader::OutputMapping& wet = loader.GetOutputs()[1];
+    EXPECT_EQ(wet.reduce, std::string("COUNT_ABOVE"));
+    EXPECT_DOUBLE_EQ(wet.threshold, 0.5);
+    ASSERT_EQ(wet.elements.size(), (size_t)3);
+    EXPECT_EQ(wet.elements[2], std::string("J3"));
+    EXPECT_EQ(wet.name, std::string("TrunkWet"));
+}
+
+TEST(MappingOptions, ExpressionOutputs) {
+    const char* head =
+        "{ \"version\": \"1.0\",\n"
+        "  \"inputs\": [ {\"index\": 0, \"name\": \"ElapsedTime\", \"object_type\": \"SYSTEM\", \"property\": \"ELAPSEDTIME\"} ],\n"
+        "  \"outputs\": [ {\"index\": 0, \"name\": \"TotalStorage\", \"object_type\": \"EXPRESSION\", \"property\": \"VALUE\",\n";
+    std::ofstream f(kTestFile);
+    f << head << "                \"expression\": \"max(ST1.VOLUME, 0) + ST2.VOLUME\"} ] }\n";
+    f.close();
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(loader.LoadFromFile(kTestFile, error));
+    const MappingLoader::OutputMapping& out = loader.GetOutputs()[0];
+    EXPECT_EQ(out.expression, std::string("max(ST1.VOLUME, 0) + ST2.VOLUME"));
+    EXPECT_EQ(out.program.GetReferenceCount(), 2);
+
+    // Syntax errors fail the load
+    f.open(kTestFile);
+    f << head << "                \"expression\": \"ST1.VOLUME +\"} ] }\n";
+    f.close();
+    MappingLoader bad;
+    EXPECT_FALSE(bad.LoadFromFile(kTestFile, error));
+    EXPECT_NE(error.find("ST1.VOLUME +"), std::string::npos);
+    std::remove(kTestFile);
+}
+
+TEST(MappingOptions, UpdateEvery) {
+    const char* head =
+        "{ \"version\": \"1.0\",\n"
+        "  \"inputs\": [ {\"index\": 0, \"name\": \"ElapsedTime\", \"object_type\": \"SYSTEM\", \"property\": \"ELAPSEDTIME\"} ],\n"
+        "  \"outputs\": [ {\"index\": 0, \"name\": \"POND\", \"object_type\": \"STORAGE\", \"property\": \"VOLUME\", ";
+    std::ofstream f(kTestFile);
+    f << head << "\"update_every\": 10},\n"
+      << "               {\"index\": 1, \"name\": \"S1/RB\", \"object_type\": \"LID\", \"property\": \"STORAGE_VOLUME\", \"update_every_seconds\": 900} ] }\n";
+    f.close();
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(loader.LoadFromFile(kTestFile, error));
+    EXPECT_EQ(loader.GetOutputs()[0].update_every, 10);
+    EXPECT_DOUBLE_EQ(loader.GetOutputs()[0].update_every_seconds, 0.0);
+    EXPECT_EQ(loader.GetOutputs()[1].update_every, 0);
+    EXPECT_DOUBLE_EQ(loader.GetOutputs()[1].update_every_seconds, 900.0);
+
+    // Only one schedule per output, and only on single-element outputs
+    f.open(kTestFile);
+    f << head << "\"update_every\": 10, \"update_every_seconds\": 900} ] }\n";
+    f.close();
+    EXPECT_FALSE(loader.LoadFromFile(kTestFile, error));
+    f.open(kTestFile);
+    f << head << "\"reduce\": \"SUM\", \"update_every\": 10} ] }\n";
+    f.close();
+    EXPECT_FALSE(loader.LoadFromFile(kTestFile, error));
+    std::remove(kTestFile);
+}
+
+TEST(MappingOptions, Worker) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_FALSE(loader.GetWorker().enabled);
+    EXPECT_TRUE(loader.GetWorker().keep_alive);
+    EXPECT_EQ(loader.GetWorker().spin_microseconds, 50);
+
+    ASSERT_TRUE(LoadWith(loader,
+        "  \"worker\": {\"enabled\": true, \"command\": \"swmm_worker {channel}\", \"timeout_seconds\": 60,"
+        " \"spin_microseconds\": 0, \"keep_alive\": false},\n", error));
+    EXPECT_TRUE(loader.GetWorker().enabled);
+    EXPECT_EQ(loader.GetWorker().command, std::string("swmm_worker {channel}"));
+    EXPECT_DOUBLE_EQ(loader.GetWorker().timeout_seconds, 60.0);
+    EXPECT_DOUBLE_EQ(loader.GetWorker().startup_seconds, 30.0);
+    EXPECT_EQ(loader.GetWorker().spin_microseconds, 0);
+    EXPECT_FALSE(loader.GetWorker().keep_alive);
+
+    EXPECT_FALSE(LoadWith(loader, "  \"worker\": {\"enabled\": true, \"startup_seconds\": 0},\n", error));
+}
+
+TEST(MappingOptions, Ensemble) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_EQ(loader.GetEnsemble().members, 1);
+
+    ASSERT_TRUE(LoadWith(loader, "  \"ensemble\": {\"members\": 8},\n", error));
+    EXPECT_EQ(loader.GetEnsemble().members, 8);
+
+    EXPECT_FALSE(LoadWith(loader, "  \"ensemble\": {\"members\": 0},\n", error));
+    // Members would share the memo files
+    EXPECT_FALSE(LoadWith(loader, "  \"memo\": {\"enabled\": true},\n  \"ensemble\": {\"members\": 2},\n", error));
+}
+
+TEST(MappingOptions, Profile) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_FALSE(loader.GetProfile().enabled);
+    EXPECT_EQ(loader.GetProfile().file, std::string("bridge_profile.json"));
+
+    ASSERT_TRUE(LoadWith(loader, "  \"profile\": {\"enabled\": true, \"file\": \"timing.json\"},\n", error));
+    EXPECT_TRUE(loader.GetProfile().enabled);
+    EXPECT_EQ(loader.GetProfile().file, std::string("timing.json"));
+
+    EXPECT_FALSE(LoadWith(loader, "  \"profile\": {\"file\": \"\"},\n", error));
+}
+
+TEST(MappingOptions, Trace) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_FALSE(loader.GetTrace().enabled);
+    EXPECT_EQ(loader.GetTrace().max_events, 200000);
+
+    ASSERT_TRUE(LoadWith(loader, "  \"trace\": {\"enabled\": true, \"file\": \"t.json\", \"max_events\": 5000},\n", error));
+    EXPECT_TRUE(loader.GetTrace().enabled);
+    EXPECT_EQ(loader.GetTrace().file, std::string("t.json"));
+    EXPECT_EQ(loader.GetTrace().max_events, 5000);
+
+    EXPECT_FALSE(LoadWith(loader, "  \"trace\": {\"max_events\": 0},\n", error));
+}
+
+TEST(MappingOptions, FlightRecorder) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_TRUE(loader.GetFlightRecorder().enabled);
+    EXPECT_EQ(loader.GetFlightRecorder().steps, 256);
+    EXPECT_EQ(loader.GetFlightRecorder().file, std::string("bridge_flight.csv"));
+
+    ASSERT_TRUE(LoadWith(loader, "  \"flight_recorder\": {\"enabled\": false, \"steps\": 16},\n", error));
+    EXPECT_FALSE(loader.GetFlightRecorder().enabled);
+    EXPECT_EQ(loader.GetFlightRecorder().steps, 16);
+    EXPECT_FALSE(loader.GetRecorder().enabled);
+
+    EXPECT_FALSE(LoadWith(loader, "  \"flight_recorder\": {\"steps\": 0},\n", error));
+}
+
+TEST(MappingOptions, Telemetry) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_FALSE(loader.GetTelemetry().enabled);
+    EXPECT_EQ(loader.GetTelemetry().name, std::string("gsswmm_telemetry"));
+
+    ASSERT_TRUE(LoadWith(loader, "  \"telemetry\": {\"enabled\": true, \"name\": \"site_a\"},\n", error));
+    EXPECT_TRUE(loader.GetTelemetry().enabled);
+    EXPECT_EQ(loader.GetTelemetry().name, std::string("site_a"));
+
+    EXPECT_FALSE(LoadWith(loader, "  \"telemetry\": {\"name\": \"\"},\n", error));
+    EXPECT_FALSE(LoadWith(loader, "  \"telemetry\": {\"name\": \"a/b\"},\n", error));
+}
+
+TEST(MappingOptions, FastForward) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_FALSE(loader.GetFastForward().enabled);
+    EXPECT_TRUE(loader.GetFastForward().states.empty());
+
+    const std::string stepping = "  \"stepping\": {\"mode\": \"GOLDSIM_TIME\", \"timestep_seconds\": 3600},\n";
+    ASSERT_TRUE(LoadWith(loader, stepping +
+        "  \"fast_forward\": {\"enabled\": true, \"input_threshold\": 0.001, \"watch_inputs\": [\"R1\"],\n"
+        "    \"states\": [{\"output\": \"POND\", \"max\": 5.0}]},\n", error));
+    const MappingLoader::FastForwardOptions& ff = loader.GetFastForward();
+    EXPECT_TRUE(ff.enabled);
+    EXPECT_NEAR(ff.input_threshold, 0.001, 1e-12);
+    ASSERT_EQ(ff.inputs.size(), (size_t)1);
+    EXPECT_EQ(ff.inputs[0], std::string("R1"));
+    ASSERT_EQ(ff.states.size(), (size_t)1);
+    EXPECT_EQ(ff.states[0].output, std::string("POND"));
+    EXPECT_NEAR(ff.states[0].max, 5.0, 1e-12);
+    EXPECT_EQ(loader.GetInputCount(), 2);
+
+    // Needs GOLDSIM_TIME, and names must be mapped
+    EXPECT_FALSE(LoadWith(loader, "  \"fast_forward\": {\"enabled\": true},\n", error));
+    EXPECT_FALSE(LoadWith(loader, stepping + "  \"fast_forward\": {\"enabled\": true, \"watch_inputs\": [\"R9\"]},\n", error));
+    EXPECT_FALSE(LoadWith(loader, stepping +
+        "  \"fast_forward\": {\"enabled\": true, \"states\": [{\"output\": \"NOPE\", \"max\": 1}]},\n", error));
+}
+
+TEST(MappingOptions, Checkpoint) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_FALSE(loader.GetCheckpoint().enabled);
+    EXPECT_NEAR(loader.GetCheckpoint().every_days, 30.0, 1e-12);
+    EXPECT_EQ(loader.GetCheckpoint().keep, 2);
+
+    ASSERT_TRUE(LoadWith(loader,
+        "  \"checkpoint\": {\"enabled\": true, \"every_days\": 7, \"dir\": \"ck\", \"keep\": 3, \"resume\": true},\n", error));
+    const MappingLoader::CheckpointOptions& ck = loader.GetCheckpoint();
+    EXPECT_TRUE(ck.enabled);
+    EXPECT_NEAR(ck.every_days, 7.0, 1e-12);
+    EXPECT_EQ(ck.dir, std::string("ck"));
+    EXPECT_EQ(ck.keep, 3);
+    EXPECT_TRUE(ck.resume);
+
+    EXPECT_FALSE(LoadWith(loader, "  \"checkpoint\": {\"enabled\": true, \"every_days\": 0},\n", error));
+    EXPECT_FALSE(LoadWith(loader, "  \"checkpoint\": {\"enabled\": true, \"keep\": 0},\n", error));
+    EXPECT_FALSE(LoadWith(loader,
+        "  \"checkpoint\": {\"enabled\": true},\n  \"memo\": {\"enabled\": true},\n", error));
+}
+
+TEST(MappingOptions, SeriesInputs) {
+    MappingLoader loader;
+    std::string error;
+    ASSERT_TRUE(LoadWith(loader, "", error));
+    EXPECT_TRUE(loader.GetSeriesInputs().empty());
+
+    ASSERT_TRUE(LoadWith(loader,
+        "  \"timeseries_inputs\": [\n"
+        "    {\"name\": \"RG2\", \"object_type\": \"GAGE\", \"property\": \"RAINFALL\", \"file\": \"storm.csv\"},\n"
+        "    {\"name\": \"J1\", \"object_type\": \"NODE\", \"property\": \"LATFLOW\", \"file\": \"dwf.gts\",\n"
+        "     \"column\": 3, \"interpolate\": \"LINEAR\", \"time_unit\": \"MINUTES\"}],\n", error));
+    const std::vector<MappingLoader::SeriesInputMapping>& s = loader.GetSeriesInputs();
+    ASSERT_EQ(s.size(), (size_t)2);
+    EXPECT_EQ(s[0].file, std::string("storm.csv"));
+    EXPECT_EQ(s[0].column, 1);
+    EXPECT_EQ(s[0].interpolate, std::string("HOLD"));
+    EXPECT_NEAR(s[0].seconds_per_unit, 3600.0, 1e-12);
+    EXPECT_EQ(s[1].column, 3);
+    EXPECT_EQ(s[1].interpolate, std::string("LINEAR"));
+    EXPECT_NEAR(s[1].seconds_per_unit, 60.0, 1e-12);
+    EXPECT_EQ(loader.GetInputCount(), 2);
+
+    // Bad settings, and a property GoldSim already sets
+    EXPECT_FALSE(LoadWith(loader, "  \"timeseries_inputs\": [{\"name\": \"RG2\", \"object_type\": \"GAGE\", "
+        "\"property\": \"RAINFALL\", \"file\": \"a.csv\", \"time_unit\": \"WEEKS\"}],\n", error));
+    EXPECT_FALSE(LoadWith(loader, "  \"timeseries_inputs\": [{\"name\": \"RG2\", \"object_type\": \"GAGE\", "
+        "\"property\": \"RAINFALL\", \"file\": \"a.csv\", \"column\": 0}],\n", error));
+    EXPECT_FALSE(LoadWith(loader, "  \"timeseries_inputs\": [{\"name\": \"RG2\", \"object_type\": \"GAGE\", "
+        "\"property\": \"RAINFALL\"}],\n", error));
+    EXPECT_FALSE(LoadWith(loader, "  \"timeseries_inputs\": [{\"name\": \"R1\", \"object_type\": \"GAGE\", "
+        "\"property\": \"RAINFALL\", \"file\": \"a.csv\"}],\n", error));
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,86 @@
+//-----------------------------------------------------------------------------
+//   test_name_index.cpp
+//
+//   Unit tests for the element name hash table (NameIndex) used to resolve
+//   mapping entries at XF_INITIALIZE
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/NameIndex.h"
+#include <string>
+
+TEST(NameIndex, FindsAddedNames) {
+    NameIndex index;
+    EXPECT_EQ(index.Find("J1"), -1);
+    EXPECT_TRUE(index.Add("J1", 0));
+    EXPECT_TRUE(index.Add("POND", 1));
+    EXPECT_TRUE(index.Add("OUT1", 2));
+    EXPECT_EQ(index.GetCount(), (size_t)3);
+    EXPECT_EQ(index.Find("POND"), 1);
+    EXPECT_EQ(index.Find("OUT1"), 2);
+    EXPECT_EQ(index.Find("J2"), -1);
+    EXPECT_EQ(index.Find(""), -1);
+
+    index.Clear();
+    EXPECT_EQ(index.GetCount(), (size_t)0);
+    EXPECT_EQ(index.Find("J1"), -1);
+}
+
+TEST(NameIndex, CaseMatching) {
+    NameIndex swmm_names;
+    swmm_names.Add("Pond_A", 4);
+    EXPECT_EQ(swmm_names.Find("POND_A"), 4);
+    EXPECT_EQ(swmm_names.Find("pond_a"), 4);
+    EXPECT_FALSE(swmm_names.Add("POND_A", 5));      // Same name to SWMM
+
+    NameIndex exact(false);
+    exact.Add("RainBarrel", 0);
+    EXPECT_EQ(exact.Find("RainBarrel"), 0);
+    EXPECT_EQ(exact.Find("rainbarrel"), -1);
+    EXPECT_TRUE(exact.Add("rainbarrel", 1));
+}
+
+TEST(NameIndex, KeepsFirstDuplicate) {
+    NameIndex index(false);
+    EXPECT_TRUE(index.Add("Trench", 0));
+    EXPECT_FALSE(index.Add("Trench", 3));
+    EXPECT_EQ(index.Find("Trench"), 0);
+    EXPECT_FALSE(index.Add("Bad", -1));
+    EXPECT_EQ(index.GetCount(), (size_t)1);
+}
+
+TEST(NameIndex, GrowsAndStaysHalfEmpty) {
+    NameIndex index;
+    for (int i = 0; i < 50000; i++) {
+        ASSERT_TRUE(index.Add("N" + std::to_string(i), i));
+    }
+    EXPECT_EQ(index.GetCount(), (size_t)50000);
+    EXPECT_TRUE(index.GetCapacity() >= 100000);
+    for (int i = 0; i < 50000; i += 7) {
+        ASSERT_EQ(index.Find("n" + std::to_string(i)), i);
+    }
+    EXPECT_EQ(index.Find("N50000"), -1);
+
+    // Names with embedded NULs (LID keys carry the subcatchment index)
+    NameIndex keys(false);
+    std::string a("\0\0\0\1Trench", 10), b("\0\0\0\2Trench", 10);
+    keys.Add(a, 0);
+    keys.Add(b, 1);
+    EXPECT_EQ(keys.Find(a), 0);
+    EXPECT_EQ(keys.Find(b), 1);
+}
+
+TEST(NameIndex, ReserveAvoidsRehash) {
+    NameIndex index;
+    index.Reserve(1000);
+    size_t capacity = index.GetCapacity();
+    EXPECT_TRUE(capacity >= 2000);
+    for (int i = 0; i < 1000; i++) index.Add(std::to_string(i), i);
+    EXPECT_EQ(index.GetCapacity(), capacity);
+    EXPECT_EQ(index.Find("999"), 999);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
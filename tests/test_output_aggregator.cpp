@@ -0,0 +1,90 @@
+//-----------------------------------------------------------------------------
+//   test_output_aggregator.cpp
+//
+//   Unit tests for sub-step output aggregation (OutputAggregator)
+//   used by GOLDSIM_TIME stepping
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/OutputAggregator.h"
+
+// Slots: 0 INSTANT, 1 MEAN, 2 MAX, 3 MIN, 4 INTEGRAL
+static void Configure(OutputAggregator& agg) {
+    agg.SetMode(0, OutputAggregator::INSTANT);
+    agg.SetMode(1, OutputAggregator::MEAN);
+    agg.SetMode(2, OutputAggregator::MAX);
+    agg.SetMode(3, OutputAggregator::MIN);
+    agg.SetMode(4, OutputAggregator::INTEGRAL);
+}
+
+TEST(OutputAggregator, ReducesSubsteps) {
+    OutputAggregator agg;
+    Configure(agg);
+    EXPECT_TRUE(agg.NeedsSubsteps());
+
+    double a[5] = { 1, 1, 1, 1, 1 };
+    double b[5] = { 4, 4, 4, 4, 4 };
+    double c[5] = { 2, 2, 2, 2, 2 };
+    agg.Begin();
+    agg.Accumulate(a, 30.0);
+    agg.Accumulate(b, 30.0);
+    agg.Accumulate(c, 60.0);
+
+    double out[5] = { 0 };
+    agg.Finish(c, out);
+    EXPECT_DOUBLE_EQ(out[0], 2.0);                           // Last value
+    EXPECT_DOUBLE_EQ(out[1], (30.0 + 120.0 + 120.0) / 120.0); // Time-weighted
+    EXPECT_DOUBLE_EQ(out[2], 4.0);
+    EXPECT_DOUBLE_EQ(out[3], 1.0);
+    EXPECT_DOUBLE_EQ(out[4], 270.0);                         // Sum of value * dt
+}
+
+TEST(OutputAggregator, BeginResetsAccumulators) {
+    OutputAggregator agg;
+    Configure(agg);
+    double v[5] = { 9, 9, 9, 9, 9 };
+    agg.Begin();
+    agg.Accumulate(v, 10.0);
+
+    double w[5] = { 3, 3, 3, 3, 3 };
+    agg.Begin();
+    agg.Accumulate(w, 10.0);
+    double out[5] = { 0 };
+    agg.Finish(w, out);
+    EXPECT_DOUBLE_EQ(out[1], 3.0);
+    EXPECT_DOUBLE_EQ(out[2], 3.0);
+    EXPECT_DOUBLE_EQ(out[3], 3.0);
+    EXPECT_DOUBLE_EQ(out[4], 30.0);
+}
+
+TEST(OutputAggregator, EmptyIntervalPassesValuesThrough) {
+    OutputAggregator agg;
+    Configure(agg);
+    double v[5] = { 5, 6, 7, 8, 9 };
+    agg.Begin();
+    agg.Finish(v, v);
+    EXPECT_DOUBLE_EQ(v[0], 5.0);
+    EXPECT_DOUBLE_EQ(v[1], 6.0);
+    EXPECT_DOUBLE_EQ(v[3], 8.0);
+    EXPECT_DOUBLE_EQ(v[4], 0.0);    // Nothing has flowed yet
+}
+
+TEST(OutputAggregator, InstantOnlyNeedsNoSubsteps) {
+    OutputAggregator agg;
+    agg.SetMode(0, OutputAggregator::INSTANT);
+    agg.SetMode(1, OutputAggregator::MEAN);
+    agg.SetMode(1, OutputAggregator::INSTANT);    // Re-set replaces the mode
+    EXPECT_FALSE(agg.NeedsSubsteps());
+}
+
+TEST(OutputAggregator, ParsesNames) {
+    EXPECT_EQ(AggregateNameToMode(""), (int)OutputAggregator::INSTANT);
+    EXPECT_EQ(AggregateNameToMode("MEAN"), (int)OutputAggregator::MEAN);
+    EXPECT_EQ(AggregateNameToMode("VOLUME"), (int)OutputAggregator::INTEGRAL);
+    EXPECT_EQ(AggregateNameToMode("median"), -1);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,195 @@
+//-----------------------------------------------------------------------------
+//   test_output_plan.cpp
+//
+//   Unit tests for the compiled output gather plan (OutputPlan)
+//   SWMM getters are replaced by local fakes that encode their arguments
+//   in the returned value so each destination slot can be checked.
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/OutputPlan.h"
+#include "../include/swmm5.h"
+#include <vector>
+
+static int g_getValue_calls = 0;
+static std::vector<int> g_getValue_order;
+
+extern "C" {
+double DLLEXPORT swmm_getValue(int property, int index) {
+    g_getValue_calls++;
+    g_getValue_order.push_back(index);
+    return property * 1000.0 + index;
+}
+double DLLEXPORT swmm_getLidUStorageVolume(int s, int l) { return 1.0e6 + s * 10 + l; }
+double DLLEXPORT swmm_getLidUSurfaceOutflow(int s, int l) { return 2.0e6 + s * 10 + l; }
+double DLLEXPORT swmm_getLidUSurfaceInflow(int s, int l) { return 3.0e6 + s * 10 + l; }
+double DLLEXPORT swmm_getLidUDrainFlow(int s, int l) { return 4.0e6 + s * 10 + l; }
+}
+
+TEST(OutputPlan, GathersIntoInterfaceSlots) {
+    OutputPlan plan;
+    plan.Add(OutputPlan::GET_VALUE, swmm_NODE_VOLUME, 7, -1, 0);
+    plan.Add(OutputPlan::GET_LID_DRAIN_FLOW, -1, 2, 1, 1);
+    plan.Add(OutputPlan::GET_VALUE, swmm_LINK_FLOW, 3, -1, 2);
+    plan.Add(OutputPlan::GET_LID_STORAGE_VOLUME, -1, 4, 0, 3);
+    plan.Compile();
+
+    double out[4] = {0};
+    plan.Gather(out);
+    EXPECT_DOUBLE_EQ(out[0], swmm_NODE_VOLUME * 1000.0 + 7);
+    EXPECT_DOUBLE_EQ(out[1], 4.0e6 + 21);
+    EXPECT_DOUBLE_EQ(out[2], swmm_LINK_FLOW * 1000.0 + 3);
+    EXPECT_DOUBLE_EQ(out[3], 1.0e6 + 40);
+    EXPECT_EQ(plan.GetOutputCount(), 4);
+}
+
+TEST(OutputPlan, GroupsByGetterAndProperty) {
+    OutputPlan plan;
+    plan.Add(OutputPlan::GET_VALUE, swmm_NODE_DEPTH, 1, -1, 0);
+    plan.Add(OutputPlan::GET_VALUE, swmm_NODE_VOLUME, 2, -1, 1);
+    plan.Add(OutputPlan::GET_VALUE, swmm_NODE_DEPTH, 3, -1, 2);
+    plan.Add(OutputPlan::GET_LID_SURFACE_INFLOW, -1, 0, 0, 3);
+    plan.Add(OutputPlan::GET_LID_SURFACE_INFLOW, -1, 1, 0, 4);
+    plan.Compile();
+
+    // DEPTH, VOLUME and one LID table
+    EXPECT_EQ(plan.GetTableCount(), 3);
+}
+
+TEST(OutputPlan, ReadsElementsInIndexOrder) {
+    OutputPlan plan;
+    plan.Add(OutputPlan::GET_VALUE, swmm_SUBCATCH_RUNOFF, 9, -1, 0);
+    plan.Add(OutputPlan::GET_VALUE, swmm_SUBCATCH_RUNOFF, 2, -1, 1);
+    plan.Add(OutputPlan::GET_VALUE, swmm_SUBCATCH_RUNOFF, 5, -1, 2);
+    plan.Compile();
+
+    g_getValue_order.clear();
+    double out[3] = {0};
+    plan.Gather(out);
+    ASSERT_EQ(g_getValue_order.size(), (size_t)3);
+    EXPECT_EQ(g_getValue_order[0], 2);
+    EXPECT_EQ(g_getValue_order[1], 5);
+    EXPECT_EQ(g_getValue_order[2], 9);
+    EXPECT_DOUBLE_EQ(out[0], swmm_SUBCATCH_RUNOFF * 1000.0 + 9);
+}
+
+TEST(OutputPlan, ReducesGroupsIntoSlots) {
+    OutputPlan plan;
+    plan.Add(OutputPlan::GET_VALUE, swmm_NODE_DEPTH, 4, -1, 0);
+    int sum = plan.AddReduction(OutputPlan::REDUCE_SUM, 0.0, 1);
+    int max = plan.AddReduction(OutputPlan::REDUCE_MAX, 0.0, 2);
+    int count = plan.AddReduction(OutputPlan::REDUCE_COUNT_ABOVE, 205003.0, 3);
+    int mean = plan.AddReduction(OutputPlan::REDUCE_MEAN, 0.0, 4);
+    int min = plan.AddReduction(OutputPlan::REDUCE_MIN, 0.0, 5);
+    for (int i = 0; i < 7; i++) {
+        plan.AddMember(sum, OutputPlan::GET_VALUE, swmm_SUBCATCH_RUNOFF, i, -1);
+        plan.AddMember(count, OutputPlan::GET_VALUE, swmm_SUBCATCH_RUNOFF, i, -1);
+    }
+    plan.AddMember(max, OutputPlan::GET_VALUE, swmm_NODE_DEPTH, 9, -1);
+    plan.AddMember(max, OutputPlan::GET_VALUE, swmm_NODE_DEPTH, 2, -1);
+    plan.AddMember(mean, OutputPlan::GET_LID_DRAIN_FLOW, -1, 1, 0);
+    plan.AddMember(mean, OutputPlan::GET_LID_DRAIN_FLOW, -1, 3, 0);
+    plan.AddMember(min, OutputPlan::GET_VALUE, swmm_NODE_DEPTH, 6, -1);
+    plan.AddMember(min, OutputPlan::GET_VALUE, swmm_NODE_DEPTH, 5, -1);
+    plan.AddMember(min, OutputPlan::GET_VALUE, swmm_NODE_DEPTH, 8, -1);
+    plan.Compile();
+    EXPECT_EQ(plan.GetOutputCount(), 6);
+    EXPECT_EQ(plan.GetMemberCount(), 21);
+    EXPECT_EQ(plan.GetSlotCount(), 6);
+
+    double out[6] = {0};
+    plan.Gather(out);
+    EXPECT_DOUBLE_EQ(out[0], swmm_NODE_DEPTH * 1000.0 + 4);
+    EXPECT_DOUBLE_EQ(out[1], 7 * swmm_SUBCATCH_RUNOFF * 1000.0 + 21);   // 0+1+...+6
+    EXPECT_DOUBLE_EQ(out[2], swmm_NODE_DEPTH * 1000.0 + 9);
+    EXPECT_DOUBLE_EQ(out[3], 3.0);                                        // Indices 4, 5, 6
+    EXPECT_DOUBLE_EQ(out[4], 4.0e6 + 20);                                 // (4e6+10 + 4e6+30) / 2
+    EXPECT_DOUBLE_EQ(out[5], swmm_NODE_DEPTH * 1000.0 + 5);
+}
+
+TEST(OutputPlan, EmptyReductionIsZero) {
+    OutputPlan plan;
+    plan.AddReduction(OutputPlan::REDUCE_MAX, 0.0, 0);
+    plan.Compile();
+    double out[1] = {42.0};
+    plan.Gather(out);
+    EXPECT_DOUBLE_EQ(out[0], 0.0);
+    EXPECT_EQ(ReduceNameToOp("COUNT_ABOVE"), (int)OutputPlan::REDUCE_COUNT_ABOVE);
+    EXPECT_EQ(ReduceNameToOp("MEDIAN"), -1);
+}
+
+TEST(OutputPlan, EvaluatesExpressionsAfterTables) {
+    ExpressionProgram prog;
+    std::string error;
+    ASSERT_TRUE(prog.Compile("A.VOLUME + 2 * B.VOLUME", error));
+    prog.ResolveReference(0, swmm_NODE_VOLUME, 1);
+    prog.ResolveReference(1, swmm_NODE_VOLUME, 2);
+
+    OutputPlan plan;
+    plan.Add(OutputPlan::GET_VALUE, swmm_NODE_DEPTH, 5, -1, 0);
+    plan.AddExpression(prog, 1);
+    plan.Compile();
+    EXPECT_EQ(plan.GetOutputCount(), 2);
+    EXPECT_EQ(plan.GetSlotCount(), 2);
+
+    double out[2] = {0};
+    plan.Gather(out);
+    EXPECT_DOUBLE_EQ(out[0], swmm_NODE_DEPTH * 1000.0 + 5);
+    EXPECT_DOUBLE_EQ(out[1], (swmm_NODE_VOLUME * 1000.0 + 1) + 2 * (swmm_NODE_VOLUME * 1000.0 + 2));
+}
+
+TEST(OutputPlan, DecimatedOutputsReadOnlyWhenDue) {
+    OutputPlan plan;
+    plan.Add(OutputPlan::GET_VALUE, swmm_NODE_DEPTH, 1, -1, 0);
+    plan.Add(OutputPlan::GET_VALUE, swmm_NODE_VOLUME, 2, -1, 1, 3);
+    plan.Add(OutputPlan::GET_VALUE, swmm_NODE_VOLUME, 4, -1, 2, 3);         // Same schedule
+    plan.Add(OutputPlan::GET_VALUE, swmm_LINK_FLOW, 5, -1, 3, 0, 60.0);
+    plan.Compile();
+    EXPECT_EQ(plan.GetCadenceCount(), 2);
+    EXPECT_EQ(plan.GetOutputCount(), 4);
+
+    double out[4] = {0};
+    g_getValue_calls = 0;
+    plan.Gather(out);                   // Initial read takes everything
+    EXPECT_EQ(g_getValue_calls, 4);
+    plan.ResetSchedule();
+
+    // 30 s routing steps: volumes due at step 3, flow every other step
+    const int expected[6] = { 1, 2, 3, 2, 1, 4 };
+    for (int step = 1; step <= 6; step++) {
+        out[1] = out[2] = out[3] = -1.0;
+        g_getValue_calls = 0;
+        plan.Gather(out, step, step * 30.0);
+        EXPECT_EQ(g_getValue_calls, expected[step - 1]);
+        EXPECT_DOUBLE_EQ(out[1], swmm_NODE_VOLUME * 1000.0 + 2);   // Cached between reads
+        EXPECT_DOUBLE_EQ(out[3], swmm_LINK_FLOW * 1000.0 + 5);
+    }
+}
+
+TEST(OutputPlan, LidPropertyNames) {
+    EXPECT_EQ(LidPropertyToGetter("STORAGE_VOLUME"), (int)OutputPlan::GET_LID_STORAGE_VOLUME);
+    EXPECT_EQ(LidPropertyToGetter("SURFACE_OUTFLOW"), (int)OutputPlan::GET_LID_SURFACE_OUTFLOW);
+    EXPECT_EQ(LidPropertyToGetter("SURFACE_INFLOW"), (int)OutputPlan::GET_LID_SURFACE_INFLOW);
+    EXPECT_EQ(LidPropertyToGetter("DRAIN_FLOW"), (int)OutputPlan::GET_LID_DRAIN_FLOW);
+    EXPECT_EQ(LidPropertyToGetter("VOLUME"), -1);
+}
+
+TEST(OutputPlan, ClearResetsPlan) {
+    OutputPlan plan;
+    plan.Add(OutputPlan::GET_VALUE, swmm_NODE_DEPTH, 1, -1, 0);
+    plan.Compile();
+    plan.Clear();
+    EXPECT_EQ(plan.GetOutputCount(), 0);
+    EXPECT_EQ(plan.GetTableCount(), 0);
+
+    g_getValue_calls = 0;
+    double out[1] = {42.0};
+    plan.Gather(out);
+    EXPECT_EQ(g_getValue_calls, 0);
+    EXPECT_DOUBLE_EQ(out[0], 42.0);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,166 @@
+//-----------------------------------------------------------------------------
+//   test_output_stats.cpp
+//
+//   Unit tests for whole-run output statistics (OutputStats)
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/OutputStats.h"
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+
+static const double kNoThreshold = std::numeric_limits<double>::quiet_NaN();
+
+TEST(OutputStats, WeightedMomentsAndExtremes) {
+    OutputStats stats;
+    int t = stats.Track(1, kNoThreshold);
+    double v[2] = {0};
+
+    // Steps of 10, 30 and 60 s
+    v[1] = 2.0; stats.Update(v, 1.0, 10.0);
+    v[1] = 6.0; stats.Update(v, 2.0, 30.0);
+    v[1] = 1.0; stats.Update(v, 3.0, 60.0);
+
+    double mean = (2.0 * 10 + 6.0 * 30 + 1.0 * 60) / 100.0;
+    double var = (10 * (2.0 - mean) * (2.0 - mean) + 30 * (6.0 - mean) * (6.0 - mean) +
+                  60 * (1.0 - mean) * (1.0 - mean)) / 100.0;
+    EXPECT_NEAR(stats.Get(t, OutputStats::STAT_MEAN, 0), mean, 1e-12);
+    EXPECT_NEAR(stats.Get(t, OutputStats::STAT_STDDEV, 0), std::sqrt(var), 1e-12);
+    EXPECT_DOUBLE_EQ(stats.Get(t, OutputStats::STAT_MAX, 0), 6.0);
+    EXPECT_DOUBLE_EQ(stats.Get(t, OutputStats::STAT_TIME_OF_MAX, 0), 2.0);
+    EXPECT_DOUBLE_EQ(stats.Get(t, OutputStats::STAT_MIN, 0), 1.0);
+    EXPECT_DOUBLE_EQ(stats.Get(t, OutputStats::STAT_TIME_OF_MIN, 0), 3.0);
+    EXPECT_EQ(stats.GetSampleCount(), 3L);
+}
+
+TEST(OutputStats, ExceedanceDurationAndEvents) {
+    OutputStats stats;
+    int t = stats.Track(0, 1.0);
+    const double series[] = { 0.5, 1.5, 2.0, 0.2, 3.0, 1.0 };
+    for (int i = 0; i < 6; i++) stats.Update(&series[i], i, 900.0);
+    EXPECT_DOUBLE_EQ(stats.Get(t, OutputStats::STAT_EXCEED_HOURS, 0), 0.75);  // Three 15 min steps
+    EXPECT_DOUBLE_EQ(stats.Get(t, OutputStats::STAT_EXCEED_EVENTS, 0), 2.0);
+}
+
+TEST(OutputStats, QuantilesConvergeOnLongRuns) {
+    OutputStats stats;
+    int t = stats.Track(0, kNoThreshold);
+    int q50 = stats.AddQuantile(0.5);
+    int q90 = stats.AddQuantile(0.9);
+    EXPECT_EQ(stats.AddQuantile(0.5), q50);
+
+    // Deterministic scramble of 0..99999
+    for (long i = 0; i < 100000; i++) {
+        double x = (double)((i * 7919) % 100000);
+        stats.Update(&x, 0.0, 1.0);
+    }
+    EXPECT_NEAR(stats.Get(t, OutputStats::STAT_QUANTILE, q50), 50000.0, 1000.0);
+    EXPECT_NEAR(stats.Get(t, OutputStats::STAT_QUANTILE, q90), 90000.0, 1000.0);
+}
+
+TEST(OutputStats, FewSamplesAreExact) {
+    OutputStats stats;
+    int t = stats.Track(0, kNoThreshold);
+    int q = stats.AddQuantile(0.5);
+    EXPECT_DOUBLE_EQ(stats.Get(t, OutputStats::STAT_QUANTILE, q), 0.0);
+    const double xs[] = { 9.0, 1.0, 5.0 };
+    for (double x : xs) stats.Update(&x, 0.0, 1.0);
+    EXPECT_DOUBLE_EQ(stats.Get(t, OutputStats::STAT_QUANTILE, q), 5.0);
+}
+
+TEST(OutputStats, FillWritesStatisticSlotsAndResetClears) {
+    OutputStats stats;
+    int t = stats.Track(0, kNoThreshold);
+    stats.AddOutput(2, t, OutputStats::STAT_MAX, 0);
+    double v[3] = { 4.0, 0.0, -1.0 };
+    stats.Update(v, 0.5, 60.0);
+    v[0] = 3.0;
+    stats.Update(v, 1.0, 60.0);
+    stats.Fill(v);
+    EXPECT_DOUBLE_EQ(v[2], 4.0);
+
+    stats.Reset();
+    stats.Fill(v);
+    EXPECT_DOUBLE_EQ(v[2], 0.0);
+    EXPECT_EQ(stats.GetSampleCount(), 0L);
+}
+
+TEST(OutputStats, WritesSummaryRows) {
+    const char* path = "test_output_stats.csv";
+    OutputStats stats;
+    stats.Track(0, kNoThreshold);
+    stats.AddQuantile(0.95);
+    double x = 2.0;
+    stats.Update(&x, 0.0, 1.0);
+    std::vector<std::string> names(1, "POND");
+    ASSERT_TRUE(stats.WriteSummary(path, names, 1, false));
+    ASSERT_TRUE(stats.WriteSummary(path, names, 2, true));
+
+    std::ifstream f(path);
+    std::string header, row1, row2;
+    std::getline(f, header);
+    std::getline(f, row1);
+    std::getline(f, row2);
+    f.close();
+    std::remove(path);
+    EXPECT_NE(header.find(",p95"), std::string::npos);
+    EXPECT_EQ(row1.substr(0, 9), std::string("1,POND,1,"));
+    EXPECT_EQ(row2.substr(0, 9), std::string("2,POND,1,"));
+}
+
+TEST(OutputStats, RestoredStateContinuesTheRun) {
+    OutputStats whole, first, second;
+    OutputStats* all[3] = { &whole, &first, &second };
+    for (OutputStats* s : all) {
+        s->Track(0, 1.0);
+        s->AddQuantile(0.5);
+        s->AddQuantile(0.9);
+    }
+    // Checkpoint after 40 of 100 steps, then carry on in a fresh object
+    std::vector<double> saved;
+    for (int i = 0; i < 100; i++) {
+        double x = (double)((i * 37) % 23) / 10.0;
+        whole.Update(&x, i, 60.0);
+        if (i < 40) first.Update(&x, i, 60.0);
+        if (i == 39) {
+            first.SaveState(saved);
+            size_t pos = 0;
+            ASSERT_TRUE(second.RestoreState(saved, pos));
+            EXPECT_EQ(pos, saved.size());
+        }
+        if (i >= 40) second.Update(&x, i, 60.0);
+    }
+    EXPECT_EQ(second.GetSampleCount(), whole.GetSampleCount());
+    for (int stat = 0; stat < OutputStats::STAT_QUANTILE; stat++) {
+        EXPECT_DOUBLE_EQ(second.Get(0, (OutputStats::Stat)stat, 0), whole.Get(0, (OutputStats::Stat)stat, 0));
+    }
+    EXPECT_DOUBLE_EQ(second.Get(0, OutputStats::STAT_QUANTILE, 0), whole.Get(0, OutputStats::STAT_QUANTILE, 0));
+    EXPECT_DOUBLE_EQ(second.Get(0, OutputStats::STAT_QUANTILE, 1), whole.Get(0, OutputStats::STAT_QUANTILE, 1));
+
+    // A different configuration is refused and left untouched
+    OutputStats other;
+    other.Track(0, 1.0);
+    size_t pos = 0;
+    EXPECT_FALSE(other.RestoreState(saved, pos));
+    EXPECT_EQ(pos, (size_t)0);
+    EXPECT_EQ(other.GetSampleCount(), 0L);
+}
+
+TEST(OutputStats, StatisticNames) {
+    double p = 0.0;
+    EXPECT_EQ(StatNameToStat("MAX", &p), (int)OutputStats::STAT_MAX);
+    EXPECT_EQ(StatNameToStat("EXCEED_HOURS", &p), (int)OutputStats::STAT_EXCEED_HOURS);
+    EXPECT_EQ(StatNameToStat("P99.9", &p), (int)OutputStats::STAT_QUANTILE);
+    EXPECT_NEAR(p, 0.999, 1e-12);
+    EXPECT_EQ(StatNameToStat("P100", &p), -1);
+    EXPECT_EQ(StatNameToStat("MEDIAN", &p), -1);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,79 @@
+//-----------------------------------------------------------------------------
+//   test_profiler.cpp
+//
+//   Unit tests for the per-phase timing histograms and report (Profiler)
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/Profiler.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static const char* kTestFile = "test_profiler.json";
+
+TEST(Profiler, DisabledRecordsNothing) {
+    Profiler prof;
+    long long t = prof.Begin();
+    EXPECT_EQ(t, 0LL);
+    prof.End(Profiler::PHASE_STEP, t);
+    { ProfileScope scope(prof, Profiler::PHASE_GATHER); }
+    EXPECT_EQ(prof.GetCount(Profiler::PHASE_STEP), 0LL);
+    EXPECT_EQ(prof.GetCount(Profiler::PHASE_GATHER), 0LL);
+}
+
+TEST(Profiler, PercentilesWithinBucketResolution) {
+    Profiler prof;
+    prof.SetEnabled(true);
+    // 1..1000 us
+    for (long long i = 1; i <= 1000; i++) prof.Record(Profiler::PHASE_STEP, i * 1000);
+    EXPECT_EQ(prof.GetCount(Profiler::PHASE_STEP), 1000LL);
+    EXPECT_EQ(prof.GetMaxNs(Profiler::PHASE_STEP), 1000000LL);
+    EXPECT_EQ(prof.GetTotalNs(Profiler::PHASE_STEP), 500500000LL);
+
+    const double qs[3] = { 0.5, 0.9, 0.99 };
+    for (double q : qs) {
+        double expected = q * 1000000.0;
+        double got = (double)prof.GetPercentileNs(Profiler::PHASE_STEP, q);
+        EXPECT_NEAR(got, expected, expected * 0.07);
+    }
+    EXPECT_EQ(prof.GetPercentileNs(Profiler::PHASE_STEP, 1.0), 1000000LL);
+    EXPECT_EQ(prof.GetPercentileNs(Profiler::PHASE_APPLY, 0.5), 0LL);
+
+    // Small values are exact
+    prof.Record(Profiler::PHASE_APPLY, 7);
+    EXPECT_EQ(prof.GetPercentileNs(Profiler::PHASE_APPLY, 0.5), 7LL);
+
+    prof.Reset();
+    EXPECT_EQ(prof.GetCount(Profiler::PHASE_STEP), 0LL);
+}
+
+TEST(Profiler, ScopeAndReport) {
+    Profiler prof;
+    prof.SetEnabled(true);
+    for (int i = 0; i < 3; i++) {
+        ProfileScope scope(prof, Profiler::PHASE_CALCULATE);
+    }
+    EXPECT_EQ(prof.GetCount(Profiler::PHASE_CALCULATE), 3LL);
+    EXPECT_TRUE(prof.GetRssSampled(Profiler::PHASE_CALCULATE) >= 0);
+    EXPECT_TRUE(Profiler::PeakRss() >= 0);
+
+    ASSERT_TRUE(prof.WriteReport(kTestFile, 2));
+    std::ifstream f(kTestFile);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    f.close();
+    std::string json = ss.str();
+    EXPECT_TRUE(json.find("\"realizations\": 2") != std::string::npos);
+    EXPECT_TRUE(json.find("\"phase\": \"calculate\", \"count\": 3") != std::string::npos);
+    EXPECT_TRUE(json.find("\"rss_peak_bytes\"") != std::string::npos);
+    EXPECT_TRUE(json.find("\"rss_sampled_bytes\"") != std::string::npos);
+    EXPECT_TRUE(json.find("\"step\"") == std::string::npos);     // Phases without samples are left out
+    std::remove(kTestFile);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,116 @@
+//-----------------------------------------------------------------------------
+//   test_recorder.cpp
+//
+//   Unit tests for the columnar per-step recording (Recorder and
+//   RecordingReader)
+//-----------------------------------------------------------------------------
+
+#include "../include/Platform.h"
+#include "gtest_minimal.h"
+#include "../include/Recorder.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static const char* kTestFile = "test_recorder.gsr";
+
+static std::vector<Recorder::Column> TestColumns() {
+    std::vector<Recorder::Column> cols(3);
+    cols[0].name = "POND";  cols[0].kind = Recorder::COLUMN_OUTPUT; cols[0].index = 1;
+    cols[1].name = "OUT1";  cols[1].kind = Recorder::COLUMN_OUTPUT; cols[1].index = 0;
+    cols[2].name = "R1";    cols[2].kind = Recorder::COLUMN_INPUT;  cols[2].index = 0;
+    return cols;
+}
+
+// Row r: outputs {r, 100 + r}, input {-r}
+static void WriteRows(int rows, int chunk_rows) {
+    Recorder rec;
+    std::string error;
+    ASSERT_TRUE(rec.Open(kTestFile, TestColumns(), chunk_rows, error));
+    for (int r = 0; r < rows; r++) {
+        double out[2] = { (double)r, 100.0 + r };
+        double in[1] = { -(double)r };
+        rec.Append(r * 0.5, out, r == 0 ? NULL : in);
+    }
+    EXPECT_EQ(rec.GetRowCount(), (long long)rows);
+    EXPECT_TRUE(rec.Close());
+}
+
+TEST(Recorder, RoundTripsColumns) {
+    WriteRows(10, 4);      // Two full chunks and a partial one
+
+    RecordingReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.Open(kTestFile, error));
+    EXPECT_EQ(reader.GetRowCount(), 10LL);
+    ASSERT_EQ(reader.GetColumnCount(), 3);
+    EXPECT_EQ(reader.GetColumnName(0), std::string("POND"));
+    EXPECT_EQ(reader.GetColumnIndex(0), 1);
+    EXPECT_EQ(reader.FindColumn("R1", Recorder::COLUMN_INPUT), 2);
+    EXPECT_EQ(reader.FindColumn("R1", Recorder::COLUMN_OUTPUT), -1);
+
+    std::vector<double> pond, out1, rain, t;
+    ASSERT_TRUE(reader.ReadColumn(0, out1));
+    ASSERT_TRUE(reader.ReadColumn(1, pond));
+    ASSERT_TRUE(reader.ReadColumn(2, rain));
+    ASSERT_TRUE(reader.ReadTimes(t));
+    for (int r = 0; r < 10; r++) {
+        EXPECT_DOUBLE_EQ(out1[r], 100.0 + r);   // Column 0 records outputs[1]
+        EXPECT_DOUBLE_EQ(pond[r], (double)r);
+        EXPECT_DOUBLE_EQ(t[r], r * 0.5);
+    }
+    EXPECT_TRUE(std::isnan(rain[0]));           // No inputs on the first row
+    EXPECT_DOUBLE_EQ(rain[9], -9.0);
+    reader.Close();
+    std::remove(kTestFile);
+}
+
+TEST(Recorder, SlicesRangesAcrossChunks) {
+    WriteRows(25, 8);
+    RecordingReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.Open(kTestFile, error));
+    double v[10];
+    ASSERT_TRUE(reader.ReadColumn(1, 5, 10, v));    // Rows 5..14 span chunks 0 and 1
+    for (int i = 0; i < 10; i++) EXPECT_DOUBLE_EQ(v[i], 5.0 + i);
+    EXPECT_FALSE(reader.ReadColumn(1, 20, 6, v));   // Past the last row
+    EXPECT_FALSE(reader.ReadColumn(3, 0, 1, v));
+    reader.Close();
+    std::remove(kTestFile);
+}
+
+TEST(Recorder, IgnoresTornChunk) {
+    WriteRows(8, 4);
+    FILE* f = NULL;
+    fopen_s(&f, kTestFile, "ab");
+    ASSERT_TRUE(f != NULL);
+    const char junk[20] = { 0 };
+    fwrite(junk, 1, sizeof(junk), f);               // Part of a third chunk
+    fclose(f);
+
+    RecordingReader reader;
+    std::string error;
+    ASSERT_TRUE(reader.Open(kTestFile, error));
+    EXPECT_EQ(reader.GetRowCount(), 8LL);
+    reader.Close();
+    std::remove(kTestFile);
+}
+
+TEST(Recorder, RejectsOtherFiles) {
+    FILE* f = NULL;
+    fopen_s(&f, kTestFile, "wb");
+    ASSERT_TRUE(f != NULL);
+    fputs("not a recording at all, just some text", f);
+    fclose(f);
+    RecordingReader reader;
+    std::string error;
+    EXPECT_FALSE(reader.Open(kTestFile, error));
+    EXPECT_FALSE(error.empty());
+    std::remove(kTestFile);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
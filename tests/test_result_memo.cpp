@@ -0,0 +1,129 @@
+//-----------------------------------------------------------------------------
+//   test_result_memo.cpp
+//
+//   Unit tests for the on-disk result store (ResultMemo) used by the
+//   memo section of SwmmGoldSimBridge.json
+//-----------------------------------------------------------------------------
+
+#include "../include/Platform.h"
+#include "gtest_minimal.h"
+#include "../include/ResultMemo.h"
+#include "../include/Hash.h"
+#include <cstdio>
+#include <string>
+
+static const unsigned long long kBase = 0x1234abcdULL;
+static const char* kStoreFile = "000000001234abcd.memo";
+
+TEST(ResultMemo, StoresAndReloadsRecords) {
+    std::remove(kStoreFile);
+    std::string error;
+    double out[3] = { 0 };
+    bool ended = true;
+    {
+        ResultMemo memo;
+        ASSERT_TRUE(memo.Open("", kBase, 3, error));
+        EXPECT_EQ(memo.GetRecordCount(), (size_t)0);
+        EXPECT_FALSE(memo.Lookup(1, out, &ended));
+
+        double a[3] = { 1.5, 2.5, 3.5 };
+        memo.Add(1, a, false);
+        memo.Add(2, NULL, true);
+        ASSERT_TRUE(memo.Lookup(1, out, &ended));    // Served from the queue
+        EXPECT_FALSE(ended);
+        EXPECT_DOUBLE_EQ(out[2], 3.5);
+        ASSERT_TRUE(memo.Flush(error));
+    }
+
+    ResultMemo memo;
+    ASSERT_TRUE(memo.Open("", kBase, 3, error));
+    EXPECT_EQ(memo.GetRecordCount(), (size_t)2);
+    ASSERT_TRUE(memo.Lookup(1, out, &ended));
+    EXPECT_FALSE(ended);
+    EXPECT_DOUBLE_EQ(out[0], 1.5);
+    EXPECT_DOUBLE_EQ(out[1], 2.5);
+    ASSERT_TRUE(memo.Lookup(2, out, &ended));
+    EXPECT_TRUE(ended);
+    memo.Close();
+    std::remove(kStoreFile);
+}
+
+TEST(ResultMemo, KeepsFirstRecordForKey) {
+    std::remove(kStoreFile);
+    std::string error;
+    ResultMemo memo;
+    ASSERT_TRUE(memo.Open("", kBase, 1, error));
+    double a = 1.0, b = 2.0, out = 0.0;
+    bool ended = false;
+    memo.Add(7, &a, false);
+    memo.Add(7, &b, false);
+    ASSERT_TRUE(memo.Flush(error));
+    memo.Add(7, &b, false);
+    EXPECT_EQ(memo.GetRecordCount(), (size_t)1);
+    ASSERT_TRUE(memo.Lookup(7, &out, &ended));
+    EXPECT_DOUBLE_EQ(out, 1.0);
+    memo.Close();
+    std::remove(kStoreFile);
+}
+
+TEST(ResultMemo, RejectsDifferentLayout) {
+    std::remove(kStoreFile);
+    std::string error;
+    {
+        ResultMemo memo;
+        ASSERT_TRUE(memo.Open("", kBase, 2, error));
+    }
+    ResultMemo memo;
+    EXPECT_FALSE(memo.Open("", kBase, 3, error));
+    EXPECT_FALSE(memo.IsOpen());
+    EXPECT_FALSE(error.empty());
+    std::remove(kStoreFile);
+}
+
+TEST(ResultMemo, IgnoresTornTail) {
+    std::remove(kStoreFile);
+    std::string error;
+    double v = 4.0, out = 0.0;
+    bool ended = false;
+    {
+        ResultMemo memo;
+        ASSERT_TRUE(memo.Open("", kBase, 1, error));
+        memo.Add(1, &v, false);
+        ASSERT_TRUE(memo.Flush(error));
+    }
+
+    // Half a record, as left by an interrupted write
+    FILE* f = NULL;
+    ASSERT_TRUE(fopen_s(&f, kStoreFile, "ab") == 0 && f != NULL);
+    fwrite("garbage", 1, 7, f);
+    fclose(f);
+
+    ResultMemo memo;
+    ASSERT_TRUE(memo.Open("", kBase, 1, error));
+    EXPECT_EQ(memo.GetRecordCount(), (size_t)1);
+    double w = 5.0;
+    memo.Add(2, &w, false);
+    ASSERT_TRUE(memo.Flush(error));
+    memo.Close();
+
+    ASSERT_TRUE(memo.Open("", kBase, 1, error));
+    EXPECT_EQ(memo.GetRecordCount(), (size_t)2);
+    ASSERT_TRUE(memo.Lookup(2, &out, &ended));
+    EXPECT_DOUBLE_EQ(out, 5.0);
+    memo.Close();
+    std::remove(kStoreFile);
+}
+
+TEST(ResultMemo, ChainKeysDependOnWholePrefix) {
+    double in1[2] = { 1.0, 0.0 }, in2[2] = { 2.0, 0.0 };
+    unsigned long long a = Fnv1a64(in2, sizeof(in2), Fnv1a64(in1, sizeof(in1), kBase));
+    unsigned long long b = Fnv1a64(in1, sizeof(in1), Fnv1a64(in2, sizeof(in2), kBase));
+    unsigned long long c = Fnv1a64(in2, sizeof(in2), Fnv1a64(in1, sizeof(in1), kBase));
+    EXPECT_NE(a, b);
+    EXPECT_EQ(a, c);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
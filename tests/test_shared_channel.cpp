@@ -0,0 +1,82 @@
+//-----------------------------------------------------------------------------
+//   test_shared_channel.cpp
+//
+//   Unit tests for the shared-memory request/reply channel used by the
+//   SWMM worker processes (SharedChannel)
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/SharedChannel.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(SharedChannel, RoundTripsBothDirections) {
+    SharedChannel client, worker;
+    std::string error;
+    std::string name = SharedChannel::MakeName(1);
+    ASSERT_TRUE(client.Create(name, 8, error));
+    ASSERT_TRUE(worker.Open(name, error));
+    EXPECT_EQ(worker.GetCapacity(), 8);
+    EXPECT_TRUE(worker.IsCreatorAlive());
+
+    // Echo server: reply with each value doubled and the method as status
+    std::thread echo([&worker]() {
+        SharedChannel::Message msg;
+        double values[8];
+        for (int i = 0; i < 3; i++) {
+            if (worker.Receive(SharedChannel::TO_WORKER, msg, values, 8, 5000, 0) != 1) return;
+            for (int k = 0; k < msg.count; k++) values[k] *= 2.0;
+            worker.Post(SharedChannel::TO_CLIENT, 0, msg.method, 0, values, msg.count, i == 2 ? "last" : NULL);
+        }
+    });
+
+    SharedChannel::Message msg;
+    for (int i = 0; i < 3; i++) {
+        double in[3] = { 1.0 + i, 2.0, -3.5 };
+        double out[3] = { 0.0, 0.0, 0.0 };
+        ASSERT_TRUE(client.Post(SharedChannel::TO_WORKER, 10 + i, 0, 3, in, 3, NULL));
+        ASSERT_EQ(client.Receive(SharedChannel::TO_CLIENT, msg, out, 3, 5000, 50), 1);
+        EXPECT_EQ(msg.status, 10 + i);
+        EXPECT_EQ(msg.count, 3);
+        EXPECT_DOUBLE_EQ(out[0], 2.0 * (1.0 + i));
+        EXPECT_DOUBLE_EQ(out[2], -7.0);
+    }
+    EXPECT_EQ(std::string(msg.text), std::string("last"));
+    echo.join();
+}
+
+TEST(SharedChannel, TimesOutAndRejectsOversizedMessages) {
+    SharedChannel client;
+    std::string error;
+    ASSERT_TRUE(client.Create(SharedChannel::MakeName(2), 2, error));
+
+    SharedChannel::Message msg;
+    EXPECT_EQ(client.Receive(SharedChannel::TO_CLIENT, msg, NULL, 0, 20, 0), 0);
+
+    double values[3] = { 1.0, 2.0, 3.0 };
+    EXPECT_FALSE(client.Post(SharedChannel::TO_WORKER, 1, 0, 0, values, 3, NULL));
+
+    // The ring holds kSlots unread messages
+    for (int i = 0; i < SharedChannel::kSlots; i++) {
+        EXPECT_TRUE(client.Post(SharedChannel::TO_WORKER, i, 0, 0, values, 2, NULL));
+    }
+    EXPECT_FALSE(client.Post(SharedChannel::TO_WORKER, 99, 0, 0, values, 2, NULL));
+    double out[2];
+    ASSERT_EQ(client.Receive(SharedChannel::TO_WORKER, msg, out, 2, 0, 0), 1);
+    EXPECT_EQ(msg.method, 0);
+    EXPECT_TRUE(client.Post(SharedChannel::TO_WORKER, 99, 0, 0, values, 2, NULL));
+}
+
+TEST(SharedChannel, OpenFailsForMissingChannel) {
+    SharedChannel worker;
+    std::string error;
+    EXPECT_FALSE(worker.Open(SharedChannel::MakeName(999), error));
+    EXPECT_FALSE(worker.IsOpen());
+    EXPECT_FALSE(error.empty());
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
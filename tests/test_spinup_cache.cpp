@@ -0,0 +1,174 @@
+//-----------------------------------------------------------------------------
+//   test_spinup_cache.cpp
+//
+//   Unit tests for the spin-up hotstart cache (SpinupCache)
+//   Tests: .inp date handling and rewriting, and the cache hit/miss path
+//   against local SWMM fakes that honour SAVE HOTSTART
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/SpinupCache.h"
+#include "../include/swmm5.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+static int g_open_calls = 0;
+static std::string g_open_file;
+static std::string g_save_path;
+
+static std::string Slurp(const std::string& path) {
+    std::ifstream f(path.c_str(), std::ios::binary);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+}
+
+extern "C" {
+int DLLEXPORT swmm_open(const char* f1, const char* f2, const char* f3) {
+    (void)f2; (void)f3;
+    g_open_calls++;
+    g_open_file = f1;
+    std::string inp = Slurp(f1);
+    size_t p = inp.find("SAVE HOTSTART \"");
+    g_save_path.clear();
+    if (p != std::string::npos) {
+        p += 15;
+        g_save_path = inp.substr(p, inp.find('"', p) - p);
+    }
+    return 0;
+}
+int DLLEXPORT swmm_start(int saveFlag) { (void)saveFlag; return 0; }
+int DLLEXPORT swmm_step(double* elapsedTime) {
+    static int n = 0;
+    *elapsedTime = (++n % 4) ? n * 0.01 : 0.0;   // Ends every 4th step
+    return 0;
+}
+int DLLEXPORT swmm_end(void) {
+    if (!g_save_path.empty()) {
+        std::ofstream f(g_save_path.c_str());
+        f << "state";
+    }
+    return 0;
+}
+int DLLEXPORT swmm_close(void) { return 0; }
+int DLLEXPORT swmm_getError(char* errMsg, int msgLen) {
+    if (msgLen > 0) errMsg[0] = '\0';
+    return 0;
+}
+}
+
+static const char* kModel =
+    "[TITLE]\r\n"
+    "Spin-up test\r\n"
+    "\r\n"
+    "[OPTIONS]\r\n"
+    ";;Option            \tValue\r\n"
+    "START_DATE          \t01/30/2007\r\n"
+    "START_TIME          \t00:00:00\r\n"
+    "END_DATE            \t03/31/2007\r\n"
+    "END_TIME            \t12:00\r\n"
+    "\r\n"
+    "[FILES]\r\n"
+    "USE HOTSTART \"old.hsf\"\r\n"
+    "\r\n"
+    "[JUNCTIONS]\r\n"
+    "J1 0 0\r\n";
+
+TEST(SpinupCache, DateRoundTrip) {
+    double d1 = 0.0, d2 = 0.0;
+    ASSERT_TRUE(InpDateTimeToDays("01/30/2007", "06:30:00", &d1));
+    ASSERT_TRUE(InpDateTimeToDays("JAN-30-2007", "6.5", &d2));
+    EXPECT_DOUBLE_EQ(d1, d2);
+
+    std::string date, time;
+    DaysToInpDateTime(d1 + 30.0, date, time);    // Across the end of February
+    EXPECT_EQ(date, std::string("03/01/2007"));
+    EXPECT_EQ(time, std::string("06:30:00"));
+
+    DaysToInpDateTime(d1 + 1830.75, date, time);   // Leap year 2008, past midnight
+    EXPECT_EQ(date, std::string("02/04/2012"));
+    EXPECT_EQ(time, std::string("00:30:00"));
+    EXPECT_FALSE(InpDateTimeToDays("13/01/2007", "", &d1));
+}
+
+TEST(SpinupCache, ReadsOptions) {
+    std::map<std::string, std::string> opts = ReadInpOptions(kModel);
+    EXPECT_EQ(opts["START_DATE"], std::string("01/30/2007"));
+    EXPECT_EQ(opts["END_TIME"], std::string("12:00"));
+    EXPECT_TRUE(opts.find("J1") == opts.end());
+}
+
+TEST(SpinupCache, RewritesOptionsAndFiles) {
+    std::map<std::string, std::string> opts;
+    opts["END_DATE"] = "02/20/2007";
+    opts["REPORT_STEP"] = "00:05:00";
+    std::vector<std::string> files(1, "SAVE HOTSTART \"new.hsf\"");
+    std::string out = RewriteInp(kModel, opts, files);
+
+    std::map<std::string, std::string> parsed = ReadInpOptions(out);
+    EXPECT_EQ(parsed["END_DATE"], std::string("02/20/2007"));
+    EXPECT_EQ(parsed["REPORT_STEP"], std::string("00:05:00"));
+    EXPECT_EQ(parsed["START_DATE"], std::string("01/30/2007"));
+    EXPECT_TRUE(out.find("old.hsf") == std::string::npos);
+    EXPECT_TRUE(out.find("SAVE HOTSTART \"new.hsf\"") != std::string::npos);
+    EXPECT_TRUE(out.find("J1 0 0") != std::string::npos);
+}
+
+TEST(SpinupCache, RunsOnceThenHitsCache) {
+    {
+        std::ofstream f("spinup_test.inp", std::ios::binary);
+        f << kModel;
+    }
+    SpinupCache cache;
+    std::string run_inp, error;
+    ASSERT_TRUE(cache.Prepare("spinup_test.inp", 21.0, "", run_inp, error));
+    EXPECT_TRUE(cache.RanSpinup());
+    EXPECT_EQ(g_open_calls, 1);
+    EXPECT_EQ(g_open_file, std::string("spinup_test_spinup.inp"));
+
+    std::map<std::string, std::string> spin = ReadInpOptions(Slurp("spinup_test_spinup.inp"));
+    EXPECT_EQ(spin["END_DATE"], std::string("02/20/2007"));
+
+    std::string run = Slurp(run_inp);
+    std::map<std::string, std::string> opts = ReadInpOptions(run);
+    EXPECT_EQ(opts["START_DATE"], std::string("02/20/2007"));
+    EXPECT_TRUE(run.find("USE HOTSTART \"" + cache.GetHotstartPath() + "\"") != std::string::npos);
+
+    // Same model and window: no SWMM run
+    ASSERT_TRUE(cache.Prepare("spinup_test.inp", 21.0, "", run_inp, error));
+    EXPECT_FALSE(cache.RanSpinup());
+    EXPECT_EQ(g_open_calls, 1);
+    std::string first = cache.GetHotstartPath();
+
+    // A different window is a different cache entry
+    ASSERT_TRUE(cache.Prepare("spinup_test.inp", 14.0, "", run_inp, error));
+    EXPECT_TRUE(cache.RanSpinup());
+    EXPECT_TRUE(cache.GetHotstartPath() != first);
+
+    std::remove(first.c_str());
+    std::remove(cache.GetHotstartPath().c_str());
+    std::remove("spinup_test.inp");
+    std::remove("spinup_test_spinup.inp");
+    std::remove("spinup_test_hotstart.inp");
+}
+
+TEST(SpinupCache, RejectsWindowPastEndDate) {
+    {
+        std::ofstream f("spinup_test.inp", std::ios::binary);
+        f << kModel;
+    }
+    SpinupCache cache;
+    std::string run_inp, error;
+    EXPECT_FALSE(cache.Prepare("spinup_test.inp", 90.0, "", run_inp, error));
+    EXPECT_FALSE(error.empty());
+    std::remove("spinup_test.inp");
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    int failed = RUN_ALL_TESTS();
+    std::remove("bridge_debug.log");
+    return failed;
+}
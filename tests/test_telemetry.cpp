@@ -0,0 +1,115 @@
+//-----------------------------------------------------------------------------
+//   test_telemetry.cpp
+//
+//   Unit tests for the shared-memory live state (Telemetry)
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/Telemetry.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::string TestName(const char* tag) {
+    return std::string("gsswmm_test_telemetry_") + tag + "_" + std::to_string(SharedMemory::CurrentProcessId());
+}
+
+static void Names(std::vector<std::string>& in, std::vector<std::string>& out) {
+    in.assign(1, "R1");
+    out.clear();
+    out.push_back("POND");
+    out.push_back("OUT1");
+}
+
+TEST(Telemetry, ReaderSeesPublishedState) {
+    std::vector<std::string> in, out;
+    Names(in, out);
+    std::string error;
+    Telemetry writer, reader;
+    const std::string name = TestName("state");
+    ASSERT_TRUE(writer.Create(name, in, out, error));
+    ASSERT_TRUE(reader.Open(name, error));
+    ASSERT_EQ(reader.GetInputNames().size(), (size_t)1);
+    ASSERT_EQ(reader.GetOutputNames().size(), (size_t)2);
+    EXPECT_EQ(reader.GetInputNames()[0], std::string("R1"));
+    EXPECT_EQ(reader.GetOutputNames()[1], std::string("OUT1"));
+
+    double inputs[1] = { 2.5 };
+    double outputs[2] = { 100.0, 7.0 };
+    writer.Publish(3, Telemetry::STATE_RUNNING, 42, 21, 0.125, inputs, outputs);
+
+    Telemetry::Snapshot s;
+    ASSERT_TRUE(reader.Read(s, 10));
+    EXPECT_EQ(s.writer_pid, SharedMemory::CurrentProcessId());
+    EXPECT_EQ(s.realization, 3);
+    EXPECT_EQ(s.state, (int)Telemetry::STATE_RUNNING);
+    EXPECT_EQ(s.route_steps, 42LL);
+    EXPECT_EQ(s.intervals, 21LL);
+    EXPECT_NEAR(s.elapsed_days, 0.125, 1e-12);
+    EXPECT_NEAR(s.inputs[0], 2.5, 1e-12);
+    EXPECT_NEAR(s.outputs[1], 7.0, 1e-12);
+
+    // NULL vectors keep the previous values
+    writer.Publish(3, Telemetry::STATE_RUNNING, 43, 22, 0.25, NULL, NULL);
+    writer.SetState(Telemetry::STATE_ENDED);
+    ASSERT_TRUE(reader.Read(s, 10));
+    EXPECT_EQ(s.state, (int)Telemetry::STATE_ENDED);
+    EXPECT_EQ(s.route_steps, 43LL);
+    EXPECT_NEAR(s.outputs[0], 100.0, 1e-12);
+}
+
+TEST(Telemetry, SnapshotsAreConsistentUnderConcurrentWrites) {
+    std::vector<std::string> in, out;
+    Names(in, out);
+    std::string error;
+    Telemetry writer, reader;
+    const std::string name = TestName("race");
+    ASSERT_TRUE(writer.Create(name, in, out, error));
+    ASSERT_TRUE(reader.Open(name, error));
+
+    // Every field of one publish carries the same step number
+    std::atomic<bool> done(false);
+    std::thread t([&]() {
+        for (long long k = 1; k <= 200000; k++) {
+            double v = (double)k;
+            double outputs[2] = { v, v };
+            writer.Publish(1, Telemetry::STATE_RUNNING, k, k, v, &v, outputs);
+        }
+        done.store(true);
+    });
+
+    int reads = 0, torn = 0;
+    Telemetry::Snapshot s;
+    while (!done.load()) {
+        if (!reader.Read(s, 1000)) continue;
+        reads++;
+        double v = (double)s.route_steps;
+        if (s.intervals != s.route_steps || s.elapsed_days != v || s.inputs[0] != v ||
+            s.outputs[0] != v || s.outputs[1] != v) {
+            torn++;
+        }
+    }
+    t.join();
+    EXPECT_EQ(torn, 0);
+    EXPECT_TRUE(reads > 0);
+    ASSERT_TRUE(reader.Read(s, 10));
+    EXPECT_EQ(s.route_steps, 200000LL);
+}
+
+TEST(Telemetry, SecondWriterIsRejectedAndMissingSegmentFails) {
+    std::vector<std::string> in, out;
+    Names(in, out);
+    std::string error;
+    Telemetry first, second, reader;
+    const std::string name = TestName("owner");
+    ASSERT_TRUE(first.Create(name, in, out, error));
+    EXPECT_FALSE(second.Create(name, in, out, error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_FALSE(reader.Open(TestName("missing"), error));
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,89 @@
+//-----------------------------------------------------------------------------
+//   test_tracer.cpp
+//
+//   Unit tests for the per-thread trace buffers and Chrome trace-event
+//   output (Tracer), and the Profiler hook that feeds them
+//-----------------------------------------------------------------------------
+
+#include "gtest_minimal.h"
+#include "../include/Tracer.h"
+#include "../include/Profiler.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+static const char* kTestFile = "test_tracer.json";
+
+static std::string ReadFile(const char* path) {
+    std::ifstream f(path);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    return ss.str();
+}
+
+static int CountOf(const std::string& text, const std::string& what) {
+    int n = 0;
+    for (size_t pos = text.find(what); pos != std::string::npos; pos = text.find(what, pos + 1)) n++;
+    return n;
+}
+
+TEST(Tracer, InactiveAddsNothing) {
+    Tracer tracer;
+    tracer.Add("step", 1, 2);
+    EXPECT_EQ(tracer.GetEventCount(), 0LL);
+}
+
+TEST(Tracer, PerThreadBuffersAndDrops) {
+    Tracer tracer;
+    tracer.Start(100);
+    tracer.NameThread("main");
+    for (int i = 0; i < 10; i++) tracer.Add("calculate", Profiler::Now(), 1000);
+
+    std::thread worker([&tracer]() {
+        tracer.NameThread("worker");
+        for (int i = 0; i < 150; i++) tracer.Add("step", Profiler::Now(), 500);
+    });
+    worker.join();
+    tracer.Stop();
+    tracer.Add("late", 0, 0);
+
+    EXPECT_EQ(tracer.GetEventCount(), 110LL);
+    EXPECT_EQ(tracer.GetDroppedCount(), 50LL);
+
+    ASSERT_TRUE(tracer.Write(kTestFile));
+    std::string json = ReadFile(kTestFile);
+    std::remove(kTestFile);
+    EXPECT_EQ(CountOf(json, "\"name\": \"calculate\""), 10);
+    EXPECT_EQ(CountOf(json, "\"name\": \"step\""), 100);
+    EXPECT_EQ(CountOf(json, "\"ph\": \"X\""), 110);
+    EXPECT_TRUE(json.find("\"args\": {\"name\": \"worker\"}") != std::string::npos);
+    EXPECT_TRUE(json.find("\"dropped_events\": 50") != std::string::npos);
+
+    // A new trace starts empty
+    tracer.Start(100);
+    EXPECT_EQ(tracer.GetEventCount(), 0LL);
+    tracer.Add("step", Profiler::Now(), 1);
+    EXPECT_EQ(tracer.GetEventCount(), 1LL);
+}
+
+TEST(Tracer, ProfilerFeedsTracerWhenDisabled) {
+    Tracer tracer;
+    Profiler prof;
+    tracer.Start(10);
+    prof.SetTracer(&tracer);
+    { ProfileScope scope(prof, Profiler::PHASE_STEP); }
+    { ProfileScope scope(prof, Profiler::PHASE_GATHER); }
+    EXPECT_EQ(tracer.GetEventCount(), 2LL);
+    EXPECT_EQ(prof.GetCount(Profiler::PHASE_STEP), 0LL);     // Histograms stay off
+
+    prof.SetTracer(NULL);
+    { ProfileScope scope(prof, Profiler::PHASE_STEP); }
+    EXPECT_EQ(tracer.GetEventCount(), 2LL);
+}
+
+int main(int argc, char** argv) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}